@@ -25,45 +25,52 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "FEDomainShapeInterpolator.h"
 #include <FECore/FESolidDomain.h>
-#include <FECore/FEOctreeSearch.h>
+#include <FECore/FEElementBVH.h>
 
 FEDomainShapeInterpolator::FEDomainShapeInterpolator(FEDomain* domain)
 {
 	m_dom = domain;
 	m_mesh = m_dom->GetMesh();
-	m_os = nullptr;
+	m_bvh = nullptr;
 }
 
 FEDomainShapeInterpolator::~FEDomainShapeInterpolator()
 {
-	delete m_os;
+	delete m_bvh;
 }
 
 bool FEDomainShapeInterpolator::Init()
 {
 	if (m_mesh == nullptr) return false;
 
-	if (m_os == nullptr)
+	if (m_bvh == nullptr)
 	{
-		m_os = new FEOctreeSearch(m_dom);
-		if (m_os->Init() == false) return false;
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(m_dom);
+		if (dom == nullptr) return false;
+
+		// inflate the element boxes a little for round-off
+		m_bvh = new FEElementBVH(m_mesh);
+		if (m_bvh->Build(dom, 1e-6) == false) return false;
 	}
 
+	// find the elements
 	int nodes = m_trgPoints.size();
+	vector<FESolidElement*> el;
+	vector<double> r;
+	if (m_bvh->FindElements(m_trgPoints, el, r) != nodes)
+	{
+		assert(false);
+		return false;
+	}
+
 	m_data.resize(nodes);
 	for (int i = 0; i < nodes; ++i)
 	{
 		Data& di = m_data[i];
-		vec3d ri = m_trgPoints[i];
-
-		// find the element
-		di.r[0] = di.r[1] = di.r[2] = 0.0;
-		di.el = (FESolidElement*)m_os->FindElement(ri, di.r);
-		if (di.el == nullptr)
-		{
-			assert(false);
-			return false;
-		}
+		di.el = el[i];
+		di.r[0] = r[3*i  ];
+		di.r[1] = r[3*i+1];
+		di.r[2] = r[3*i+2];
 		assert(di.el->GetMeshPartition() == m_dom);
 	}
 
@@ -29,7 +29,7 @@ SOFTWARE.*/
 class FEDomain;
 class FESolidElement;
 class FEMesh;
-class FEOctreeSearch;
+class FEElementBVH;
 
 //! Maps data by using element shape functions
 class FEDomainShapeInterpolator : public FEMeshDataInterpolator
@@ -58,7 +58,7 @@ private:
 	FEDomain*	m_dom;
 	FEMesh*	m_mesh;
 
-	FEOctreeSearch*	m_os;
+	FEElementBVH*	m_bvh;
 	vector<vec3d>	m_trgPoints;
 	vector<Data>	m_data;
 };
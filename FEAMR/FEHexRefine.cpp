@@ -809,6 +809,7 @@ void FEHexRefine::BuildNewDomains(FEModel& fem)
 		FEDomain& dom = mesh.Domain(i);
 		dom.CreateMaterialPointData();
 		dom.Init();
+		dom.ForEachMaterialPoint([](FEMaterialPoint& mp) { mp.Init(); });
 		dom.Activate();
 	}
 }
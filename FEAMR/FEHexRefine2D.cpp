@@ -662,6 +662,7 @@ void FEHexRefine2D::BuildNewDomains(FEModel& fem)
 		FEDomain& dom = mesh.Domain(i);
 		dom.CreateMaterialPointData();
 		dom.Init();
+		dom.ForEachMaterialPoint([](FEMaterialPoint& mp) { mp.Init(); });
 		dom.Activate();
 	}
 }
@@ -484,6 +484,7 @@ bool FEMMGRemesh::MMG::build_new_mesh(MMG5_pMesh mmgMesh, MMG5_pSol mmgSol, FEMo
 		// re-init domain
 		dom.CreateMaterialPointData();
 		dom.Init();
+		dom.ForEachMaterialPoint([](FEMaterialPoint& mp) { mp.Init(); });
 		dom.Activate();
 	}
 	mesh.RebuildLUT();
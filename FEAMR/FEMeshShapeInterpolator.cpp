@@ -24,45 +24,49 @@ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
 #include "FEMeshShapeInterpolator.h"
-#include <FECore/FEOctreeSearch.h>
+#include <FECore/FEElementBVH.h>
 #include <FECore/FEMesh.h>
 
 //=============================================================================================
 FEMeshShapeInterpolator::FEMeshShapeInterpolator(FEMesh* mesh) : m_mesh(mesh)
 {
-	m_os = nullptr;
+	m_bvh = nullptr;
 }
 
 FEMeshShapeInterpolator::~FEMeshShapeInterpolator()
 {
-	delete m_os;
+	delete m_bvh;
 }
 
 bool FEMeshShapeInterpolator::Init()
 {
 	if (m_mesh == nullptr) return false;
 
-	if (m_os == nullptr)
+	if (m_bvh == nullptr)
 	{
-		m_os = new FEOctreeSearch(m_mesh);
-		if (m_os->Init() == false) return false;
+		// inflate the element boxes a little for round-off
+		m_bvh = new FEElementBVH(m_mesh);
+		if (m_bvh->Build(1e-6) == false) return false;
 	}
 
+	// find the elements
 	int nodes = m_trgPoints.size();
+	vector<FESolidElement*> el;
+	vector<double> r;
+	if (m_bvh->FindElements(m_trgPoints, el, r) != nodes)
+	{
+		assert(false);
+		return false;
+	}
+
 	m_data.resize(nodes);
 	for (int i = 0; i < nodes; ++i)
 	{
 		Data& di = m_data[i];
-		vec3d ri = m_trgPoints[i];
-
-		// find the element
-		di.r[0] = di.r[1] = di.r[2] = 0.0;
-		di.el = (FESolidElement*)m_os->FindElement(ri, di.r);
-		if (di.el == nullptr)
-		{
-			assert(false);
-			return false;
-		}
+		di.el = el[i];
+		di.r[0] = r[3*i  ];
+		di.r[1] = r[3*i+1];
+		di.r[2] = r[3*i+2];
 	}
 
 	return true;
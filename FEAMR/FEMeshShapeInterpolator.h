@@ -28,7 +28,7 @@ SOFTWARE.*/
 
 //=======================================================================================
 class FEMesh;
-class FEOctreeSearch;
+class FEElementBVH;
 class FESolidElement;
 
 //! Interpolates data by using the element shape functions
@@ -56,7 +56,7 @@ public:
 
 private:
 	FEMesh*	m_mesh;
-	FEOctreeSearch*	m_os;
+	FEElementBVH*	m_bvh;
 	vector<vec3d>	m_trgPoints;
 	vector<Data>	m_data;
 };
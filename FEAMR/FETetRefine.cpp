@@ -182,6 +182,7 @@ bool FETetRefine::RefineMesh()
 		FEDomain& dom = mesh.Domain(i);
 		dom.CreateMaterialPointData();
 		dom.Init();
+		dom.ForEachMaterialPoint([](FEMaterialPoint& mp) { mp.Init(); });
 		dom.Activate();
 	}
 
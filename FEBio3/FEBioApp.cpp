@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "console.h"
 #include "CommandManager.h"
 #include <FECore/log.h>
+#include <FECore/FEProfiler.h>
 #include "console.h"
 #include "breakpoint.h"
 #include <FEBioLib/febio.h>
@@ -163,6 +164,13 @@ int FEBioApp::RunModel()
 	fem.SetPlotFilename(m_ops.szplt);
 	fem.SetDumpFilename(m_ops.szdmp);
 
+	// turn on the profiler
+	if (m_ops.bprofile)
+	{
+		FEProfiler::GetInstance()->Enable(true);
+		fem.SetProfileFilename(m_ops.szprof);
+	}
+
 	// read the input file if specified
 	int nret = 0;
 	if (m_ops.szfile[0])
@@ -230,12 +238,14 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 	ops.bsplash = true;
 	ops.bsilent = false;
 	ops.binteractive = true;
+	ops.bprofile = false;
 
 	// these flags indicate whether the corresponding file name
 	// was defined on the command line. Otherwise, a default name will be generated.
 	bool blog = false;
 	bool bplt = false;
 	bool bdmp = false;
+	bool bprof = false;
 	bool brun = true;
 
 	// initialize file names
@@ -243,6 +253,7 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 	ops.szplt[0] = 0;
 	ops.szlog[0] = 0;
 	ops.szdmp[0] = 0;
+	ops.szprof[0] = 0;
 	ops.sztask[0] = 0;
 	ops.szctrl[0] = 0;
 	ops.szimp[0] = 0;
@@ -275,6 +286,24 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 			strcpy(ops.szctrl, argv[++i]);
 			ops.binteractive = false;
 		}
+		else if (strcmp(sz, "-export_log") == 0)
+		{
+			if (ops.sztask[0] != 0) { fprintf(stderr, "-export_log is incompatible with other command line option.\n"); return false; }
+			strcpy(ops.sztask, "export_log");
+			strcpy(ops.szctrl, argv[++i]);
+			ops.binteractive = false;
+		}
+		else if (strcmp(sz, "-bench") == 0)
+		{
+			if (ops.sztask[0] != 0) { fprintf(stderr, "-bench is incompatible with other command line option.\n"); return false; }
+			strcpy(ops.sztask, "model_benchmark");
+			if ((i < nargs - 1) && (argv[i + 1][0] != '-'))
+			{
+				// assume this is the name of the results file
+				strcpy(ops.szctrl, argv[++i]);
+			}
+			ops.binteractive = false;
+		}
 		else if (strcmp(sz, "-p") == 0)
 		{
 			bplt = true;
@@ -301,6 +330,20 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 				}
 			}
 		}
+		else if (strcmp(sz, "-profile") == 0)
+		{
+			ops.bprofile = true;
+			if (i<nargs - 1)
+			{
+				char* szi = argv[i + 1];
+				if (szi[0] != '-')
+				{
+					// assume this is the name of the profile report
+					strcpy(ops.szprof, argv[++i]);
+					bprof = true;
+				}
+			}
+		}
 		else if (strcmp(sz, "-o") == 0)
 		{
 			blog = true;
@@ -467,6 +510,7 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 		if (!blog) sprintf(ops.szlog, "%s.log", szlogbase);
 		if (!bplt) sprintf(ops.szplt, "%s.xplt", szbase);
 		if (!bdmp) sprintf(ops.szdmp, "%s.dmp", szbase);
+		if (!bprof) sprintf(ops.szprof, "%s_profile.json", szbase);
 	}
 	else if (ops.szctrl[0])
 	{
@@ -478,6 +522,7 @@ bool FEBioApp::ParseCmdLine(int nargs, char* argv[])
 		if (!blog) sprintf(ops.szlog, "%s.log", szbase);
 		if (!bplt) sprintf(ops.szplt, "%s.xplt", szbase);
 		if (!bdmp) sprintf(ops.szdmp, "%s.dmp", szbase);
+		if (!bprof) sprintf(ops.szprof, "%s_profile.json", szbase);
 	}
 
 	return brun;
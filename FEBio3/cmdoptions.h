@@ -38,6 +38,7 @@ struct CMDOPTIONS
 	bool	bsplash;			//!< show splash screen or not
 	bool	bsilent;			//!< run FEBio in silent mode (no output to screen)
 	bool	binteractive;		//!< start FEBio interactively
+	bool	bprofile;			//!< write a profile report
 
 	int		dumpLevel;		//!< requested restart level
 
@@ -45,6 +46,7 @@ struct CMDOPTIONS
 	char	szlog[MAXFILE];	//!< log file name
 	char	szplt[MAXFILE];	//!< plot file name
 	char	szdmp[MAXFILE];	//!< dump file name
+	char	szprof[MAXFILE];	//!< profile report file name
 	char	szcnf[MAXFILE];	//!< configuration file
 	char	sztask[MAXFILE];	//!< task name
 	char	szctrl[MAXFILE];	//!< control file for tasks
@@ -61,12 +63,14 @@ struct CMDOPTIONS
 		bsplash = true;
 		bsilent = false;
 		binteractive = false;
+		bprofile = false;
 		dumpLevel = 0;
 
 		szfile[0] = 0;
 		szlog[0] = 0;
 		szplt[0] = 0;
 		szdmp[0] = 0;
+		szprof[0] = 0;
 		szcnf[0] = 0;
 		sztask[0] = 0;
 		szctrl[0] = 0;
@@ -433,10 +433,13 @@ void FEFluidDomain3D::ElementStiffness(FESolidElement &el, matrix &ke, const FET
 //-----------------------------------------------------------------------------
 void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
+    // get the cached scatter maps (if available)
+    FEDomainAssemblyMap* amap = LS.AssemblyMap(*this, 4);
+
     // repeat over all solid elements
     int NE = (int)m_Elem.size();
     
-#pragma omp parallel for shared (NE)
+#pragma omp parallel for shared (NE, amap)
     for (int iel=0; iel<NE; ++iel)
     {
 		FESolidElement& el = m_Elem[iel];
@@ -456,6 +459,7 @@ void FEFluidDomain3D::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 		vector<int> lm;
 		UnpackLM(el, lm);
 		ke.SetIndices(lm);
+		if (amap) ke.SetScatterMap(amap->ScatterMap(iel));
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
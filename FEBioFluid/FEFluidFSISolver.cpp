@@ -1349,6 +1349,7 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
     
     // setup the global vector
     FEResidualVector RHS(fem, R, m_Fr);
+    PrepareResidualVector(RHS);
 
     // zero rigid body reaction forces
     m_rigidSolver.Residual();
@@ -1469,6 +1470,9 @@ bool FEFluidFSISolver::Residual(vector<double>& R)
         }
     }
     
+    // make sure all contributions are added before we read the reaction forces
+    RHS.Flush();
+
     // set the nodal reaction forces
     // TODO: Is this a good place to do this?
     for (int i=0; i<mesh.Nodes(); ++i)
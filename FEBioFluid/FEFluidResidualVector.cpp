@@ -44,10 +44,12 @@ FEFluidResidualVector::~FEFluidResidualVector()
 }
 
 //-----------------------------------------------------------------------------
-void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe)
+void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
-    
-    vector<double>& R = m_R;
+    // when assembling in parallel with thread buffers, all contributions go into the thread's buffer
+    vector<double>* buf = ThreadBuffer();
+    vector<double>& R = (buf ? *buf : m_R);
+    const int neq = (int)m_R.size();
     
     int i, I;
     
@@ -63,14 +65,20 @@ void FEFluidResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<d
             I = elm[i];
             
             if ( I >= 0){
+                if (buf) R[I] += fe[i];
+                else {
 #pragma omp atomic
-                R[I] += fe[i];
+                    R[I] += fe[i];
+                }
             }
             // TODO: Find another way to store reaction forces
             
             else if (-I-2 >= 0){
+                if (buf) R[neq - I - 2] -= fe[i];
+                else {
 #pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                    m_Fr[-I-2] -= fe[i];
+                }
             }
         }
         
@@ -854,6 +854,7 @@ bool FEFluidSolver::Residual(vector<double>& R)
     
     // setup the global vector
     FEFluidResidualVector RHS(fem, R, m_Fr);
+    PrepareResidualVector(RHS);
     
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
@@ -913,6 +914,9 @@ bool FEFluidSolver::Residual(vector<double>& R)
         }
     }
     
+    // make sure all contributions are added before we read the reaction forces
+    RHS.Flush();
+
     // set the nodal reaction forces
     // TODO: Is this a good place to do this?
     for (int i=0; i<mesh.Nodes(); ++i)
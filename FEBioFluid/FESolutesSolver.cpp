@@ -750,6 +750,7 @@ bool FESolutesSolver::Residual(vector<double>& R)
     
     // setup the global vector
     FEGlobalVector RHS(fem, R, m_Fr);
+    PrepareResidualVector(RHS);
     
     // get the mesh
     FEMesh& mesh = fem.GetMesh();
@@ -780,6 +781,9 @@ bool FESolutesSolver::Residual(vector<double>& R)
         }
     }
     
+    // add the contributions of the thread buffers
+    RHS.Flush();
+
     // increase RHS counter
     m_nrhs++;
     
@@ -55,6 +55,7 @@ SOFTWARE.*/
 #include <FECore/LinearSolver.h>
 #include <FECore/FEDomain.h>
 #include <FECore/FEMaterial.h>
+#include <FECore/FEProfiler.h>
 #include "febio.h"
 #include "version.h"
 #include <iostream>
@@ -267,6 +268,14 @@ void FEBioModel::SetDumpFilename(const std::string& sfile)
 	m_sdump = sfile;
 }
 
+//-----------------------------------------------------------------------------
+//! Set the name of the profile report. The report is only written when the
+//! profiler is turned on.
+void FEBioModel::SetProfileFilename(const std::string& sfile)
+{
+	m_sprof = sfile;
+}
+
 //-----------------------------------------------------------------------------
 //! Return the name of the input file
 const std::string& FEBioModel::GetInputFileName()
@@ -295,6 +304,13 @@ const std::string& FEBioModel::GetDumpFileName()
 	return	m_sdump;
 }
 
+//-----------------------------------------------------------------------------
+//! Return the profile report file name.
+const std::string& FEBioModel::GetProfileFileName()
+{
+	return m_sprof;
+}
+
 //-----------------------------------------------------------------------------
 //! get the file title (i.e. name of input file without the path)
 const std::string& FEBioModel::GetFileTitle()
@@ -327,6 +343,7 @@ bool FEBioModel::Input(const char* szfile)
 {
 	// start the timer
 	TimerTracker t(&m_InputTime);
+	PROFILE_SCOPE("input");
 
 	// create file reader
 	FEBioImport fim;
@@ -488,6 +505,7 @@ void FEBioModel::WriteLog(unsigned int nwhen)
 void FEBioModel::Write(unsigned int nwhen)
 {
 	TimerTracker t(&m_IOTimer);
+	PROFILE_SCOPE("output");
 
 	// get the current step
 	FEAnalysis* pstep = GetCurrentStep();
@@ -617,6 +635,7 @@ void FEBioModel::Write(unsigned int nwhen)
 				// output the state if requested
 				if (bout && (m_lastUpdate != UpdateCounter()) )
 				{
+					PROFILE_SCOPE("plot");
 					m_lastUpdate = UpdateCounter();
 
 					// update the plot objects
@@ -665,12 +684,16 @@ void FEBioModel::Write(unsigned int nwhen)
 
 		if (bout) WriteData();
 	}
+
+	// the profile report is updated after each step
+	if (nwhen == CB_STEP_SOLVED) WriteProfile("step");
 }
 
 //-----------------------------------------------------------------------------
 //! Write user data to the logfile
 void FEBioModel::WriteData()
 {
+	PROFILE_SCOPE("data");
 	DataStore& dataStore = GetDataStore();
 	dataStore.Write();
 }
@@ -679,6 +702,7 @@ void FEBioModel::WriteData()
 //! Dump state to archive for restarts
 void FEBioModel::DumpData()
 {
+	PROFILE_SCOPE("dump");
 	DumpFile ar(*this);
 	if (ar.Create(m_sdump.c_str()) == false)
 	{
@@ -691,6 +715,32 @@ void FEBioModel::DumpData()
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Append the profiler's report as a single line of JSON to the profile file.
+//! The timings are accumulated from the start of the run.
+void FEBioModel::WriteProfile(const char* szevent, bool bconv)
+{
+	if ((FEProfiler::IsEnabled() == false) || m_sprof.empty()) return;
+
+	FILE* fp = fopen(m_sprof.c_str(), "at");
+	if (fp == nullptr) return;
+
+	fprintf(fp, "{\"event\":\"%s\"", szevent);
+	FEAnalysis* step = GetCurrentStep();
+	if (strcmp(szevent, "run") == 0)
+	{
+		fprintf(fp, ",\"elapsed\":%lg,\"status\":\"%s\"", m_SolveTime.GetTime(), (bconv ? "normal" : "error"));
+	}
+	else if (step)
+	{
+		fprintf(fp, ",\"step\":%d,\"time\":%lg,\"time_steps\":%d", GetCurrentStepIndex() + 1, GetTime().currentTime, step->m_ntimesteps);
+	}
+	std::string regions = FEProfiler::GetInstance()->ReportJSON();
+	fprintf(fp, ",\"regions\":%s}\n", regions.c_str());
+
+	fclose(fp);
+}
+
 //-----------------------------------------------------------------------------
 void FEBioModel::Log(int ntag, const char* szmsg)
 {
@@ -1367,6 +1417,15 @@ void FEBioModel::SerializeDataStore(DumpStream& ar)
 bool FEBioModel::Init()
 {
 	TimerTracker t(&m_InitTime);
+	PROFILE_SCOPE("init");
+
+	// start a new profile report
+	if (FEProfiler::IsEnabled() && !m_sprof.empty())
+	{
+		FILE* fp = fopen(m_sprof.c_str(), "wt");
+		if (fp) fclose(fp);
+		else feLogWarning("Failed creating profile report (%s).", m_sprof.c_str());
+	}
 
 	// Open the logfile
 	if (m_logLevel != 0)
@@ -1588,6 +1647,9 @@ bool FEBioModel::Solve()
 	// stop total time tracker
 	m_SolveTime.stop();
 
+	// write the final profile report
+	WriteProfile("run", bconv);
+
 	// get peak memory usage
 #ifdef WIN32
 	size_t memsize = GetPeakMemory();
@@ -1615,6 +1677,15 @@ bool FEBioModel::Solve()
 		double init_time    = m_InitTime.GetTime (); total_time += init_time;
 		double solve_time   = m_SolveTime.GetTime(); total_time += solve_time;
 		double io_time      = m_IOTimer.GetTime  ();
+		double plt_write    = 0.0;
+		double plt_wait     = 0.0;
+		if (m_plot)
+		{
+			// make sure the background writer is done
+			m_plot->Sync();
+			plt_write = m_plot->GetWriteTime();
+			plt_wait  = m_plot->GetWaitTime();
+		}
 		double total_linsol = 0.0;
 		double total_reform = 0.0;
 		double total_stiff  = 0.0;
@@ -1642,6 +1713,8 @@ bool FEBioModel::Solve()
 		Timer::time_str(init_time   , sztime); feLog("\tInitialization time ............. : %s (%lg sec)\n\n", sztime, init_time   );
 		Timer::time_str(solve_time  , sztime); feLog("\tSolve time ...................... : %s (%lg sec)\n\n", sztime, solve_time  );
 		Timer::time_str(io_time     , sztime); feLog("\t   IO-time (plot, dmp, data) .... : %s (%lg sec)\n\n", sztime, io_time     );
+		Timer::time_str(plt_write   , sztime); feLog("\t      plot file writer .......... : %s (%lg sec)\n\n", sztime, plt_write   );
+		Timer::time_str(plt_wait    , sztime); feLog("\t      waiting for plot writer ... : %s (%lg sec)\n\n", sztime, plt_wait    );
 		Timer::time_str(total_reform, sztime); feLog("\t   reforming stiffness .......... : %s (%lg sec)\n\n", sztime, total_reform);
 		Timer::time_str(total_stiff , sztime); feLog("\t   evaluating stiffness ......... : %s (%lg sec)\n\n", sztime, total_stiff );
 		Timer::time_str(total_rhs   , sztime); feLog("\t   evaluating residual .......... : %s (%lg sec)\n\n", sztime, total_rhs   );
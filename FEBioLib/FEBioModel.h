@@ -141,12 +141,14 @@ public: // --- I/O functions ---
 	void SetLogFilename  (const std::string& sfile);
 	void SetPlotFilename (const std::string& sfile);
 	void SetDumpFilename (const std::string& sfile);
+	void SetProfileFilename(const std::string& sfile);
 
 	//! Get the I/O file names
 	const std::string& GetInputFileName();
 	const std::string& GetLogfileName  ();
 	const std::string& GetPlotFileName ();
 	const std::string& GetDumpFileName ();
+	const std::string& GetProfileFileName();
 
 	//! get the file title
 	const std::string& GetFileTitle();
@@ -191,6 +193,9 @@ private:
 private:
 	void UpdatePlotObjects();
 
+	// append the profiler report to the profile file
+	void WriteProfile(const char* szevent, bool bconv = true);
+
 private:
 	Timer		m_SolveTime;	//!< timer to track total time to solve problem
 	Timer		m_InputTime;	//!< timer to track time to read model
@@ -219,6 +224,7 @@ protected: // file names
 	std::string		m_splot;			//!< plot output file name
 	std::string		m_slog ;			//!< log output file name
 	std::string		m_sdump;			//!< dump file name
+	std::string		m_sprof;			//!< profile report file name
 
 	std::string	m_title;	//!< model title
 
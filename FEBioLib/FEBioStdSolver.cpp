@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include <FEBioLib/FEBioModel.h>
 #include <FECore/log.h>
 #include <FEBioXML/FERestartImport.h>
+#include <FEBioXML/FEBinaryMesh.h>
+#include <FECore/DataRecordReader.h>
 #include <FECore/DumpFile.h>
 #include <FECore/FEAnalysis.h>
 
@@ -133,3 +135,112 @@ bool FEBioRestart::Run()
 	// continue the analysis
 	return (GetFEModel() ? GetFEModel()->Solve() : false);
 }
+
+//-----------------------------------------------------------------------------
+bool FEBioConvertMesh::Init(const char* szfile)
+{
+	FEBioModel& fem = static_cast<FEBioModel&>(*GetFEModel());
+	const std::string& sinp = fem.GetInputFileName();
+
+	// if no file name is given, we append "_bin" to the input file's name
+	if (szfile && szfile[0]) m_febm = szfile;
+	else
+	{
+		size_t n = sinp.rfind('.');
+		m_febm = (n == std::string::npos ? sinp : sinp.substr(0, n)) + "_bin.febm";
+	}
+
+	// the new input file gets the same name as the binary file
+	size_t n = m_febm.rfind('.');
+	m_feb = (n == std::string::npos ? m_febm : m_febm.substr(0, n)) + ".feb";
+	if (m_feb == sinp)
+	{
+		fprintf(stderr, "FATAL ERROR: Converting the mesh would overwrite the input file %s\n", sinp.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioConvertMesh::Run()
+{
+	FEBioModel& fem = static_cast<FEBioModel&>(*GetFEModel());
+
+	FEBinaryMeshConverter conv;
+	if (conv.Convert(fem, fem.GetInputFileName().c_str(), m_febm.c_str(), m_feb.c_str()) == false)
+	{
+		feLogError("%s", conv.GetErrorMessage().c_str());
+		return false;
+	}
+
+	feLog("Binary mesh written to %s\n", m_febm.c_str());
+	feLog("Input file written to %s\n", m_feb.c_str());
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioExportLog::Init(const char* szfile)
+{
+	if ((szfile == 0) || (szfile[0] == 0))
+	{
+		fprintf(stderr, "FATAL ERROR: No binary data file was specified\n");
+		return false;
+	}
+	m_bin = szfile;
+
+	size_t n = m_bin.rfind('.');
+	m_txt = (n == std::string::npos ? m_bin : m_bin.substr(0, n)) + ".txt";
+	if (m_txt == m_bin) m_txt += ".txt";
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBioExportLog::Run()
+{
+	DataRecordReader in;
+	if (in.Open(m_bin.c_str()) == false)
+	{
+		fprintf(stderr, "FATAL ERROR: Failed reading binary data file %s\n", m_bin.c_str());
+		return false;
+	}
+
+	FILE* fp = fopen(m_txt.c_str(), "wt");
+	if (fp == 0)
+	{
+		fprintf(stderr, "FATAL ERROR: Failed creating file %s\n", m_txt.c_str());
+		return false;
+	}
+
+	// the data expression is the list of field names
+	std::string data;
+	for (int i = 0; i < in.Fields(); ++i)
+	{
+		if (i > 0) data += ";";
+		data += in.FieldName(i);
+	}
+
+	int nitems = in.Items();
+	int nfields = in.Fields();
+	int nstep, nframes = 0;
+	double time;
+	std::vector<double> val;
+	while (in.ReadFrame(nstep, time, val))
+	{
+		fprintf(fp, "*Step  = %d\n", nstep);
+		fprintf(fp, "*Time  = %.9lg\n", time);
+		fprintf(fp, "*Data  = %s\n", data.c_str());
+		for (int i = 0; i < nitems; ++i)
+		{
+			fprintf(fp, "%d", in.ItemID(i));
+			for (int j = 0; j < nfields; ++j) fprintf(fp, " %.12lg", val[j*nitems + i]);
+			fprintf(fp, "\n");
+		}
+		nframes++;
+	}
+	fclose(fp);
+
+	fprintf(stdout, "%d frames written to %s\n", nframes, m_txt.c_str());
+	return true;
+}
@@ -57,3 +57,43 @@ public:
 	//! Run the FE model
 	virtual bool Run();
 };
+
+//-----------------------------------------------------------------------------
+// Converts the mesh of the input file to a binary mesh file (.febm). 
+// The control file argument is the name of the binary mesh file. A new input 
+// file that references the binary mesh is written next to it.
+class FEBioConvertMesh : public FECoreTask
+{
+public:
+	FEBioConvertMesh(FEModel* pfem) : FECoreTask(pfem){}
+
+	//! initialization
+	bool Init(const char* szfile);
+
+	//! write the binary mesh and new input file
+	bool Run();
+
+private:
+	std::string	m_febm;	//!< binary mesh file name
+	std::string	m_feb;	//!< new input file name
+};
+
+//-----------------------------------------------------------------------------
+// Exports a binary log data file to text. The control file argument is the
+// name of the binary file. The text file gets the same name with the
+// extension .txt and uses the layout of the text data records.
+class FEBioExportLog : public FECoreTask
+{
+public:
+	FEBioExportLog(FEModel* pfem) : FECoreTask(pfem){}
+
+	//! initialization
+	bool Init(const char* szfile);
+
+	//! write the text file
+	bool Run();
+
+private:
+	std::string	m_bin;	//!< binary data file name
+	std::string	m_txt;	//!< text file name
+};
@@ -59,6 +59,8 @@ void InitLibrary()
 {
 	REGISTER_FECORE_CLASS(FEBioStdSolver, "solve");
 	REGISTER_FECORE_CLASS(FEBioRestart, "restart");
+	REGISTER_FECORE_CLASS(FEBioConvertMesh, "convert_mesh");
+	REGISTER_FECORE_CLASS(FEBioExportLog, "export_log");
 
 	FECore::InitModule();
 	FEAMR::InitModule();
@@ -610,7 +610,8 @@ public:
 	{
 		FEMaterialPoint& mp_noconst = const_cast<FEMaterialPoint&>(mp);
 		FEMicroMaterialPoint* mmppt = mp_noconst.ExtractData<FEMicroMaterialPoint>();
-		return m_mat->AveragedStressPK1(mmppt->m_rve, mp_noconst);
+		FERVEModel& rve = m_mat->RestoreRVE(*mmppt);
+		return m_mat->AveragedStressPK1(rve, mp_noconst);
 	}
 
 private:
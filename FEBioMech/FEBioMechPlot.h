@@ -40,7 +40,7 @@ SOFTWARE.*/
 class FEPlotNodeVelocity : public FEPlotNodeData
 {
 public:
-	FEPlotNodeVelocity(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE){}
+	FEPlotNodeVelocity(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE){ SetThreadSafe(true); }
 	bool Save(FEMesh& m, FEDataStream& a);
 };
 
@@ -50,7 +50,7 @@ public:
 class FEPlotNodeAcceleration : public FEPlotNodeData
 {
 public:
-	FEPlotNodeAcceleration(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE){}
+	FEPlotNodeAcceleration(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE){ SetThreadSafe(true); }
 	bool Save(FEMesh& m, FEDataStream& a);
 };
 
@@ -59,7 +59,7 @@ public:
 class FEPlotNodeReactionForces : public FEPlotNodeData
 {
 public:
-	FEPlotNodeReactionForces(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE){}
+	FEPlotNodeReactionForces(FEModel* pfem) : FEPlotNodeData(pfem, PLT_VEC3F, FMT_NODE){ SetThreadSafe(true); }
 	bool Save(FEMesh& m, FEDataStream& a);
 };
 
@@ -263,7 +263,7 @@ public:
 class FEPlotElementVelocity : public FEPlotDomainData
 {
 public:
-    FEPlotElementVelocity(FEModel* pfem) : FEPlotDomainData(pfem, PLT_VEC3F, FMT_ITEM){}
+    FEPlotElementVelocity(FEModel* pfem) : FEPlotDomainData(pfem, PLT_VEC3F, FMT_ITEM){ SetThreadSafe(true); }
     bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -290,7 +290,7 @@ public:
 class FEPlotElementStress : public FEPlotDomainData
 {
 public:
-	FEPlotElementStress(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM){}
+	FEPlotElementStress(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM){ SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -488,7 +488,7 @@ public:
 class FEPlotRelativeVolume : public FEPlotDomainData
 {
 public:
-	FEPlotRelativeVolume(FEModel* pfem) : FEPlotDomainData(pfem, PLT_FLOAT, FMT_ITEM){}
+	FEPlotRelativeVolume(FEModel* pfem) : FEPlotDomainData(pfem, PLT_FLOAT, FMT_ITEM){ SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
@@ -804,7 +804,7 @@ public:
 class FEPlotLagrangeStrain : public FEPlotDomainData
 {
 public:
-	FEPlotLagrangeStrain(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM){}
+	FEPlotLagrangeStrain(FEModel* pfem) : FEPlotDomainData(pfem, PLT_MAT3FS, FMT_ITEM){ SetThreadSafe(true); }
 	bool Save(FEDomain& dom, FEDataStream& a);
 };
 
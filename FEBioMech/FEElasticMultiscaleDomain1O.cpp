@@ -32,6 +32,8 @@ SOFTWARE.*/
 #include "FECore/mat3d.h"
 #include "FECore/tens6d.h"
 #include <FECore/log.h>
+#include <FECore/FEException.h>
+#include <FECore/FEProfiler.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -50,10 +52,9 @@ bool FEElasticMultiscaleDomain1O::Init()
 	FEMicroMaterial* pmat = dynamic_cast<FEMicroMaterial*>(m_pMat);
 	if (m_pMat == 0) return false;
 
-	// get the parent RVE
-	FERVEModel& rve = pmat->m_mrve;
-
 	// loop over all elements
+	// Note that the material points only store the state of their RVE. The RVEs 
+	// themselves are solved in the material's workspaces.
 	for (size_t i=0; i<m_Elem.size(); ++i)
 	{
 		FESolidElement& el = m_Elem[i];
@@ -64,10 +65,7 @@ bool FEElasticMultiscaleDomain1O::Init()
 			FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 			FEMicroMaterialPoint& mmpt = *mp.ExtractData<FEMicroMaterialPoint>();
 
-			// create the material point RVEs
 			mmpt.m_F_prev = pt.m_F;	// TODO: I think I can remove this line
-			mmpt.m_rve.CopyFrom(rve);
-			if (mmpt.m_rve.Init() == false) return false;
 		}
 	}
 
@@ -85,7 +83,13 @@ bool FEElasticMultiscaleDomain1O::Init()
 			{
 				FEMaterialPoint& mp = *pel->GetMaterialPoint(ngp);
 				FEMicroMaterialPoint& mmpt = *mp.ExtractData<FEMicroMaterialPoint>();
-				FERVEProbe* prve = new FERVEProbe(fem, mmpt.m_rve, p.m_szfile.c_str());
+
+				// the probe gets its own copy of the RVE
+				FERVEModel* rve = pmat->CreateRVE();
+				if (rve == nullptr) return false;
+
+				FERVEProbe* prve = new FERVEProbe(fem, *rve, p.m_szfile.c_str());
+				prve->SetMaterialPoint(&mmpt);
 				prve->SetDebugFlag(p.m_bdebug);
 			}
 			else
@@ -103,3 +107,52 @@ bool FEElasticMultiscaleDomain1O::Init()
 
 	return true;
 }
+
+//-----------------------------------------------------------------------------
+// Update the element stresses. This solves the RVE problems of all the 
+// integration points in parallel. Since the cost of an RVE solve can vary
+// a lot between points, the elements are scheduled dynamically.
+void FEElasticMultiscaleDomain1O::Update(const FETimeInfo& tp)
+{
+	PROFILE_SCOPE("material_update");
+
+	bool berr = false;
+	bool bfail = false;
+	int NE = Elements();
+	#pragma omp parallel for shared(NE, berr, bfail) schedule(dynamic)
+	for (int i=0; i<NE; ++i)
+	{
+		// exceptions cannot leave the parallel region, so we catch
+		// them here and rethrow them after the loop
+		try
+		{
+			FESolidElement& el = Element(i);
+			if (el.isActive())
+			{
+				UpdateElementStress(i, tp);
+			}
+		}
+		catch (NegativeJacobian e)
+		{
+			#pragma omp critical
+			{
+				berr = true;
+				if (e.DoOutput()) feLogError(e.what());
+			}
+		}
+		catch (FEMultiScaleException)
+		{
+			bfail = true;
+		}
+	}
+
+	// an RVE failed to converge
+	if (bfail) throw FEMultiScaleException(-1, -1);
+
+	// if we encountered an error, we request a running restart
+	if (berr)
+	{
+		if (NegativeJacobian::DoOutput() == false) feLogError("Negative jacobian was detected.");
+		throw DoRunningRestart();
+	}
+}
@@ -42,4 +42,7 @@ public:
 
 	//! initialize class
 	bool Init();
+
+	//! update the element stresses
+	void Update(const FETimeInfo& tp) override;
 };
@@ -36,6 +36,9 @@ SOFTWARE.*/
 #include <FECore/sys.h>
 #include "FEBioMech.h"
 #include <FECore/FELinearSystem.h>
+#include <FECore/FELinearConstraintManager.h>
+#include <FECore/MatrixFreeOperator.h>
+#include <FECore/FEProfiler.h>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -176,12 +179,16 @@ void FEElasticSolidDomain::InternalForces(FEGlobalVector& R)
 			fe.assign(ndof, 0);
 
 			// calculate internal force vector
-			ElementInternalForce(el, fe);
+			{
+				PROFILE_SCOPE("element_forces");
+				ElementInternalForce(el, fe);
+			}
 
 			// get the element's LM vector
 			UnpackLM(el, lm);
 
 			// assemble element 'fe'-vector into global R vector
+			PROFILE_SCOPE("scatter");
 			R.Assemble(el.m_node, lm, fe);
 		}
 	}
@@ -312,6 +319,72 @@ void FEElasticSolidDomain::ElementGeometricalStiffness(FESolidElement &el, matri
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Adds the material stiffness of an integration point to the element matrix,
+//! given the shape function gradients G and the 'D' matrix.
+static void addMaterialStiffness(int neln, const vec3d* G, double D[6][6], double detJt, matrix& ke)
+{
+	double Gxi, Gyi, Gzi;
+	double Gxj, Gyj, Gzj;
+
+	// The 'D*BL' matrix
+	double DBL[6][3];
+
+	// we only calculate the upper triangular part
+	// since ke is symmetric. The other part is
+	// determined below using this symmetry.
+	for (int i=0, i3=0; i<neln; ++i, i3 += 3)
+	{
+		Gxi = G[i].x;
+		Gyi = G[i].y;
+		Gzi = G[i].z;
+
+		for (int j=0, j3 = 0; j<neln; ++j, j3 += 3)
+		{
+			Gxj = G[j].x;
+			Gyj = G[j].y;
+			Gzj = G[j].z;
+
+			// calculate D*BL matrices
+			DBL[0][0] = (D[0][0]*Gxj+D[0][3]*Gyj+D[0][5]*Gzj);
+			DBL[0][1] = (D[0][1]*Gyj+D[0][3]*Gxj+D[0][4]*Gzj);
+			DBL[0][2] = (D[0][2]*Gzj+D[0][4]*Gyj+D[0][5]*Gxj);
+
+			DBL[1][0] = (D[1][0]*Gxj+D[1][3]*Gyj+D[1][5]*Gzj);
+			DBL[1][1] = (D[1][1]*Gyj+D[1][3]*Gxj+D[1][4]*Gzj);
+			DBL[1][2] = (D[1][2]*Gzj+D[1][4]*Gyj+D[1][5]*Gxj);
+
+			DBL[2][0] = (D[2][0]*Gxj+D[2][3]*Gyj+D[2][5]*Gzj);
+			DBL[2][1] = (D[2][1]*Gyj+D[2][3]*Gxj+D[2][4]*Gzj);
+			DBL[2][2] = (D[2][2]*Gzj+D[2][4]*Gyj+D[2][5]*Gxj);
+
+			DBL[3][0] = (D[3][0]*Gxj+D[3][3]*Gyj+D[3][5]*Gzj);
+			DBL[3][1] = (D[3][1]*Gyj+D[3][3]*Gxj+D[3][4]*Gzj);
+			DBL[3][2] = (D[3][2]*Gzj+D[3][4]*Gyj+D[3][5]*Gxj);
+
+			DBL[4][0] = (D[4][0]*Gxj+D[4][3]*Gyj+D[4][5]*Gzj);
+			DBL[4][1] = (D[4][1]*Gyj+D[4][3]*Gxj+D[4][4]*Gzj);
+			DBL[4][2] = (D[4][2]*Gzj+D[4][4]*Gyj+D[4][5]*Gxj);
+
+			DBL[5][0] = (D[5][0]*Gxj+D[5][3]*Gyj+D[5][5]*Gzj);
+			DBL[5][1] = (D[5][1]*Gyj+D[5][3]*Gxj+D[5][4]*Gzj);
+			DBL[5][2] = (D[5][2]*Gzj+D[5][4]*Gyj+D[5][5]*Gxj);
+
+			ke[i3  ][j3  ] += (Gxi*DBL[0][0] + Gyi*DBL[3][0] + Gzi*DBL[5][0] )*detJt;
+			ke[i3  ][j3+1] += (Gxi*DBL[0][1] + Gyi*DBL[3][1] + Gzi*DBL[5][1] )*detJt;
+			ke[i3  ][j3+2] += (Gxi*DBL[0][2] + Gyi*DBL[3][2] + Gzi*DBL[5][2] )*detJt;
+
+			ke[i3+1][j3  ] += (Gyi*DBL[1][0] + Gxi*DBL[3][0] + Gzi*DBL[4][0] )*detJt;
+			ke[i3+1][j3+1] += (Gyi*DBL[1][1] + Gxi*DBL[3][1] + Gzi*DBL[4][1] )*detJt;
+			ke[i3+1][j3+2] += (Gyi*DBL[1][2] + Gxi*DBL[3][2] + Gzi*DBL[4][2] )*detJt;
+
+			ke[i3+2][j3  ] += (Gzi*DBL[2][0] + Gyi*DBL[4][0] + Gxi*DBL[5][0] )*detJt;
+			ke[i3+2][j3+1] += (Gzi*DBL[2][1] + Gyi*DBL[4][1] + Gxi*DBL[5][1] )*detJt;
+			ke[i3+2][j3+2] += (Gzi*DBL[2][2] + Gyi*DBL[4][2] + Gxi*DBL[5][2] )*detJt;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! Calculates element material stiffness element matrix
 
@@ -324,15 +397,9 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 	// global derivatives of shape functions
 	vec3d G[FEElement::MAX_NODES];
 
-	double Gxi, Gyi, Gzi;
-	double Gxj, Gyj, Gzj;
-
 	// The 'D' matrix
 	double D[6][6] = {0};	// The 'D' matrix
 
-	// The 'D*BL' matrix
-	double DBL[6][3];
-
 	// jacobian
 	double detJt;
 	
@@ -354,102 +421,226 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
         tens4dmm C = m_pMat->SolidTangent(mp);
 		C.extract(D);
 
-		// we only calculate the upper triangular part
-		// since ke is symmetric. The other part is
-		// determined below using this symmetry.
-		for (int i=0, i3=0; i<neln; ++i, i3 += 3)
+		addMaterialStiffness(neln, G, D, detJt, ke);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
+{
+	// For matrix-free solves we can cache the material tangents. Since they are
+	// stored in symmetric form, this is only done for symmetric problems.
+	MatrixFreeOperator* mfo = LS.GetMatrixFreeOperator();
+	if (mfo && mfo->CacheTangents() && LS.IsSymmetric())
+	{
+		if (mfo->IsApplying()) StiffnessProduct(LS, *mfo);
+		else CachedStiffnessMatrix(LS);
+		return;
+	}
+
+	// see if we should do an element-colored assembly
+	FEDomainAssemblyMap* amap = LS.ColoredAssemblyMap(*this, 3);
+	if (amap)
+	{
+		// Elements of the same color do not share nodes, so they can be
+		// assembled concurrently without atomic updates.
+		const FEElementColoring& colors = amap->m_colors;
+		for (int c = 0; c < colors.Colors(); ++c)
 		{
-			Gxi = G[i].x;
-			Gyi = G[i].y;
-			Gzi = G[i].z;
+			const int NC = colors.Elements(c);
+			const int* elist = colors.ElementList(c);
 
-			for (int j=0, j3 = 0; j<neln; ++j, j3 += 3)
+			#pragma omp parallel for shared (NC, elist)
+			for (int i = 0; i < NC; ++i)
 			{
-				Gxj = G[j].x;
-				Gyj = G[j].y;
-				Gzj = G[j].z;
-
-				// calculate D*BL matrices
-				DBL[0][0] = (D[0][0]*Gxj+D[0][3]*Gyj+D[0][5]*Gzj);
-				DBL[0][1] = (D[0][1]*Gyj+D[0][3]*Gxj+D[0][4]*Gzj);
-				DBL[0][2] = (D[0][2]*Gzj+D[0][4]*Gyj+D[0][5]*Gxj);
-
-				DBL[1][0] = (D[1][0]*Gxj+D[1][3]*Gyj+D[1][5]*Gzj);
-				DBL[1][1] = (D[1][1]*Gyj+D[1][3]*Gxj+D[1][4]*Gzj);
-				DBL[1][2] = (D[1][2]*Gzj+D[1][4]*Gyj+D[1][5]*Gxj);
-
-				DBL[2][0] = (D[2][0]*Gxj+D[2][3]*Gyj+D[2][5]*Gzj);
-				DBL[2][1] = (D[2][1]*Gyj+D[2][3]*Gxj+D[2][4]*Gzj);
-				DBL[2][2] = (D[2][2]*Gzj+D[2][4]*Gyj+D[2][5]*Gxj);
-
-				DBL[3][0] = (D[3][0]*Gxj+D[3][3]*Gyj+D[3][5]*Gzj);
-				DBL[3][1] = (D[3][1]*Gyj+D[3][3]*Gxj+D[3][4]*Gzj);
-				DBL[3][2] = (D[3][2]*Gzj+D[3][4]*Gyj+D[3][5]*Gxj);
-
-				DBL[4][0] = (D[4][0]*Gxj+D[4][3]*Gyj+D[4][5]*Gzj);
-				DBL[4][1] = (D[4][1]*Gyj+D[4][3]*Gxj+D[4][4]*Gzj);
-				DBL[4][2] = (D[4][2]*Gzj+D[4][4]*Gyj+D[4][5]*Gxj);
-
-				DBL[5][0] = (D[5][0]*Gxj+D[5][3]*Gyj+D[5][5]*Gzj);
-				DBL[5][1] = (D[5][1]*Gyj+D[5][3]*Gxj+D[5][4]*Gzj);
-				DBL[5][2] = (D[5][2]*Gzj+D[5][4]*Gyj+D[5][5]*Gxj);
-
-				ke[i3  ][j3  ] += (Gxi*DBL[0][0] + Gyi*DBL[3][0] + Gzi*DBL[5][0] )*detJt;
-				ke[i3  ][j3+1] += (Gxi*DBL[0][1] + Gyi*DBL[3][1] + Gzi*DBL[5][1] )*detJt;
-				ke[i3  ][j3+2] += (Gxi*DBL[0][2] + Gyi*DBL[3][2] + Gzi*DBL[5][2] )*detJt;
-
-				ke[i3+1][j3  ] += (Gyi*DBL[1][0] + Gxi*DBL[3][0] + Gzi*DBL[4][0] )*detJt;
-				ke[i3+1][j3+1] += (Gyi*DBL[1][1] + Gxi*DBL[3][1] + Gzi*DBL[4][1] )*detJt;
-				ke[i3+1][j3+2] += (Gyi*DBL[1][2] + Gxi*DBL[3][2] + Gzi*DBL[4][2] )*detJt;
-
-				ke[i3+2][j3  ] += (Gzi*DBL[2][0] + Gyi*DBL[4][0] + Gxi*DBL[5][0] )*detJt;
-				ke[i3+2][j3+1] += (Gzi*DBL[2][1] + Gyi*DBL[4][1] + Gxi*DBL[5][1] )*detJt;
-				ke[i3+2][j3+2] += (Gzi*DBL[2][2] + Gyi*DBL[4][2] + Gxi*DBL[5][2] )*detJt;
+				int iel = elist[i];
+				ElementStiffnessMatrix(LS, iel, amap->ScatterMap(iel), true);
 			}
 		}
 	}
+	else
+	{
+		// use the cached scatter maps, if available
+		amap = LS.AssemblyMap(*this, 3);
+
+		// repeat over all solid elements
+		int NE = Elements();
+	
+		#pragma omp parallel for shared (NE, amap)
+		for (int iel=0; iel<NE; ++iel)
+		{
+			ElementStiffnessMatrix(LS, iel, (amap ? amap->ScatterMap(iel) : nullptr), false);
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
-void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
+//! Calculates the stiffness matrix of an element and assembles it. If the scatter
+//! map is provided, the element matrix is assembled directly into the matrix values.
+//! The lockFree flag indicates that no other thread assembles into the same entries.
+void FEElasticSolidDomain::ElementStiffnessMatrix(FELinearSystem& LS, int iel, const int* scatterMap, bool lockFree)
 {
-	// repeat over all solid elements
-	int NE = Elements();
-	
-	#pragma omp parallel for shared (NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
-		FESolidElement& el = m_Elem[iel];
+	FESolidElement& el = m_Elem[iel];
 
-		if (el.isActive()) {
+	if (el.isActive()) {
 
-			// get the element's LM vector
-			vector<int> lm;
-			UnpackLM(el, lm);
+		// get the element's LM vector
+		vector<int> lm;
+		UnpackLM(el, lm);
 
-			// element stiffness matrix
-			FEElementMatrix ke(el, lm);
+		// element stiffness matrix
+		FEElementMatrix ke(el, lm);
+		if (scatterMap) ke.SetScatterMap(scatterMap, lockFree);
 
-			// create the element's stiffness matrix
-			int ndof = 3 * el.Nodes();
-			ke.resize(ndof, ndof);
-			ke.zero();
+		// create the element's stiffness matrix
+		int ndof = 3 * el.Nodes();
+		ke.resize(ndof, ndof);
+		ke.zero();
+
+		{
+			PROFILE_SCOPE("element_matrix");
 
 			// calculate geometrical stiffness
 			ElementGeometricalStiffness(el, ke);
 
 			// calculate material stiffness
 			ElementMaterialStiffness(el, ke);
+		}
+
+		// assemble element matrix in global stiffness matrix
+		PROFILE_SCOPE("scatter");
+		LS.Assemble(ke);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the stiffness matrix and stores the (symmetrized) material tangents
+//! at the integration points, so that StiffnessProduct can evaluate matrix-vector
+//! products without evaluating the material again.
+void FEElasticSolidDomain::CachedStiffnessMatrix(FELinearSystem& LS)
+{
+	const int NE = Elements();
+	m_tangentOffset.resize(NE + 1);
+	m_tangentOffset[0] = 0;
+	for (int i = 0; i < NE; ++i) m_tangentOffset[i + 1] = m_tangentOffset[i] + m_Elem[i].GaussPoints();
+	m_tangent.resize(m_tangentOffset[NE]);
+
+	#pragma omp parallel for shared (NE)
+	for (int iel = 0; iel < NE; ++iel)
+	{
+		FESolidElement& el = m_Elem[iel];
+		if (el.isActive() == false) continue;
+
+		vector<int> lm;
+		UnpackLM(el, lm);
+
+		FEElementMatrix ke(el, lm);
+		const int neln = el.Nodes();
+		ke.resize(3*neln, 3*neln);
+		ke.zero();
+
+		ElementGeometricalStiffness(el, ke);
+
+		vec3d G[FEElement::MAX_NODES];
+		double D[6][6];
+		const double* gw = el.GaussWeights();
+		const int nint = el.GaussPoints();
+		for (int n = 0; n < nint; ++n)
+		{
+			double detJt = ShapeGradient(el, n, G, m_alphaf)*gw[n] * m_alphaf;
+
+			FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+			tens4dmm C = m_pMat->SolidTangent(mp);
+			C.extract(D);
+
+			addMaterialStiffness(neln, G, D, detJt, ke);
+
+			// store the symmetric part of the tangent
+			for (int i = 0; i < 6; ++i)
+				for (int j = i + 1; j < 6; ++j) D[i][j] = 0.5*(D[i][j] + D[j][i]);
+			m_tangent[m_tangentOffset[iel] + n] = tens4ds(D);
+		}
+
+		LS.Assemble(ke);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Adds the product of the stiffness matrix with the input vector of the 
+//! matrix-free operator, using the tangents stored in CachedStiffnessMatrix.
+void FEElasticSolidDomain::StiffnessProduct(FELinearSystem& LS, MatrixFreeOperator& A)
+{
+	FELinearConstraintManager& LCM = GetFEModel()->GetLinearConstraintManager();
+	const bool blc = (LCM.LinearConstraints() > 0);
+	const double* x = A.InputVector();
+
+	const int NE = Elements();
+	#pragma omp parallel shared (NE)
+	{
+		vector<int> lm;
+		vector<double> ye;
+		vec3d xe[FEElement::MAX_NODES];
+		vec3d G[FEElement::MAX_NODES];
+
+		#pragma omp for
+		for (int iel = 0; iel < NE; ++iel)
+		{
+			FESolidElement& el = m_Elem[iel];
+			if (el.isActive() == false) continue;
+
+			// elements that are connected to rigid bodies or linear constraints
+			// need the element matrix for the additional assembly steps
+			const int neln = el.Nodes();
+			bool bfull = (blc && LCM.HasConstrainedNodes(el.m_node));
+			for (int i = 0; (i < neln) && (bfull == false); ++i)
+			{
+				if (m_pMesh->Node(el.m_node[i]).m_rid >= 0) bfull = true;
+			}
+			if (bfull)
+			{
+				ElementStiffnessMatrix(LS, iel, nullptr, false);
+				continue;
+			}
+
+			UnpackLM(el, lm);
+
+			// the element's part of the input vector
+			for (int i = 0; i < neln; ++i)
+			{
+				xe[i].x = (lm[3*i    ] >= 0 ? x[lm[3*i    ]] : 0.0);
+				xe[i].y = (lm[3*i + 1] >= 0 ? x[lm[3*i + 1]] : 0.0);
+				xe[i].z = (lm[3*i + 2] >= 0 ? x[lm[3*i + 2]] : 0.0);
+			}
+
+			ye.assign(3*neln, 0.0);
+			const double* gw = el.GaussWeights();
+			const tens4ds* C = &m_tangent[m_tangentOffset[iel]];
+			const int nint = el.GaussPoints();
+			for (int n = 0; n < nint; ++n)
+			{
+				double w = ShapeGradient(el, n, G, m_alphaf)*gw[n] * m_alphaf;
+
+				// gradient of the input vector
+				mat3d L; L.zero();
+				for (int i = 0; i < neln; ++i) L += (xe[i] & G[i]);
+
+				// material part: C:sym(L)
+				mat3ds t = C[n].dot(L);
+
+				// geometrical part
+				FEElasticMaterialPoint& pt = *el.GetMaterialPoint(n)->ExtractData<FEElasticMaterialPoint>();
+				const mat3ds& s = pt.m_s;
+
+				for (int i = 0; i < neln; ++i)
+				{
+					vec3d f = (t*G[i] + L*(s*G[i]))*w;
+					ye[3*i    ] += f.x;
+					ye[3*i + 1] += f.y;
+					ye[3*i + 2] += f.z;
+				}
+			}
 
-/*			// assign symmetic parts
-			// TODO: Can this be omitted by changing the Assemble routine so that it only
-			// grabs elements from the upper diagonal matrix?
-			for (int i = 0; i < ndof; ++i)
-				for (int j = i + 1; j < ndof; ++j)
-					ke[j][i] = ke[i][j];
-*/
-			// assemble element matrix in global stiffness matrix
-			LS.Assemble(ke);
+			A.AddProduct(lm, ye, 3*neln);
 		}
 	}
 }
@@ -541,6 +732,8 @@ void FEElasticSolidDomain::ElementStiffness(const FETimeInfo& tp, int iel, matri
 //-----------------------------------------------------------------------------
 void FEElasticSolidDomain::Update(const FETimeInfo& tp)
 {
+	PROFILE_SCOPE("material_update");
+
 	bool berr = false;
 	int NE = Elements();
 	#pragma omp parallel for shared(NE, berr)
@@ -32,6 +32,8 @@ SOFTWARE.*/
 #include "FESolidMaterial.h"
 #include <FECore/FEDofList.h>
 
+class MatrixFreeOperator;
+
 //-----------------------------------------------------------------------------
 //! domain described by Lagrange-type 3D volumetric elements
 //!
@@ -108,6 +110,15 @@ public:
 	//! material stiffness component
 	virtual void ElementMaterialStiffness(FESolidElement& el, matrix& ke);
 
+	//! calculates and assembles the stiffness matrix of element iel
+	void ElementStiffnessMatrix(FELinearSystem& LS, int iel, const int* scatterMap, bool lockFree);
+
+	//! calculates the stiffness matrix and caches the material tangents (for matrix-free solves)
+	void CachedStiffnessMatrix(FELinearSystem& LS);
+
+	//! adds the product of the stiffness matrix with a vector, using the cached tangents
+	void StiffnessProduct(FELinearSystem& LS, MatrixFreeOperator& A);
+
 	// --- R E S I D U A L ---
 
 	//! Calculates the internal stress vector for solid elements
@@ -132,4 +143,7 @@ protected:
 	FEDofList	m_dof;		// total dof list
 
 	FESolidMaterial*	m_pMat;
+
+	vector<tens4ds>	m_tangent;			// cached material tangents (for matrix-free solves)
+	vector<int>		m_tangentOffset;	// offset of each element into m_tangent
 };
@@ -43,17 +43,25 @@ SOFTWARE.*/
 #include <FECore/FELinearConstraintManager.h>
 #include "FEResidualVector.h"
 #include "FEBioMech.h"
+#include "FEElasticMaterial.h"
+#include "FERigidSolidDomain.h"
+#include <typeinfo>
 
 //-----------------------------------------------------------------------------
 // define the parameter list
 BEGIN_FECORE_CLASS(FEExplicitSolidSolver, FESolver)
 	ADD_PARAMETER(m_dyn_damping, "dyn_damping");
+	ADD_PARAMETER(m_auto_dt    , "auto_dt");
+	ADD_PARAMETER(m_dt_safety  , FE_RANGE_LEFT_OPEN(0.0, 1.0), "dt_safety");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
 FEExplicitSolidSolver::FEExplicitSolidSolver(FEModel* pfem) : FESolver(pfem), m_dofU(pfem), m_dofV(pfem), m_dofSQ(pfem), m_dofRQ(pfem)
 {
 	m_dyn_damping = 0.99;
+	m_auto_dt = false;
+	m_dt_safety = 0.9;
+	m_dtcrit = 0.0;
 	m_niter = 0;
 	m_nreq = 0;
 
@@ -116,25 +124,26 @@ bool FEExplicitSolidSolver::Init()
 	gather(m_Ut, mesh, m_dofSQ[2]);
 
 	// calculate the inverse mass vector for the explicit analysis
-	vector<double> dummy(m_inv_mass);
-	FEGlobalVector Mi(fem, m_inv_mass, dummy);
-	matrix ke;
-	int j, iel;
-	int nint, neln;
-	double *H, kab;
-	vector <int> lm;
-	vector <double> el_lumped_mass;
 	// Data structure to store element mass data for dynamic damping:-
 	// Define an overall dynamic array of pointers to the array that points to the element data
 	// domain_mass is a list of pointers to the data for each domain
 	domain_mass = new double ** [mesh.Domains()];
 
+	// The elements of the elastic solid domains are colored so that elements of the same
+	// color do not share nodes. This allows the explicit element loops to scatter nodal data
+	// concurrently without atomics.
+	m_colors.assign(mesh.Domains(), FEElementColoring());
+
+	// the lumped masses are first assembled and then inverted
+	zero(m_inv_mass);
 	for (int nd = 0; nd < mesh.Domains(); ++nd)
 	{
 		// check whether it is a solid domain
 		FEElasticSolidDomain* pbd = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
 		if (pbd)  // it is an elastic solid domain
 		{
+			m_colors[nd].Create(*pbd);
+
 			// for each domain define an array of pointers to the individual element_mass records
 			double ** elmasses; 
 			elmasses = new double * [pbd->Elements()];
@@ -143,70 +152,87 @@ bool FEExplicitSolidSolver::Init()
 
 			FESolidMaterial* pme = dynamic_cast<FESolidMaterial*>(pbd->GetMaterial());
 
-			for (iel=0; iel<pbd->Elements(); ++iel)
+			const FEElementColoring& colors = m_colors[nd];
+			for (int c = 0; c < colors.Colors(); ++c)
 			{
-				FESolidElement& el = pbd->Element(iel);
-				pbd->UnpackLM(el, lm);
-
-				nint = el.GaussPoints();
-				neln = el.Nodes();
-
-				ke.resize(3*neln, 3*neln);
-				ke.zero();
-				el_lumped_mass.resize(3*neln);
-				for (int i=0; i<3*neln; ++i) el_lumped_mass[i]=0.0;
-
-				// create the element mass matrix
-				for (int n=0; n<nint; ++n)
+				int NC = colors.Elements(c);
+				const int* elist = colors.ElementList(c);
+				#pragma omp parallel for shared(NC, elist)
+				for (int k = 0; k < NC; ++k)
 				{
-					FEMaterialPoint& mp = *el.GetMaterialPoint(n);
-					double d = pme->Density(mp);
-					double detJ0 = pbd->detJ0(el, n)*el.GaussWeights()[n];
+					int iel = elist[k];
+					FESolidElement& el = pbd->Element(iel);
+
+					vector<int> lm;
+					pbd->UnpackLM(el, lm);
+
+					int nint = el.GaussPoints();
+					int neln = el.Nodes();
+
+					// create the element mass matrix, reduced to a lumped mass vector
+					vector<double> el_lumped_mass(neln, 0.0);
+					for (int n=0; n<nint; ++n)
+					{
+						FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+						double d = pme->Density(mp);
+						double detJ0 = pbd->detJ0(el, n)*el.GaussWeights()[n];
+
+						double* H = el.H(n);
+						for (int i=0; i<neln; ++i)
+							for (int j=0; j<neln; ++j)
+							{
+								el_lumped_mass[i] += H[i]*H[j]*detJ0*d;
+							}
+					}
+
+					// add up the total
+					double total_mass = 0.0;
+					for (int i=0; i<neln; ++i) total_mass += el_lumped_mass[i];
+
+					// define an element mass record
+					double * thiselement;
+					thiselement = new double [neln+1];
+					// and set a pointer to the element data
+					elmasses[iel] = thiselement;
+					thiselement[0] = total_mass; // total mass of the element first, followed by the fraction at each node
+					// for each node, store the fraction of the element mass associated with it
+					for (int i=0; i<neln; ++i)
+					{
+						thiselement[i+1] = el_lumped_mass[i]/total_mass;
+					} // loop over nodes within element
 
-					H = el.H(n);
+					// assemble the lumped mass. Elements of the same color don't share nodes, so no atomics are needed.
 					for (int i=0; i<neln; ++i)
-						for (j=0; j<neln; ++j)
+					{
+						for (int j=0; j<3; ++j)
 						{
-							kab = H[i]*H[j]*detJ0*d;
-							ke[3*i  ][3*j  ] += kab;
-							ke[3*i+1][3*j+1] += kab;
-							ke[3*i+2][3*j+2] += kab;
-						}	
-				}
-				// reduce to a lumped mass vector and add up the total
-				double total_mass = 0.0;
-				for (int i=0; i<3*neln; ++i)
-				{
-						for (j=0; j<neln; ++j)
-						{
-							el_lumped_mass[i]+=ke[i][j];
+							int I = lm[3*i+j];
+							if (I >= 0) m_inv_mass[I] += el_lumped_mass[i];
 						}
-						total_mass += el_lumped_mass[i];
-				}	
-				total_mass /= 3.0; // because each mass is represented three times for each direction
-				// define an element mass record
-				double * thiselement;
-				thiselement = new double [neln+1];
-				// and set a pointer to the element data
-				elmasses[iel] = thiselement;
-				thiselement[0] = total_mass; // total mass of the element first, followed by the fraction at each node
-				// for each node, store the fraction of the element mass associated with it
-				for (int i=0; i<neln; ++i)
-				{
-					thiselement[i+1] = (el_lumped_mass[3*i]+el_lumped_mass[3*i+1]+el_lumped_mass[3*i+2])/(3*total_mass);
-				} // loop over nodes within element
-				// invert and assemble element matrix into inv_mass vector 
-				for (int i=0; i<3*neln; ++i)
-				{
-					el_lumped_mass[i] = 1.0/el_lumped_mass[i];
-				}
-				Mi.Assemble(el.m_node, lm, el_lumped_mass);
-				// formerly AssembleResidual(el.m_node, lm, el_lumped_mass, m_inv_mass);
-			} // loop over elements
+					}
+				} // loop over elements
+			} // loop over colors
 		} // was an elastic solid domain
 		else domain_mass[nd] = 0;  // no masses stored for other types of domain
 	}
 
+	// invert the lumped mass
+	for (int i=0; i<neq; ++i)
+	{
+		m_inv_mass[i] = (m_inv_mass[i] > 0.0 ? 1.0 / m_inv_mass[i] : 1.0);
+	}
+
+	// estimate the critical time step
+	m_dtcrit = StableTimeStep();
+	if (m_dtcrit > 0.0) feLog("\tEstimated stable time step ............... : %lg\n", m_dtcrit);
+
+	FEAnalysis* step = fem.GetCurrentStep();
+	if (m_auto_dt) step->m_dt = StableStepSize(fem.GetCurrentTime());
+	else if ((m_dtcrit > 0.0) && (step->m_dt > m_dtcrit))
+	{
+		feLogWarning("The time step size (%lg) exceeds the estimated stable time step (%lg).", step->m_dt, m_dtcrit);
+	}
+
 	// Calculate initial residual to be used on the first time step
 	if (Residual(m_R1) == false) return false;
 	m_R1 += m_Fd;
@@ -214,6 +240,32 @@ bool FEExplicitSolidSolver::Init()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! When the time step is set automatically, the time increment that was chosen
+//! by the analysis step is replaced by the stable time step before the step is solved.
+bool FEExplicitSolidSolver::InitStep(double time)
+{
+	FEModel& fem = *GetFEModel();
+
+	// the stable time step is not stored on restart, so it may need to be re-estimated
+	if (m_auto_dt && (m_dtcrit <= 0.0)) m_dtcrit = StableTimeStep();
+
+	if (m_auto_dt && (m_dtcrit > 0.0))
+	{
+		FETimeInfo& tp = fem.GetTime();
+		double t0 = tp.currentTime - tp.timeIncrement;
+		double dt = StableStepSize(t0);
+		if (dt != tp.timeIncrement)
+		{
+			fem.GetCurrentStep()->m_dt = dt;
+			tp.timeIncrement = dt;
+			tp.currentTime = time = t0 + dt;
+		}
+	}
+
+	return FESolver::InitStep(time);
+}
+
 //-----------------------------------------------------------------------------
 //! Updates the current state of the model
 void FEExplicitSolidSolver::Update(vector<double>& ui)
@@ -610,13 +662,9 @@ bool FEExplicitSolidSolver::DoSolve()
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
 	int N = mesh.Nodes(); // this is the total number of nodes in the mesh
-	int j,iel;
     double dt = fem.GetTime().timeIncrement;
-	double avx = 0.0;  // average element velocity in each direction
-	double avy = 0.0;
-	double avz = 0.0;
-	double mass_at_node;
 
+	#pragma omp parallel for
 	for (i=0; i<N; ++i) // zero the new acceleration vector ready to add in the damping components
 	{
 		FENode& node = mesh.Node(i);
@@ -631,50 +679,59 @@ bool FEExplicitSolidSolver::DoSolve()
 		if (pbd)  // it is an elastic solid domain
 		{
 			double ** emass = domain_mass[nd]; // array of pointers to the element mass records for this domain
-			for (iel=0; iel<pbd->Elements(); ++iel)
-			{
-				FESolidElement& el = pbd->Element(iel);
 
-				// zero the three average velocity components
-				avx = 0.0;
-				avy = 0.0;
-				avz = 0.0;
-
-				// will use previously calculated element mass data for weighted averaging of velocities
-
-				// loop over each element to find the average velocity
-				// then calculate the weighted velocity change for each node
-				// add each velocity change into node.m_vt
-				double * this_element = emass[iel]; // pointer to the array of fractional nodal masses for this element
-				for (j=0; j<el.Nodes(); j++) // loop over each node in the element
-				{
-					FENode& node = mesh.Node(el.m_node[j]);  // get the node 
-					avx += node.m_vp.x*this_element[j+1];  // add each of the three components to the averages
-					avy += node.m_vp.y*this_element[j+1];  // weighted by the fractional mass of the node
-					avz += node.m_vp.z*this_element[j+1];  // remembering that this_element[0] is the total mass
-				}
-				for (j=0; j<el.Nodes(); j++) // loop over each node in the element again
-				// and calculate and add in the velocity change contribution to each dof
+			// elements of the same color don't share nodes, so they can update the nodal accelerations concurrently
+			const FEElementColoring& colors = m_colors[nd];
+			for (int c = 0; c < colors.Colors(); ++c)
+			{
+				int NC = colors.Elements(c);
+				const int* elist = colors.ElementList(c);
+				#pragma omp parallel for shared(NC, elist)
+				for (int k = 0; k < NC; ++k)
 				{
-					FENode& node = mesh.Node(el.m_node[j]);  // get the node 
-					//	need to find node.m_vt.x += (avx-node.m_vp.x)*dt*m_dyn_damping*element_mass_at_node/total_mass at node;
-					// should be t* = dt/(h/c) not dt
-					// put this into the accelerations as (avx-node.m_vp.x)*m_dyn_damping*element_mass_at_node
-					// then it will be multiplied by dt and divided by m_inv_mass later 
-					mass_at_node = this_element[j+1]*this_element[0];
-					node.m_at.x += (avx-node.m_vp.x)*mass_at_node*m_dyn_damping;
-					node.m_at.y += (avy-node.m_vp.y)*mass_at_node*m_dyn_damping;
-					node.m_at.z += (avz-node.m_vp.z)*mass_at_node*m_dyn_damping;
-				}
-			}  // loop over elements
+					FESolidElement& el = pbd->Element(elist[k]);
+
+					// zero the three average velocity components
+					double avx = 0.0;
+					double avy = 0.0;
+					double avz = 0.0;
+
+					// will use previously calculated element mass data for weighted averaging of velocities
+
+					// loop over each element to find the average velocity
+					// then calculate the weighted velocity change for each node
+					// add each velocity change into node.m_vt
+					double * this_element = emass[elist[k]]; // pointer to the array of fractional nodal masses for this element
+					for (int j=0; j<el.Nodes(); j++) // loop over each node in the element
+					{
+						FENode& node = mesh.Node(el.m_node[j]);  // get the node 
+						avx += node.m_vp.x*this_element[j+1];  // add each of the three components to the averages
+						avy += node.m_vp.y*this_element[j+1];  // weighted by the fractional mass of the node
+						avz += node.m_vp.z*this_element[j+1];  // remembering that this_element[0] is the total mass
+					}
+					for (int j=0; j<el.Nodes(); j++) // loop over each node in the element again
+					// and calculate and add in the velocity change contribution to each dof
+					{
+						FENode& node = mesh.Node(el.m_node[j]);  // get the node 
+						//	need to find node.m_vt.x += (avx-node.m_vp.x)*dt*m_dyn_damping*element_mass_at_node/total_mass at node;
+						// should be t* = dt/(h/c) not dt
+						// put this into the accelerations as (avx-node.m_vp.x)*m_dyn_damping*element_mass_at_node
+						// then it will be multiplied by dt and divided by m_inv_mass later 
+						double mass_at_node = this_element[j+1]*this_element[0];
+						node.m_at.x += (avx-node.m_vp.x)*mass_at_node*m_dyn_damping;
+						node.m_at.y += (avy-node.m_vp.y)*mass_at_node*m_dyn_damping;
+						node.m_at.z += (avz-node.m_vp.z)*mass_at_node*m_dyn_damping;
+					}
+				}  // loop over elements
+			}  // loop over colors
 		}  // if (pbd)
 	}  // loop over domains
 
+	#pragma omp parallel for private(n)
 	for (i=0; i<N; ++i)
 	{
 		FENode& node = mesh.Node(i);
 		//  calculate acceleration using F=ma and update - note m_inv_mass is 1/m so multiply not divide
-		n=(int)m_R1[0];
 		if ((n = node.m_ID[m_dofU[0]]) >= 0) node.m_at.x = (node.m_at.x+m_R1[n])*m_inv_mass[n];
 		if ((n = node.m_ID[m_dofU[1]]) >= 0) node.m_at.y = (node.m_at.y+m_R1[n])*m_inv_mass[n];
 		if ((n = node.m_ID[m_dofU[2]]) >= 0) node.m_at.z = (node.m_at.z+m_R1[n])*m_inv_mass[n];
@@ -695,6 +752,13 @@ bool FEExplicitSolidSolver::DoSolve()
 	// calculate new residual at this point - which will be used on the next step to find the acceleration
 	Residual(m_R1);
 
+	// update the stable time step for the deformed mesh
+	if (m_auto_dt)
+	{
+		m_dtcrit = StableTimeStep();
+		pstep->m_dt = StableStepSize(fem.GetCurrentTime());
+	}
+
 	// update total displacements
 	int neq = (int)m_Ui.size();
 	for (i=0; i<neq; ++i) m_Ui[i] += m_ui[i];
@@ -748,8 +812,18 @@ bool FEExplicitSolidSolver::Residual(vector<double>& R)
 	// calculate the internal (stress) forces
 	for (i=0; i<mesh.Domains(); ++i)
 	{
-		FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-		dom.InternalForces(RHS);
+		// Only plain elastic solid domains use the colored loop. Derived domains
+		// (e.g. UDG hexes, UT4 tets, rigid domains) have their own force routines.
+		FEDomain& dom = mesh.Domain(i);
+		if (typeid(dom) == typeid(FEElasticSolidDomain))
+		{
+			InternalForces(static_cast<FEElasticSolidDomain&>(dom), m_colors[i], R);
+		}
+		else
+		{
+			FEElasticDomain& edom = dynamic_cast<FEElasticDomain&>(dom);
+			edom.InternalForces(RHS);
+		}
 	}
 
 	// calculate the body forces
@@ -812,6 +886,175 @@ bool FEExplicitSolidSolver::Residual(vector<double>& R)
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Calculates the internal forces of an elastic solid domain. The elements are 
+//! processed one color at a time, so that the element forces can be added to the 
+//! residual without atomics.
+void FEExplicitSolidSolver::InternalForces(FEElasticSolidDomain& dom, const FEElementColoring& colors, vector<double>& R)
+{
+	for (int c = 0; c < colors.Colors(); ++c)
+	{
+		int NC = colors.Elements(c);
+		const int* elist = colors.ElementList(c);
+		#pragma omp parallel for shared(NC, elist)
+		for (int k = 0; k < NC; ++k)
+		{
+			FESolidElement& el = dom.Element(elist[k]);
+			if (el.isActive() == false) continue;
+
+			// calculate the element force vector
+			vector<double> fe(3 * el.Nodes(), 0.0);
+			dom.ElementInternalForce(el, fe);
+
+			// get the element's LM vector
+			vector<int> lm;
+			dom.UnpackLM(el, lm);
+
+			// assemble into the residual and the reaction forces
+			int ndof = (int)fe.size();
+			for (int i = 0; i < ndof; ++i)
+			{
+				int I = lm[i];
+				if (I >= 0) R[I] += fe[i];
+				else if (-I - 2 >= 0) m_Fr[-I - 2] -= fe[i];
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Estimates the critical time step of the current configuration. This is the 
+//! smallest time a dilatational wave needs to cross an element. Returns zero
+//! if the model has no elastic solid domains.
+double FEExplicitSolidSolver::StableTimeStep()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+
+	double dtmin = 0.0;
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		// rigid elements don't limit the time step
+		FEElasticSolidDomain* pbd = dynamic_cast<FEElasticSolidDomain*>(&mesh.Domain(nd));
+		if ((pbd == nullptr) || dynamic_cast<FERigidSolidDomain*>(pbd)) continue;
+
+		int NE = pbd->Elements();
+		#pragma omp parallel shared(NE, dtmin)
+		{
+			double dtl = 0.0;
+			#pragma omp for nowait
+			for (int i = 0; i < NE; ++i)
+			{
+				FESolidElement& el = pbd->Element(i);
+				if (el.isActive() == false) continue;
+
+				double dte = ElementStableTimeStep(*pbd, el);
+				if ((dte > 0.0) && ((dtl == 0.0) || (dte < dtl))) dtl = dte;
+			}
+
+			#pragma omp critical
+			{
+				if ((dtl > 0.0) && ((dtmin == 0.0) || (dtl < dtmin))) dtmin = dtl;
+			}
+		}
+	}
+
+	return dtmin;
+}
+
+//-----------------------------------------------------------------------------
+//! Calculates the critical time step of an element as the ratio of its 
+//! characteristic length and the dilatational wave speed. The characteristic length is
+//! the element's volume divided by its largest face area (the smallest height for
+//! tetrahedral elements), and is halved for higher order elements. The wave speed is
+//! evaluated from the spatial tangent and current density at the integration points.
+double FEExplicitSolidSolver::ElementStableTimeStep(FEElasticSolidDomain& dom, FESolidElement& el)
+{
+	FEMesh& mesh = *dom.GetMesh();
+	FESolidMaterial* pme = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
+	if (pme == nullptr) return 0.0;
+
+	// current volume and largest wave speed
+	double Ve = 0.0, c2max = 0.0;
+	int nint = el.GaussPoints();
+	double* gw = el.GaussWeights();
+	for (int n = 0; n < nint; ++n)
+	{
+		Ve += dom.detJt(el, n)*gw[n];
+
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+		double rho = pme->Density(mp) / pt.m_J;
+		if (rho <= 0.0) continue;
+
+		// the P-wave modulus is bounded by the largest normal component of the tangent
+		tens4ds C = pme->Tangent(mp);
+		double M = C(0, 0);
+		if (C(1, 1) > M) M = C(1, 1);
+		if (C(2, 2) > M) M = C(2, 2);
+
+		double c2 = M / rho;
+		if (c2 > c2max) c2max = c2;
+	}
+	if ((c2max <= 0.0) || (Ve <= 0.0)) return 0.0;
+
+	// largest face area, evaluated from the face's corner nodes
+	double Amax = 0.0;
+	int nf[FEElement::MAX_NODES];
+	for (int i = 0; i < el.Faces(); ++i)
+	{
+		int nn = el.GetFace(i, nf);
+		vec3d r0 = mesh.Node(nf[0]).m_rt;
+		vec3d r1 = mesh.Node(nf[1]).m_rt;
+		vec3d r2 = mesh.Node(nf[2]).m_rt;
+		double A = 0.0;
+		if ((nn == 3) || (nn == 6) || (nn == 7)) A = 0.5*((r1 - r0) ^ (r2 - r0)).norm();
+		else
+		{
+			vec3d r3 = mesh.Node(nf[3]).m_rt;
+			A = 0.5*((r2 - r0) ^ (r3 - r1)).norm();
+		}
+		if (A > Amax) Amax = A;
+	}
+	if (Amax <= 0.0) return 0.0;
+
+	double L = Ve / Amax;
+	switch (el.Shape())
+	{
+	case ET_TET4:
+	case ET_TET5:
+		L *= 3.0;
+		break;
+	case ET_TET10:
+	case ET_TET15:
+	case ET_TET20:
+		L *= 1.5;
+		break;
+	case ET_HEX20:
+	case ET_HEX27:
+	case ET_PENTA15:
+		L *= 0.5;
+		break;
+	default:
+		break;
+	}
+
+	return L / sqrt(c2max);
+}
+
+//-----------------------------------------------------------------------------
+//! Returns the time step size for a time step that starts at time t0 when the 
+//! time step is set automatically. This is the scaled stable time step, but the 
+//! step is not allowed to go past the end of the analysis step.
+double FEExplicitSolidSolver::StableStepSize(double t0)
+{
+	FEAnalysis* step = GetFEModel()->GetCurrentStep();
+	if (m_dtcrit <= 0.0) return step->m_dt;
+
+	double dt = m_dt_safety*m_dtcrit;
+	if (t0 + dt > step->m_tend) dt = step->m_tend - t0;
+	return dt;
+}
+
 //-----------------------------------------------------------------------------
 //! Calculates the contact forces
 void FEExplicitSolidSolver::ContactForces(FEGlobalVector& R)
@@ -31,6 +31,10 @@ SOFTWARE.*/
 #include "FECore/FEGlobalVector.h"
 #include <FECore/FETimeInfo.h>
 #include <FECore/FEDofList.h>
+#include <FECore/FEElementColoring.h>
+
+class FEElasticSolidDomain;
+class FESolidElement;
 
 //-----------------------------------------------------------------------------
 //! This class implements a nonlinear explicit solver for solid mechanics
@@ -54,6 +58,9 @@ public:
 	//! Solve an analysis step
 	bool SolveStep() override;
 
+	//! Initialize a time step
+	bool InitStep(double time) override;
+
 	//! Update data
 	void Update(vector<double>& ui) override;
 
@@ -85,8 +92,23 @@ public:
 	
 	void ContactForces(FEGlobalVector& R);
 
+	//! internal forces of an elastic solid domain
+	void InternalForces(FEElasticSolidDomain& dom, const FEElementColoring& colors, vector<double>& R);
+
+	//! estimate the critical time step of the current configuration
+	double StableTimeStep();
+
+	//! critical time step of an element
+	double ElementStableTimeStep(FEElasticSolidDomain& dom, FESolidElement& el);
+
+	//! time step size when the time step is set automatically
+	double StableStepSize(double t0);
+
 public:
 	double		m_dyn_damping;	//!< velocity damping for the explicit solver
+	bool		m_auto_dt;		//!< set the time step to the (scaled) stable time step
+	double		m_dt_safety;	//!< scale factor applied to the stable time step
+	double		m_dtcrit;		//!< estimated critical time step of the current configuration
 
 public:
 	// equation numbers
@@ -105,6 +127,8 @@ public:
 	vector<double> m_R1;	//!< residual at iteration i
 	double *** domain_mass;	//! Pointer to data structure for nodal masses, dynamically allocated during initiation
 
+	vector<FEElementColoring>	m_colors;	//!< element coloring of the elastic solid domains
+
 protected:
 	FEDofList	m_dofU, m_dofV, m_dofSQ, m_dofRQ;
 
@@ -39,11 +39,14 @@ SOFTWARE.*/
 #include "FEBioPlot/FEBioPlotFile.h"
 #include <FECore/mat6d.h>
 #include "FEBCPrescribedDeformation.h"
+#include <FECore/sys.h>
 #include <sstream>
 
 //=============================================================================
 FERVEProbe::FERVEProbe(FEModel& fem, FEModel& rve, const char* szfile) : FECallBack(&fem, CB_ALWAYS), m_rve(rve), m_file(szfile) 
 {
+	m_xplt = 0;
+	m_mmpt = 0;
 	m_bdebug = false;
 }
 
@@ -81,7 +84,17 @@ bool FERVEProbe::Execute(FEModel& fem, int nwhen)
 
 void FERVEProbe::Save()
 {
-	if (m_xplt) m_xplt->Write(m_rve, (float) m_rve.GetCurrentTime());
+	if (m_xplt == 0) return;
+
+	// get the current state of the material point's RVE
+	if (m_mmpt && (m_mmpt->m_rve.IsEmpty() == false))
+	{
+		FERVEModel* rve = dynamic_cast<FERVEModel*>(&m_rve);
+		assert(rve);
+		rve->RestoreState(m_mmpt->m_rve);
+	}
+
+	m_xplt->Write(m_rve, (float) m_rve.GetCurrentTime());
 }
 
 //=============================================================================
@@ -125,12 +138,8 @@ FEMaterialPoint* FEMicroMaterialPoint::Copy()
 void FEMicroMaterialPoint::Serialize(DumpStream& ar)
 {
 	FEMaterialPoint::Serialize(ar);
-	if (ar.IsSaving())
-	{
-	}
-	else
-	{
-	}
+	ar & m_F_prev;
+	ar & m_rve;
 }
 
 //=============================================================================
@@ -178,11 +187,14 @@ FEMicroMaterial::FEMicroMaterial(FEModel* pfem) : FEElasticMaterial(pfem)
 	m_szbc[0] = 0;
 	m_bctype = FERVEModel::DISPLACEMENT;	// use displacement BCs by default
 	m_scale = 1.0;
+	m_nws = 0;
 }
 
 //-----------------------------------------------------------------------------
 FEMicroMaterial::~FEMicroMaterial(void)
 {
+	for (size_t i = 0; i < m_rve.size(); ++i) delete m_rve[i];
+	m_rve.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -221,9 +233,53 @@ bool FEMicroMaterial::Init()
 		feLogError("An error occurred preparing RVE model"); return false;
 	}
 
+	// Create the RVE workspaces, one for each thread. The material points only store 
+	// the state of their RVE, which is restored into the workspace of the thread that
+	// evaluates the point. This way the RVEs can be solved in parallel.
+	if (m_rve.empty())
+	{
+		m_nws = omp_get_max_threads();
+		for (int i = 0; i < m_nws; ++i)
+		{
+			if (CreateRVE() == nullptr) {
+				feLogError("An error occurred initializing RVE model"); return false;
+			}
+		}
+
+		// this is the state of RVEs that have not been solved yet
+		m_rve[0]->SaveState(m_rve0);
+	}
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// create a copy of the parent RVE, owned by this material
+FERVEModel* FEMicroMaterial::CreateRVE()
+{
+	FERVEModel* rve = new FERVEModel;
+	rve->CopyFrom(m_mrve);
+	rve->BlockLog();
+	if (rve->Init() == false)
+	{
+		delete rve;
+		return nullptr;
+	}
+	m_rve.push_back(rve);
+	return rve;
+}
+
+//-----------------------------------------------------------------------------
+// Restore the RVE state of a material point into the RVE workspace of the calling thread.
+FERVEModel& FEMicroMaterial::RestoreRVE(FEMicroMaterialPoint& mmpt)
+{
+	int n = omp_get_thread_num();
+	assert(n < m_nws);
+	FERVEModel& rve = *m_rve[n];
+	rve.RestoreState(mmpt.m_rve.IsEmpty() ? m_rve0 : mmpt.m_rve);
+	return rve;
+}
+
 //-----------------------------------------------------------------------------
 // Note that this function is not used in the first-order implemenetation
 mat3ds FEMicroMaterial::Stress(FEMaterialPoint &mp)
@@ -232,33 +288,40 @@ mat3ds FEMicroMaterial::Stress(FEMaterialPoint &mp)
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 	FEMicroMaterialPoint& mmpt = *mp.ExtractData<FEMicroMaterialPoint>();
 	mat3d F = pt.m_F;
+
+	// get the RVE of this point
+	FERVEModel& rve = RestoreRVE(mmpt);
 	
 	// update the BC's
-	mmpt.m_rve.Update(F);
+	rve.Update(F);
 
 	// solve the RVE
-	bool bret = mmpt.m_rve.Solve();
+	bool bret = rve.Solve();
 
 	// make sure it converged
 	if (bret == false) throw FEMultiScaleException(-1, -1);
 
 	// calculate the averaged Cauchy stress
-	mat3ds sa = mmpt.m_rve.StressAverage(mp);
+	mat3ds sa = rve.StressAverage(mp);
 	
 	// calculate the difference between the macro and micro energy for Hill-Mandel condition
-	mmpt.m_micro_energy = micro_energy(mmpt.m_rve);	
+	mmpt.m_micro_energy = micro_energy(rve);
+
+	// store the new RVE state
+	rve.SaveState(mmpt.m_rve);
 	
 	return sa;
 }
 
 //-----------------------------------------------------------------------------
-// The stiffness is evaluated at the same time the stress is evaluated so we 
-// can just return it here. Note that this assumes that the stress function 
-// is always called prior to the tangent function.
+// The stiffness is evaluated from the RVE state that was stored when the stress
+// was evaluated. Note that this assumes that the stress function is always 
+// called prior to the tangent function.
 tens4ds FEMicroMaterial::Tangent(FEMaterialPoint &mp)
 {
 	FEMicroMaterialPoint& mmpt = *mp.ExtractData<FEMicroMaterialPoint>();
-	return mmpt.m_rve.StiffnessAverage(mp);
+	FERVEModel& rve = RestoreRVE(mmpt);
+	return rve.StiffnessAverage(mp);
 }
 
 //-----------------------------------------------------------------------------
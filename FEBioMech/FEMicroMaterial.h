@@ -36,6 +36,7 @@ SOFTWARE.*/
 
 //-----------------------------------------------------------------------------
 class FEBioPlotFile;
+class FEMicroMaterialPoint;
 
 //-----------------------------------------------------------------------------
 class FERVEProbe : public FECallBack
@@ -52,8 +53,13 @@ public:
 	void SetDebugFlag(bool b) { m_bdebug = b; }
 	bool GetDebugFlag() const { return m_bdebug; }
 
+	// Track the RVE state of a material point. The RVE model is then only used
+	// to restore the point's state into before it is written.
+	void SetMaterialPoint(FEMicroMaterialPoint* pt) { m_mmpt = pt; }
+
 private:
 	FEModel&			m_rve;		//!< The RVE model to keep track of
+	FEMicroMaterialPoint*	m_mmpt;	//!< the material point whose RVE state is tracked (or null)
 	FEBioPlotFile*		m_xplt;		//!< the actual plot file
 	std::string			m_file;		//!< file name
 	bool				m_bdebug;
@@ -90,7 +96,7 @@ public:
 	double	   m_macro_energy_inc;	// Macroscopic strain energy increment
 	double	   m_micro_energy_inc;	// Microscopic strain energy increment
 
-	FERVEModel	m_rve;				// Local copy of the parent rve
+	FERVEState	m_rve;				// State of the RVE at this point (empty until it is first solved)
 };
 
 //-----------------------------------------------------------------------------
@@ -154,6 +160,12 @@ public:
 	// average RVE energy
 	double micro_energy(FEModel& rve);
 
+	// Restore the RVE state of a material point into the RVE workspace of the calling thread.
+	FERVEModel& RestoreRVE(FEMicroMaterialPoint& mmpt);
+
+	// create a copy of the parent RVE, owned by this material
+	FERVEModel* CreateRVE();
+
 public:
 	int Probes() { return (int) m_probe.size(); }
 	FEMicroProbe& Probe(int i) { return *m_probe[i]; }
@@ -161,6 +173,10 @@ public:
 protected:
 	std::vector<FEMicroProbe*>	m_probe;
 
+	std::vector<FERVEModel*>	m_rve;		//!< RVE copies (the first ones are the per-thread workspaces)
+	int							m_nws;		//!< number of workspaces
+	FERVEState					m_rve0;		//!< initial RVE state
+
 public:
 	// declare the parameter list
 	DECLARE_FECORE_CLASS();
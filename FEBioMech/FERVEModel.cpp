@@ -43,7 +43,7 @@ SOFTWARE.*/
 #include <FECore/FECoreKernel.h>
 
 //-----------------------------------------------------------------------------
-FERVEModel::FERVEModel()
+FERVEModel::FERVEModel() : m_ar(*this)
 {
 	m_bctype = DISPLACEMENT;
 }
@@ -67,6 +67,115 @@ void FERVEModel::CopyFrom(FERVEModel& rve)
 	m_BN = rve.m_BN;
 }
 
+//-----------------------------------------------------------------------------
+size_t FERVEState::Size() const
+{
+	return (m_node.size() + m_Fr.size())*sizeof(double) + m_dom.size() + m_model.size();
+}
+
+//-----------------------------------------------------------------------------
+// The buffers are streamed as raw data, since they can be large.
+template <typename T> static void serialize_buffer(DumpStream& ar, std::vector<T>& v)
+{
+	if (ar.IsSaving())
+	{
+		int n = (int)v.size();
+		ar << n;
+		if (n > 0) ar.write(v.data(), sizeof(T), n);
+	}
+	else
+	{
+		int n = 0;
+		ar >> n;
+		v.resize(n);
+		if (n > 0) ar.read(v.data(), sizeof(T), n);
+	}
+}
+
+void FERVEState::Serialize(DumpStream& ar)
+{
+	ar & m_tstart;
+	serialize_buffer(ar, m_node);
+	serialize_buffer(ar, m_Fr);
+	serialize_buffer(ar, m_dom);
+	serialize_buffer(ar, m_model);
+}
+
+//-----------------------------------------------------------------------------
+// store the current state of the RVE
+void FERVEModel::SaveState(FERVEState& s)
+{
+	FEMesh& mesh = GetMesh();
+
+	// the start time is not part of the streamed model state
+	s.m_tstart = GetStartTime();
+
+	// nodal state
+	const int NN = mesh.Nodes();
+	size_t nsize = 0;
+	for (int i = 0; i < NN; ++i) nsize += mesh.Node(i).StateSize();
+	s.m_node.resize(nsize);
+
+	double* pd = s.m_node.data();
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		node.SaveState(pd);
+		pd += node.StateSize();
+	}
+
+	// the reaction forces are needed for the averaged PK1 stress
+	FEAnalysis* pstep = GetCurrentStep();
+	FESolidSolver2* ps = (pstep ? dynamic_cast<FESolidSolver2*>(pstep->GetFESolver()) : nullptr);
+	if (ps) s.m_Fr = ps->m_Fr; else s.m_Fr.clear();
+
+	// domain state
+	m_ar.Open(true, true);
+	for (int i = 0; i < mesh.Domains(); ++i) mesh.Domain(i).Serialize(m_ar);
+	s.m_dom.assign(m_ar.data(), m_ar.data() + m_ar.tell());
+
+	// everything else
+	m_ar.Open(true, true);
+	SerializeNonMeshState(m_ar);
+	s.m_model.assign(m_ar.data(), m_ar.data() + m_ar.tell());
+}
+
+//-----------------------------------------------------------------------------
+// restore the RVE to a previously saved state
+void FERVEModel::RestoreState(const FERVEState& s)
+{
+	FEMesh& mesh = GetMesh();
+
+	SetStartTime(s.m_tstart);
+
+	// nodal state
+	const double* pd = s.m_node.data();
+	const int NN = mesh.Nodes();
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		node.RestoreState(pd);
+		pd += node.StateSize();
+	}
+
+	// domain state
+	m_ar.Open(true, true);
+	m_ar.write(s.m_dom.data(), sizeof(char), s.m_dom.size());
+	m_ar.Open(false, true);
+	for (int i = 0; i < mesh.Domains(); ++i) mesh.Domain(i).Serialize(m_ar);
+
+	// everything else
+	m_ar.Open(true, true);
+	m_ar.write(s.m_model.data(), sizeof(char), s.m_model.size());
+	m_ar.Open(false, true);
+	SerializeNonMeshState(m_ar);
+
+	// reaction forces (this must be done last, since the solver resets them)
+	FEAnalysis* pstep = GetCurrentStep();
+	FESolidSolver2* ps = (pstep ? dynamic_cast<FESolidSolver2*>(pstep->GetFESolver()) : nullptr);
+	if (ps && (ps->m_Fr.size() == s.m_Fr.size())) ps->m_Fr = s.m_Fr;
+}
+
 //-----------------------------------------------------------------------------
 //! Initializes the RVE model and evaluates some useful quantities.
 bool FERVEModel::InitRVE(int rveType, const char* szbc)
@@ -29,9 +29,35 @@ SOFTWARE.*/
 #pragma once
 #include "FECore/FEModel.h"
 #include <FECore/tens4d.h>
+#include <FECore/DumpMemStream.h>
 
 class FEBCPrescribedDeformation;
 
+//-----------------------------------------------------------------------------
+// The state of an RVE model, i.e. the data that changes when the RVE is solved.
+// This allows many material points to share a single RVE model: the state of a
+// point is restored into the model before it is solved and saved afterwards.
+class FERVEState
+{
+public:
+	FERVEState() : m_tstart(0.0) {}
+
+	//! an empty state is the initial state of the RVE
+	bool IsEmpty() const { return m_model.empty(); }
+
+	//! size of the state data (in bytes)
+	size_t Size() const;
+
+	void Serialize(DumpStream& ar);
+
+public:
+	double				m_tstart;	//!< start time of the next solve
+	std::vector<double>	m_node;		//!< nodal state
+	std::vector<double>	m_Fr;		//!< reaction forces (not streamed by the solver)
+	std::vector<char>	m_dom;		//!< domain (i.e. material point) state
+	std::vector<char>	m_model;	//!< the remaining model state (time, step and solver data, ...)
+};
+
 //-----------------------------------------------------------------------------
 // Class describing the RVE model.
 // This is used by the homogenization code.
@@ -70,6 +96,12 @@ public:
 	// copy from the parent RVE
 	void CopyFrom(FERVEModel& rve);
 
+	//! store the current state of the RVE
+	void SaveState(FERVEState& s);
+
+	//! restore the RVE to a previously saved state
+	void RestoreState(const FERVEState& s);
+
 	//! Calculate the stress average
 	mat3ds StressAverage(FEMaterialPoint& mp);
 
@@ -95,4 +127,5 @@ private:
 	int				m_bctype;			//!< RVE type
 	FEBoundingBox	m_bb;				//!< bounding box of mesh
 	vector<int>		m_BN;				//!< boundary node flags
+	DumpMemStream	m_ar;				//!< stream for saving and restoring the state
 };
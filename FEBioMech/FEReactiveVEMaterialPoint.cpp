@@ -75,6 +75,7 @@ void FEReactiveVEMaterialPoint::Update(const FETimeInfo& timeInfo)
 			double w = m_pRve->ReformingBondMassFraction(*this);
 			m_w.push_back(w);
 		}
+		m_pRve->CompactGenerations(*this);
 	}
 	else {
 		if (m_pRuc->NewGeneration(*this)) {
@@ -84,12 +85,23 @@ void FEReactiveVEMaterialPoint::Update(const FETimeInfo& timeInfo)
 			double w = m_pRuc->ReformingBondMassFraction(*this);
 			m_w.push_back(w);
 		}
+		m_pRuc->CompactGenerations(*this);
 	}
     
     // don't forget to initialize the base class
     FEMaterialPoint::Update(timeInfo);
 }
 
+//-----------------------------------------------------------------------------
+//! Remove generation ig from the generation data
+void FEReactiveVEMaterialPoint::RemoveGeneration(int ig)
+{
+	m_Fi.erase(m_Fi.begin() + ig);
+	m_Ji.erase(m_Ji.begin() + ig);
+	m_v.erase(m_v.begin() + ig);
+	m_w.erase(m_w.begin() + ig);
+}
+
 //-----------------------------------------------------------------------------
 //! Serialize data to the archive
 void FEReactiveVEMaterialPoint::Serialize(DumpStream& ar)
@@ -56,6 +56,9 @@ public:
     //! Serialize data to archive
     void Serialize(DumpStream& ar);
     
+    //! remove a generation
+    void RemoveGeneration(int ig);
+    
 public:
     // multigenerational material data
     deque <mat3d>  m_Fi;	//!< inverse of relative deformation gradient
@@ -68,6 +68,9 @@ public:
     //! cull generations
     void CullGenerations(FEMaterialPoint& pt);
     
+    //! merge generations to bound their number
+    void CompactGenerations(FEMaterialPoint& pt);
+    
     //! evaluate bond mass fraction for a given generation
     double BreakingBondMassFraction(FEMaterialPoint& pt, const int ig, const mat3ds D);
     
@@ -87,6 +90,8 @@ private:
     
 public:
     double	m_wmin;		//!< minimum value of relaxation
+    double  m_wtol;     //!< generations with a smaller bond mass fraction are merged
+    int     m_nmax;     //!< max nr of generations per point (0 = no limit)
     int     m_btype;    //!< bond kinetics type
     int     m_ttype;    //!< bond breaking trigger type
     
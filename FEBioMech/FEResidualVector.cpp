@@ -47,7 +47,10 @@ FEResidualVector::~FEResidualVector()
 void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
     
-    vector<double>& R = m_R;
+    // when assembling in parallel with thread buffers, all contributions go into the thread's buffer
+    vector<double>* buf = ThreadBuffer();
+    vector<double>& R = (buf ? *buf : m_R);
+    const int neq = (int)m_R.size();
     
     int i, I, n;
     
@@ -62,14 +65,20 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
             I = elm[i];
             
             if ( I >= 0){
+                if (buf) R[I] += fe[i];
+                else {
 #pragma omp atomic
-                R[I] += fe[i];
+                    R[I] += fe[i];
+                }
             }
             // TODO: Find another way to store reaction forces
             
             else if (-I-2 >= 0){
+                if (buf) R[neq - I - 2] -= fe[i];
+                else {
 #pragma omp atomic
-                m_Fr[-I-2] -= fe[i];
+                    m_Fr[-I-2] -= fe[i];
+                }
             }
         }
         
@@ -128,16 +137,22 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 							n = lm[3];
 							if (n >= 0)
 							{
+								if (buf) R[n] += m.x;
+								else {
 #pragma omp atomic
-								R[n] += m.x;
+									R[n] += m.x;
+								}
 							}
 #pragma omp atomic
 							RB.m_Mr.x -= m.x;
 							n = lm[4];
 							if (n >= 0)
 							{
+								if (buf) R[n] += m.y;
+								else {
 #pragma omp atomic
-								R[n] += m.y;
+									R[n] += m.y;
+								}
 							}
 
 #pragma omp atomic
@@ -145,8 +160,11 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 							n = lm[5];
 							if (n >= 0)
 							{
+								if (buf) R[n] += m.z;
+								else {
 #pragma omp atomic
-								R[n] += m.z;
+									R[n] += m.z;
+								}
 							}
 #pragma omp atomic
 							RB.m_Mr.z -= m.z;
@@ -165,16 +183,22 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 							n = lm[0];
 							if (n >= 0)
 							{
+								if (buf) R[n] += f.x;
+								else {
 #pragma omp atomic
-								R[n] += f.x;
+									R[n] += f.x;
+								}
 							}
 #pragma omp atomic
 							RB.m_Fr.x -= f.x;
 							n = lm[1];
 							if (n >= 0)
 							{
+								if (buf) R[n] += f.y;
+								else {
 #pragma omp atomic
-								R[n] += f.y;
+									R[n] += f.y;
+								}
 							}
 #pragma omp atomic
 							RB.m_Fr.y -= f.y;
@@ -182,8 +206,11 @@ void FEResidualVector::Assemble(vector<int>& en, vector<int>& elm, vector<double
 							n = lm[2];
 							if (n >= 0)
 							{
+								if (buf) R[n] += f.z;
+								else {
 #pragma omp atomic
-								R[n] += f.z;
+									R[n] += f.z;
+								}
 							}
 #pragma omp atomic
 							RB.m_Fr.z -= f.z;
@@ -207,16 +234,20 @@ void FEResidualVector::Assemble(int node_id, int dof, double f)
 	int n = node.m_ID[dof];
 
 	// assemble into global vector
+	vector<double>* buf = ThreadBuffer();
 	if (n >= 0) {
+		if (buf) (*buf)[n] += f;
+		else {
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 	else {
 		FESolidSolver2* solver = dynamic_cast<FESolidSolver2*>(m_fem.GetCurrentStep()->GetFESolver());
 		if (solver)
 		{
 			FERigidSolver* rigidSolver = solver->GetRigidSolver();
-			rigidSolver->AssembleResidual(node_id, dof, f, m_R);
+			rigidSolver->AssembleResidual(node_id, dof, f, (buf ? *buf : m_R));
 		}
 	}
 }
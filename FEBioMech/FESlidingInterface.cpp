@@ -499,10 +499,6 @@ void FESlidingInterface::Activate()
 
 void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface& ms, bool bupseg, bool bmove)
 {
-	// node projection data
-	double r, s;
-	vec3d q;
-
 	FEClosestPointProjection cpp(ms);
 	cpp.SetTolerance(m_stol);
 	cpp.SetSearchRadius(m_sradius);
@@ -510,8 +506,16 @@ void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface&
 	cpp.Init();
 
 	// loop over all primary surface nodes
-	for (int i=0; i<ss.Nodes(); ++i)
+	// (when nodes are moved onto the secondary surface we stay serial, since 
+	// this can change the surface that is being projected on)
+	int NN = ss.Nodes();
+#pragma omp parallel for schedule(dynamic) if (bmove == false)
+	for (int i=0; i<NN; ++i)
 	{
+		// node projection data
+		double r, s;
+		vec3d q;
+
 		// get the node
 		FENode& node = ss.Node(i);
 
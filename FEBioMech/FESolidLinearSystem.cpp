@@ -45,6 +45,17 @@ void FESolidLinearSystem::StiffnessAssemblyScaleFactor(double a)
 	m_stiffnessScale = a;
 }
 
+// see if any of the nodes is attached to a rigid body
+bool FESolidLinearSystem::HasRigidNodes(const std::vector<int>& en)
+{
+	FEMesh& mesh = m_solver->GetFEModel()->GetMesh();
+	for (size_t i = 0; i < en.size(); ++i)
+	{
+		if ((en[i] >= 0) && (mesh.Node(en[i]).m_rid >= 0)) return true;
+	}
+	return false;
+}
+
 void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 {
 	// Rigid joints require a different assembly approach in that we can do 
@@ -73,11 +84,13 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		vector<double>& ui = m_u;
 
 		// adjust for linear constraints
+		// NOTE: This does not require a critical section, provided all other writes to
+		//       the child entries are atomic (see FELinearSystem::ColoredAssemblyMap).
+		//       Elements that are not connected to a linear constraint return right away.
 		FEModel* fem = m_solver->GetFEModel();
 		FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 		if (LCM.LinearConstraints() > 0)
 		{
-			#pragma omp critical 
 			LCM.AssembleStiffness(m_K, m_F, m_u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
 		}
 
@@ -121,7 +134,12 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 
 		// see if there are any rigid body dofs here
-		#pragma omp critical 
-		m_rigidSolver->RigidStiffness(m_K, m_u, m_F, ke, m_alpha);
+		// NOTE: We only enter the critical section when the element is connected to a
+		//       rigid body, since otherwise this would serialize the element assembly.
+		if (HasRigidNodes(ke.Nodes()))
+		{
+			#pragma omp critical 
+			m_rigidSolver->RigidStiffness(m_K, m_u, m_F, ke, m_alpha);
+		}
 	}
 }
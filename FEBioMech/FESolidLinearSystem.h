@@ -45,6 +45,10 @@ public:
 	// scale factor for stiffness matrix
 	void StiffnessAssemblyScaleFactor(double a);
 
+private:
+	// see if any of the nodes is attached to a rigid body
+	bool HasRigidNodes(const std::vector<int>& en);
+
 private:
 	FERigidSolver*	m_rigidSolver;
 	double			m_alpha;
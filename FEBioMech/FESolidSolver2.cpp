@@ -48,6 +48,7 @@ SOFTWARE.*/
 #include <FECore/FEModelLoad.h>
 #include <FECore/FELinearConstraintManager.h>
 #include <FECore/vector.h>
+#include <FECore/FEProfiler.h>
 #include "FESolidLinearSystem.h"
 #include "FEBioMech.h"
 
@@ -1077,12 +1078,15 @@ bool FESolidSolver2::StiffnessMatrix()
 	FESolidLinearSystem LS(this, &m_rigidSolver, *m_pK, m_Fd, m_ui, (m_msymm == REAL_SYMMETRIC), m_alpha, m_nreq);
 
 	// calculate the stiffness matrix for each domain
-	for (int i=0; i<mesh.Domains(); ++i) 
 	{
-		if (mesh.Domain(i).IsActive()) 
+		PROFILE_SCOPE("elements");
+		for (int i=0; i<mesh.Domains(); ++i) 
 		{
-			FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
-			dom.StiffnessMatrix(LS);
+			if (mesh.Domain(i).IsActive()) 
+			{
+				FEElasticDomain& dom = dynamic_cast<FEElasticDomain&>(mesh.Domain(i));
+				dom.StiffnessMatrix(LS);
+			}
 		}
 	}
 
@@ -1154,6 +1158,7 @@ bool FESolidSolver2::StiffnessMatrix()
 //! Calculate the stiffness contribution due to nonlinear constraints
 void FESolidSolver2::NonLinearConstraintStiffness(FELinearSystem& LS, const FETimeInfo& tp)
 {
+	PROFILE_SCOPE("constraints");
 	FEModel& fem = *GetFEModel();
 	int N = fem.NonlinearConstraints();
 	for (int i=0; i<N; ++i) 
@@ -1168,6 +1173,7 @@ void FESolidSolver2::NonLinearConstraintStiffness(FELinearSystem& LS, const FETi
 
 void FESolidSolver2::ContactStiffness(FELinearSystem& LS)
 {
+	PROFILE_SCOPE("contact");
 	FEModel& fem = *GetFEModel();
 	const FETimeInfo& tp = fem.GetTime();
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
@@ -1181,6 +1187,7 @@ void FESolidSolver2::ContactStiffness(FELinearSystem& LS)
 //! Calculates the contact forces
 void FESolidSolver2::ContactForces(FEGlobalVector& R)
 {
+	PROFILE_SCOPE("contact");
 	FEModel& fem = *GetFEModel();
 	const FETimeInfo& tp = fem.GetTime();
 	for (int i = 0; i<fem.SurfacePairConstraints(); ++i)
@@ -1208,12 +1215,14 @@ bool FESolidSolver2::Residual(vector<double>& R)
 	// setup the global vector
 	zero(R);
 	FEResidualVector RHS(fem, R, m_Fr);
+	PrepareResidualVector(RHS);
 
 	// zero rigid body reaction forces
 	m_rigidSolver.Residual();
 
 	// calculate the internal (stress) forces
 	InternalForces(RHS);
+	RHS.Flush();
 
 	// extract the internal forces
 	// (only when we really need it, below)
@@ -1278,6 +1287,7 @@ bool FESolidSolver2::Residual(vector<double>& R)
 //! Internal forces
 void FESolidSolver2::InternalForces(FEGlobalVector& R)
 {
+	PROFILE_SCOPE("elements");
 	FEMesh& mesh = GetFEModel()->GetMesh();
 	for (int i = 0; i<mesh.Domains(); ++i)
 	{
@@ -1369,6 +1379,9 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 		}
 	}
 
+	// make sure all contributions are added before we read the reaction forces
+	RHS.Flush();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (int i = 0; i<mesh.Nodes(); ++i)
@@ -1395,6 +1408,7 @@ void FESolidSolver2::ExternalForces(FEGlobalVector& RHS)
 //! calculate the nonlinear constraint forces 
 void FESolidSolver2::NonLinearConstraintForces(FEGlobalVector& R, const FETimeInfo& tp)
 {
+	PROFILE_SCOPE("constraints");
 	FEModel& fem = *GetFEModel();
 	int N = fem.NonlinearConstraints();
 	for (int i=0; i<N; ++i) 
@@ -43,6 +43,8 @@ BEGIN_FECORE_CLASS(FEUncoupledReactiveViscoelasticMaterial, FEUncoupledMaterial)
 	ADD_PARAMETER(m_wmin , FE_RANGE_CLOSED(0.0, 1.0), "wmin"    );
 	ADD_PARAMETER(m_btype, FE_RANGE_CLOSED(1, 2), "kinetics");
 	ADD_PARAMETER(m_ttype, FE_RANGE_CLOSED(0, 2), "trigger" );
+	ADD_PARAMETER(m_wtol , FE_RANGE_CLOSED(0.0, 1.0), "compact_tol");
+	ADD_PARAMETER(m_nmax , FE_RANGE_GREATER_OR_EQUAL(0), "max_generations");
 
 	// set material properties
 	ADD_PROPERTY(m_pBase, "elastic");
@@ -56,6 +58,8 @@ END_FECORE_CLASS();
 FEUncoupledReactiveViscoelasticMaterial::FEUncoupledReactiveViscoelasticMaterial(FEModel* pfem) : FEUncoupledMaterial(pfem)
 {
     m_wmin = 0;
+    m_wtol = 0;
+    m_nmax = 0;
     m_btype = 0;
     m_ttype = 0;
 
@@ -420,3 +424,62 @@ void FEUncoupledReactiveViscoelasticMaterial::CullGenerations(FEMaterialPoint& m
     
     return;
 }
+
+//-----------------------------------------------------------------------------
+//! Merge generations whose bond mass fraction is below m_wtol and, if the number
+//! of generations exceeds m_nmax, the generations with the smallest mass fraction.
+//! A generation is merged into the next younger one, which takes over its current
+//! bond mass fraction. The two most recent generations are never merged, so that
+//! the mass fraction of the next reforming generation is not affected.
+void FEUncoupledReactiveViscoelasticMaterial::CompactGenerations(FEMaterialPoint& mp)
+{
+    if ((m_wtol <= 0) && (m_nmax <= 0)) return;
+    
+    // get the elastic part
+    FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
+    
+    // get the reactive viscoelastic point data
+    FEReactiveVEMaterialPoint& pt = *mp.ExtractData<FEReactiveVEMaterialPoint>();
+    
+    int ng = (int)pt.m_Fi.size();
+    if (ng <= 2) return;
+    
+    mat3ds D = ep.RateOfDeformation();
+    
+    // keep safe copy of deformation gradient
+    mat3d F = ep.m_F;
+    double J = ep.m_J;
+    
+    // evaluate the current bond mass fraction of each generation
+    vector<double> w(ng);
+    for (int ig=0; ig<ng; ++ig) {
+        ep.m_F = F*pt.m_Fi[ig];
+        ep.m_J = J*pt.m_Ji[ig];
+        w[ig] = BreakingBondMassFraction(mp, ig, D);
+    }
+    
+    // restore safe copy of deformation gradient
+    ep.m_F = F;
+    ep.m_J = J;
+    
+    while (ng > 2) {
+        // find the generation with the smallest mass fraction
+        int imin = 0;
+        for (int ig=1; ig<ng-2; ++ig)
+            if (w[ig] < w[imin]) imin = ig;
+        
+        if ((w[imin] >= m_wtol) && ((m_nmax <= 0) || (ng <= m_nmax))) break;
+        
+        // For kinetics type 2 the mass fraction of a generation is defined by the
+        // breaking times of it and its predecessor, so removing a generation already
+        // merges its mass into the next one. For type 1 we rescale the mass fraction
+        // of the next generation.
+        int inext = imin + 1;
+        if ((m_btype == 1) && (w[inext] > 0)) pt.m_w[inext] *= (w[imin] + w[inext])/w[inext];
+        w[inext] += w[imin];
+        
+        pt.RemoveGeneration(imin);
+        w.erase(w.begin() + imin);
+        --ng;
+    }
+}
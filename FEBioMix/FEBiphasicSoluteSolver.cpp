@@ -419,6 +419,7 @@ bool FEBiphasicSoluteSolver::Residual(vector<double>& R)
 
 	// setup global RHS vector
 	FEResidualVector RHS(fem, R, m_Fr);
+	PrepareResidualVector(RHS);
 
 	// zero rigid body reaction forces
 	m_rigidSolver.Residual();
@@ -486,6 +487,9 @@ bool FEBiphasicSoluteSolver::Residual(vector<double>& R)
 		}
 	}
 
+	// make sure all contributions are added before we read the reaction forces
+	RHS.Flush();
+
 	// set the nodal reaction forces
 	// TODO: Is this a good place to do this?
 	for (i=0; i<mesh.Nodes(); ++i)
@@ -714,12 +714,6 @@ double FESlidingInterface2::AutoPressurePenalty(FESurfaceElement& el, FESlidingS
 void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface2& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-
-	double ps[FEElement::MAX_NODES], p1;
 
 	double R = m_srad*mesh.GetBoundingBox().radius();
 
@@ -783,7 +777,7 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 	}
 
 	// loop over all integration points
- //   #pragma omp parallel for shared(R, bupseg)
+#pragma omp parallel for schedule(dynamic)
 	for (int i=0; i<ss.Elements(); ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
@@ -793,6 +787,7 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 		int nint = el.GaussPoints();
 
 		// get the nodal pressures
+		double ps[FEElement::MAX_NODES], p1 = 0;
 		if (sporo)
 		{
 			for (int j=0; j<ne; ++j) ps[j] = mesh.Node(el.m_node[j]).get(m_dofP);
@@ -804,16 +799,17 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 			FESlidingSurface2::Data& pt = static_cast<FESlidingSurface2::Data&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 
 			// get the pressure at the integration point
             if (sporo) p1 = el.eval(ps, j);
 
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = {0,0};
 			if (pme)
 			{
 				double g;
@@ -850,7 +846,7 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 
 				double eps = m_epsn*pt.m_epsn*psf;
 
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 
 				pt.m_gap = (g <= R? g : 0);
 
@@ -795,13 +795,6 @@ double FESlidingInterface3::AutoConcentrationPenalty(FESurfaceElement& el, FESli
 void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface3& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-	
-	double ps[FEElement::MAX_NODES], p1;
-	double cs[FEElement::MAX_NODES], c1;
 	
 	double R = m_srad*mesh.GetBoundingBox().radius();
 	
@@ -866,7 +859,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
     }
     
 	// loop over all integration points
-//    #pragma omp parallel for shared(R, bupseg)
+#pragma omp parallel for schedule(dynamic)
 	for (int i=0; i<ss.Elements(); ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
@@ -878,6 +871,9 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 		int ne = el.Nodes();
 		int nint = el.GaussPoints();
 		
+		double ps[FEElement::MAX_NODES], p1 = 0;
+		double cs[FEElement::MAX_NODES], c1 = 0;
+
 		// get the nodal pressures
 		if (sporo)
 		{
@@ -895,7 +891,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 			FESlidingSurface3::Data& pt = static_cast<FESlidingSurface3::Data&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 			
 			// get the pressure at the integration point
 			if (sporo) p1 = el.eval(ps, j);
@@ -904,10 +900,11 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 			if (ssolu) c1 = el.eval(cs, j);
 			
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 			
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = {0,0};
 			if (pme)
 			{
 				double g;
@@ -944,7 +941,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 				
 				double eps = m_epsn*pt.m_epsn*psf;
 				
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 				
 				pt.m_gap = (g <= R? g : 0);
 				
@@ -921,14 +921,9 @@ double FESlidingInterfaceMP::AutoConcentrationPenalty(FESurfaceElement& el,
 void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfaceMP& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
 	
 	const int MN = FEElement::MAX_NODES;
 	int nsol = (int)m_sid.size();
-	double ps[MN], p1;
 	vector< vector<double> > cs(nsol, vector<double>(MN));
 	vector<double> c1(nsol);
 	
@@ -995,7 +990,8 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
     }
     
 	// loop over all integration points
-//    #pragma omp parallel for shared(R, bupseg)
+	// (each thread gets its own copy of the concentration buffers)
+#pragma omp parallel for schedule(dynamic) firstprivate(cs, c1)
 	for (int i=0; i<ss.Elements(); ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
@@ -1005,6 +1001,8 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
 		int ne = el.Nodes();
 		int nint = el.GaussPoints();
 		
+		double ps[MN], p1 = 0;
+
 		// get the nodal pressures
 		if (sporo)
 		{
@@ -1021,7 +1019,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
 			FESlidingSurfaceMP::Data& pt = static_cast<FESlidingSurfaceMP::Data&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 			
 			// get the pressure at the integration point
 			if (sporo) p1 = el.eval(ps, j);
@@ -1030,10 +1028,11 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
 			for (int isol=0; isol<nsol; ++isol) c1[isol] = el.eval(&cs[isol][0], j);
 			
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 			
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = {0,0};
 			if (pme)
 			{
 				double g;
@@ -1070,7 +1069,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
 				
 				double eps = m_epsn*pt.m_epsn*psf;
 				
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 				
 				pt.m_gap = (g <= R? g : 0);
 				
@@ -39,6 +39,7 @@ BEGIN_FECORE_CLASS(FELMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
 	ADD_PARAMETER(m_bcov  , "print_cov"   );
+	ADD_PARAMETER(m_nworkers, "max_workers");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -75,6 +76,7 @@ FELMOptimizeMethod::FELMOptimizeMethod()
 	m_fdiff  = 0.001;
 	m_nmax   = 100;
 	m_bcov   = 0;
+	m_nworkers = 1;
 	m_loglevel = LogLevel::LOG_NEVER;
 }
 
@@ -203,23 +205,26 @@ void FELMOptimizeMethod::ObjFun(vector<double>& x, vector<double>& a, vector<dou
 	m_yopt = y;
 
 	// now calculate the derivatives using forward differences
+	// (the perturbed problems are independent, so they can be solved concurrently)
 	int ndata = (int)x.size();
-	vector<double> a1(a);
-	vector<double> y1(ndata);
 	int ma = (int)a.size();
+	vector< vector<double> > a1(ma, a);
 	for (int i=0; i<ma; ++i)
 	{
 		FEInputParameter& var = *opt.GetInputParameter(i);
 
 		double b = var.ScaleFactor();
 
-		a1[i] = a1[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
-		assert(a1[i] != a[i]);
+		a1[i][i] = a[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
+		assert(a1[i][i] != a[i]);
+	}
+
+	vector< vector<double> > y1;
+	if (opt.FESolve(a1, y1, m_nworkers) == false) throw FEErrorTermination();
 
-		if (opt.FESolve(a1) == false) throw FEErrorTermination();
-		opt.GetObjective().Evaluate(y1);
-		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/(a1[i] - a[i]);
-		a1[i] = a[i];
+	for (int i=0; i<ma; ++i)
+	{
+		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[i][j] - y[j])/(a1[i][i] - a[i]);
 	}
 }
 
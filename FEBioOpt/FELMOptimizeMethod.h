@@ -53,6 +53,7 @@ public:
 	double			m_fdiff;	// forward difference step size
 	int				m_nmax;		// maximum number of iterations
 	bool			m_bcov;		// flag to print covariant matrix
+	int				m_nworkers;	// max number of concurrent forward solves for the finite difference derivatives
 
 protected:
 	vector<double>	m_yopt;	// optimal y-values
@@ -71,6 +71,16 @@ double FEObjectiveFunction::Evaluate(vector<double>& y)
 	// evaluate the functions
 	EvaluateFunctions(y);
 
+	// calculate the objective value
+	return ObjectiveValue(y);
+}
+
+double FEObjectiveFunction::ObjectiveValue(const vector<double>& y)
+{
+	// get the number of measurements
+	int ndata = Measurements();
+	assert((int)y.size() == ndata);
+
 	// get the measurement vector
 	vector<double> y0(ndata);
 	GetMeasurements(y0);
@@ -70,6 +70,10 @@ public:
 	// evaluate objective function
 	double Evaluate();
 
+	// calculate the objective function for the function values f
+	// (i.e. the f_i below), which were evaluated previously
+	double ObjectiveValue(const vector<double>& f);
+
 	// print output to screen or not
 	void SetVerbose(bool b) { m_verbose = b; }
 
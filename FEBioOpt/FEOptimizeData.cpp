@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FEOptimizeData.h"
 #include "FELMOptimizeMethod.h"
 #include "FEOptimizeInput.h"
+#include "FEProcessPool.h"
 #include <FECore/FECoreKernel.h>
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
@@ -211,22 +212,10 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 	obj.Reset();
 
 	// set the input parameters
-	int nvar = InputParameters();
-	if (nvar != (int)a.size()) return false;
-	for (int i = 0; i<nvar; ++i)
-	{
-		FEInputParameter& var = *GetInputParameter(i);
-		var.SetValue(a[i]);
-	}
+	if (SetParameters(a) == false) return false;
 
 	// report the new values
-	feLog("\n----- Iteration: %d -----\n", m_niter);
-	for (int i = 0; i<nvar; ++i)
-	{
-		FEInputParameter& var = *GetInputParameter(i);
-		string name = var.GetName();
-		feLog("%-15s = %lg\n", name.c_str(), var.GetValue());
-	}
+	ReportParameters();
 
 	// reset the FEM data
 	FEModel& fem = *GetFEModel();
@@ -241,3 +230,89 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+//-----------------------------------------------------------------------------
+//! Solve the FE problem for several sets of parameters and evaluate the objective function
+//! for each of them. The function values are returned in y. The problems are solved
+//! concurrently in (at most) maxWorkers worker processes, each working on its own copy of the model. 
+//! The output and the results are the same as when calling FESolve and evaluating the 
+//! objective function for each parameter set in order. If a callback function is given, it is
+//! called (in order) for each parameter set as soon as its results are available.
+bool FEOptimizeData::FESolve(const vector< vector<double> >& a, vector< vector<double> >& y, int maxWorkers, SolveCallback cb)
+{
+	int N = (int)a.size();
+	FEObjectiveFunction& obj = GetObjective();
+
+	FEProcessPool pool(maxWorkers);
+	if ((pool.IsParallel() == false) || (N < 2))
+	{
+		y.resize(N);
+		for (int i = 0; i < N; ++i)
+		{
+			if (FESolve(a[i]) == false) return false;
+			double fobj = obj.Evaluate(y[i]);
+			if (cb) cb(i, y[i], fobj);
+		}
+		return true;
+	}
+
+	// solve all problems in the worker processes
+	FEModel& fem = *GetFEModel();
+	bool bfailed = false;
+	bool bret = pool.Run(N, [&](int i, vector<double>& yi) {
+
+		// This runs in a worker process, so it must not produce any output.
+		fem.BlockLog();
+		obj.Reset();
+		if (SetParameters(a[i]) == false) return false;
+		fem.Reset();
+		if (RunTask() == false) return false;
+
+		yi.resize(obj.Measurements());
+		obj.EvaluateFunctions(yi);
+		return true;
+	}, y, [&](int i, bool bok, const vector<double>& yi) {
+
+		// Report the results in order. If a solve failed, we stop 
+		// at the failed one, as the serial loop would.
+		if (bfailed) return;
+
+		m_niter++;
+		SetParameters(a[i]);
+		ReportParameters();
+
+		if ((bok == false) || ((int)yi.size() != obj.Measurements())) { bfailed = true; return; }
+		double fobj = obj.ObjectiveValue(yi);
+		if (cb) cb(i, yi, fobj);
+	});
+
+	return (bret && !bfailed);
+}
+
+//-----------------------------------------------------------------------------
+//! set the values of the input parameters
+bool FEOptimizeData::SetParameters(const vector<double>& a)
+{
+	int nvar = InputParameters();
+	if (nvar != (int)a.size()) return false;
+	for (int i = 0; i<nvar; ++i)
+	{
+		FEInputParameter& var = *GetInputParameter(i);
+		var.SetValue(a[i]);
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! print the current iteration and the values of the input parameters
+void FEOptimizeData::ReportParameters()
+{
+	feLog("\n----- Iteration: %d -----\n", m_niter);
+	int nvar = InputParameters();
+	for (int i = 0; i<nvar; ++i)
+	{
+		FEInputParameter& var = *GetInputParameter(i);
+		string name = var.GetName();
+		feLog("%-15s = %lg\n", name.c_str(), var.GetValue());
+	}
+}
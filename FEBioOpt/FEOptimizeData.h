@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FEObjectiveFunction.h"
 #include <vector>
 #include <string>
+#include <functional>
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -144,6 +145,12 @@ public:
 	//! solve the FE problem with a new set of parameters
 	bool FESolve(const vector<double>& a);
 
+	//! callback for reporting the results of a parameter set (index, function values, objective value)
+	typedef std::function<void(int n, const vector<double>& y, double fobj)> SolveCallback;
+
+	//! solve the FE problem for several sets of parameters (concurrently) and evaluate the objective function
+	bool FESolve(const vector< vector<double> >& a, vector< vector<double> >& y, int maxWorkers, SolveCallback cb = nullptr);
+
 public:
 	// return the number of input parameters
 	int InputParameters() { return (int)m_Var.size(); }
@@ -174,6 +181,13 @@ public:
 
 	bool RunTask();
 
+private:
+	//! set the values of the input parameters
+	bool SetParameters(const vector<double>& a);
+
+	//! print the current iteration and the values of the input parameters
+	void ReportParameters();
+
 public:
 	int	m_niter;	// nr of minor iterations (i.e. FE solves)
 
@@ -29,6 +29,11 @@ SOFTWARE.*/
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
 #include <FECore/log.h>
+#include <FECore/Timer.h>
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioPlot/PlotFile.h>
+#include "FEProcessPool.h"
+#include "FEResultsJournal.h"
 
 FESweepParam::FESweepParam()
 {
@@ -62,6 +67,7 @@ void FESweepParam::SetValue(double v)
 FEParameterSweep::FEParameterSweep(FEModel* fem) : FECoreTask(fem)
 {
 	m_niter = 0;
+	m_nworkers = 1;
 }
 
 //! initialization
@@ -163,6 +169,15 @@ bool FEParameterSweep::Input(const char* szfile)
 			// looks good, so throw it on the pile
 			m_params.push_back(p);
 		}
+		else if (tag == "max_workers")
+		{
+			tag.value(m_nworkers);
+			if (m_nworkers < 1) throw XMLReader::InvalidValue(tag);
+		}
+		else if (tag == "journal")
+		{
+			m_journal = tag.szvalue();
+		}
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	} while (!tag.isend());
@@ -184,12 +199,12 @@ bool FEParameterSweep::Run()
 		a[i] = pi.m_min;
 	}
 
-	// run the parameter sweep
+	// collect all the points of the parameter sweep
+	vector< vector<double> > points;
 	bool bdone = false;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (FESolve(a) == false) return false;
+		points.push_back(a);
 
 		// update indices
 		for (size_t i = 0; i<ma; ++i)
@@ -202,8 +217,72 @@ bool FEParameterSweep::Run()
 		}
 	}
 	while (!bdone);
+	int N = (int)points.size();
 
-	return true;
+	// open the journal and skip the points that were already done
+	FEResultsJournal journal;
+	if (m_journal.empty() == false)
+	{
+		if (journal.Open(m_journal) == false)
+		{
+			feLogError("Failed opening journal %s", m_journal.c_str());
+			return false;
+		}
+	}
+
+	vector<int> todo;
+	for (int n = 0; n < N; ++n)
+	{
+		vector<double> y;
+		if (m_journal.empty() || (journal.Find(n, points[n], y) == false)) todo.push_back(n);
+	}
+	if ((int)todo.size() < N) feLog("\n%d of %d points were read from journal %s\n", N - (int)todo.size(), N, m_journal.c_str());
+
+	// The points are solved in worker processes when more than one worker is requested. 
+	// Each worker writes its own log and plot file, which requires an FEBioModel.
+	FEProcessPool pool(m_nworkers);
+	FEBioModel* fem = dynamic_cast<FEBioModel*>(GetFEModel());
+	if ((fem == nullptr) || (todo.size() < 2)) pool.SetMaxWorkers(1);
+	bool bparallel = pool.IsParallel();
+
+	// The workers can't share the plot file, so we close it here. 
+	if (bparallel)
+	{
+		PlotFile* plt = fem->GetPlotFile();
+		if (plt) plt->Close();
+	}
+
+	// run the parameter sweep
+	Timer timer;
+	timer.start();
+	int ndone = 0;
+	vector< vector<double> > results;
+	bool bret = pool.Run((int)todo.size(), [&](int i, vector<double>& y) {
+		int n = todo[i];
+		if (bparallel) return FESolveWorker(n, points[n]);
+		else return FESolve(points[n]);
+	}, results, [&](int i, bool bok, const vector<double>& y) {
+		int n = todo[i];
+		if (bparallel) ReportPoint(n, points[n]);
+		if (bok == false) return;
+
+		if (m_journal.empty() == false) journal.Add(n, points[n], y);
+
+		// report progress
+		ndone++;
+		double sec = timer.peek();
+		if (sec > 0.0) feLog("\ncompleted %d of %d points (%.1lf points per hour)\n", ndone, (int)todo.size(), 3600.0*ndone / sec);
+	});
+	timer.stop();
+
+	if (bret)
+	{
+		char sztime[64];
+		Timer::time_str(timer.GetTime(), sztime);
+		feLog("\n%d points solved in %s\n", ndone, sztime);
+	}
+
+	return bret;
 }
 
 bool FEParameterSweep::FESolve(const vector<double>& a)
@@ -237,3 +316,55 @@ bool FEParameterSweep::FESolve(const vector<double>& a)
 
 	return bret;
 }
+
+// returns the file name with the point number inserted before the extension
+static string point_file_name(const string& fileName, int n, const char* szext)
+{
+	string base = fileName;
+	size_t pos = base.rfind('.');
+	size_t sep = base.find_last_of("/\\");
+	if ((pos != string::npos) && ((sep == string::npos) || (pos > sep))) base = base.substr(0, pos);
+
+	char sz[32] = { 0 };
+	sprintf(sz, "_%d", n + 1);
+	return base + sz + szext;
+}
+
+// This solves point n in a worker process. Each point writes its own log and plot file.
+bool FEParameterSweep::FESolveWorker(int n, const vector<double>& a)
+{
+	FEBioModel& fem = dynamic_cast<FEBioModel&>(*GetFEModel());
+
+	// set the input parameters
+	size_t nvar = m_params.size();
+	assert(nvar == a.size());
+	for (int i = 0; i<nvar; ++i) m_params[i].SetValue(a[i]);
+
+	// setup the output files for this point
+	Logfile& log = fem.GetLogFile();
+	log.close();
+	fem.SetLogFilename(point_file_name(fem.GetLogfileName(), n, ".log"));
+	fem.SetPlotFilename(point_file_name(fem.GetPlotFileName(), n, ".xplt"));
+	for (int i = 0; i < fem.Steps(); ++i) fem.GetStep(i)->SetPlotHint(FE_PLOT_NO_HINT);
+
+	// the workers don't write to the screen
+	Logfile::MODE mode = log.GetMode();
+	if (mode == Logfile::LOG_FILE_AND_SCREEN) log.SetMode(Logfile::LOG_FILE);
+	else if (mode == Logfile::LOG_SCREEN) log.SetMode(Logfile::LOG_NEVER);
+
+	// reset and solve the model
+	if (fem.Reset() == false) return false;
+	return fem.Solve();
+}
+
+// report a point that was solved by a worker
+void FEParameterSweep::ReportPoint(int n, const vector<double>& a)
+{
+	++m_niter;
+	feLog("\n----- Iteration: %d (point %d) -----\n", m_niter, n + 1);
+	for (size_t i = 0; i<m_params.size(); ++i)
+	{
+		string name = m_params[i].m_paramName;
+		feLog("%-15s = %lg\n", name.c_str(), a[i]);
+	}
+}
@@ -60,8 +60,12 @@ private:
 	bool Input(const char* szfile);
 	bool InitParams();
 	bool FESolve(const vector<double>& a);
+	bool FESolveWorker(int n, const vector<double>& a);
+	void ReportPoint(int n, const vector<double>& a);
 
 private:
 	vector<FESweepParam>	m_params;
 	int						m_niter;
+	int						m_nworkers;	//!< max number of points that are solved concurrently
+	string					m_journal;	//!< name of the results journal (used for resuming a sweep)
 };
@@ -0,0 +1,250 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEProcessPool.h"
+#include <stdio.h>
+#ifndef WIN32
+#include <deque>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef WIN32
+extern "C" void __cdecl omp_set_num_threads(int);
+#else
+extern "C" void omp_set_num_threads(int);
+#endif
+
+#ifndef WIN32
+//-----------------------------------------------------------------------------
+// write all the data to a pipe
+static bool write_all(int fd, const void* pd, size_t nsize)
+{
+	const char* p = (const char*)pd;
+	while (nsize > 0)
+	{
+		ssize_t n = write(fd, p, nsize);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			return false;
+		}
+		p += n;
+		nsize -= n;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// read all the data from a pipe
+static bool read_all(int fd, void* pd, size_t nsize)
+{
+	char* p = (char*)pd;
+	while (nsize > 0)
+	{
+		ssize_t n = read(fd, p, nsize);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			return false;
+		}
+		if (n == 0) return false;	// the worker exited before sending all its data
+		p += n;
+		nsize -= n;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// This runs in the worker process. It runs the job and writes the results to the pipe.
+// The worker never returns to the caller.
+static void run_worker(FEProcessPool::JobFunction& f, int job, int fd)
+{
+	// The OpenMP thread pool of the parent does not exist in the child process and 
+	// some OpenMP runtimes hang when a forked child enters a parallel region. 
+	// Since the workers already run concurrently, each worker uses a single thread.
+	omp_set_num_threads(1);
+
+	std::vector<double> r;
+	int status = 0;
+	try {
+		status = (f(job, r) ? 1 : 0);
+	}
+	catch (...)
+	{
+		status = 0;
+	}
+
+	int n = (int)r.size();
+	bool bok = write_all(fd, &status, sizeof(int));
+	if (bok) bok = write_all(fd, &n, sizeof(int));
+	if (bok && (n > 0)) bok = write_all(fd, &r[0], n * sizeof(double));
+	close(fd);
+
+	// use _exit so that we don't flush any buffers or run destructors of the parent's data
+	_exit(bok ? 0 : 1);
+}
+
+//-----------------------------------------------------------------------------
+// read the results of a worker and wait for it to finish
+static bool collect_worker(pid_t pid, int fd, std::vector<double>& r)
+{
+	int status = 0, n = 0;
+	bool bok = read_all(fd, &status, sizeof(int));
+	if (bok) bok = read_all(fd, &n, sizeof(int));
+	if (bok && (n > 0))
+	{
+		r.resize(n);
+		bok = read_all(fd, &r[0], n * sizeof(double));
+	}
+	close(fd);
+
+	int ret = 0;
+	while (waitpid(pid, &ret, 0) < 0)
+	{
+		if (errno != EINTR) { bok = false; break; }
+	}
+	if (!WIFEXITED(ret) || (WEXITSTATUS(ret) != 0)) bok = false;
+
+	// don't return partial results of a failed job
+	if ((bok == false) || (status != 1))
+	{
+		r.clear();
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+FEProcessPool::FEProcessPool(int maxWorkers)
+{
+	SetMaxWorkers(maxWorkers);
+}
+
+//-----------------------------------------------------------------------------
+void FEProcessPool::SetMaxWorkers(int n)
+{
+	m_maxWorkers = (n < 1 ? 1 : n);
+}
+
+//-----------------------------------------------------------------------------
+bool FEProcessPool::IsParallel() const
+{
+#ifdef WIN32
+	return false;
+#else
+	return (m_maxWorkers > 1);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+bool FEProcessPool::Run(int jobs, JobFunction f, std::vector< std::vector<double> >& results, DoneFunction done)
+{
+	results.assign(jobs, std::vector<double>());
+
+	if (IsParallel() == false)
+	{
+		for (int i = 0; i < jobs; ++i)
+		{
+			bool bok = f(i, results[i]);
+			if (bok == false) results[i].clear();
+			if (done) done(i, bok, results[i]);
+			if (bok == false) return false;
+		}
+		return true;
+	}
+
+#ifndef WIN32
+	struct Worker
+	{
+		pid_t	pid;
+		int		fd;
+		int		job;
+	};
+	std::deque<Worker> active;
+
+	bool bok = true;
+	int next = 0;
+	while (((next < jobs) && bok) || !active.empty())
+	{
+		// start as many workers as we can
+		while (bok && (next < jobs) && ((int)active.size() < m_maxWorkers))
+		{
+			int job = next++;
+
+			int fd[2] = { -1, -1 };
+			pid_t pid = -1;
+			if (pipe(fd) == 0)
+			{
+				// flush all output streams, otherwise the worker inherits the unwritten data
+				fflush(nullptr);
+
+				pid = fork();
+				if (pid == 0)
+				{
+					close(fd[0]);
+					run_worker(f, job, fd[1]);
+				}
+				close(fd[1]);
+				if (pid < 0) { close(fd[0]); fd[0] = -1; }
+			}
+
+			// If we could not start a worker (pid = -1), the job will be 
+			// run here when it's its turn, so the results stay in order.
+			Worker w = { pid, fd[0], job };
+			active.push_back(w);
+			if (pid < 0) break;
+		}
+
+		// collect the results of the oldest worker
+		if (active.empty() == false)
+		{
+			Worker w = active.front(); active.pop_front();
+			bool bjob = false;
+			if (w.pid < 0)
+			{
+				bjob = f(w.job, results[w.job]);
+				if (bjob == false) results[w.job].clear();
+			}
+			else bjob = collect_worker(w.pid, w.fd, results[w.job]);
+
+			if (bjob == false) bok = false;
+			if (done) done(w.job, bjob, results[w.job]);
+		}
+	}
+
+	return bok;
+#else
+	return false;
+#endif
+}
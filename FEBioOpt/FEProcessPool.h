@@ -0,0 +1,70 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <functional>
+
+//-----------------------------------------------------------------------------
+//! This class runs a number of independent jobs concurrently. Each job runs in
+//! its own (forked) process, so it works on a private copy of the model and
+//! cannot interfere with the other jobs or with the calling process. The results
+//! of a job are sent back to the caller through a pipe. 
+//! On platforms that don't support fork (i.e. Windows), or when only one worker
+//! is requested, the jobs are run one after another in the calling process.
+class FEProcessPool
+{
+public:
+	//! The job function. It should calculate the result vector for the job with the
+	//! given index and return false if the job failed. 
+	typedef std::function<bool(int job, std::vector<double>& result)>	JobFunction;
+
+	//! This function is called in the calling process when a job has finished. 
+	//! It is called in the order of the jobs. 
+	typedef std::function<void(int job, bool bok, const std::vector<double>& result)>	DoneFunction;
+
+public:
+	FEProcessPool(int maxWorkers = 1);
+
+	//! set the max number of concurrent worker processes
+	void SetMaxWorkers(int n);
+
+	//! get the max number of concurrent worker processes
+	int MaxWorkers() const { return m_maxWorkers; }
+
+	//! returns true if the jobs will be run in worker processes
+	bool IsParallel() const;
+
+	//! Run the jobs 0 to jobs-1. The results are returned in the order of the jobs.
+	//! Returns false if any of the jobs failed. The results of failed jobs are empty 
+	//! and no new jobs are started after a job failed.
+	bool Run(int jobs, JobFunction f, std::vector< std::vector<double> >& results, DoneFunction done = nullptr);
+
+private:
+	int	m_maxWorkers;
+};
@@ -0,0 +1,150 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEResultsJournal.h"
+#include <math.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------
+FEResultsJournal::FEResultsJournal()
+{
+	m_fp = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FEResultsJournal::~FEResultsJournal()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+void FEResultsJournal::Close()
+{
+	if (m_fp) fclose(m_fp);
+	m_fp = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// The format of each line is:
+// index na a[0] ... a[na-1] ny y[0] ... y[ny-1]
+// Lines that cannot be read (e.g. the last line when the run was interrupted while
+// it was being written) are ignored. 
+bool FEResultsJournal::Open(const std::string& fileName)
+{
+	Close();
+	m_data.clear();
+
+	// read the existing entries
+	bool bpartial = false;
+	FILE* fp = fopen(fileName.c_str(), "rt");
+	if (fp)
+	{
+		char szline[4096] = { 0 };
+		std::string line;
+		while (fgets(szline, sizeof(szline), fp))
+		{
+			line += szline;
+			if (line.empty() || (line[line.size() - 1] != '\n')) continue;
+
+			const char* sz = line.c_str();
+			char* ch = nullptr;
+			bool bok = true;
+
+			int index = (int)strtol(sz, &ch, 10); if (ch == sz) bok = false; sz = ch;
+			int na = (int)strtol(sz, &ch, 10); if ((ch == sz) || (na < 0)) bok = false; sz = ch;
+			Entry e;
+			for (int i = 0; bok && (i < na); ++i)
+			{
+				double v = strtod(sz, &ch); if (ch == sz) bok = false; sz = ch;
+				e.a.push_back(v);
+			}
+			int ny = (bok ? (int)strtol(sz, &ch, 10) : 0); if ((ch == sz) || (ny < 0)) bok = false; sz = ch;
+			for (int i = 0; bok && (i < ny); ++i)
+			{
+				double v = strtod(sz, &ch); if (ch == sz) bok = false; sz = ch;
+				e.y.push_back(v);
+			}
+
+			if (bok) m_data[index] = e;
+			line.clear();
+		}
+		bpartial = (line.empty() == false);
+		fclose(fp);
+	}
+
+	// open the file for appending new entries
+	m_fp = fopen(fileName.c_str(), "at");
+	if (m_fp == nullptr) return false;
+
+	// terminate an incomplete last line
+	if (bpartial) { fputc('\n', m_fp); fflush(m_fp); }
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEResultsJournal::Find(int index, const std::vector<double>& a, std::vector<double>& y) const
+{
+	std::map<int, Entry>::const_iterator it = m_data.find(index);
+	if (it == m_data.end()) return false;
+
+	// make sure this is the same point
+	const Entry& e = it->second;
+	if (e.a.size() != a.size()) return false;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		double tol = 1e-12*(fabs(a[i]) + 1.0);
+		if (fabs(e.a[i] - a[i]) > tol) return false;
+	}
+
+	y = e.y;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEResultsJournal::Add(int index, const std::vector<double>& a, const std::vector<double>& y)
+{
+	Entry& e = m_data[index];
+	e.a = a;
+	e.y = y;
+
+	if (m_fp == nullptr) return;
+
+	// write the whole line at once and flush it, so that it's not lost when the run is interrupted
+	std::string line;
+	char sz[64];
+	sprintf(sz, "%d %d", index, (int)a.size()); line += sz;
+	for (size_t i = 0; i < a.size(); ++i) { sprintf(sz, " %.17lg", a[i]); line += sz; }
+	sprintf(sz, " %d", (int)y.size()); line += sz;
+	for (size_t i = 0; i < y.size(); ++i) { sprintf(sz, " %.17lg", y[i]); line += sz; }
+	line += "\n";
+
+	fputs(line.c_str(), m_fp);
+	fflush(m_fp);
+}
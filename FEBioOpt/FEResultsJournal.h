@@ -0,0 +1,73 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <vector>
+#include <string>
+#include <map>
+#include <stdio.h>
+
+//-----------------------------------------------------------------------------
+//! The results journal keeps a record of the points of a parameter sweep (or scan)
+//! that were completed. Each completed point is appended to a text file as soon as it
+//! is finished, so that an interrupted run can be resumed by skipping all the points
+//! that are already in the journal. 
+//! Each line of the file stores the point index, the parameter values and the results. 
+class FEResultsJournal
+{
+public:
+	FEResultsJournal();
+	~FEResultsJournal();
+
+	//! Open the journal file. Entries that are already in the file are read first. 
+	//! New entries will be appended to the file.
+	bool Open(const std::string& fileName);
+
+	//! close the file
+	void Close();
+
+	//! see if the point with the given index and parameter values is in the journal.
+	//! If so, its results are returned in y.
+	bool Find(int index, const std::vector<double>& a, std::vector<double>& y) const;
+
+	//! add a completed point to the journal
+	void Add(int index, const std::vector<double>& a, const std::vector<double>& y);
+
+	//! number of entries
+	int Entries() const { return (int) m_data.size(); }
+
+private:
+	struct Entry
+	{
+		std::vector<double>	a;	// parameter values
+		std::vector<double>	y;	// results
+	};
+
+	FILE*					m_fp;
+	std::map<int, Entry>	m_data;
+};
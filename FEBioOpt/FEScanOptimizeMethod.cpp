@@ -29,21 +29,30 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FEScanOptimizeMethod.h"
 #include "FEOptimizeData.h"
+#include "FEResultsJournal.h"
 #include "FECore/log.h"
+#include "FECore/Timer.h"
 
 BEGIN_FECORE_CLASS(FEScanOptimizeMethod, FEOptimizeMethod)
-
+	ADD_PARAMETER(m_nworkers, "max_workers");
+	ADD_PARAMETER(m_journal , "journal");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
 // FEScanOptimizeMethod
 //-----------------------------------------------------------------------------
 
+FEScanOptimizeMethod::FEScanOptimizeMethod()
+{
+	m_nworkers = 1;
+}
+
 bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj)
 {
 	if (pOpt == 0) return false;
 	FEOptimizeData& opt = *pOpt;
 	FEObjectiveFunction& obj = opt.GetObjective();
+	FEModel* fem = opt.GetFEModel();
 
 	// set the intial values for the variables
 	int ma = opt.InputParameters();
@@ -54,25 +63,12 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 		a[i] = var->MinValue();
 	}
 
-	// loop until done
-	vector<double> y(ma, 0.0);
+	// collect all the points of the scan
+	vector< vector<double> > points;
 	bool bdone = false;
-	double fmin = 0.0;
 	do
 	{
-		// solve the problem with the new input parameters
-		if (opt.FESolve(a) == false) return false;
-
-		// calculate objective function
-		double fobj = obj.Evaluate(y);
-
-		// update minimum
-		if ((fmin == 0.0) || (fobj < fmin))
-		{
-			fmin = fobj;
-			amin = a;
-			ymin = y;
-		}
+		points.push_back(a);
 
 		// update indices
 		for (int i=0; i<ma; ++i)
@@ -85,6 +81,71 @@ bool FEScanOptimizeMethod::Solve(FEOptimizeData* pOpt, vector<double>& amin, vec
 		}
 	}
 	while (!bdone);
+	int N = (int)points.size();
+
+	// open the journal and see which points were already done
+	FEResultsJournal journal;
+	if (m_journal.empty() == false)
+	{
+		if (journal.Open(m_journal) == false)
+		{
+			feLogErrorEx(fem, "Failed opening journal %s", m_journal.c_str());
+			return false;
+		}
+	}
+
+	vector< vector<double> > y(N);
+	vector<double> fobj(N, 0.0);
+	vector< vector<double> > todo_a;
+	vector<int> todo;
+	const int nmeas = obj.Measurements();
+	for (int n=0; n<N; ++n)
+	{
+		// A journal entry is only used when it has a value for each measurement. It may 
+		// have been written for a different objective or by a parameter sweep.
+		if (m_journal.empty() || (journal.Find(n, points[n], y[n]) == false) || ((int)y[n].size() != nmeas))
+		{
+			todo.push_back(n);
+			todo_a.push_back(points[n]);
+		}
+		else fobj[n] = obj.ObjectiveValue(y[n]);
+	}
+	if ((int)todo.size() < N) feLogEx(fem, "\n%d of %d points were read from journal %s\n", N - (int)todo.size(), N, m_journal.c_str());
+
+	// solve the remaining points
+	Timer timer;
+	timer.start();
+	vector< vector<double> > ytodo;
+	bool bret = opt.FESolve(todo_a, ytodo, m_nworkers, [&](int i, const vector<double>& yi, double fi) {
+		int n = todo[i];
+		y[n] = yi;
+		fobj[n] = fi;
+		if (m_journal.empty() == false) journal.Add(n, points[n], yi);
+	});
+	timer.stop();
+	if (bret == false) return false;
+
+	if (todo.empty() == false)
+	{
+		double sec = timer.GetTime();
+		char sztime[64];
+		Timer::time_str(sec, sztime);
+		feLogEx(fem, "\n%d points solved in %s", (int)todo.size(), sztime);
+		if (sec > 0.0) feLogEx(fem, " (%.1lf points per hour)", 3600.0*todo.size() / sec);
+		feLogEx(fem, "\n");
+	}
+
+	// find the minimum
+	double fmin = 0.0;
+	for (int n=0; n<N; ++n)
+	{
+		if ((fmin == 0.0) || (fobj[n] < fmin))
+		{
+			fmin = fobj[n];
+			amin = points[n];
+			ymin = y[n];
+		}
+	}
 
 	// store the optimum data
 	if (minObj) *minObj = fmin;
@@ -34,11 +34,17 @@ SOFTWARE.*/
 class FEScanOptimizeMethod : public FEOptimizeMethod
 {
 public:
+	FEScanOptimizeMethod();
+
 	// this implements the solution algorithm.
 	// returns the optimal parameter values in amin
 	// returns the optimal measurement vector in ymin
 	// returns the optimal objective function value in minObj
 	bool Solve(FEOptimizeData* pOpt, vector<double>& amin, vector<double>& ymin, double* minObj) override;
 
+public:
+	int		m_nworkers;		//!< max number of points that are solved concurrently
+	string	m_journal;		//!< name of the results journal (used for resuming a scan)
+
 	DECLARE_FECORE_CLASS();
 };
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FECore/FEModel.h"
 #include "FECore/FEMaterial.h"
 #include <FECore/FESurface.h>
+#include <exception>
 
 FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM()
 {
@@ -40,7 +41,7 @@ FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM()
 	m_ntype = 0;
 	m_nfmt = 0;
 	m_arraySize = 0;
-	m_szname[0] = 0;
+	memset(m_szname, 0, STR_SIZE);
 }
 
 FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM(const FEBioPlotFile::DICTIONARY_ITEM& item)
@@ -50,7 +51,7 @@ FEBioPlotFile::DICTIONARY_ITEM::DICTIONARY_ITEM(const FEBioPlotFile::DICTIONARY_
 	m_nfmt = item.m_nfmt;
 	m_arraySize = item.m_arraySize;
 	m_arrayNames = item.m_arrayNames;
-	m_szname[0] = 0;
+	memset(m_szname, 0, STR_SIZE);
 	if (item.m_szname[0]) strcpy(m_szname, item.m_szname);
 }
 
@@ -710,6 +711,24 @@ void FEBioPlotFile::Close()
 	m_ar.Close();
 }
 
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::Sync()
+{
+	m_ar.Sync();
+}
+
+//-----------------------------------------------------------------------------
+double FEBioPlotFile::GetWriteTime()
+{
+	return m_ar.GetWriteTime();
+}
+
+//-----------------------------------------------------------------------------
+double FEBioPlotFile::GetWaitTime()
+{
+	return m_ar.GetWaitTime();
+}
+
 //-----------------------------------------------------------------------------
 bool FEBioPlotFile::Open(FEModel &fem, const char *szfile)
 {
@@ -856,9 +875,10 @@ void FEBioPlotFile::WriteDictionaryItem(DICTIONARY_ITEM& it)
 	{
 		for (int i = 0; i < (int)it.m_arraySize; ++i)
 		{
-			string& si = it.m_arrayNames[i];
-			const char* c = si.c_str();
-			m_ar.WriteChunk(PLT_DIC_ITEM_ARRAYNAME, (char*)c, STR_SIZE);
+			// copy to a zero-padded buffer, so we don't write past the end of the string
+			char sz[STR_SIZE] = { 0 };
+			strncpy(sz, it.m_arrayNames[i].c_str(), STR_SIZE - 1);
+			m_ar.WriteChunk(PLT_DIC_ITEM_ARRAYNAME, sz, STR_SIZE);
 		}
 	}
 	m_ar.WriteChunk(PLT_DIC_ITEM_NAME, it.m_szname, STR_SIZE);
@@ -1413,6 +1433,9 @@ bool FEBioPlotFile::Write(FEModel &fem, float ftime)
 		}
 		m_ar.EndChunk();
 
+		// evaluate all the plot variables of this state
+		EvaluateStateData(fem);
+
 		m_ar.BeginChunk(PLT_STATE_DATA);
 		{
 			// Global Data
@@ -1478,10 +1501,116 @@ void FEBioPlotFile::WriteGlobalData(FEModel& fem)
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteNodeData(FEModel& fem)
+//! Evaluate all the plot variables of the current state. Many plot variables are
+//! not read-only (e.g. they evaluate material tangents on the material points or 
+//! build mesh data lazily), so only the variables that are flagged as thread-safe
+//! are evaluated concurrently, each one by a single thread. The others are evaluated
+//! first, in dictionary order, on the calling thread. The data is stored so that it can
+//! be written to the archive in dictionary order afterwards. That way, the file
+//! is identical to the file written with one thread.
+void FEBioPlotFile::EvaluateStateData(FEModel& fem)
 {
+	// collect the plot variables
+	struct FIELD_JOB
+	{
+		int			nregion;
+		FEPlotData*	pd;
+		FieldData*	fd;
+	};
+	vector<FIELD_JOB> jobs;
+
+	m_nodeData.resize(m_dic.m_Node.size());
+	m_elemData.resize(m_dic.m_Elem.size());
+	m_faceData.resize(m_dic.m_Face.size());
+
 	list<DICTIONARY_ITEM>::iterator it = m_dic.m_Node.begin();
-	for (int i=0; i<(int) m_dic.m_Node.size(); ++i, ++it)
+	for (int i = 0; i < (int)m_dic.m_Node.size(); ++i, ++it)
+	{
+		FIELD_JOB job = { FE_REGION_NODE, it->m_psave, &m_nodeData[i] };
+		jobs.push_back(job);
+	}
+
+	it = m_dic.m_Elem.begin();
+	for (int i = 0; i < (int)m_dic.m_Elem.size(); ++i, ++it)
+	{
+		FIELD_JOB job = { FE_REGION_DOMAIN, it->m_psave, &m_elemData[i] };
+		jobs.push_back(job);
+	}
+
+	it = m_dic.m_Face.begin();
+	for (int i = 0; i < (int)m_dic.m_Face.size(); ++i, ++it)
+	{
+		FIELD_JOB job = { FE_REGION_SURFACE, it->m_psave, &m_faceData[i] };
+		jobs.push_back(job);
+	}
+
+	// evaluate the plot variables that are not thread-safe and collect the others
+	vector<FIELD_JOB*> safeJobs;
+	for (size_t i = 0; i < jobs.size(); ++i)
+	{
+		FIELD_JOB& job = jobs[i];
+		job.fd->m_id.clear();
+		job.fd->m_data.clear();
+		if (job.pd == nullptr) continue;
+
+		if (job.pd->IsThreadSafe()) safeJobs.push_back(&job);
+		else EvalDataField(fem, job.nregion, job.pd, *job.fd);
+	}
+
+	// make sure the mesh's lazily built data exists before the threads access the mesh
+	fem.GetMesh().NodeElementList();
+
+	// evaluate the thread-safe plot variables concurrently
+	// (exceptions cannot leave the parallel region, so we pass the first one on afterwards)
+	std::exception_ptr err = nullptr;
+	const int NJ = (int)safeJobs.size();
+#pragma omp parallel for schedule(dynamic, 1) if (NJ > 1)
+	for (int i = 0; i < NJ; ++i)
+	{
+		FIELD_JOB& job = *safeJobs[i];
+		try {
+			EvalDataField(fem, job.nregion, job.pd, *job.fd);
+		}
+		catch (...)
+		{
+#pragma omp critical (plot_eval_error)
+			if (err == nullptr) err = std::current_exception();
+		}
+	}
+
+	if (err) std::rethrow_exception(err);
+}
+
+//-----------------------------------------------------------------------------
+//! Evaluate a plot variable of the given region type.
+void FEBioPlotFile::EvalDataField(FEModel& fem, int nregion, FEPlotData* pd, FieldData& fd)
+{
+	switch (nregion)
+	{
+	case FE_REGION_NODE   : EvalNodeDataField   (fem, pd, fd); break;
+	case FE_REGION_DOMAIN : EvalDomainDataField (fem, pd, fd); break;
+	case FE_REGION_SURFACE: EvalSurfaceDataField(fem, pd, fd); break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Write the evaluated data of a plot variable to the archive.
+void FEBioPlotFile::WriteDataField(FieldData& fd)
+{
+	for (size_t i = 0; i < fd.m_data.size(); ++i)
+	{
+		m_ar.WriteData(fd.m_id[i], fd.m_data[i].data());
+	}
+
+	// the archive keeps its own copy, so we can release the memory
+	vector<int>().swap(fd.m_id);
+	vector<FEDataStream>().swap(fd.m_data);
+}
+
+//-----------------------------------------------------------------------------
+void FEBioPlotFile::WriteNodeData(FEModel& fem)
+{
+	for (int i=0; i<(int) m_nodeData.size(); ++i)
 	{
 		m_ar.BeginChunk(PLT_STATE_VARIABLE);
 		{
@@ -1489,7 +1618,7 @@ void FEBioPlotFile::WriteNodeData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteNodeDataField(fem, it->m_psave);
+				WriteDataField(m_nodeData[i]);
 			}
 			m_ar.EndChunk();
 		}
@@ -1500,8 +1629,7 @@ void FEBioPlotFile::WriteNodeData(FEModel& fem)
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::WriteDomainData(FEModel& fem)
 {
-	list<DICTIONARY_ITEM>::iterator it = m_dic.m_Elem.begin();
-	for (int i=0; i<(int) m_dic.m_Elem.size(); ++i, ++it)
+	for (int i=0; i<(int) m_elemData.size(); ++i)
 	{
 		m_ar.BeginChunk(PLT_STATE_VARIABLE);
 		{
@@ -1509,7 +1637,7 @@ void FEBioPlotFile::WriteDomainData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteDomainDataField(fem, it->m_psave);
+				WriteDataField(m_elemData[i]);
 			}
 			m_ar.EndChunk();
 		}
@@ -1520,8 +1648,7 @@ void FEBioPlotFile::WriteDomainData(FEModel& fem)
 //-----------------------------------------------------------------------------
 void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
 {
-	list<DICTIONARY_ITEM>::iterator it = m_dic.m_Face.begin();
-	for (int i=0; i<(int) m_dic.m_Face.size(); ++i, ++it)
+	for (int i=0; i<(int) m_faceData.size(); ++i)
 	{
 		m_ar.BeginChunk(PLT_STATE_VARIABLE);
 		{
@@ -1529,7 +1656,7 @@ void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
 			m_ar.WriteChunk(PLT_STATE_VAR_ID, nid);
 			m_ar.BeginChunk(PLT_STATE_VAR_DATA);
 			{
-				if (it->m_psave) WriteSurfaceDataField(fem, it->m_psave);
+				WriteDataField(m_faceData[i]);
 			}
 			m_ar.EndChunk();
 		}
@@ -1538,7 +1665,7 @@ void FEBioPlotFile::WriteSurfaceData(FEModel& fem)
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::EvalNodeDataField(FEModel &fem, FEPlotData* pd, FieldData& fd)
 {
 	// loop over all node sets
 	// right now there is only one, namely the node set of all mesh nodes
@@ -1552,12 +1679,13 @@ void FEBioPlotFile::WriteNodeDataField(FEModel &fem, FEPlotData* pd)
 		// pad mismatches
 		assert(a.size() == N*ndata);
 		if (a.size() != N * ndata) a.resize(N*ndata, 0.f);
-		m_ar.WriteData(0, a.data());
+		fd.m_id.push_back(0);
+		fd.m_data.push_back(std::move(a));
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
+void FEBioPlotFile::EvalSurfaceDataField(FEModel& fem, FEPlotData* pd, FieldData& fd)
 {
 	// loop over all surfaces
 	FEMesh& m = fem.GetMesh();
@@ -1599,7 +1727,8 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 			if (a.size() == nsize)
 			{
 				// assumed padding is already there, or not needed
-				m_ar.WriteData(i + 1, a.data());
+				fd.m_id.push_back(i + 1);
+				fd.m_data.push_back(std::move(a));
 			}
 			else
 			{
@@ -1620,15 +1749,16 @@ void FEBioPlotFile::WriteSurfaceDataField(FEModel& fem, FEPlotData* pd)
 					}
 				}
 
-				// write the padded data
-				m_ar.WriteData(i + 1, b.data());
+				// store the padded data
+				fd.m_id.push_back(i + 1);
+				fd.m_data.push_back(std::move(b));
 			}
 		}
 	}
 }
 
 //-----------------------------------------------------------------------------
-void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
+void FEBioPlotFile::EvalDomainDataField(FEModel &fem, FEPlotData* pd, FieldData& fd)
 {
 	FEMesh& m = fem.GetMesh();
 	int ND = m.Domains();
@@ -1649,7 +1779,7 @@ void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
 
 	// loop over all domains in the item list
 	int N = (int)item.size();
-	for (int i = 0; i<ND; ++i)
+	for (int i = 0; i<N; ++i)
 	{
 		// get the domain
 		FEDomain& D = m.Domain(item[i]);
@@ -1678,13 +1808,14 @@ void FEBioPlotFile::WriteDomainDataField(FEModel &fem, FEPlotData* pd)
 		}
 		assert(nsize > 0);
 
-		// fill data vector and save
+		// fill data vector and store
 		FEDataStream a;
 		a.reserve(nsize);
 		if (pd->Save(D, a))
 		{
 			assert(a.size() == nsize);
-			m_ar.WriteData(item[i] + 1, a.data());
+			fd.m_id.push_back(item[i] + 1);
+			fd.m_data.push_back(std::move(a));
 		}
 	}
 }
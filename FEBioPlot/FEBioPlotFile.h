@@ -265,6 +265,14 @@ public:
 		vec3d	m_r2;	// point 2
 	};
 
+	// The evaluated data of a plot variable. There is one data stream for each
+	// region (mesh, domain, or surface) the variable was saved for.
+	struct FieldData
+	{
+		vector<int>				m_id;		// region ID of each stream
+		vector<FEDataStream>	m_data;		// data streams
+	};
+
 public:
 	FEBioPlotFile(FEModel& fem);
 	~FEBioPlotFile(void);
@@ -292,6 +300,15 @@ public:
 	//! see if the plot file is valid
 	virtual bool IsValid() const;
 
+	//! wait until all states are written to file
+	void Sync() override;
+
+	//! time spent writing the plot file in the background
+	double GetWriteTime() override;
+
+	//! time spent waiting for the background writer
+	double GetWaitTime() override;
+
 	// Write a mesh section
 	bool WriteMeshSection(FEModel& fem);
 
@@ -339,9 +356,14 @@ protected:
 	void WriteObjectsState();
 	void WriteObjectData(PlotObject* po);
 
-	void WriteNodeDataField(FEModel& fem, FEPlotData* pd);
-	void WriteDomainDataField(FEModel& fem, FEPlotData* pd);
-	void WriteSurfaceDataField(FEModel& fem, FEPlotData* pd);
+	// The plot variables of a state are evaluated first (in parallel), and
+	// then written to the archive in dictionary order.
+	void EvaluateStateData(FEModel& fem);
+	void EvalDataField(FEModel& fem, int nregion, FEPlotData* pd, FieldData& fd);
+	void EvalNodeDataField(FEModel& fem, FEPlotData* pd, FieldData& fd);
+	void EvalDomainDataField(FEModel& fem, FEPlotData* pd, FieldData& fd);
+	void EvalSurfaceDataField(FEModel& fem, FEPlotData* pd, FieldData& fd);
+	void WriteDataField(FieldData& fd);
 
 	void WriteMeshState(FEMesh& mesh);
 
@@ -362,6 +384,11 @@ protected:
 
 	vector<PointObject*>	m_Points;
 	vector<LineObject*>		m_Lines;
+
+	// evaluated plot variables of the current state
+	vector<FieldData>	m_nodeData;
+	vector<FieldData>	m_elemData;
+	vector<FieldData>	m_faceData;
 };
 
 //-----------------------------------------------------------------------------
@@ -60,6 +60,15 @@ public:
 	//! see if the plot file is valid
 	virtual bool IsValid() const = 0;
 
+	//! wait until all states are written to file
+	virtual void Sync() {}
+
+	//! time spent writing the plot file in the background (in seconds)
+	virtual double GetWriteTime() { return 0.0; }
+
+	//! time spent waiting for the background writer (in seconds)
+	virtual double GetWaitTime() { return 0.0; }
+
 protected:
 	FEModel*	m_pfem;		//!< pointer to FE model
 };
@@ -32,7 +32,6 @@ SOFTWARE.*/
 
 #ifdef HAVE_ZLIB
 #include "zlib.h"
-static z_stream strm;
 #endif
 
 //=============================================================================
@@ -45,6 +44,12 @@ FileStream::FileStream()
 	m_buf  = new unsigned char[m_bufsize];
 	m_pout = new unsigned char[m_bufsize];
 	m_ncompress = 0;
+	m_fp = 0;
+#ifdef HAVE_ZLIB
+	m_pz = new z_stream;
+#else
+	m_pz = 0;
+#endif
 }
 
 FileStream::~FileStream()
@@ -54,6 +59,10 @@ FileStream::~FileStream()
 	delete [] m_pout;
 	m_buf = 0;
 	m_pout = 0;
+#ifdef HAVE_ZLIB
+	delete (z_stream*) m_pz;
+#endif
+	m_pz = 0;
 }
 
 bool FileStream::Open(const char* szfile)
@@ -84,6 +93,7 @@ void FileStream::Close()
 void FileStream::BeginStreaming()
 {
 #ifdef HAVE_ZLIB
+	z_stream& strm = *((z_stream*) m_pz);
 	if (m_ncompress)
 	{
 		strm.zalloc = Z_NULL;
@@ -98,6 +108,7 @@ void FileStream::EndStreaming()
 {
 	Flush();
 #ifdef HAVE_ZLIB
+	z_stream& strm = *((z_stream*) m_pz);
 	if (m_ncompress)
 	{
 		strm.avail_in = 0;
@@ -149,6 +160,7 @@ void FileStream::Write(void* pd, size_t Size, size_t Count)
 void FileStream::Flush()
 {
 #ifdef HAVE_ZLIB
+	z_stream& strm = *((z_stream*) m_pz);
 	if (m_ncompress)
 	{
 		strm.avail_in = m_current;
@@ -207,6 +219,11 @@ PltArchive::PltArchive()
 	m_pRoot = 0;
 	m_pChunk = 0;
 	m_bSaving = true;
+	m_ncompress = 0;
+
+	m_basync = true;
+	m_npending = 0;
+	m_bquit = false;
 }
 
 PltArchive::~PltArchive()
@@ -219,6 +236,9 @@ void PltArchive::Close()
 	if (m_bSaving)
 	{
 		if (m_pRoot) Flush();
+
+		// make sure everything is written before we close the file
+		StopWriter();
 	}
 	else 
 	{
@@ -237,22 +257,125 @@ void PltArchive::Close()
 
 void PltArchive::SetCompression(int n)
 {
-	if (m_fp) m_fp->SetCompression(n);
+	// Chunk trees that are still queued keep the compression level they were 
+	// created with. The new level is applied to the file stream when the next tree is written.
+	m_ncompress = n;
 }
 
 void PltArchive::Flush()
 {
 	if (m_fp && m_pRoot)
 	{
-		m_fp->BeginStreaming();
-		m_pRoot->Write(m_fp);
-		m_fp->EndStreaming();
+		if (m_basync)
+		{
+			// start the writer thread the first time we need it
+			if (m_writer.joinable() == false)
+			{
+				m_bquit = false;
+				m_npending = 0;
+				m_writer = std::thread(&PltArchive::WriterThread, this);
+			}
+
+			std::unique_lock<std::mutex> lock(m_mutex);
+
+			// wait until there is room in the queue
+			if (m_npending >= MAX_PENDING)
+			{
+				m_waitTime.start();
+				m_cv.wait(lock, [this]() { return m_npending < MAX_PENDING; });
+				m_waitTime.stop();
+			}
+
+			// the writer thread now owns the tree
+			WRITE_TASK task = { m_pRoot, m_ncompress };
+			m_queue.push_back(task);
+			m_npending++;
+			m_cv.notify_all();
+		}
+		else
+		{
+			m_writeTime.start();
+			WriteTree(m_pRoot, m_ncompress);
+			m_writeTime.stop();
+		}
 	}
-	delete m_pRoot;
+	else delete m_pRoot;
 	m_pRoot = 0;
 	m_pChunk = 0;
 }
 
+void PltArchive::WriteTree(OBranch* root, int ncompress)
+{
+	m_fp->SetCompression(ncompress);
+	m_fp->BeginStreaming();
+	root->Write(m_fp);
+	m_fp->EndStreaming();
+	delete root;
+}
+
+void PltArchive::WriterThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_cv.wait(lock, [this]() { return (m_bquit || (m_queue.empty() == false)); });
+
+		// we only quit when all the trees are written
+		if (m_queue.empty()) break;
+
+		WRITE_TASK task = m_queue.front();
+		m_queue.pop_front();
+
+		// write the tree without holding the lock so the solver thread can queue the next one
+		lock.unlock();
+		m_writeTime.start();
+		WriteTree(task.root, task.ncompress);
+		m_writeTime.stop();
+		lock.lock();
+
+		m_npending--;
+		m_cv.notify_all();
+	}
+}
+
+void PltArchive::Sync()
+{
+	if (m_writer.joinable() == false) return;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_npending > 0)
+	{
+		m_waitTime.start();
+		m_cv.wait(lock, [this]() { return (m_npending == 0); });
+		m_waitTime.stop();
+	}
+}
+
+void PltArchive::StopWriter()
+{
+	if (m_writer.joinable() == false) return;
+
+	Sync();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bquit = true;
+		m_cv.notify_all();
+	}
+	m_writer.join();
+}
+
+double PltArchive::GetWriteTime()
+{
+	// the write timer is only updated by the writer thread while a tree is pending
+	Sync();
+	return m_writeTime.GetTime();
+}
+
+double PltArchive::GetWaitTime()
+{
+	return m_waitTime.GetTime();
+}
+
 bool PltArchive::Create(const char* szfile)
 {
 	// attempt to create the file
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FECore/Archive.h"
+#include "FECore/Timer.h"
 #include <assert.h>
 #include <string>
 #include <string.h>
@@ -35,6 +36,10 @@ SOFTWARE.*/
 #include <list>
 #include <vector>
 #include <stack>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -71,6 +76,7 @@ private:
 	unsigned char*	m_buf;	//!< buffer
 	unsigned char*	m_pout;	//!< temp buffer when writing
 	int		m_ncompress;	//!< compression level
+	void*	m_pz;			//!< zlib stream (only used when compressing)
 };
 
 class OBranch;
@@ -233,8 +239,15 @@ protected:
 
 //-----------------------------------------------------------------------------
 //! Implementation of an archiving class. Will be used by the FEBioPlotFile class.
+//! When writing, the chunk tree of a completed root chunk is handed to a background
+//! thread that serializes, compresses, and writes it to file. The solver thread can
+//! then continue with the next time step while the output is written. At most
+//! MAX_PENDING trees can be waiting to be written; if the queue is full, the solver 
+//! thread waits until the writer thread has processed a tree.
 class PltArchive : public Archive
 {
+	enum { MAX_PENDING = 2 };
+
 protected:
 	// CHUNK data structure for reading
 	struct CHUNK
@@ -244,6 +257,13 @@ protected:
 		unsigned int	nsize;	// size of chunk
 	};
 
+	// a chunk tree that is waiting to be written
+	struct WRITE_TASK
+	{
+		OBranch*	root;		// root of chunk tree
+		int			ncompress;	// compression level
+	};
+
 public:
 	//! constructor
 	PltArchive();
@@ -346,9 +366,46 @@ public:
 
 	bool IsValid() const { return (m_fp != 0); }
 
+public:
+	// --- Background writing ---
+
+	// use the background writer thread (on by default)
+	void SetAsync(bool b) { m_basync = b; }
+
+	// wait until all completed chunk trees are written to file
+	void Sync();
+
+	// time spent in the writer thread writing chunk trees
+	double GetWriteTime();
+
+	// time the caller waited for the writer thread
+	double GetWaitTime();
+
+protected:
+	// write a chunk tree to file
+	void WriteTree(OBranch* root, int ncompress);
+
+	// writer thread's main loop
+	void WriterThread();
+
+	// stop the writer thread
+	void StopWriter();
+
 protected:
 	FileStream*	m_fp;		// pointer to file stream
 	bool		m_bSaving;	// read or write mode?
+	int			m_ncompress;	// compression level of next chunk tree
+
+	// background writer
+	bool					m_basync;		// use the writer thread
+	std::thread				m_writer;		// the writer thread
+	std::mutex				m_mutex;		// protects the queue data
+	std::condition_variable	m_cv;			// signals changes to the queue data
+	std::deque<WRITE_TASK>	m_queue;		// chunk trees waiting to be written
+	int						m_npending;		// trees queued or being written
+	bool					m_bquit;		// tells the writer thread to stop
+	Timer					m_writeTime;	// time spent by writer thread
+	Timer					m_waitTime;		// time caller waited for writer thread
 
 	// write data
 	OBranch*	m_pRoot;	// chunk tree root
@@ -0,0 +1,190 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEAssemblyBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <math.h>
+
+#ifdef WIN32
+extern "C" int __cdecl omp_get_max_threads();
+extern "C" void __cdecl omp_set_num_threads(int);
+#else
+extern "C" int omp_get_max_threads();
+extern "C" void omp_set_num_threads(int);
+#endif
+
+//-----------------------------------------------------------------------------
+FEAssemblyBenchmark::FEAssemblyBenchmark(FEModel* pfem) : FECoreTask(pfem)
+{
+	m_iters = 5;
+}
+
+//-----------------------------------------------------------------------------
+// initialize the benchmark
+bool FEAssemblyBenchmark::Init(const char* sz)
+{
+	FEModel& fem = *GetFEModel();
+
+	// do the FE initialization
+	if (fem.Init() == false) return false;
+
+	// activate the first step and initialize its solver
+	fem.SetCurrentStepIndex(0);
+	FEAnalysis* step = fem.GetCurrentStep();
+	if (step->Activate() == false) return false;
+	if (step->InitSolver() == false) return false;
+
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if (solver == nullptr)
+	{
+		feLogError("The assembly benchmark requires a Newton solver.");
+		return false;
+	}
+
+	// initialize the first time step
+	FETimeInfo& tp = fem.GetTime();
+	tp.timeIncrement = step->m_dt0;
+	tp.currentTime += step->m_dt0;
+	if (solver->InitStep(tp.currentTime) == false) return false;
+
+	// build the stiffness matrix profile
+	return solver->CreateStiffness(true);
+}
+
+//-----------------------------------------------------------------------------
+// time the stiffness matrix evaluation
+double FEAssemblyBenchmark::TimeStiffness(int nthreads, bool bcolored, bool bscatter)
+{
+	FEModel& fem = *GetFEModel();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+	FEGlobalMatrix& K = *solver->GetStiffnessMatrix();
+
+	omp_set_num_threads(nthreads);
+	K.SetColoredAssembly(bcolored);
+	K.SetScatterMaps(bscatter);
+
+	// evaluate once to make sure the assembly maps are built
+	K.Zero();
+	solver->StiffnessMatrix();
+
+	Timer timer;
+	for (int i = 0; i < m_iters; ++i)
+	{
+		K.Zero();
+		timer.start();
+		solver->StiffnessMatrix();
+		timer.stop();
+	}
+
+	return timer.GetTime() / m_iters;
+}
+
+//-----------------------------------------------------------------------------
+// run the benchmark
+bool FEAssemblyBenchmark::Run()
+{
+	FEModel& fem = *GetFEModel();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+	FEGlobalMatrix& K = *solver->GetStiffnessMatrix();
+	SparseMatrix& A = K;
+
+	const int maxThreads = omp_get_max_threads();
+
+	feLog("\nAssembly benchmark\n");
+	feLog("\tNr of equations ........................... : %d\n", K.Rows());
+	feLog("\tNr of nonzeroes in stiffness matrix ....... : %d\n", K.NonZeroes());
+	feLog("\tNr of evaluations per measurement ......... : %d\n\n", m_iters);
+	feLog("   threads   search (s)   cached (s)  colored (s)   speedup\n");
+	feLog("--------------------------------------------------------------\n");
+
+	// reference values from the serial atomic assembly
+	std::vector<double> K0;
+	bool bok = true;
+	for (int nt = 1; ; nt *= 2)
+	{
+		if (nt > maxThreads) nt = maxThreads;
+
+		// atomic assembly, searching the sparsity pattern for each element
+		double t0 = TimeStiffness(nt, false, false);
+		if (A.Values() && K0.empty()) K0.assign(A.Values(), A.Values() + A.NonZeroes());
+
+		// atomic assembly with cached scatter maps
+		double t1 = TimeStiffness(nt, false, true);
+		if (CompareMatrix(K0) == false) bok = false;
+
+		// colored assembly with cached scatter maps
+		double t2 = TimeStiffness(nt, true, true);
+		if (CompareMatrix(K0) == false) bok = false;
+
+		feLog("%10d %12.5lg %12.5lg %12.5lg %9.2lf\n", nt, t0, t1, t2, (t2 > 0 ? t0 / t2 : 0.0));
+
+		if (nt == maxThreads) break;
+	}
+
+	// restore the state
+	omp_set_num_threads(maxThreads);
+	K.SetColoredAssembly(solver->m_bcoloredAssembly);
+	K.SetScatterMaps(solver->m_bscatterMaps);
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+// compare the current stiffness matrix to the reference values
+bool FEAssemblyBenchmark::CompareMatrix(const std::vector<double>& K0)
+{
+	FEModel& fem = *GetFEModel();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+	SparseMatrix& A = *solver->GetStiffnessMatrix()->GetSparseMatrixPtr();
+
+		// the assembly should produce the same matrix (up to round-off)
+	if (A.Values() == nullptr) return true;
+
+	const double* pv = A.Values();
+	double kmax = 0.0, dmax = 0.0;
+	for (size_t i = 0; i < K0.size(); ++i)
+	{
+		if (fabs(K0[i]) > kmax) kmax = fabs(K0[i]);
+		double d = fabs(pv[i] - K0[i]);
+		if (d > dmax) dmax = d;
+	}
+	if (dmax > 1e-12*kmax)
+	{
+		feLogWarning("Stiffness matrix differs from reference assembly (max. difference = %lg)", dmax);
+		return false;
+	}
+
+	return true;
+}
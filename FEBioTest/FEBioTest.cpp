@@ -35,6 +35,9 @@ SOFTWARE.*/
 #include "FEJFNKTangentDiagnostic.h"
 #include "FEBioEigenSolver.h"
 #include "FEResetTest.h"
+#include "FEAssemblyBenchmark.h"
+#include "FEMaterialPointBenchmark.h"
+#include "FEModelBenchmark.h"
 
 namespace FEBioTest
 {
@@ -46,5 +49,8 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEJFNKTangentDiagnostic, "jfnk tangent test");
 	REGISTER_FECORE_CLASS(FEBioEigenSolver, "eigen");
 	REGISTER_FECORE_CLASS(FEResetTest, "reset_test");
+	REGISTER_FECORE_CLASS(FEAssemblyBenchmark, "assembly_benchmark");
+	REGISTER_FECORE_CLASS(FEMaterialPointBenchmark, "material_point_benchmark");
+	REGISTER_FECORE_CLASS(FEModelBenchmark, "model_benchmark");
 }
 }
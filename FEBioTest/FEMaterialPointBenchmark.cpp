@@ -0,0 +1,166 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEMaterialPointBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FEDomain.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <FEBioMech/FEElasticMaterial.h>
+
+#ifdef WIN32
+extern "C" int __cdecl omp_get_max_threads();
+#else
+extern "C" int omp_get_max_threads();
+#endif
+
+//-----------------------------------------------------------------------------
+FEMaterialPointBenchmark::FEMaterialPointBenchmark(FEModel* pfem) : FECoreTask(pfem)
+{
+	m_iters = 20;
+}
+
+//-----------------------------------------------------------------------------
+// initialize the benchmark
+bool FEMaterialPointBenchmark::Init(const char* sz)
+{
+	FEModel& fem = *GetFEModel();
+
+	// do the FE initialization
+	if (fem.Init() == false) return false;
+
+	// collect the integration points of all elastic solid domains
+	// and give them a (non-trivial) deformation
+	mat3d F(1.05, 0.02, 0.0, 0.0, 0.98, 0.01, 0.01, 0.0, 1.02);
+	double J = F.det();
+
+	FEMesh& mesh = fem.GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
+		if (mat == nullptr) continue;
+
+		for (int j = 0; j < dom.Elements(); ++j)
+		{
+			FEElement& el = dom.ElementRef(j);
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEMaterialPoint* mp = el.GetMaterialPoint(n);
+				FEElasticMaterialPoint* ep = mp->ExtractData<FEElasticMaterialPoint>();
+				if (ep == nullptr) continue;
+				ep->m_F = F;
+				ep->m_J = J;
+
+				m_pt.push_back(mp);
+				m_mat.push_back(mat);
+			}
+		}
+	}
+
+	if (m_pt.empty())
+	{
+		feLogError("The material point benchmark requires an elastic solid domain.");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// run the benchmark
+bool FEMaterialPointBenchmark::Run()
+{
+	const int N = (int)m_pt.size();
+	const double scale = 1e9 / ((double)N * m_iters);
+
+	// checksums, so the compiler cannot skip the evaluations
+	double sum[5] = { 0 };
+
+	// search the material point data with dynamic_cast
+	Timer t0;
+	t0.start();
+	for (int k = 0; k < m_iters; ++k)
+		for (int i = 0; i < N; ++i) sum[0] += m_pt[i]->FindData<FEElasticMaterialPoint>()->m_J;
+	t0.stop();
+
+	// extract the data using the cached offsets
+	Timer t1;
+	t1.start();
+	for (int k = 0; k < m_iters; ++k)
+		for (int i = 0; i < N; ++i) sum[1] += m_pt[i]->ExtractData<FEElasticMaterialPoint>()->m_J;
+	t1.stop();
+
+	// stress evaluation
+	Timer t2;
+	t2.start();
+	for (int k = 0; k < m_iters; ++k)
+		for (int i = 0; i < N; ++i) sum[2] += m_mat[i]->Stress(*m_pt[i]).tr();
+	t2.stop();
+
+	// tangent evaluation
+	Timer t3;
+	t3.start();
+	for (int k = 0; k < m_iters; ++k)
+		for (int i = 0; i < N; ++i) sum[3] += m_mat[i]->SolidTangent(*m_pt[i])(0, 0, 0, 0);
+	t3.stop();
+
+	// stress and tangent evaluation on all threads
+	const int nt = omp_get_max_threads();
+	Timer t4;
+	t4.start();
+	for (int k = 0; k < m_iters; ++k)
+	{
+		double s = 0.0;
+#pragma omp parallel for reduction(+:s)
+		for (int i = 0; i < N; ++i)
+		{
+			s += m_mat[i]->Stress(*m_pt[i]).tr();
+			s += m_mat[i]->SolidTangent(*m_pt[i])(0, 0, 0, 0);
+		}
+		sum[4] += s;
+	}
+	t4.stop();
+
+	feLog("\nMaterial point benchmark\n");
+	feLog("\tNr of integration points .................. : %d\n", N);
+	feLog("\tNr of evaluations per point ............... : %d\n\n", m_iters);
+	feLog("                                   time/point (ns)    points/s\n");
+	feLog("-----------------------------------------------------------------\n");
+	feLog("search data (dynamic_cast) ...... : %12.2lf %12.4lg\n", t0.GetTime()*scale, 1e9 / (t0.GetTime()*scale));
+	feLog("extract data (cached offset) .... : %12.2lf %12.4lg\n", t1.GetTime()*scale, 1e9 / (t1.GetTime()*scale));
+	feLog("stress .......................... : %12.2lf %12.4lg\n", t2.GetTime()*scale, 1e9 / (t2.GetTime()*scale));
+	feLog("tangent ......................... : %12.2lf %12.4lg\n", t3.GetTime()*scale, 1e9 / (t3.GetTime()*scale));
+	feLog("stress + tangent (%3d threads) .. : %12.2lf %12.4lg\n", nt, t4.GetTime()*scale, 1e9 / (t4.GetTime()*scale));
+	feLog("\nchecksums: %lg %lg %lg %lg %lg\n", sum[0], sum[1], sum[2], sum[3], sum[4]);
+
+	return (sum[0] == sum[1]);
+}
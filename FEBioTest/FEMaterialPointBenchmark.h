@@ -0,0 +1,59 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+#include <vector>
+
+class FEMaterialPoint;
+class FESolidMaterial;
+
+//-----------------------------------------------------------------------------
+// This task measures the throughput of the stress and tangent evaluations per 
+// integration point for the elastic solid domains of a model. It also compares 
+// the cost of finding the elastic material point data with and without the 
+// cached offsets of the material point layout.
+class FEMaterialPointBenchmark : public FECoreTask
+{
+public:
+	// constructor
+	FEMaterialPointBenchmark(FEModel* pfem);
+
+	// initialize the benchmark
+	bool Init(const char* sz) override;
+
+	// run the benchmark
+	bool Run() override;
+
+private:
+	int		m_iters;	// number of evaluations per integration point
+
+	std::vector<FEMaterialPoint*>	m_pt;	// integration points
+	std::vector<FESolidMaterial*>	m_mat;	// material of each integration point
+};
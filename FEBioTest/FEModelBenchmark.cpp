@@ -0,0 +1,536 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEModelBenchmark.h"
+#include <FEBioLib/FEBioModel.h>
+#include <FEBioPlot/PlotFile.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FECoreKernel.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/FESurfacePairConstraint.h>
+#include <FECore/LinearSolver.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <FECore/vec3d.h>
+#include <stdio.h>
+
+#ifdef WIN32
+extern "C" int __cdecl omp_get_max_threads();
+extern "C" void __cdecl omp_set_num_threads(int);
+#else
+extern "C" int omp_get_max_threads();
+extern "C" void omp_set_num_threads(int);
+#endif
+
+//-----------------------------------------------------------------------------
+// the benchmark models
+static const char* szmodels[] = { "solid", "biphasic", "contact", "fluid", "shell" };
+
+//-----------------------------------------------------------------------------
+// the models whose module uses a non-symmetric stiffness matrix by default
+static bool IsNonSymmetricModel(const std::string& model)
+{
+	return ((model == "biphasic") || (model == "fluid"));
+}
+
+//-----------------------------------------------------------------------------
+// see if the default linear solver can solve non-symmetric systems
+static bool DefaultSolverSupportsNonSymmetric(FEModel* fem)
+{
+	FECoreKernel& fecore = FECoreKernel::GetInstance();
+	LinearSolver* ls = fecore.CreateDefaultLinearSolver(fem);
+	if (ls == nullptr) return false;
+
+	SparseMatrix* A = ls->CreateSparseMatrix(REAL_UNSYMMETRIC);
+	bool bok = (A != nullptr);
+	delete ls;
+	delete A;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+// Helper class for writing a structured grid of hex8 elements
+class FEBenchGrid
+{
+public:
+	FEBenchGrid(int nx, int ny, int nz, vec3d r0, vec3d r1, int noff) : m_nx(nx), m_ny(ny), m_nz(nz), m_r0(r0), m_r1(r1), m_noff(noff) {}
+
+	int Node(int i, int j, int k) const { return m_noff + 1 + i + (m_nx + 1)*(j + (m_ny + 1)*k); }
+	int Nodes() const { return (m_nx + 1)*(m_ny + 1)*(m_nz + 1); }
+	int Elements() const { return m_nx*m_ny*m_nz; }
+
+	void WriteNodes(FILE* fp) const
+	{
+		for (int k = 0; k <= m_nz; ++k)
+			for (int j = 0; j <= m_ny; ++j)
+				for (int i = 0; i <= m_nx; ++i)
+				{
+					double x = m_r0.x + (m_r1.x - m_r0.x)*i / m_nx;
+					double y = m_r0.y + (m_r1.y - m_r0.y)*j / m_ny;
+					double z = m_r0.z + (m_r1.z - m_r0.z)*k / m_nz;
+					fprintf(fp, "\t\t\t<node id=\"%d\">%lg,%lg,%lg</node>\n", Node(i, j, k), x, y, z);
+				}
+	}
+
+	int WriteElements(FILE* fp, int eoff) const
+	{
+		for (int k = 0; k < m_nz; ++k)
+			for (int j = 0; j < m_ny; ++j)
+				for (int i = 0; i < m_nx; ++i)
+				{
+					fprintf(fp, "\t\t\t<elem id=\"%d\">%d,%d,%d,%d,%d,%d,%d,%d</elem>\n", ++eoff,
+						Node(i, j, k), Node(i + 1, j, k), Node(i + 1, j + 1, k), Node(i, j + 1, k),
+						Node(i, j, k + 1), Node(i + 1, j, k + 1), Node(i + 1, j + 1, k + 1), Node(i, j + 1, k + 1));
+				}
+		return eoff;
+	}
+
+	// write the nodes of the face where the given coordinate is at its lower (0) or upper (1) bound
+	void WriteFaceNodes(FILE* fp, int ncoord, int nside) const
+	{
+		int n[3] = { m_nx, m_ny, m_nz };
+		for (int k = 0; k <= m_nz; ++k)
+			for (int j = 0; j <= m_ny; ++j)
+				for (int i = 0; i <= m_nx; ++i)
+				{
+					int m[3] = { i, j, k };
+					if (m[ncoord] == nside*n[ncoord]) fprintf(fp, "\t\t\t<node id=\"%d\"/>\n", Node(i, j, k));
+				}
+	}
+
+	// write the facets of the bottom (z = min) or top (z = max) face, with outward normals
+	void WriteZFacets(FILE* fp, bool top) const
+	{
+		int k = (top ? m_nz : 0), nf = 0;
+		for (int j = 0; j < m_ny; ++j)
+			for (int i = 0; i < m_nx; ++i)
+			{
+				int n0 = Node(i, j, k), n1 = Node(i + 1, j, k), n2 = Node(i + 1, j + 1, k), n3 = Node(i, j + 1, k);
+				if (top) fprintf(fp, "\t\t\t<quad4 id=\"%d\">%d,%d,%d,%d</quad4>\n", ++nf, n0, n1, n2, n3);
+				else fprintf(fp, "\t\t\t<quad4 id=\"%d\">%d,%d,%d,%d</quad4>\n", ++nf, n0, n3, n2, n1);
+			}
+	}
+
+private:
+	int		m_nx, m_ny, m_nz;
+	vec3d	m_r0, m_r1;
+	int		m_noff;
+};
+
+//-----------------------------------------------------------------------------
+FEModelBenchmark::FEModelBenchmark(FEModel* pfem) : FECoreTask(pfem)
+{
+	m_iters = 3;
+	m_size.push_back(8);
+	m_size.push_back(16);
+	m_size.push_back(24);
+}
+
+//-----------------------------------------------------------------------------
+// initialize the benchmark
+bool FEModelBenchmark::Init(const char* sz)
+{
+	m_csv = ((sz && sz[0]) ? sz : "febio_bench.csv");
+
+	// temporary files are written next to the CSV file
+	size_t n = m_csv.rfind('.');
+	m_base = (n == std::string::npos ? m_csv : m_csv.substr(0, n));
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// write the input file of a benchmark model
+bool FEModelBenchmark::WriteModel(const std::string& model, int n, const char* szfile)
+{
+	FILE* fp = fopen(szfile, "wt");
+	if (fp == nullptr) return false;
+
+	const char* szmodule = "solid";
+	if (model == "biphasic") szmodule = "biphasic";
+	else if (model == "fluid") szmodule = "fluid";
+
+	fprintf(fp, "<?xml version=\"1.0\" encoding=\"ISO-8859-1\"?>\n");
+	fprintf(fp, "<febio_spec version=\"2.5\">\n");
+	fprintf(fp, "\t<Module type=\"%s\"/>\n", szmodule);
+	fprintf(fp, "\t<Control>\n\t\t<time_steps>1</time_steps>\n\t\t<step_size>0.1</step_size>\n\t\t<plot_level>PLOT_MAJOR_ITRS</plot_level>\n");
+	// The symmetry of the stiffness matrix is left at each module's default
+	// (e.g. the fluid and biphasic solvers are non-symmetric), so that the
+	// timings reflect the models as they are normally run.
+	fprintf(fp, "\t</Control>\n");
+
+	// materials
+	fprintf(fp, "\t<Material>\n");
+	if (model == "biphasic")
+	{
+		fprintf(fp, "\t\t<material id=\"1\" type=\"biphasic\">\n");
+		fprintf(fp, "\t\t\t<phi0>0.2</phi0>\n");
+		fprintf(fp, "\t\t\t<solid type=\"neo-Hookean\">\n\t\t\t\t<E>1</E>\n\t\t\t\t<v>0.3</v>\n\t\t\t</solid>\n");
+		fprintf(fp, "\t\t\t<permeability type=\"perm-const-iso\">\n\t\t\t\t<perm>0.001</perm>\n\t\t\t</permeability>\n");
+		fprintf(fp, "\t\t</material>\n");
+	}
+	else if (model == "fluid")
+	{
+		fprintf(fp, "\t\t<material id=\"1\" type=\"fluid\">\n");
+		fprintf(fp, "\t\t\t<density>1</density>\n\t\t\t<k>1</k>\n");
+		fprintf(fp, "\t\t\t<viscous type=\"Newtonian fluid\">\n\t\t\t\t<mu>0.001</mu>\n\t\t\t\t<kappa>0</kappa>\n\t\t\t</viscous>\n");
+		fprintf(fp, "\t\t</material>\n");
+	}
+	else
+	{
+		int nmat = (model == "contact" ? 2 : 1);
+		for (int i = 1; i <= nmat; ++i)
+			fprintf(fp, "\t\t<material id=\"%d\" type=\"neo-Hookean\">\n\t\t\t<E>1</E>\n\t\t\t<v>0.3</v>\n\t\t</material>\n", i);
+	}
+	fprintf(fp, "\t</Material>\n");
+
+	// geometry
+	fprintf(fp, "\t<Geometry>\n");
+	if (model == "shell")
+	{
+		fprintf(fp, "\t\t<Nodes name=\"Plate\">\n");
+		for (int j = 0; j <= n; ++j)
+			for (int i = 0; i <= n; ++i) fprintf(fp, "\t\t\t<node id=\"%d\">%lg,%lg,0</node>\n", 1 + i + (n + 1)*j, (double)i / n, (double)j / n);
+		fprintf(fp, "\t\t</Nodes>\n");
+		fprintf(fp, "\t\t<Elements type=\"quad4\" mat=\"1\" name=\"Plate\">\n");
+		for (int j = 0; j < n; ++j)
+			for (int i = 0; i < n; ++i)
+			{
+				int n0 = 1 + i + (n + 1)*j;
+				fprintf(fp, "\t\t\t<elem id=\"%d\">%d,%d,%d,%d</elem>\n", 1 + i + n*j, n0, n0 + 1, n0 + n + 2, n0 + n + 1);
+			}
+		fprintf(fp, "\t\t</Elements>\n");
+		fprintf(fp, "\t\t<NodeSet name=\"fixed\">\n");
+		for (int j = 0; j <= n; ++j) fprintf(fp, "\t\t\t<node id=\"%d\"/>\n", 1 + (n + 1)*j);
+		fprintf(fp, "\t\t</NodeSet>\n");
+	}
+	else if (model == "contact")
+	{
+		int nz = (n < 2 ? 1 : n / 2);
+		FEBenchGrid lower(n, n, nz, vec3d(0, 0, 0), vec3d(1, 1, 0.5), 0);
+		FEBenchGrid upper(n, n, nz, vec3d(0, 0, 0.5), vec3d(1, 1, 1), lower.Nodes());
+		fprintf(fp, "\t\t<Nodes name=\"Blocks\">\n");
+		lower.WriteNodes(fp);
+		upper.WriteNodes(fp);
+		fprintf(fp, "\t\t</Nodes>\n");
+		fprintf(fp, "\t\t<Elements type=\"hex8\" mat=\"1\" name=\"Lower\">\n");
+		int ne = lower.WriteElements(fp, 0);
+		fprintf(fp, "\t\t</Elements>\n");
+		fprintf(fp, "\t\t<Elements type=\"hex8\" mat=\"2\" name=\"Upper\">\n");
+		upper.WriteElements(fp, ne);
+		fprintf(fp, "\t\t</Elements>\n");
+		fprintf(fp, "\t\t<NodeSet name=\"fixed\">\n");
+		lower.WriteFaceNodes(fp, 2, 0);
+		upper.WriteFaceNodes(fp, 2, 1);
+		fprintf(fp, "\t\t</NodeSet>\n");
+		fprintf(fp, "\t\t<Surface name=\"primary\">\n");
+		lower.WriteZFacets(fp, true);
+		fprintf(fp, "\t\t</Surface>\n");
+		fprintf(fp, "\t\t<Surface name=\"secondary\">\n");
+		upper.WriteZFacets(fp, false);
+		fprintf(fp, "\t\t</Surface>\n");
+		fprintf(fp, "\t\t<SurfacePair name=\"contact\">\n\t\t\t<master surface=\"primary\"/>\n\t\t\t<slave surface=\"secondary\"/>\n\t\t</SurfacePair>\n");
+	}
+	else if (model == "fluid")
+	{
+		// channel along the x-axis
+		int ny = (n < 2 ? 1 : n / 2);
+		FEBenchGrid grid(2 * n, ny, ny, vec3d(0, 0, 0), vec3d(2, 0.5, 0.5), 0);
+		fprintf(fp, "\t\t<Nodes name=\"Channel\">\n");
+		grid.WriteNodes(fp);
+		fprintf(fp, "\t\t</Nodes>\n");
+		fprintf(fp, "\t\t<Elements type=\"hex8\" mat=\"1\" name=\"Channel\">\n");
+		grid.WriteElements(fp, 0);
+		fprintf(fp, "\t\t</Elements>\n");
+		fprintf(fp, "\t\t<NodeSet name=\"walls\">\n");
+		grid.WriteFaceNodes(fp, 1, 0);
+		grid.WriteFaceNodes(fp, 1, 1);
+		grid.WriteFaceNodes(fp, 2, 0);
+		grid.WriteFaceNodes(fp, 2, 1);
+		fprintf(fp, "\t\t</NodeSet>\n");
+		fprintf(fp, "\t\t<NodeSet name=\"inlet\">\n");
+		grid.WriteFaceNodes(fp, 0, 0);
+		fprintf(fp, "\t\t</NodeSet>\n");
+	}
+	else
+	{
+		FEBenchGrid grid(n, n, n, vec3d(0, 0, 0), vec3d(1, 1, 1), 0);
+		fprintf(fp, "\t\t<Nodes name=\"Cube\">\n");
+		grid.WriteNodes(fp);
+		fprintf(fp, "\t\t</Nodes>\n");
+		fprintf(fp, "\t\t<Elements type=\"hex8\" mat=\"1\" name=\"Cube\">\n");
+		grid.WriteElements(fp, 0);
+		fprintf(fp, "\t\t</Elements>\n");
+		fprintf(fp, "\t\t<NodeSet name=\"fixed\">\n");
+		grid.WriteFaceNodes(fp, 2, 0);
+		fprintf(fp, "\t\t</NodeSet>\n");
+		fprintf(fp, "\t\t<NodeSet name=\"drained\">\n");
+		grid.WriteFaceNodes(fp, 2, 1);
+		fprintf(fp, "\t\t</NodeSet>\n");
+	}
+	fprintf(fp, "\t</Geometry>\n");
+
+	if (model == "shell")
+	{
+		fprintf(fp, "\t<MeshData>\n\t\t<ElementData var=\"shell thickness\" elem_set=\"Plate\">0.01,0.01,0.01,0.01</ElementData>\n\t</MeshData>\n");
+	}
+
+	// boundary conditions
+	fprintf(fp, "\t<Boundary>\n");
+	if (model == "fluid")
+	{
+		fprintf(fp, "\t\t<fix bc=\"wx,wy,wz\" node_set=\"walls\"/>\n");
+		fprintf(fp, "\t\t<fix bc=\"wy,wz\" node_set=\"inlet\"/>\n");
+	}
+	else if (model == "shell") fprintf(fp, "\t\t<fix bc=\"x,y,z,sx,sy,sz\" node_set=\"fixed\"/>\n");
+	else
+	{
+		fprintf(fp, "\t\t<fix bc=\"x,y,z\" node_set=\"fixed\"/>\n");
+		if (model == "biphasic") fprintf(fp, "\t\t<fix bc=\"p\" node_set=\"drained\"/>\n");
+	}
+	fprintf(fp, "\t</Boundary>\n");
+
+	if (model == "contact")
+	{
+		fprintf(fp, "\t<Contact>\n\t\t<contact type=\"sliding-elastic\" surface_pair=\"contact\">\n");
+		fprintf(fp, "\t\t\t<penalty>1</penalty>\n\t\t\t<auto_penalty>1</auto_penalty>\n\t\t\t<tolerance>0.01</tolerance>\n");
+		fprintf(fp, "\t\t</contact>\n\t</Contact>\n");
+	}
+
+	// plot output
+	fprintf(fp, "\t<Output>\n\t\t<plotfile type=\"febio\">\n");
+	if (model == "fluid")
+	{
+		fprintf(fp, "\t\t\t<var type=\"fluid velocity\"/>\n\t\t\t<var type=\"fluid pressure\"/>\n");
+	}
+	else
+	{
+		fprintf(fp, "\t\t\t<var type=\"displacement\"/>\n\t\t\t<var type=\"stress\"/>\n");
+		if (model == "biphasic") fprintf(fp, "\t\t\t<var type=\"effective fluid pressure\"/>\n");
+	}
+	fprintf(fp, "\t\t</plotfile>\n\t</Output>\n");
+
+	fprintf(fp, "</febio_spec>\n");
+	fclose(fp);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// build one benchmark model
+bool FEModelBenchmark::BuildModel(FEBioModel& fem, const std::string& model, int n)
+{
+	std::string sfeb = m_base + "_model.feb";
+	if (WriteModel(model, n, sfeb.c_str()) == false) return false;
+
+	fem.SetLogLevel(0);
+	fem.SetPlotFilename(m_base + "_model.xplt");
+	fem.BlockLog();
+	bool bret = fem.Input(sfeb.c_str()) && fem.Init();
+	remove(sfeb.c_str());
+	if (bret == false) return false;
+
+	// activate the first step and initialize its solver
+	fem.SetCurrentStepIndex(0);
+	FEAnalysis* step = fem.GetCurrentStep();
+	if (step->Activate() == false) return false;
+	if (step->InitSolver() == false) return false;
+
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if (solver == nullptr) return false;
+
+	// initialize the first time step
+	FETimeInfo& tp = fem.GetTime();
+	tp.timeIncrement = step->m_dt0;
+	tp.currentTime += step->m_dt0;
+	if (solver->InitStep(tp.currentTime) == false) return false;
+
+	// build the stiffness matrix profile
+	if (solver->CreateStiffness(true) == false) return false;
+
+	// open the plot file
+	PlotFile* plt = fem.GetPlotFile();
+	if (plt && (plt->Open(fem, fem.GetPlotFileName().c_str()) == false)) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// time the parts of the model with the given number of threads
+bool FEModelBenchmark::TimeModel(FEBioModel& fem, int nthreads, Timing& t)
+{
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+	FEGlobalMatrix& K = *solver->GetStiffnessMatrix();
+	LinearSolver* ls = solver->GetLinearSolver();
+	int neq = solver->NumberOfEquations();
+
+	omp_set_num_threads(nthreads);
+
+	Timer assembly, residual, factor, backsolve, contact, output;
+	std::vector<double> R(neq), u(neq);
+	for (int i = 0; i < m_iters; ++i)
+	{
+		// contact search
+		contact.start();
+		for (int j = 0; j < fem.SurfacePairConstraints(); ++j)
+		{
+			FESurfacePairConstraint* pc = fem.SurfacePairConstraint(j);
+			if (pc->IsActive()) pc->Update();
+		}
+		contact.stop();
+
+		// stiffness assembly
+		assembly.start();
+		K.Zero();
+		solver->StiffnessMatrix();
+		assembly.stop();
+
+		// residual evaluation
+		residual.start();
+		solver->Residual(R);
+		residual.stop();
+
+		// linear solve
+		factor.start();
+		bool bret = ls->Factor();
+		factor.stop();
+		if (bret == false) return false;
+
+		backsolve.start();
+		bret = ls->BackSolve(u, R);
+		backsolve.stop();
+		if (bret == false) return false;
+
+		// plot file output
+		PlotFile* plt = fem.GetPlotFile();
+		if (plt)
+		{
+			output.start();
+			plt->Write(fem, (float)fem.GetTime().currentTime);
+			plt->Sync();
+			output.stop();
+		}
+	}
+
+	t.assembly  = assembly.GetTime() / m_iters;
+	t.residual  = residual.GetTime() / m_iters;
+	t.factor    = factor.GetTime() / m_iters;
+	t.backsolve = backsolve.GetTime() / m_iters;
+	t.contact   = contact.GetTime() / m_iters;
+	t.output    = output.GetTime() / m_iters;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// run the benchmark
+bool FEModelBenchmark::Run()
+{
+	FILE* fp = fopen(m_csv.c_str(), "wt");
+	if (fp == nullptr)
+	{
+		feLogError("Failed creating benchmark file %s", m_csv.c_str());
+		return false;
+	}
+	fprintf(fp, "model,size,elements,equations,nonzeroes,threads,assembly,residual,factor,backsolve,contact,output\n");
+
+	const int maxThreads = omp_get_max_threads();
+
+	feLog("\nModel benchmark (times in seconds per evaluation)\n\n");
+	feLog("    model  size  elements  equations threads  assembly  residual    factor backsolve   contact    output\n");
+	feLog("-----------------------------------------------------------------------------------------------------------\n");
+
+	const bool bnonsymm = DefaultSolverSupportsNonSymmetric(GetFEModel());
+
+	bool bok = true;
+	int nmodels = sizeof(szmodels) / sizeof(const char*);
+	for (int m = 0; m < nmodels; ++m)
+	{
+		// The models use the default matrix symmetry of their module, so the ones that
+		// need a non-symmetric matrix are skipped when the default solver can't handle them.
+		if (IsNonSymmetricModel(szmodels[m]) && (bnonsymm == false))
+		{
+			feLogWarning("Skipping benchmark model %s: the default linear solver does not support non-symmetric matrices.", szmodels[m]);
+			continue;
+		}
+
+		for (size_t s = 0; s < m_size.size(); ++s)
+		{
+			int n = m_size[s];
+
+			FEBioModel fem;
+			if (BuildModel(fem, szmodels[m], n) == false)
+			{
+				feLogError("Failed building benchmark model %s (size %d)", szmodels[m], n);
+				bok = false;
+				continue;
+			}
+
+			int nelems = fem.GetMesh().Elements();
+			FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(fem.GetCurrentStep()->GetFESolver());
+			int neq = solver->NumberOfEquations();
+			int nnz = solver->GetStiffnessMatrix()->NonZeroes();
+
+			for (int nt = 1; ; nt *= 2)
+			{
+				if (nt > maxThreads) nt = maxThreads;
+
+				Timing t;
+				if (TimeModel(fem, nt, t) == false)
+				{
+					feLogError("Failed timing benchmark model %s (size %d)", szmodels[m], n);
+					bok = false;
+					break;
+				}
+
+				feLog("%9s %5d %9d %10d %7d %9.4lf %9.4lf %9.4lf %9.4lf %9.4lf %9.4lf\n", szmodels[m], n, nelems, neq, nt, 
+					t.assembly, t.residual, t.factor, t.backsolve, t.contact, t.output);
+				fprintf(fp, "%s,%d,%d,%d,%d,%d,%lg,%lg,%lg,%lg,%lg,%lg\n", szmodels[m], n, nelems, neq, nnz, nt, 
+					t.assembly, t.residual, t.factor, t.backsolve, t.contact, t.output);
+				fflush(fp);
+
+				if (nt == maxThreads) break;
+			}
+
+			omp_set_num_threads(maxThreads);
+
+			// close the plot file before it is removed
+			PlotFile* plt = fem.GetPlotFile();
+			if (plt) plt->Close();
+			remove(fem.GetPlotFileName().c_str());
+		}
+	}
+
+	fclose(fp);
+	feLog("\nResults written to %s\n", m_csv.c_str());
+
+	return bok;
+}
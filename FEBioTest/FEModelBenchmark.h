@@ -0,0 +1,83 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+#include <vector>
+#include <string>
+
+class FEBioModel;
+
+//-----------------------------------------------------------------------------
+// This task measures the throughput of the main parts of an analysis on a set
+// of parametric models that are generated in code (a hex cube, a biphasic cube,
+// a contact pair, a fluid channel and a shell plate). For each model and size
+// it times the stiffness assembly, residual evaluation, factorization, back
+// substitution, contact search and plot file output for an increasing number
+// of threads. The results are written to a CSV file so that runs can be compared.
+class FEModelBenchmark : public FECoreTask
+{
+public:
+	// the timed parts of a model
+	struct Timing
+	{
+		double	assembly;
+		double	residual;
+		double	factor;
+		double	backsolve;
+		double	contact;
+		double	output;
+	};
+
+public:
+	// constructor
+	FEModelBenchmark(FEModel* pfem);
+
+	// initialize the benchmark. The argument is the name of the CSV file.
+	bool Init(const char* sz) override;
+
+	// run the benchmark
+	bool Run() override;
+
+private:
+	// write the input file of a benchmark model
+	bool WriteModel(const std::string& model, int n, const char* szfile);
+
+	// build one benchmark model
+	bool BuildModel(FEBioModel& fem, const std::string& model, int n);
+
+	// time the parts of the model with the given number of threads
+	bool TimeModel(FEBioModel& fem, int nthreads, Timing& t);
+
+private:
+	std::string			m_csv;		// output file
+	std::string			m_base;		// base name of temporary files
+	std::vector<int>	m_size;		// model sizes (number of elements along an edge)
+	int					m_iters;	// number of evaluations per measurement
+};
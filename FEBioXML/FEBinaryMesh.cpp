@@ -0,0 +1,999 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEBinaryMesh.h"
+#include "FEBioImport.h"
+#include "FEModelBuilder.h"
+#include "XMLReader.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FEDomain.h>
+#include <FECore/FEDomainMap.h>
+#include <FECore/FEMaterial.h>
+#include <FECore/FEElementLibrary.h>
+#include <FECore/fecore_type.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <set>
+#include <map>
+#include <algorithm>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace FEBinaryMesh;
+
+//-----------------------------------------------------------------------------
+// size of a payload item, padded to the 8-byte alignment of the file
+static size_t padded(size_t bytes) { return (bytes + 7) & ~((size_t)7); }
+
+//-----------------------------------------------------------------------------
+// helper class for reading the items of a block's payload
+class FEBinaryBlockCursor
+{
+public:
+	FEBinaryBlockCursor(const char* data, size_t size, const std::string& file) : m_data(data), m_size(size), m_pos(0), m_file(file) {}
+
+	int ReadInt() { int n; memcpy(&n, Advance(sizeof(int)), sizeof(int)); return n; }
+
+	std::string ReadString()
+	{
+		int l = ReadInt();
+		if (l < 0) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+		const char* sz = Advance(l);
+		return std::string(sz, l);
+	}
+
+	const int* ReadInts(size_t n) { return (const int*) Advance(n*sizeof(int)); }
+
+	const double* ReadDoubles(size_t n) { return (const double*) Advance(n*sizeof(double)); }
+
+private:
+	const char* Advance(size_t bytes)
+	{
+		size_t n = padded(bytes);
+		if (m_pos + n > m_size) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+		const char* p = m_data + m_pos;
+		m_pos += n;
+		return p;
+	}
+
+private:
+	const char*	m_data;
+	size_t		m_size;
+	size_t		m_pos;
+	const std::string&	m_file;
+};
+
+//=============================================================================
+FEBinaryMeshReader::FEBinaryMeshReader()
+{
+	m_pdata = nullptr;
+	m_size = 0;
+	m_node0 = 0;
+#ifdef WIN32
+	m_hfile = INVALID_HANDLE_VALUE;
+	m_hmap = NULL;
+#endif
+}
+
+//-----------------------------------------------------------------------------
+FEBinaryMeshReader::~FEBinaryMeshReader()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshReader::Open(const char* szfile)
+{
+	Close();
+	m_file = szfile;
+
+#ifdef WIN32
+	HANDLE hfile = CreateFileA(szfile, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hfile == INVALID_HANDLE_VALUE) return false;
+	m_hfile = hfile;
+
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(hfile, &size) == FALSE) { Close(); return false; }
+	m_size = (size_t) size.QuadPart;
+	if (m_size == 0) { Close(); return false; }
+
+	HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hmap == NULL) { Close(); return false; }
+	m_hmap = hmap;
+
+	m_pdata = (const char*) MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+	if (m_pdata == nullptr) { Close(); return false; }
+#else
+	int fd = open(szfile, O_RDONLY);
+	if (fd == -1) return false;
+
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0)) { close(fd); return false; }
+	m_size = (size_t) st.st_size;
+
+	void* p = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (p == MAP_FAILED) { m_size = 0; return false; }
+	m_pdata = (const char*) p;
+#endif
+
+	// read the header
+	if (m_size < 16) { Close(); return false; }
+	int hdr[4];
+	memcpy(hdr, m_pdata, sizeof(hdr));
+	if ((hdr[0] != MAGIC) || (hdr[1] != VERSION)) { Close(); return false; }
+	int blocks = hdr[2];
+
+	// build the block table
+	size_t pos = 16;
+	for (int i = 0; i < blocks; ++i)
+	{
+		if (pos + 16 > m_size) { Close(); return false; }
+		int id;
+		long long size;
+		memcpy(&id, m_pdata + pos, sizeof(int));
+		memcpy(&size, m_pdata + pos + 8, sizeof(long long));
+		pos += 16;
+		if ((size < 0) || (pos + (size_t) size > m_size)) { Close(); return false; }
+
+		BLOCK b;
+		b.id = id;
+		b.data = m_pdata + pos;
+		b.size = (size_t) size;
+		m_block.push_back(b);
+
+		pos += padded((size_t) size);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::Close()
+{
+#ifdef WIN32
+	if (m_pdata) UnmapViewOfFile(m_pdata);
+	if (m_hmap) CloseHandle((HANDLE) m_hmap);
+	if (m_hfile != INVALID_HANDLE_VALUE) CloseHandle((HANDLE) m_hfile);
+	m_hmap = NULL;
+	m_hfile = INVALID_HANDLE_VALUE;
+#else
+	if (m_pdata) munmap((void*) m_pdata, m_size);
+#endif
+	m_pdata = nullptr;
+	m_size = 0;
+	m_block.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::BuildMesh(FEModelBuilder& builder)
+{
+	FEModel& fem = builder.GetFEModel();
+
+	// nodes are referenced by index, so we need to know where this file's nodes start.
+	m_node0 = fem.GetMesh().Nodes();
+
+	// The blocks are processed in the order they were written, which
+	// guarantees that nodes and domains are read before the sets that reference them.
+	for (size_t i = 0; i < m_block.size(); ++i)
+	{
+		const BLOCK& b = m_block[i];
+		switch (b.id)
+		{
+		case FEBM_NODES  : ReadNodes  (builder, b); break;
+		case FEBM_DOMAIN : ReadDomain (builder, b); break;
+		case FEBM_NODESET: ReadNodeSet(fem, b); break;
+		case FEBM_ELEMSET: ReadElemSet(fem, b); break;
+		case FEBM_SURFACE: ReadSurface(fem, b); break;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::BuildMeshData(FEModel& fem)
+{
+	for (size_t i = 0; i < m_block.size(); ++i)
+	{
+		const BLOCK& b = m_block[i];
+		if (b.id == FEBM_ELEMDATA) ReadElemData(fem, b);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::ReadNodes(FEModelBuilder& builder, const BLOCK& b)
+{
+	FEMesh& mesh = builder.GetFEModel().GetMesh();
+	FEBinaryBlockCursor ar(b.data, b.size, m_file);
+
+	int nodes = ar.ReadInt();
+	if (nodes <= 0) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+	const int* id = ar.ReadInts(nodes);
+	const double* r = ar.ReadDoubles(3 * (size_t) nodes);
+
+	// get the largest nodal ID
+	int N0 = mesh.Nodes();
+	int max_id = (N0 > 0 ? mesh.Node(N0 - 1).GetID() : 0);
+
+	mesh.AddNodes(nodes);
+	for (int i = 0; i < nodes; ++i, r += 3)
+	{
+		// nodal IDs must increase
+		if (id[i] <= max_id) throw FEFileException("Invalid node ID %d in binary mesh file %s.", id[i], m_file.c_str());
+		max_id = id[i];
+
+		FENode& node = mesh.Node(N0 + i);
+		node.m_r0 = vec3d(r[0], r[1], r[2]);
+		node.m_rt = node.m_r0;
+		node.SetID(id[i]);
+	}
+
+	// tell the file reader to rebuild the node ID table
+	builder.BuildNodeList();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::ReadDomain(FEModelBuilder& builder, const BLOCK& b)
+{
+	FEModel& fem = builder.GetFEModel();
+	FEMesh& mesh = fem.GetMesh();
+	FEBinaryBlockCursor ar(b.data, b.size, m_file);
+
+	std::string name = ar.ReadString();
+	std::string type = ar.ReadString();
+	std::string mat  = ar.ReadString();
+	int active = ar.ReadInt();
+	int elems  = ar.ReadInt();
+	int neln   = ar.ReadInt();
+	if ((elems <= 0) || (neln <= 0) || (neln > FEElement::MAX_NODES)) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+	const int* eid  = ar.ReadInts(elems);
+	const int* node = ar.ReadInts((size_t) elems*neln);
+
+	// find the material (by name first, then by ID)
+	FEMaterial* pmat = fem.FindMaterial(mat);
+	if (pmat == 0)
+	{
+		int nmat = atoi(mat.c_str()) - 1;
+		if ((nmat < 0) || (nmat >= fem.Materials())) throw FEBioImport::InvalidDomainMaterial();
+		pmat = fem.GetMaterial(nmat);
+	}
+
+	// get the element type
+	FE_Element_Spec espec = builder.ElementSpec(type.c_str());
+	if (FEElementLibrary::IsValid(espec) == false) throw FEBioImport::InvalidElementType();
+
+	// create the new domain
+	FEDomain* pdom = builder.CreateDomain(espec, pmat);
+	if (pdom == 0) throw FEBioImport::FailedCreatingDomain();
+	FEDomain& dom = *pdom;
+	dom.SetName(name);
+	if (active == 0) dom.SetActive(false);
+
+	// add it to the mesh
+	dom.Create(elems, espec);
+	dom.SetMatID(pmat->GetID() - 1);
+	mesh.AddDomain(pdom);
+
+	// like the xml input, we create an element set for the domain
+	FEElementSet* pg = fecore_alloc(FEElementSet, &fem);
+	pg->SetName(name);
+	mesh.AddElementSet(pg);
+
+	// set the element data
+	int NN = mesh.Nodes();
+	for (int i = 0; i < elems; ++i, node += neln)
+	{
+		FEElement& el = dom.ElementRef(i);
+		if (el.Nodes() != neln) throw FEFileException("Invalid element type for domain %s in binary mesh file %s.", name.c_str(), m_file.c_str());
+
+		el.SetID(eid[i]);
+		for (int j = 0; j < neln; ++j)
+		{
+			int n = m_node0 + node[j];
+			if ((node[j] < 0) || (n >= NN)) throw FEFileException("Invalid node index in domain %s in binary mesh file %s.", name.c_str(), m_file.c_str());
+			el.m_node[j] = n;
+		}
+	}
+
+	// keep track of the largest element ID (the IDs don't have to be sorted)
+	for (int i = 0; i < elems; ++i)
+	{
+		if (eid[i] > builder.m_maxid) builder.m_maxid = eid[i];
+	}
+
+	// create the element set
+	pg->Create(pdom);
+
+	// assign material point data
+	dom.CreateMaterialPointData();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::ReadNodeSet(FEModel& fem, const BLOCK& b)
+{
+	FEMesh& mesh = fem.GetMesh();
+	FEBinaryBlockCursor ar(b.data, b.size, m_file);
+
+	std::string name = ar.ReadString();
+	int n = ar.ReadInt();
+	if (n < 0) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+	const int* node = ar.ReadInts(n);
+
+	int NN = mesh.Nodes();
+	std::vector<int> l(n);
+	for (int i = 0; i < n; ++i)
+	{
+		l[i] = m_node0 + node[i];
+		if ((node[i] < 0) || (l[i] >= NN)) throw FEFileException("Invalid node index in node set %s in binary mesh file %s.", name.c_str(), m_file.c_str());
+	}
+
+	FENodeSet* ps = fecore_alloc(FENodeSet, &fem);
+	ps->SetName(name);
+	ps->Add(l);
+	mesh.AddNodeSet(ps);
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::ReadElemSet(FEModel& fem, const BLOCK& b)
+{
+	FEMesh& mesh = fem.GetMesh();
+	FEBinaryBlockCursor ar(b.data, b.size, m_file);
+
+	std::string name = ar.ReadString();
+	int n = ar.ReadInt();
+	if (n <= 0) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+	const int* eid = ar.ReadInts(n);
+	std::vector<int> l(eid, eid + n);
+
+	// see if all elements belong to the same domain
+	FEDomain* dom = nullptr;
+	for (int i = 0; i < n; ++i)
+	{
+		FEElement* el = mesh.FindElementFromID(l[i]);
+		if (el == nullptr) throw FEFileException("Invalid element ID %d in element set %s in binary mesh file %s.", l[i], name.c_str(), m_file.c_str());
+
+		FEDomain* dom_i = dynamic_cast<FEDomain*>(el->GetMeshPartition());
+		if (i == 0) dom = dom_i;
+		else if (dom != dom_i) { dom = nullptr; break; }
+	}
+
+	FEElementSet* pg = fecore_alloc(FEElementSet, &fem);
+	pg->SetName(name);
+	if (dom) pg->Create(dom, l); else pg->Create(l);
+	mesh.AddElementSet(pg);
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::ReadSurface(FEModel& fem, const BLOCK& b)
+{
+	FEMesh& mesh = fem.GetMesh();
+	FEBinaryBlockCursor ar(b.data, b.size, m_file);
+
+	std::string name = ar.ReadString();
+	int faces = ar.ReadInt();
+	if (faces < 0) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+	const int* f = ar.ReadInts(10 * (size_t) faces);
+
+	FEFacetSet* ps = fecore_alloc(FEFacetSet, &fem);
+	ps->Create(faces);
+	ps->SetName(name);
+	mesh.AddFacetSet(ps);
+
+	int NN = mesh.Nodes();
+	for (int i = 0; i < faces; ++i, f += 10)
+	{
+		FEFacetSet::FACET& face = ps->Face(i);
+		face.ntype = f[0];
+
+		// the facet type also defines the number of nodes
+		if ((face.ntype < 3) || (face.ntype > FEFacetSet::FACET::MAX_NODES)) throw FEFileException("Invalid facet in surface %s in binary mesh file %s.", name.c_str(), m_file.c_str());
+		for (int j = 0; j < face.ntype; ++j)
+		{
+			int n = m_node0 + f[1 + j];
+			if ((f[1 + j] < 0) || (n >= NN)) throw FEFileException("Invalid node index in surface %s in binary mesh file %s.", name.c_str(), m_file.c_str());
+			face.node[j] = n;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshReader::ReadElemData(FEModel& fem, const BLOCK& b)
+{
+	FEMesh& mesh = fem.GetMesh();
+	FEBinaryBlockCursor ar(b.data, b.size, m_file);
+
+	std::string name = ar.ReadString();
+	std::string set  = ar.ReadString();
+	FEDataType dataType = (FEDataType) ar.ReadInt();
+	int fmt = ar.ReadInt();
+	int n = ar.ReadInt();
+	if (n < 0) throw FEFileException("Binary mesh file %s is corrupt.", m_file.c_str());
+	const double* v = ar.ReadDoubles(n);
+
+	FEElementSet* part = mesh.FindElementSet(set);
+	if (part == nullptr) throw FEFileException("Element set %s of data map %s not found.", set.c_str(), name.c_str());
+
+	FEDomainMap* map = new FEDomainMap(dataType, (Storage_Fmt) fmt);
+	map->Create(part);
+
+	// the map must have the same layout as the one that was written
+	if ((map->DataSize() == 0) || (map->BufferSize() != n))
+	{
+		delete map;
+		throw FEFileException("Invalid size of data map %s in binary mesh file %s.", name.c_str(), m_file.c_str());
+	}
+
+	int items = n / map->DataSize();
+	for (int i = 0; i < items; ++i, v += map->DataSize())
+	{
+		switch (dataType)
+		{
+		case FE_DOUBLE: map->set<double>(i, v[0]); break;
+		case FE_VEC2D : map->set<vec2d >(i, vec2d(v[0], v[1])); break;
+		case FE_VEC3D : map->set<vec3d >(i, vec3d(v[0], v[1], v[2])); break;
+		case FE_MAT3D : map->set<mat3d >(i, mat3d(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8])); break;
+		case FE_MAT3DS: map->set<mat3ds>(i, mat3ds(v[0], v[1], v[2], v[3], v[4], v[5])); break;
+		default:
+			assert(false);
+		}
+	}
+
+	// see if this map already exsits 
+	FEDomainMap* oldMap = dynamic_cast<FEDomainMap*>(mesh.FindDataMap(name));
+	if (oldMap)
+	{
+		oldMap->Merge(*map);
+		delete map;
+	}
+	else
+	{
+		map->SetName(name);
+		mesh.AddDataMap(map);
+	}
+}
+
+//=============================================================================
+FEBinaryMeshWriter::FEBinaryMeshWriter()
+{
+	m_fp = nullptr;
+	m_blocks = 0;
+	m_blockID = 0;
+}
+
+//-----------------------------------------------------------------------------
+FEBinaryMeshWriter::~FEBinaryMeshWriter()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshWriter::Create(const char* szfile)
+{
+	m_fp = fopen(szfile, "wb");
+	if (m_fp == nullptr) return false;
+
+	// write a header. The block count is filled in when the file is closed.
+	int hdr[4] = { MAGIC, VERSION, 0, 0 };
+	fwrite(hdr, sizeof(int), 4, m_fp);
+	m_blocks = 0;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshWriter::Close()
+{
+	if (m_fp == nullptr) return false;
+
+	fseek(m_fp, 2*sizeof(int), SEEK_SET);
+	fwrite(&m_blocks, sizeof(int), 1, m_fp);
+	bool bok = (ferror(m_fp) == 0);
+	fclose(m_fp);
+	m_fp = nullptr;
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::WriteNodes(FEModel& fem)
+{
+	FEMesh& mesh = fem.GetMesh();
+	int NN = mesh.Nodes();
+
+	std::vector<int> id(NN);
+	std::vector<double> r(3 * NN);
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		id[i] = node.GetID();
+		r[3*i  ] = node.m_r0.x;
+		r[3*i+1] = node.m_r0.y;
+		r[3*i+2] = node.m_r0.z;
+	}
+
+	BeginBlock(FEBM_NODES);
+	Write(NN);
+	Write(&id[0], NN);
+	Write(&r[0], 3 * NN);
+	EndBlock();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::WriteDomain(FEDomain& dom, const char* sztype, const char* szmat)
+{
+	int NE = dom.Elements();
+	int neln = (NE > 0 ? dom.ElementRef(0).Nodes() : 0);
+
+	std::vector<int> id(NE), node(NE*neln);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		assert(el.Nodes() == neln);
+		id[i] = el.GetID();
+		for (int j = 0; j < neln; ++j) node[i*neln + j] = el.m_node[j];
+	}
+
+	BeginBlock(FEBM_DOMAIN);
+	Write(dom.GetName());
+	Write(std::string(sztype));
+	Write(std::string(szmat));
+	Write(dom.IsActive() ? 1 : 0);
+	Write(NE);
+	Write(neln);
+	Write(&id[0], NE);
+	Write(&node[0], node.size());
+	EndBlock();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::WriteNodeSet(FENodeSet& nset)
+{
+	int N = nset.Size();
+	std::vector<int> node(N);
+	for (int i = 0; i < N; ++i) node[i] = nset[i];
+
+	BeginBlock(FEBM_NODESET);
+	Write(nset.GetName());
+	Write(N);
+	Write(node.data(), N);
+	EndBlock();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::WriteElementSet(FEElementSet& eset)
+{
+	const std::vector<int>& l = eset.GetElementIDList();
+
+	BeginBlock(FEBM_ELEMSET);
+	Write(eset.GetName());
+	Write((int) l.size());
+	Write(l.data(), l.size());
+	EndBlock();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::WriteSurface(FEFacetSet& surf)
+{
+	int NF = surf.Faces();
+	std::vector<int> f(10 * NF, -1);
+	for (int i = 0; i < NF; ++i)
+	{
+		FEFacetSet::FACET& face = surf.Face(i);
+		f[10*i] = face.ntype;
+		for (int j = 0; j < face.ntype; ++j) f[10*i + 1 + j] = face.node[j];
+	}
+
+	BeginBlock(FEBM_SURFACE);
+	Write(surf.GetName());
+	Write(NF);
+	Write(f.data(), f.size());
+	EndBlock();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::WriteElementData(FEDomainMap& map)
+{
+	const FEElementSet* set = map.GetElementSet();
+	assert(set);
+
+	int dataSize = map.DataSize();
+	int items = map.BufferSize() / dataSize;
+	std::vector<double> v; v.reserve(map.BufferSize());
+	for (int i = 0; i < items; ++i)
+	{
+		switch (map.DataType())
+		{
+		case FE_DOUBLE: v.push_back(map.get<double>(i)); break;
+		case FE_VEC2D: { vec2d a = map.get<vec2d>(i); v.push_back(a.x()); v.push_back(a.y()); } break;
+		case FE_VEC3D: { vec3d a = map.get<vec3d>(i); v.push_back(a.x); v.push_back(a.y); v.push_back(a.z); } break;
+		case FE_MAT3D: { mat3d a = map.get<mat3d>(i); for (int k = 0; k < 9; ++k) v.push_back(a[k / 3][k % 3]); } break;
+		case FE_MAT3DS: { mat3ds a = map.get<mat3ds>(i); v.push_back(a.xx()); v.push_back(a.yy()); v.push_back(a.zz()); v.push_back(a.xy()); v.push_back(a.yz()); v.push_back(a.xz()); } break;
+		default:
+			assert(false);
+		}
+	}
+
+	BeginBlock(FEBM_ELEMDATA);
+	Write(map.GetName());
+	Write(set->GetName());
+	Write((int) map.DataType());
+	Write(map.StorageFormat());
+	Write((int) v.size());
+	Write(v.data(), v.size());
+	EndBlock();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::BeginBlock(int id)
+{
+	m_blockID = id;
+	m_buf.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::EndBlock()
+{
+	int hdr[2] = { m_blockID, 0 };
+	long long size = (long long) m_buf.size();
+	fwrite(hdr, sizeof(int), 2, m_fp);
+	fwrite(&size, sizeof(long long), 1, m_fp);
+	if (m_buf.empty() == false) fwrite(&m_buf[0], 1, m_buf.size(), m_fp);
+	m_blocks++;
+	m_buf.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::Write(int n) { Write((const void*) &n, sizeof(int)); }
+void FEBinaryMeshWriter::Write(const int* pi, size_t n) { Write((const void*) pi, n*sizeof(int)); }
+void FEBinaryMeshWriter::Write(const double* pd, size_t n) { Write((const void*) pd, n*sizeof(double)); }
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::Write(const std::string& s)
+{
+	Write((int) s.size());
+	Write(s.c_str(), s.size());
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::Write(const void* pd, size_t bytes)
+{
+	const char* p = (const char*) pd;
+	if (bytes > 0) m_buf.insert(m_buf.end(), p, p + bytes);
+	Align();
+}
+
+//-----------------------------------------------------------------------------
+void FEBinaryMeshWriter::Align()
+{
+	m_buf.resize(padded(m_buf.size()), 0);
+}
+
+//=============================================================================
+// The converter reads the input file with the XMLReader, which also records the file
+// positions of the tags. That way, the text of the tags that were not converted can
+// be copied verbatim.
+
+//-----------------------------------------------------------------------------
+// an element of an xml file and its location in the file
+struct XMLTextElement
+{
+	std::string	name;
+	std::map<std::string, std::string>	att;
+	size_t	start;		// position of the start tag's '<'
+	size_t	end;		// position after the end tag's '>'
+
+	// get the value of an attribute
+	bool attribute(const char* szatt, std::string& val) const
+	{
+		std::map<std::string, std::string>::const_iterator it = att.find(szatt);
+		if (it == att.end()) return false;
+		val = it->second;
+		return true;
+	}
+};
+
+//-----------------------------------------------------------------------------
+// Skip the tag's element and return the file position after its end tag.
+// On return, tag is the next sibling (or the parent's end tag).
+static size_t xml_skip(XMLTag& tag)
+{
+	if (tag.isleaf())
+	{
+		size_t end = (size_t)tag.m_fend;
+		++tag;
+		return end;
+	}
+
+	++tag;
+	while (!tag.isend()) xml_skip(tag);
+	size_t end = (size_t)tag.m_fend;
+	++tag;
+	return end;
+}
+
+//-----------------------------------------------------------------------------
+// Read the child elements of the tag's element.
+// On return, tag is the next sibling (or the parent's end tag).
+static void xml_children(XMLTag& tag, std::vector<XMLTextElement>& l)
+{
+	l.clear();
+	if (tag.isleaf()) { ++tag; return; }
+
+	++tag;
+	while (!tag.isend())
+	{
+		XMLTextElement e;
+		e.name = tag.Name();
+		for (int i = 0; i < tag.m_natt; ++i) e.att[tag.m_att[i].m_szatt] = tag.m_att[i].m_szatv;
+		e.start = (size_t)tag.m_fstart;
+		e.end = xml_skip(tag);
+		l.push_back(e);
+	}
+	++tag;
+}
+
+//-----------------------------------------------------------------------------
+// A text edit: replaces the range [start, end) with text
+struct XMLTextEdit
+{
+	size_t		start, end;
+	std::string	text;
+};
+
+static bool edit_less(const XMLTextEdit& a, const XMLTextEdit& b) { return a.start < b.start; }
+
+//-----------------------------------------------------------------------------
+// Replace the converted children of an element by a BinaryMesh tag
+static void xml_replace(const std::string& s, const std::vector<XMLTextElement>& child, const std::vector<bool>& converted, const std::string& sztag, std::vector<XMLTextEdit>& edits)
+{
+	bool first = true;
+	for (size_t i = 0; i < child.size(); ++i)
+	{
+		if (converted[i] == false) continue;
+
+		XMLTextEdit e;
+		e.start = child[i].start;
+		e.end = child[i].end;
+		if (first) e.text = sztag;
+		else
+		{
+			// remove the entire line
+			while ((e.start > 0) && ((s[e.start - 1] == ' ') || (s[e.start - 1] == '\t'))) e.start--;
+			if ((e.start > 0) && (s[e.start - 1] == '\n')) e.start--;
+			if ((e.start > 0) && (s[e.start - 1] == '\r')) e.start--;
+		}
+		edits.push_back(e);
+		first = false;
+	}
+}
+
+//=============================================================================
+FEBinaryMeshConverter::FEBinaryMeshConverter()
+{
+
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshConverter::error(const char* sz, ...)
+{
+	char szerr[1024] = { 0 };
+	va_list	args;
+	va_start(args, sz);
+	vsnprintf(szerr, sizeof(szerr), sz, args);
+	va_end(args);
+	m_err = szerr;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBinaryMeshConverter::Convert(FEModel& fem, const char* szfeb, const char* szfebm, const char* szout)
+{
+	FEMesh& mesh = fem.GetMesh();
+
+	// read the input file
+	FILE* fp = fopen(szfeb, "rb");
+	if (fp == nullptr) return error("Failed opening input file %s.", szfeb);
+	std::string s;
+	char buf[65536];
+	size_t nread;
+	while ((nread = fread(buf, 1, sizeof(buf), fp)) > 0) s.append(buf, nread);
+	fclose(fp);
+
+	// find the Geometry and MeshData sections
+	XMLReader xml;
+	if (xml.Open(szfeb) == false) return error("Failed opening input file %s.", szfeb);
+	XMLTag tag;
+	if (xml.FindTag("febio_spec", tag) == false) return error("febio_spec tag was not found in %s.", szfeb);
+
+	const char* szver = tag.AttributeValue("version", true);
+	std::string ver = (szver ? szver : "");
+	if ((ver != "2.5") && (ver != "3.0")) return error("Only febio_spec 2.5 and 3.0 files can be converted.");
+
+	std::vector<XMLTextElement> geoChild, dataChild;
+	bool hasGeo = false;
+	try
+	{
+		++tag;
+		while (!tag.isend())
+		{
+			// sections that are read from another file are left alone
+			bool from = (tag.AttributeValue("from", true) != nullptr);
+			if ((tag == "Geometry") && !from) { xml_children(tag, geoChild); hasGeo = true; }
+			else if ((tag == "MeshData") && !from) xml_children(tag, dataChild);
+			else xml.SkipTag(tag);
+		}
+	}
+	catch (XMLReader::Error& e)
+	{
+		return error("Failed parsing input file %s: %s", szfeb, e.what());
+	}
+	catch (...)
+	{
+		return error("Failed parsing input file %s.", szfeb);
+	}
+	xml.Close();
+	if (hasGeo == false) return error("Input file %s does not have a Geometry section that can be converted.", szfeb);
+
+	FEBinaryMeshWriter out;
+	if (out.Create(szfebm) == false) return error("Failed creating binary mesh file %s.", szfebm);
+
+	// write the Geometry section
+	std::vector<bool> geoConverted(geoChild.size(), false);
+	bool nodesWritten = false;
+	int domains = 0;
+	for (size_t i = 0; i < geoChild.size(); ++i)
+	{
+		const XMLTextElement& c = geoChild[i];
+		std::string name;
+		bool hasName = c.attribute("name", name);
+		if (c.name == "Nodes")
+		{
+			// all nodes are written at once
+			if (nodesWritten == false) out.WriteNodes(fem);
+			nodesWritten = true;
+
+			if (hasName)
+			{
+				FENodeSet* ps = mesh.FindNodeSet(name);
+				if (ps == nullptr) { out.Close(); remove(szfebm); return error("Node set %s not found.", name.c_str()); }
+				out.WriteNodeSet(*ps);
+			}
+			geoConverted[i] = true;
+		}
+		else if (c.name == "Elements")
+		{
+			std::string type, mat;
+			c.attribute("type", type);
+			c.attribute("mat", mat);
+			if (hasName == false) name = "_unnamed";
+
+			// the domains are created in the order of the Elements tags
+			if ((nodesWritten == false) || (domains >= mesh.Domains()) || (mesh.Domain(domains).GetName() != name))
+			{
+				out.Close(); remove(szfebm);
+				return error("The domains of the model do not match the Elements sections.");
+			}
+			out.WriteDomain(mesh.Domain(domains++), type.c_str(), mat.c_str());
+			geoConverted[i] = true;
+		}
+		else if (c.name == "NodeSet")
+		{
+			FENodeSet* ps = mesh.FindNodeSet(name);
+			if (ps == nullptr) { out.Close(); remove(szfebm); return error("Node set %s not found.", name.c_str()); }
+			out.WriteNodeSet(*ps);
+			geoConverted[i] = true;
+		}
+		else if (c.name == "Surface")
+		{
+			FEFacetSet* ps = mesh.FindFacetSet(name);
+			if (ps == nullptr) { out.Close(); remove(szfebm); return error("Surface %s not found.", name.c_str()); }
+			out.WriteSurface(*ps);
+			geoConverted[i] = true;
+		}
+		else if (c.name == "ElementSet")
+		{
+			// empty element sets are not added to the mesh
+			FEElementSet* ps = mesh.FindElementSet(name);
+			if (ps) out.WriteElementSet(*ps);
+			geoConverted[i] = true;
+		}
+		else if ((c.name == "Part") || (c.name == "Instance"))
+		{
+			out.Close(); remove(szfebm);
+			return error("Geometry sections that define parts cannot be converted.");
+		}
+	}
+	if (domains != mesh.Domains())
+	{
+		out.Close(); remove(szfebm);
+		return error("The domains of the model do not match the Elements sections.");
+	}
+
+	// write the tabulated element data
+	std::vector<bool> dataConverted(dataChild.size(), false);
+	std::set<std::string> mapsWritten;
+	for (size_t i = 0; i < dataChild.size(); ++i)
+	{
+		const XMLTextElement& c = dataChild[i];
+		std::string name, tmp;
+		if ((c.name != "ElementData") || (c.attribute("name", name) == false)) continue;
+		if (c.attribute("var", tmp) || c.attribute("generator", tmp)) continue;
+
+		// the map's element set must be one that is defined in the mesh
+		FEDomainMap* map = dynamic_cast<FEDomainMap*>(mesh.FindDataMap(name));
+		if ((map == nullptr) || (map->GetElementSet() == nullptr)) continue;
+		if (mesh.FindElementSet(map->GetElementSet()->GetName()) != map->GetElementSet()) continue;
+
+		if (mapsWritten.find(name) == mapsWritten.end()) out.WriteElementData(*map);
+		mapsWritten.insert(name);
+		dataConverted[i] = true;
+	}
+
+	if (out.Close() == false) return error("Failed writing binary mesh file %s.", szfebm);
+
+	// the BinaryMesh tag references the binary file relative to the new input file
+	std::string febm(szfebm), feb(szout);
+	size_t n1 = febm.find_last_of("/\\");
+	size_t n2 = feb.find_last_of("/\\");
+	std::string dir1 = (n1 == std::string::npos ? "" : febm.substr(0, n1));
+	std::string dir2 = (n2 == std::string::npos ? "" : feb.substr(0, n2));
+	if (dir1 == dir2) febm = febm.substr(n1 == std::string::npos ? 0 : n1 + 1);
+	std::string binTag = "<BinaryMesh file=\"" + febm + "\"/>";
+
+	// replace the converted tags
+	std::vector<XMLTextEdit> edits;
+	xml_replace(s, geoChild, geoConverted, binTag, edits);
+	xml_replace(s, dataChild, dataConverted, binTag, edits);
+	std::sort(edits.begin(), edits.end(), edit_less);
+
+	std::string t;
+	t.reserve(s.size() / 4);
+	size_t pos = 0;
+	for (size_t i = 0; i < edits.size(); ++i)
+	{
+		t.append(s, pos, edits[i].start - pos);
+		t.append(edits[i].text);
+		pos = edits[i].end;
+	}
+	t.append(s, pos, std::string::npos);
+
+	fp = fopen(szout, "wb");
+	if (fp == nullptr) return error("Failed creating file %s.", szout);
+	bool bok = (fwrite(t.c_str(), 1, t.size(), fp) == t.size());
+	fclose(fp);
+	if (bok == false) return error("Failed writing file %s.", szout);
+
+	return true;
+}
@@ -0,0 +1,199 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "febioxml_api.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class FEModel;
+class FEModelBuilder;
+class FEDomain;
+class FENodeSet;
+class FEElementSet;
+class FEFacetSet;
+class FEDomainMap;
+
+//-----------------------------------------------------------------------------
+// Layout of a binary mesh file (.febm)
+//
+// The file starts with a 16 byte header (magic "FEBM", version, block count, 
+// reserved), followed by a sequence of blocks. Each block starts with a 16 byte
+// block header (block ID, reserved, payload size in bytes). All items of a 
+// payload start on an 8-byte boundary, so that integer and double arrays can be
+// used directly from the mapped file. Strings are stored as a 32-bit length 
+// followed by the characters (without terminating zero).
+//
+//  FEBM_NODES    : N, node IDs[N], coordinates[3N]
+//  FEBM_DOMAIN   : name, type, mat, active, NE, NEN, element IDs[NE], nodes[NE*NEN]
+//  FEBM_NODESET  : name, N, nodes[N]
+//  FEBM_ELEMSET  : name, N, element IDs[N]
+//  FEBM_SURFACE  : name, NF, (type, nodes[9])[NF]
+//  FEBM_ELEMDATA : name, element set, data type, format, N, values[N]
+//
+// Node references are zero-based indices into the node block of the same file.
+// Element references are element IDs. The element type and the material are
+// stored as strings, exactly as they would appear in the Elements tag, so that
+// they are resolved in the same way as the xml input.
+namespace FEBinaryMesh {
+	enum { MAGIC = 0x4D424546, VERSION = 1 };
+
+	enum BlockID {
+		FEBM_NODES = 1,
+		FEBM_DOMAIN,
+		FEBM_NODESET,
+		FEBM_ELEMSET,
+		FEBM_SURFACE,
+		FEBM_ELEMDATA
+	};
+}
+
+//-----------------------------------------------------------------------------
+// Reads a binary mesh file. The file is memory-mapped, and the mesh is 
+// created directly from the mapped arrays. 
+// Errors in the file's content are reported by throwing an FEFileException.
+class FEBIOXML_API FEBinaryMeshReader
+{
+	struct BLOCK
+	{
+		int				id;		// block ID
+		const char*		data;	// pointer to payload
+		size_t			size;	// payload size
+	};
+
+public:
+	FEBinaryMeshReader();
+	~FEBinaryMeshReader();
+
+	//! map the file and read the block table
+	bool Open(const char* szfile);
+
+	//! unmap the file
+	void Close();
+
+	//! create the nodes, domains, node sets, element sets, and surfaces
+	void BuildMesh(FEModelBuilder& builder);
+
+	//! create the element data maps
+	void BuildMeshData(FEModel& fem);
+
+private:
+	void ReadNodes   (FEModelBuilder& builder, const BLOCK& b);
+	void ReadDomain  (FEModelBuilder& builder, const BLOCK& b);
+	void ReadNodeSet (FEModel& fem, const BLOCK& b);
+	void ReadElemSet (FEModel& fem, const BLOCK& b);
+	void ReadSurface (FEModel& fem, const BLOCK& b);
+	void ReadElemData(FEModel& fem, const BLOCK& b);
+
+private:
+	std::string			m_file;
+	const char*			m_pdata;	// start of mapped file
+	size_t				m_size;		// size of mapped file
+	std::vector<BLOCK>	m_block;	// block table
+	int					m_node0;	// index of first node in mesh
+
+#ifdef WIN32
+	void*	m_hfile;
+	void*	m_hmap;
+#endif
+};
+
+//-----------------------------------------------------------------------------
+// Writes a binary mesh file.
+class FEBIOXML_API FEBinaryMeshWriter
+{
+public:
+	FEBinaryMeshWriter();
+	~FEBinaryMeshWriter();
+
+	bool Create(const char* szfile);
+
+	bool Close();
+
+public:
+	//! write all the nodes of the mesh
+	void WriteNodes(FEModel& fem);
+
+	//! write a domain (type and mat are the strings of the Elements tag)
+	void WriteDomain(FEDomain& dom, const char* sztype, const char* szmat);
+
+	void WriteNodeSet(FENodeSet& nset);
+
+	void WriteElementSet(FEElementSet& eset);
+
+	void WriteSurface(FEFacetSet& surf);
+
+	void WriteElementData(FEDomainMap& map);
+
+private:
+	void BeginBlock(int id);
+	void EndBlock();
+
+	void Write(int n);
+	void Write(const std::string& s);
+	void Write(const int* pi, size_t n);
+	void Write(const double* pd, size_t n);
+	void Write(const void* pd, size_t bytes);
+	void Align();
+
+private:
+	FILE*				m_fp;
+	int					m_blocks;	// nr of blocks written
+	int					m_blockID;	// ID of current block
+	std::vector<char>	m_buf;		// payload of current block
+};
+
+//-----------------------------------------------------------------------------
+// Converts the mesh of an febio input file to a binary mesh file. 
+// The model must already have been read from the input file. The mesh is then
+// written from the FEModel, and a copy of the input file is created in which
+// the converted tags of the Geometry and MeshData sections are replaced by a 
+// BinaryMesh tag that references the binary file. 
+// Only the Nodes, Elements, NodeSet, Surface, and ElementSet tags of the Geometry 
+// section and tabulated ElementData maps are converted. All other tags are copied.
+class FEBIOXML_API FEBinaryMeshConverter
+{
+public:
+	FEBinaryMeshConverter();
+
+	//! Convert the mesh of the input file szfeb. This writes the files szfebm
+	//! (the binary mesh) and szout (the new input file). 
+	bool Convert(FEModel& fem, const char* szfeb, const char* szfebm, const char* szout);
+
+	//! get the error message
+	const std::string& GetErrorMessage() const { return m_err; }
+
+private:
+	bool error(const char* sz, ...);
+
+private:
+	std::string	m_err;
+};
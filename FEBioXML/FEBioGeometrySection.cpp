@@ -36,6 +36,26 @@ SOFTWARE.*/
 #include "FEBioMech/FEElasticMaterial.h"
 #include "FECore/FECoreKernel.h"
 #include <FECore/FENodeNodeList.h>
+#include "FEBinaryMesh.h"
+
+//-----------------------------------------------------------------------------
+//! Reads the nodes, domains, and sets from a binary mesh file (.febm). 
+//! The file name is given by the "file" attribute, and is relative to the input file.
+void FEBioGeometrySection::ParseBinaryMesh(XMLTag& tag)
+{
+	const char* szfile = tag.AttributeValue("file");
+
+	// see if we need to pre-pend a path
+	char szin[512];
+	strcpy(szin, szfile);
+	char* ch = strrchr(szin, '\\');
+	if (ch==0) ch = strrchr(szin, '/');
+	if (ch==0) sprintf(szin, "%s%s", GetFileReader()->GetFilePath(), szfile);
+
+	FEBinaryMeshReader bin;
+	if (bin.Open(szin) == false) throw XMLReader::InvalidAttributeValue(tag, "file", szfile);
+	bin.BuildMesh(*GetBuilder());
+}
 
 //-----------------------------------------------------------------------------
 bool FEBioGeometrySection::ReadElement(XMLTag &tag, FEElement& el, int nid)
@@ -1003,6 +1023,7 @@ void FEBioGeometrySection25::Parse(XMLTag& tag)
 		else if (tag == "NodeSetSet" ) ParseNodeSetSetSection (tag);
 		else if (tag == "Part"       ) ParsePartSection       (tag);
 		else if (tag == "Instance"   ) ParseInstanceSection   (tag);
+		else if (tag == "BinaryMesh" ) ParseBinaryMesh        (tag);
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	}
@@ -39,6 +39,9 @@ public:
 
 protected:
 	bool ReadElement(XMLTag& tag, FEElement& el, int nid);
+
+	// read the mesh from a binary mesh file
+	void ParseBinaryMesh(XMLTag& tag);
 };
 
 //-----------------------------------------------------------------------------
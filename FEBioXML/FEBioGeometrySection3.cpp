@@ -64,6 +64,7 @@ void FEBioGeometrySection3::Parse(XMLTag& tag)
 		else if (tag == "NodeSetSet" ) ParseNodeSetSetSection (tag);
 		else if (tag == "Part"       ) ParsePartSection       (tag);
 		else if (tag == "Instance"   ) ParseInstanceSection   (tag);
+		else if (tag == "BinaryMesh" ) ParseBinaryMesh        (tag);
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	}
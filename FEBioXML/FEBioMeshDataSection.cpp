@@ -37,6 +37,7 @@ SOFTWARE.*/
 #include <FECore/FEModelParam.h>
 #include <FECore/FEDomainMap.h>
 #include <FECore/FEConstValueVec3.h>
+#include "FEBinaryMesh.h"
 #include <sstream>
 
 // in FEBioMeshDataSection3.cpp
@@ -362,11 +363,30 @@ void FEBioMeshDataSection::Parse(XMLTag& tag)
 				ParseDataArray(tag, *pdata, "node");
 			}
 		}
+		else if (tag == "BinaryMesh") ParseBinaryMesh(tag);
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	} while (!tag.isend());
 }
 
+//-----------------------------------------------------------------------------
+//! Reads the element data maps that are stored in a binary mesh file.
+void FEBioMeshDataSection::ParseBinaryMesh(XMLTag& tag)
+{
+	const char* szfile = tag.AttributeValue("file");
+
+	// see if we need to pre-pend a path
+	char szin[512];
+	strcpy(szin, szfile);
+	char* ch = strrchr(szin, '\\');
+	if (ch==0) ch = strrchr(szin, '/');
+	if (ch==0) sprintf(szin, "%s%s", GetFileReader()->GetFilePath(), szfile);
+
+	FEBinaryMeshReader bin;
+	if (bin.Open(szin) == false) throw XMLReader::InvalidAttributeValue(tag, "file", szfile);
+	bin.BuildMeshData(*GetFEModel());
+}
+
 //-----------------------------------------------------------------------------
 void FEBioMeshDataSection::ParseShellThickness(XMLTag& tag, FEElementSet& set)
 {
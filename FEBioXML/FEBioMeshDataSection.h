@@ -54,6 +54,7 @@ protected:
 	void ParseMaterialAxes  (XMLTag& tag, FEElementSet& set);
 	void ParseMaterialData  (XMLTag& tag, FEElementSet& set, const string& name);
 	void ParseMaterialFiberProperty(XMLTag& tag, FEElementSet& set);
+	void ParseBinaryMesh    (XMLTag& tag);
 
 private:
 	void ParseElementData(XMLTag& tag, FEElementSet& set, vector<ELEMENT_DATA>& values, int nvalues);
@@ -93,6 +94,7 @@ protected:
 	void ParseMaterialFibers(XMLTag& tag, FEElementSet& set);
 	void ParseMaterialAxes(XMLTag& tag, FEElementSet& set);
 	void ParseMaterialAxesProperty(XMLTag& tag, FEElementSet& set);
+	void ParseBinaryMesh(XMLTag& tag);
 
 private:
 	void ParseElementData(XMLTag& tag, FEElementSet& set, vector<ELEMENT_DATA>& values, int nvalues);
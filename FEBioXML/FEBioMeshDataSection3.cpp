@@ -42,6 +42,7 @@ SOFTWARE.*/
 #include <FECore/FEMaterialPointProperty.h>
 #include <FECore/FEConstDataGenerator.h>
 #include <FECore/FEConstValueVec3.h>
+#include "FEBinaryMesh.h"
 #include <sstream>
 
 //-----------------------------------------------------------------------------
@@ -76,12 +77,31 @@ void FEBioMeshDataSection3::Parse(XMLTag& tag)
 		if      (tag == "NodeData"   ) ParseNodalData  (tag);
 		else if (tag == "SurfaceData") ParseSurfaceData(tag);
 		else if (tag == "ElementData") ParseElementData(tag);
+		else if (tag == "BinaryMesh" ) ParseBinaryMesh (tag);
 		else throw XMLReader::InvalidTag(tag);
 		++tag;
 	}
 	while (!tag.isend());
 }
 
+//-----------------------------------------------------------------------------
+//! Reads the element data maps that are stored in a binary mesh file.
+void FEBioMeshDataSection3::ParseBinaryMesh(XMLTag& tag)
+{
+	const char* szfile = tag.AttributeValue("file");
+
+	// see if we need to pre-pend a path
+	char szin[512];
+	strcpy(szin, szfile);
+	char* ch = strrchr(szin, '\\');
+	if (ch==0) ch = strrchr(szin, '/');
+	if (ch==0) sprintf(szin, "%s%s", GetFileReader()->GetFilePath(), szfile);
+
+	FEBinaryMeshReader bin;
+	if (bin.Open(szin) == false) throw XMLReader::InvalidAttributeValue(tag, "file", szfile);
+	bin.BuildMeshData(*GetFEModel());
+}
+
 //-----------------------------------------------------------------------------
 void FEBioMeshDataSection3::ParseNodalData(XMLTag& tag)
 {
@@ -150,6 +150,18 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
 			}
 
+			sz = tag.AttributeValue("binary", true);
+			if (sz != 0)
+			{
+				// binary data is always written to a separate file
+				if (strcmp(sz, "on") == 0)
+				{
+					if (tag.AttributeValue("file", true) == 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+					prec->SetBinary(true);
+				}
+				else if (strcmp(sz, "off") != 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+			}
+
 			const char* sztmp = "set";
 			if (GetFileReader()->GetFileVersion() >= 0x0205) sztmp = "node_set";
 			sz = tag.AttributeValue(sztmp, true);
@@ -200,6 +212,18 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
 			}
 
+			sz = tag.AttributeValue("binary", true);
+			if (sz != 0)
+			{
+				// binary data is always written to a separate file
+				if (strcmp(sz, "on") == 0)
+				{
+					if (tag.AttributeValue("file", true) == 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+					prec->SetBinary(true);
+				}
+				else if (strcmp(sz, "off") != 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+			}
+
 			const char* sztmp = "elset";
 			if (GetFileReader()->GetFileVersion() >= 0x0205) sztmp = "elem_set";
 
@@ -251,6 +275,18 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
 				else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
 			}
 
+			sz = tag.AttributeValue("binary", true);
+			if (sz != 0)
+			{
+				// binary data is always written to a separate file
+				if (strcmp(sz, "on") == 0)
+				{
+					if (tag.AttributeValue("file", true) == 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+					prec->SetBinary(true);
+				}
+				else if (strcmp(sz, "off") != 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+			}
+
 			prec->SetItemList(tag.szvalue());
 
 			GetFEBioImport()->AddDataRecord(prec);
@@ -291,6 +327,18 @@ void FEBioOutputSection::ParseLogfile(XMLTag &tag)
                 if      (strcmp(sz, "on") == 0) prec->SetComments(true);
                 else if (strcmp(sz, "off") == 0) prec->SetComments(false); 
             }
+
+            sz = tag.AttributeValue("binary", true);
+            if (sz != 0)
+            {
+                // binary data is always written to a separate file
+                if (strcmp(sz, "on") == 0)
+                {
+                    if (tag.AttributeValue("file", true) == 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+                    prec->SetBinary(true);
+                }
+                else if (strcmp(sz, "off") != 0) throw XMLReader::InvalidAttributeValue(tag, "binary", sz);
+            }
             
             prec->SetItemList(tag.szvalue());
             
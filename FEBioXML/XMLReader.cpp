@@ -61,6 +61,7 @@ XMLTag::XMLTag()
 {
 	m_preader = 0;
 	m_bend = false;
+	m_fpos = m_fstart = m_fend = 0;
 
 	m_sztag[0] = 0;
 	m_nlevel = 0;
@@ -687,6 +688,7 @@ void XMLReader::ReadTag(XMLTag& tag)
 			{
 				throw XMLSyntaxError(m_nline);
 			}
+		tag.m_fstart = currentPos() - 1;
 
 		ch = GetChar();
 		if (ch == '!')
@@ -781,6 +783,7 @@ void XMLReader::ReadTag(XMLTag& tag)
 		++n;
 		++tag.m_natt;
 	}
+	tag.m_fend = currentPos();
 
 	if (!tag.isend() && !tag.isempty())
 	{
@@ -836,6 +839,7 @@ void XMLReader::ReadEndTag(XMLTag& tag)
 			// skip whitespace
 			while (isspace(ch)) ch=GetChar();
 			if (ch != '>') throw XMLSyntaxError(m_nline);
+			tag.m_fend = currentPos();
 
 			// find the start of the next tag
 			if (tag.m_nlevel)
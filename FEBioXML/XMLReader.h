@@ -92,6 +92,8 @@ public:
 
 	XMLReader*	m_preader;			// pointer to reader
     int64_t		m_fpos;				// file position of next tag
+	int64_t		m_fstart;			// file position of the tag's '<'
+	int64_t		m_fend;				// file position after the '>' of the tag (or its end tag for leaves)
 	int		m_nstart_line;		// line number at beginning of tag
 	int		m_ncurrent_line;	// current line number
 
@@ -55,6 +55,9 @@ DataRecord::DataRecord(FEModel* pfem, const char* szfile, int ntype) : m_type(nt
 	m_fp = 0;
 	m_szfile[0] = 0;
 
+	m_bbinary = false;
+	m_bheader = false;
+
 	if (szfile)
 	{
 		strcpy(m_szfile, szfile);
@@ -91,6 +94,23 @@ void DataRecord::SetFormat(const char* sz)
 	strcpy(m_szfmt, sz);
 }
 
+//-----------------------------------------------------------------------------
+void DataRecord::SetBinary(bool b)
+{
+	if (b == m_bbinary) return;
+	m_bbinary = b;
+	m_bheader = false;
+
+	// reopen the file in the correct mode
+	if (m_szfile[0])
+	{
+		if (m_fp) fclose(m_fp);
+		m_fp = fopen(m_szfile, (b ? "wb" : "wt"));
+		if (m_fp == 0) feLogErrorEx(m_pfem, "FAILED CREATING DATA FILE %s\n\n", m_szfile);
+		else if (b) setvbuf(m_fp, 0, _IOFBF, 1 << 20);
+	}
+}
+
 //-----------------------------------------------------------------------------
 bool DataRecord::Initialize()
 {
@@ -200,6 +220,13 @@ bool DataRecord::Write()
 	feLogEx(m_pfem, "Time = %.9lg\n", ftime);
 	feLogEx(m_pfem, "Data = %s\n", m_szname);
 
+	// binary records are written to their own file
+	if (m_bbinary)
+	{
+		feLogEx(m_pfem, "File = %s\n", m_szfile);
+		return WriteBinary();
+	}
+
 	// write some comments
 	FILE* fp = m_fp;
 	if (fp && m_bcomm)
@@ -241,6 +268,75 @@ bool DataRecord::Write()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void DataRecord::WriteBinaryHeader()
+{
+	// the field names are taken from the data expression
+	std::vector<std::string> fields;
+	std::string data(m_szdata);
+	size_t n0 = 0, n1;
+	do
+	{
+		n1 = data.find(';', n0);
+		fields.push_back(data.substr(n0, (n1 == std::string::npos ? n1 : n1 - n0)));
+		n0 = n1 + 1;
+	}
+	while (n1 != std::string::npos);
+	assert((int)fields.size() == Size());
+
+	int nitems = (int)m_item.size();
+	int hdr[5] = { FE_DATA_BINARY_MAGIC, FE_DATA_BINARY_VERSION, m_type, Size(), nitems };
+	fwrite(hdr, sizeof(int), 5, m_fp);
+	for (int i = 0; i < Size(); ++i)
+	{
+		std::string name = (i < (int)fields.size() ? fields[i] : std::string());
+		int l = (int)name.size();
+		int ntype = DATA_COLUMN_DOUBLE;
+		fwrite(&l, sizeof(int), 1, m_fp);
+		if (l > 0) fwrite(name.c_str(), 1, l, m_fp);
+		fwrite(&ntype, sizeof(int), 1, m_fp);
+	}
+	if (nitems > 0) fwrite(&m_item[0], sizeof(int), nitems, m_fp);
+
+	m_bheader = true;
+}
+
+//-----------------------------------------------------------------------------
+// Write one frame of binary data. Each field is evaluated for all items and 
+// written as a single column.
+bool DataRecord::WriteBinary()
+{
+	if (m_fp == 0) return false;
+	if (m_bheader == false) WriteBinaryHeader();
+
+	int nstep = m_pfem->GetCurrentStep()->m_ntimesteps;
+	double ftime = m_pfem->GetCurrentTime();
+	fwrite(&nstep, sizeof(int), 1, m_fp);
+	fwrite(&ftime, sizeof(double), 1, m_fp);
+
+	int nitems = (int)m_item.size();
+	m_col.resize(nitems);
+	bool bparallel = PrepareParallelEvaluate();
+	for (int j = 0; j < Size(); ++j)
+	{
+		if (bparallel)
+		{
+#pragma omp parallel for
+			for (int i = 0; i < nitems; ++i) m_col[i] = Evaluate(m_item[i], j);
+		}
+		else
+		{
+			for (int i = 0; i < nitems; ++i) m_col[i] = Evaluate(m_item[i], j);
+		}
+
+		if (nitems > 0) fwrite(&m_col[0], sizeof(double), nitems, m_fp);
+	}
+
+	fflush(m_fp);
+
+	return (ferror(m_fp) == 0);
+}
+
 //-----------------------------------------------------------------------------
 
 void DataRecord::SetItemList(const char* szlist)
@@ -323,6 +419,7 @@ void DataRecord::Serialize(DumpStream &ar)
 	ar & m_bcomm;
 	ar & m_item;
 	ar & m_szdata;
+	ar & m_bbinary;
 
 	// when we're loading we need to reinitialize the file
 	if (ar.IsLoading())
@@ -334,7 +431,9 @@ void DataRecord::Serialize(DumpStream &ar)
 		if (m_szfile[0] != 0)
 		{
 			// reopen data file for appending
-			m_fp = fopen(m_szfile, "a+");
+			// (the header of a binary file was already written)
+			m_fp = fopen(m_szfile, (m_bbinary ? "ab" : "a+"));
+			m_bheader = m_bbinary;
 		}
 	}
 }
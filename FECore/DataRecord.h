@@ -52,6 +52,19 @@ public:
 	UnknownDataField(const char* sz);
 };
 
+//-----------------------------------------------------------------------------
+// Layout of a binary data record file
+//
+// header: magic ("FELB"), version, record type (FE_DATA_XXX), number of fields (NF),
+//         number of items (NI), NF x (name length, name, column type), NI item IDs
+// frame : step, time (double), NF x column of NI values
+//
+// All integers are 32-bit. The only column type currently is DATA_COLUMN_DOUBLE.
+// A frame is appended each time the record is written.
+#define FE_DATA_BINARY_MAGIC	0x424C4546
+#define FE_DATA_BINARY_VERSION	1
+#define DATA_COLUMN_DOUBLE		1
+
 //-----------------------------------------------------------------------------
 
 class FECORE_API DataRecord
@@ -71,6 +84,10 @@ public:
 	void SetFormat(const char* sz);
 	void SetComments(bool b) { m_bcomm = b; }
 
+	//! write the data in the binary columnar format (requires a file)
+	void SetBinary(bool b);
+	bool IsBinary() const { return m_bbinary; }
+
 public:
 	virtual bool Initialize();
 	virtual double Evaluate(int item, int ndata) = 0;
@@ -79,10 +96,18 @@ public:
 	virtual void Parse(const char* sz) = 0;
 	virtual int Size() const = 0;
 
+	//! Derived classes return true if Evaluate may be called concurrently for 
+	//! different items. This is called before each binary write, so lookup tables
+	//! that Evaluate needs can be built here.
+	virtual bool PrepareParallelEvaluate() { return false; }
+
 private:
 	std::string printToString(int i);
 	std::string printToFormatString(int i);
 
+	bool WriteBinary();
+	void WriteBinaryHeader();
+
 public:
 	int					m_nid;		//!< ID of data record
 	std::vector<int>	m_item;		//!< item list
@@ -100,4 +125,8 @@ protected:
 
 	FEModel*	m_pfem;
 	FILE*		m_fp;
+
+	bool				m_bbinary;	//!< write binary columnar data
+	bool				m_bheader;	//!< binary header was written
+	std::vector<double>	m_col;		//!< column buffer for binary output
 };
@@ -0,0 +1,118 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "DataRecordReader.h"
+#include "DataRecord.h"
+
+//-----------------------------------------------------------------------------
+DataRecordReader::DataRecordReader()
+{
+	m_fp = 0;
+	m_ntype = 0;
+}
+
+//-----------------------------------------------------------------------------
+DataRecordReader::~DataRecordReader()
+{
+	Close();
+}
+
+//-----------------------------------------------------------------------------
+void DataRecordReader::Close()
+{
+	if (m_fp) fclose(m_fp);
+	m_fp = 0;
+	m_ntype = 0;
+	m_field.clear();
+	m_item.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool DataRecordReader::Open(const char* szfile)
+{
+	Close();
+
+	m_fp = fopen(szfile, "rb");
+	if (m_fp == 0) return false;
+
+	// read the header
+	int hdr[5];
+	if ((fread(hdr, sizeof(int), 5, m_fp) != 5) || 
+		(hdr[0] != FE_DATA_BINARY_MAGIC) || 
+		(hdr[1] != FE_DATA_BINARY_VERSION) ||
+		(hdr[3] < 0) || (hdr[4] < 0))
+	{
+		Close();
+		return false;
+	}
+	m_ntype = hdr[2];
+	int nfields = hdr[3];
+	int nitems  = hdr[4];
+
+	// read the field names
+	m_field.resize(nfields);
+	for (int i = 0; i < nfields; ++i)
+	{
+		int l = 0, ntype = 0;
+		if ((fread(&l, sizeof(int), 1, m_fp) != 1) || (l < 0) || (l > 1024)) { Close(); return false; }
+		std::string& name = m_field[i];
+		name.resize(l);
+		if ((l > 0) && (fread(&name[0], 1, l, m_fp) != (size_t)l)) { Close(); return false; }
+
+		// only double columns are supported for now
+		if ((fread(&ntype, sizeof(int), 1, m_fp) != 1) || (ntype != DATA_COLUMN_DOUBLE)) { Close(); return false; }
+	}
+
+	// read the item IDs
+	m_item.resize(nitems);
+	if ((nitems > 0) && (fread(&m_item[0], sizeof(int), nitems, m_fp) != (size_t)nitems))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool DataRecordReader::ReadFrame(int& nstep, double& time, std::vector<double>& data)
+{
+	if (m_fp == 0) return false;
+
+	if (fread(&nstep, sizeof(int), 1, m_fp) != 1) return false;
+	if (fread(&time, sizeof(double), 1, m_fp) != 1) return false;
+
+	size_t n = m_field.size()*m_item.size();
+	data.resize(n);
+	if ((n > 0) && (fread(&data[0], sizeof(double), n, m_fp) != n)) return false;
+
+	return true;
+}
@@ -0,0 +1,67 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "fecore_api.h"
+
+//-----------------------------------------------------------------------------
+//! This class reads the binary files that are written by data records whose
+//! binary flag is set (see DataRecord.h for the file layout).
+class FECORE_API DataRecordReader
+{
+public:
+	DataRecordReader();
+	~DataRecordReader();
+
+	//! Open the file and read the header
+	bool Open(const char* szfile);
+
+	//! close the file
+	void Close();
+
+	//! Read the next frame. Values are stored field by field, i.e. the value of
+	//! field j for item i is stored at index j*Items() + i.
+	bool ReadFrame(int& nstep, double& time, std::vector<double>& data);
+
+public:
+	int Type() const { return m_ntype; }
+	int Fields() const { return (int)m_field.size(); }
+	const std::string& FieldName(int n) const { return m_field[n]; }
+	int Items() const { return (int)m_item.size(); }
+	int ItemID(int n) const { return m_item[n]; }
+
+private:
+	FILE*	m_fp;
+	int		m_ntype;
+
+	std::vector<std::string>	m_field;
+	std::vector<int>			m_item;
+};
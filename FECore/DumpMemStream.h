@@ -47,6 +47,10 @@ public: // overloaded from base class
 
 	size_t size() const { return m_nsize; }
 	size_t reserved() const { return m_nreserved; }
+
+	// the stream's buffer and the current position in it
+	const char* data() const { return m_pb; }
+	size_t tell() const { return (size_t)(m_pd - m_pb); }
 	bool EndOfStream() const;
 
 protected:
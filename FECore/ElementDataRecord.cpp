@@ -88,6 +88,15 @@ double ElementDataRecord::Evaluate(int item, int ndata)
 	else return 0.0;
 }
 
+//-----------------------------------------------------------------------------
+// The element lookup table is built lazily, so make sure it exists before 
+// the items are evaluated concurrently.
+bool ElementDataRecord::PrepareParallelEvaluate()
+{
+	if (m_ELT.empty()) BuildELT();
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 void ElementDataRecord::BuildELT()
 {
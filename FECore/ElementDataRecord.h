@@ -57,6 +57,7 @@ class FECORE_API ElementDataRecord : public DataRecord
 public:
 	ElementDataRecord(FEModel* pfem, const char* szfile);
 	double Evaluate(int item, int ndata);
+	bool PrepareParallelEvaluate();
 	void Parse(const char* sz);
 	void SelectAllItems();
 	int Size() const;
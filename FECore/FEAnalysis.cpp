@@ -35,6 +35,7 @@ SOFTWARE.*/
 #include "MatrixProfile.h"
 #include "FEBoundaryCondition.h"
 #include "DumpMemStream.h"
+#include "FEModelCheckpoint.h"
 #include "FELinearConstraintManager.h"
 #include "FEShellDomain.h"
 #include "FEMeshAdaptor.h"
@@ -51,6 +52,7 @@ BEGIN_FECORE_CLASS(FEAnalysis, FECoreBase)
 	ADD_PARAMETER(m_noutput     , "output_level", 0, "OUTPUT_NEVER\0OUTPUT_MAJOR_ITRS\0OUTPUT_MINOR_ITRS\0OUTPUT_MUST_POINTS\0OUTPUT_FINAL\0");
 	ADD_PARAMETER(m_nplot_stride, "plot_stride");
 	ADD_PARAMETER(m_nanalysis   , "analysis", 0, "STATIC\0DYNAMIC\0STEADY-STATE\0TRANSIENT=1\0");
+	ADD_PARAMETER(m_ncheckpoint , "retry_checkpoint", 0, "FULL\0INCREMENTAL\0");
 
 	ADD_PROPERTY(m_psolver, "solver");
 	ADD_PROPERTY(m_timeController, "time_stepper", FEProperty::Optional);
@@ -67,6 +69,7 @@ FEAnalysis::FEAnalysis(FEModel* fem) : FECoreBase(fem)
 
 	// --- Analysis data ---
 	m_nanalysis = FE_STATIC;	// do quasi-static analysis
+	m_ncheckpoint = 1;			// use incremental checkpoints for retries
 
 	// --- Time Step Data ---
 	m_ntime = -1;
@@ -374,6 +377,9 @@ bool FEAnalysis::Solve()
 	// dump stream for running restarts
 	DumpMemStream dmp(fem);
 
+	// or the checkpoint that only stores the model state
+	FEModelCheckpoint checkpoint(fem);
+
 	// repeat for all timesteps
 	if (m_timeController) m_timeController->m_nretries = 0;
 	while (endtime - fem.GetCurrentTime() > eps)
@@ -382,8 +388,12 @@ bool FEAnalysis::Solve()
 		// we need to retry this time step
 		if (m_timeController && (m_timeController->m_maxretries > 0))
 		{ 
-			dmp.clear();
-			fem.Serialize(dmp); 
+			if (m_ncheckpoint == 1) checkpoint.Save();
+			else
+			{
+				dmp.clear();
+				fem.Serialize(dmp);
+			}
 		}
 
 		// Inform that the time is about to change. (Plugins can use 
@@ -465,8 +475,12 @@ bool FEAnalysis::Solve()
 			if (m_timeController && (m_timeController->m_nretries < m_timeController->m_maxretries))
 			{
 				// restore the previous state
-				dmp.Open(false, true);
-				fem.Serialize(dmp);
+				if (m_ncheckpoint == 1) checkpoint.Restore();
+				else
+				{
+					dmp.Open(false, true);
+					fem.Serialize(dmp);
+				}
 				
 				// let's try again
 				m_timeController->Retry();
@@ -485,6 +499,14 @@ bool FEAnalysis::Solve()
 		}
 	}
 
+	// report the checkpoint timings
+	if (checkpoint.Saves() > 0)
+	{
+		feLog("\n\tCheckpoint data size ............ : %.3lf MB\n", checkpoint.Size() / 1048576.0);
+		feLog("\tCheckpoints saved ............... : %d (%lg sec)\n", checkpoint.Saves(), checkpoint.SaveTime());
+		feLog("\tCheckpoints restored ............ : %d (%lg sec)\n\n", checkpoint.Restores(), checkpoint.RestoreTime());
+	}
+
 	// TODO: Why is this here?
 	fem.SetStartTime(fem.GetCurrentTime());
 
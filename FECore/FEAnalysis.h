@@ -144,6 +144,7 @@ public:
 	// --- Control Data ---
 	//{
 		int		m_nanalysis;	//!< analysis type
+		int		m_ncheckpoint;	//!< how the model state is stored for retries (0 = full serialization, 1 = incremental checkpoint)
 	//}
 
 	// --- Time Step Data ---
@@ -28,13 +28,14 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FENNQuery.h"
+#include "FESurfaceBVH.h"
 #include "FEElemElemList.h"
 #include "FENodeElemList.h"
 
 //-----------------------------------------------------------------------------
 // This class can be used to find the closest point projection of a point
-// onto a surface.
+// onto a surface. The projection functions only read data, so they can be 
+// called from multiple threads after Init() was called.
 class FECORE_API FEClosestPointProjection
 {
 public:
@@ -78,7 +79,7 @@ protected:
 
 protected:
 	FESurface&		m_surf;		//!< reference to surface
-	FENNQuery		m_SNQ;		//!< used to find the nearest neighbour
+	FESurfaceBVH*	m_bvh;		//!< used to find the nearest neighbour
 	FENodeElemList	m_NEL;		//!< node-element tree
 	FEElemElemList	m_EEL;		//!< element neighbor list
 };
@@ -55,6 +55,11 @@ void FEDomain::SetMatID(int mid)
 // determines how many integration points an element gets). 
 void FEDomain::CreateMaterialPointData()
 {
+	// Destroy the material points of a previous call (e.g. when the mesh was refined),
+	// so that the arena's memory can be reused.
+	ForEachElement([](FEElement& el) { el.ClearData(); });
+	m_arena.Reset();
+
 	FEMaterial* pmat = GetMaterial();
 	FEMesh* mesh = GetMesh();
 	if (pmat) ForEachElement([=](FEElement& el) {
@@ -65,7 +70,7 @@ void FEDomain::CreateMaterialPointData()
 
 		for (int k = 0; k < el.GaussPoints(); ++k)
 		{
-			FEMaterialPoint* mp = pmat->CreateMaterialPointData();
+			FEMaterialPoint* mp = m_arena.CreateMaterialPoint(pmat);
 			mp->m_r0 = el.Evaluate(r, k);
 			mp->m_index = k;
 			el.SetMaterialPointData(mp, k);
@@ -125,7 +130,7 @@ void FEDomain::Serialize(DumpStream& ar)
 				int nint = el.GaussPoints();
 				for (int j = 0; j < nint; ++j)
 				{
-					el.SetMaterialPointData(pmat->CreateMaterialPointData(), j);
+					el.SetMaterialPointData(m_arena.CreateMaterialPoint(pmat), j);
 					el.GetMaterialPoint(j)->Serialize(ar);
 				}
 			}
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "FEMeshPartition.h"
+#include "FEMaterialPointArena.h"
 
 // forward declaration of material class
 class FEMaterial;
@@ -83,4 +84,9 @@ protected:
 
 	// helper function for unpacking element dofs
 	void UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm);
+
+private:
+	// NOTE: The elements are stored in the derived classes, so they (and their 
+	// material points) are destroyed before the arena.
+	FEMaterialPointArena	m_arena;	//!< storage for the material point data
 };
@@ -0,0 +1,345 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEElementBVH.h"
+#include "FEMesh.h"
+#include "FESolidDomain.h"
+#include <algorithm>
+
+// max number of elements in a leaf
+#define BVH_LEAF_SIZE	4
+
+// max depth of the traversal stack
+#define BVH_MAX_STACK	128
+
+//-----------------------------------------------------------------------------
+FEElementBVH::FEElementBVH(FEMesh* mesh, Configuration config) : m_mesh(mesh), m_config(config)
+{
+	m_inflate = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+FEElementBVH::~FEElementBVH()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEElementBVH::Clear()
+{
+	m_elem.clear();
+	m_perm.clear();
+	m_ebox.clear();
+	m_node.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool FEElementBVH::Build(FESolidDomain* dom, double inflate)
+{
+	Clear();
+	if ((m_mesh == nullptr) || (dom == nullptr)) return false;
+
+	int NE = dom->Elements();
+	m_elem.resize(NE);
+	for (int i = 0; i < NE; ++i) m_elem[i] = &dom->Element(i);
+
+	return BuildTree(inflate);
+}
+
+//-----------------------------------------------------------------------------
+bool FEElementBVH::Build(double inflate)
+{
+	Clear();
+	if (m_mesh == nullptr) return false;
+
+	for (int i = 0; i < m_mesh->Domains(); ++i)
+	{
+		FEDomain& dom = m_mesh->Domain(i);
+		if (dom.Class() == FE_DOMAIN_SOLID)
+		{
+			FESolidDomain& sd = static_cast<FESolidDomain&>(dom);
+			for (int j = 0; j < sd.Elements(); ++j) m_elem.push_back(&sd.Element(j));
+		}
+	}
+
+	return BuildTree(inflate);
+}
+
+//-----------------------------------------------------------------------------
+bool FEElementBVH::BuildTree(double inflate)
+{
+	m_inflate = inflate;
+
+	int NE = (int)m_elem.size();
+	if (NE == 0) return false;
+
+	// calculate the element boxes and centers
+	m_perm.resize(NE);
+	m_ebox.resize(NE);
+	std::vector<vec3d> c(NE);
+	for (int i = 0; i < NE; ++i)
+	{
+		m_perm[i] = i;
+		m_ebox[i] = ElementBox(*m_elem[i]);
+		c[i] = (m_ebox[i].r0 + m_ebox[i].r1)*0.5;
+	}
+
+	// build the tree
+	m_node.reserve(2 * (NE / BVH_LEAF_SIZE + 1));
+	BuildNode(0, NE, c);
+
+	// put the element boxes in leaf order and calculate the node boxes
+	Refit();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Creates the node for the elements m_perm[first, first + count) and returns its index.
+// The elements are split at the median of the longest axis of their centers.
+int FEElementBVH::BuildNode(int first, int count, std::vector<vec3d>& c)
+{
+	int n = (int)m_node.size();
+	Node node;
+	node.left = node.right = -1;
+	node.first = first;
+	node.count = count;
+	m_node.push_back(node);
+
+	if (count <= BVH_LEAF_SIZE) return n;
+
+	// find the extent of the element centers
+	vec3d r0 = c[m_perm[first]], r1 = r0;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& ci = c[m_perm[i]];
+		if (ci.x < r0.x) r0.x = ci.x; if (ci.x > r1.x) r1.x = ci.x;
+		if (ci.y < r0.y) r0.y = ci.y; if (ci.y > r1.y) r1.y = ci.y;
+		if (ci.z < r0.z) r0.z = ci.z; if (ci.z > r1.z) r1.z = ci.z;
+	}
+	vec3d d = r1 - r0;
+	int axis = 0;
+	if ((d.y > d.x) && (d.y >= d.z)) axis = 1;
+	else if ((d.z > d.x) && (d.z > d.y)) axis = 2;
+
+	// split at the median
+	int m = count / 2;
+	int* p = &m_perm[0];
+	std::nth_element(p + first, p + first + m, p + first + count, [&](int a, int b) {
+		const vec3d& ca = c[a];
+		const vec3d& cb = c[b];
+		if (axis == 0) return ca.x < cb.x;
+		if (axis == 1) return ca.y < cb.y;
+		return ca.z < cb.z;
+	});
+
+	// NOTE: m_node may be reallocated, so don't hold on to references
+	int left  = BuildNode(first, m, c);
+	int right = BuildNode(first + m, count - m, c);
+	m_node[n].left = left;
+	m_node[n].right = right;
+	m_node[n].count = 0;
+
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+FEElementBVH::Box FEElementBVH::ElementBox(FESolidElement& el) const
+{
+	Box box;
+	int neln = el.Nodes();
+	if (m_config == REFERENCE_CONFIG)
+	{
+		box.r0 = box.r1 = m_mesh->Node(el.m_node[0]).m_r0;
+		for (int j = 1; j < neln; ++j)
+		{
+			const vec3d& r = m_mesh->Node(el.m_node[j]).m_r0;
+			if (r.x < box.r0.x) box.r0.x = r.x; if (r.x > box.r1.x) box.r1.x = r.x;
+			if (r.y < box.r0.y) box.r0.y = r.y; if (r.y > box.r1.y) box.r1.y = r.y;
+			if (r.z < box.r0.z) box.r0.z = r.z; if (r.z > box.r1.z) box.r1.z = r.z;
+		}
+	}
+	else
+	{
+		box.r0 = box.r1 = m_mesh->Node(el.m_node[0]).m_rt;
+		for (int j = 1; j < neln; ++j)
+		{
+			const vec3d& r = m_mesh->Node(el.m_node[j]).m_rt;
+			if (r.x < box.r0.x) box.r0.x = r.x; if (r.x > box.r1.x) box.r1.x = r.x;
+			if (r.y < box.r0.y) box.r0.y = r.y; if (r.y > box.r1.y) box.r1.y = r.y;
+			if (r.z < box.r0.z) box.r0.z = r.z; if (r.z > box.r1.z) box.r1.z = r.z;
+		}
+	}
+
+	// inflate a little for round-off
+	if (m_inflate > 0.0)
+	{
+		vec3d d = box.r1 - box.r0;
+		double R = d.x;
+		if (d.y > R) R = d.y;
+		if (d.z > R) R = d.z;
+		double dr = R*m_inflate;
+		box.r0 -= vec3d(dr, dr, dr);
+		box.r1 += vec3d(dr, dr, dr);
+	}
+
+	return box;
+}
+
+//-----------------------------------------------------------------------------
+// Recalculate all bounding boxes. The tree topology is not changed, so the
+// hierarchy remains valid (although it may become less efficient) when the mesh deforms. 
+void FEElementBVH::Refit()
+{
+	int NE = (int)m_perm.size();
+	if (NE == 0) return;
+
+	// element boxes
+#pragma omp parallel for if (NE > 1000)
+	for (int i = 0; i < NE; ++i)
+	{
+		m_ebox[i] = ElementBox(*m_elem[m_perm[i]]);
+	}
+
+	// node boxes (children are stored after their parents, so we can loop backwards)
+	for (int i = (int)m_node.size() - 1; i >= 0; --i)
+	{
+		Node& node = m_node[i];
+		Box box;
+		if (node.left == -1)
+		{
+			box = m_ebox[node.first];
+			for (int j = 1; j < node.count; ++j)
+			{
+				const Box& bj = m_ebox[node.first + j];
+				box.r0.x = std::min(box.r0.x, bj.r0.x); box.r1.x = std::max(box.r1.x, bj.r1.x);
+				box.r0.y = std::min(box.r0.y, bj.r0.y); box.r1.y = std::max(box.r1.y, bj.r1.y);
+				box.r0.z = std::min(box.r0.z, bj.r0.z); box.r1.z = std::max(box.r1.z, bj.r1.z);
+			}
+		}
+		else
+		{
+			const Box& bl = m_node[node.left].box;
+			const Box& br = m_node[node.right].box;
+			box.r0.x = std::min(bl.r0.x, br.r0.x); box.r1.x = std::max(bl.r1.x, br.r1.x);
+			box.r0.y = std::min(bl.r0.y, br.r0.y); box.r1.y = std::max(bl.r1.y, br.r1.y);
+			box.r0.z = std::min(bl.r0.z, br.r0.z); box.r1.z = std::max(bl.r1.z, br.r1.z);
+		}
+		node.box = box;
+	}
+}
+
+//-----------------------------------------------------------------------------
+FESolidElement* FEElementBVH::FindElement(const vec3d& y, double r[3]) const
+{
+	std::vector<int> tmp;
+	return FindElement(y, r, tmp);
+}
+
+//-----------------------------------------------------------------------------
+// tmp is used to store the candidate elements, i.e. the elements whose bounding box contains y.
+FESolidElement* FEElementBVH::FindElement(const vec3d& y, double r[3], std::vector<int>& tmp) const
+{
+	if (m_node.empty()) return nullptr;
+
+	// collect all the candidates
+	tmp.clear();
+	int stack[BVH_MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const Node& node = m_node[stack[--ns]];
+		if (node.box.IsInside(y) == false) continue;
+
+		if (node.left == -1)
+		{
+			for (int i = node.first; i < node.first + node.count; ++i)
+			{
+				if (m_ebox[i].IsInside(y)) tmp.push_back(m_perm[i]);
+			}
+		}
+		else
+		{
+			assert(ns + 2 <= BVH_MAX_STACK);
+			stack[ns++] = node.right;
+			stack[ns++] = node.left;
+		}
+	}
+
+	// Process the candidates in the order the elements were added, 
+	// so that we find the same element as a linear search would. 
+	if (tmp.size() > 1) std::sort(tmp.begin(), tmp.end());
+
+	for (size_t i = 0; i < tmp.size(); ++i)
+	{
+		FESolidElement& e = *m_elem[tmp[i]];
+		FESolidDomain* dom = static_cast<FESolidDomain*>(e.GetMeshPartition());
+		if (m_config == REFERENCE_CONFIG)
+		{
+			// apply a Newton method to find the isoparametric coordinates r
+			if (dom->ProjectToReferenceElement(e, y, r)) return &e;
+		}
+		else
+		{
+			// apply a Newton method to find the isoparametric coordinates r
+			dom->ProjectToElement(e, y, r);
+
+			// see if the point r lies inside the element
+			const double eps = 1.0001;
+			if ((r[0] >= -eps) && (r[0] <= eps) &&
+				(r[1] >= -eps) && (r[1] <= eps) &&
+				(r[2] >= -eps) && (r[2] <= eps)) return &e;
+		}
+	}
+
+	return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+int FEElementBVH::FindElements(const std::vector<vec3d>& y, std::vector<FESolidElement*>& el, std::vector<double>& r) const
+{
+	int N = (int)y.size();
+	el.assign(N, nullptr);
+	r.assign(3 * N, 0.0);
+
+	int nfound = 0;
+#pragma omp parallel if (N > 1) reduction(+:nfound)
+	{
+		std::vector<int> tmp;
+#pragma omp for schedule(dynamic, 64)
+		for (int i = 0; i < N; ++i)
+		{
+			el[i] = FindElement(y[i], &r[3 * i], tmp);
+			if (el[i]) nfound++;
+		}
+	}
+
+	return nfound;
+}
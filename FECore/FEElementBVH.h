@@ -0,0 +1,119 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include "vec3d.h"
+#include <vector>
+
+class FEMesh;
+class FESolidDomain;
+class FESolidElement;
+
+//-----------------------------------------------------------------------------
+//! This class builds a bounding volume hierarchy (BVH) over solid elements and
+//! uses it to find the element that contains a given point. 
+//! The hierarchy can be built for the reference or the current configuration. 
+//! When the nodes move, Refit() updates the bounding boxes without rebuilding 
+//! the tree. Queries return the same element as a linear search over the elements
+//! (i.e. the first element in domain order that contains the point). 
+class FECORE_API FEElementBVH
+{
+public:
+	enum Configuration {
+		REFERENCE_CONFIG,
+		CURRENT_CONFIG
+	};
+
+private:
+	// axis-aligned box
+	struct Box
+	{
+		vec3d	r0, r1;
+
+		bool IsInside(const vec3d& r) const
+		{
+			return ((r.x >= r0.x) && (r.y >= r0.y) && (r.z >= r0.z) && (r.x <= r1.x) && (r.y <= r1.y) && (r.z <= r1.z));
+		}
+	};
+
+	// node of the tree
+	struct Node
+	{
+		Box		box;
+		int		left, right;	// child nodes (-1 for leaves)
+		int		first, count;	// range of elements in a leaf
+	};
+
+public:
+	FEElementBVH(FEMesh* mesh, Configuration config = REFERENCE_CONFIG);
+	~FEElementBVH();
+
+	//! build the hierarchy for the elements of a solid domain. 
+	//! The element boxes are inflated by the relative amount inflate for round-off.
+	bool Build(FESolidDomain* dom, double inflate = 0.0);
+
+	//! build the hierarchy for all the solid elements of the mesh
+	bool Build(double inflate = 0.0);
+
+	//! update the bounding boxes for the current nodal positions
+	void Refit();
+
+	//! clear all data
+	void Clear();
+
+	//! number of elements in the hierarchy
+	int Elements() const { return (int)m_elem.size(); }
+
+	//! the configuration this hierarchy was built for
+	Configuration GetConfiguration() const { return m_config; }
+
+	//! find the element in which point y lies and return the iso-parametric coordinates in r
+	FESolidElement* FindElement(const vec3d& y, double r[3]) const;
+
+	//! find the elements for a list of points. The iso-parametric coordinates are returned in r 
+	//! (three values per point). If no element is found for a point, its element is set to zero.
+	//! Returns the number of points that were found. 
+	int FindElements(const std::vector<vec3d>& y, std::vector<FESolidElement*>& el, std::vector<double>& r) const;
+
+private:
+	bool BuildTree(double inflate);
+	int BuildNode(int first, int count, std::vector<vec3d>& c);
+	Box ElementBox(FESolidElement& el) const;
+	FESolidElement* FindElement(const vec3d& y, double r[3], std::vector<int>& tmp) const;
+
+private:
+	FEMesh*			m_mesh;
+	Configuration	m_config;
+	double			m_inflate;
+
+	std::vector<FESolidElement*>	m_elem;	//!< list of elements (in the order they were added)
+	std::vector<int>				m_perm;	//!< element index for each leaf slot
+	std::vector<Box>				m_ebox;	//!< element boxes (in leaf order)
+	std::vector<Node>				m_node;	//!< nodes of the tree (children are always stored after their parents)
+};
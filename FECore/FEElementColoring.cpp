@@ -0,0 +1,98 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEElementColoring.h"
+#include "FENodeElemList.h"
+#include "FEDomain.h"
+
+//-----------------------------------------------------------------------------
+FEElementColoring::FEElementColoring()
+{
+}
+
+//-----------------------------------------------------------------------------
+void FEElementColoring::Clear()
+{
+	m_elem.clear();
+	m_pc.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEElementColoring::Create(FEDomain& dom)
+{
+	Clear();
+	const int NE = dom.Elements();
+	if (NE == 0) return;
+
+	// we need to know which elements share a node
+	FENodeElemList NEL;
+	NEL.Create(dom);
+
+	// greedy coloring: assign each element the smallest color that is not
+	// yet used by any of the elements it shares a node with.
+	std::vector<int> color(NE, -1);
+	std::vector<int> tag;	// tag[c] == i if color c is used by a neighbor of element i
+	int ncolors = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		int ne = el.Nodes();
+		for (int j = 0; j < ne; ++j)
+		{
+			int n = el.m_node[j];
+			int nval = NEL.Valence(n);
+			int* eli = NEL.ElementIndexList(n);
+			for (int k = 0; k < nval; ++k)
+			{
+				int ck = color[eli[k]];
+				if (ck >= 0) tag[ck] = i;
+			}
+		}
+
+		int c = 0;
+		while ((c < ncolors) && (tag[c] == i)) ++c;
+		if (c == ncolors)
+		{
+			tag.push_back(-1);
+			ncolors++;
+		}
+		color[i] = c;
+	}
+
+	// count the elements of each color
+	m_pc.assign(ncolors + 1, 0);
+	for (int i = 0; i < NE; ++i) m_pc[color[i] + 1]++;
+	for (int c = 0; c < ncolors; ++c) m_pc[c + 1] += m_pc[c];
+
+	// fill the element list
+	m_elem.resize(NE);
+	std::vector<int> pos(m_pc.begin(), m_pc.end() - 1);
+	for (int i = 0; i < NE; ++i) m_elem[pos[color[i]]++] = i;
+}
@@ -36,6 +36,8 @@ SOFTWARE.*/
 FEElementMatrix::FEElementMatrix(const FEElement& el)
 {
 	m_node = el.m_node;
+	m_scatter = nullptr;
+	m_lockFree = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -44,6 +46,8 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke) : matrix(ke)
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
+	m_scatter = ke.m_scatter;
+	m_lockFree = ke.m_lockFree;
 }
 
 //-----------------------------------------------------------------------------
@@ -52,6 +56,8 @@ FEElementMatrix::FEElementMatrix(const FEElementMatrix& ke, double scale)
 	m_node = ke.m_node;
 	m_lmi = ke.m_lmi;
 	m_lmj = ke.m_lmj;
+	m_scatter = ke.m_scatter;
+	m_lockFree = ke.m_lockFree;
 	matrix& T = *this;
 	const matrix& K = ke;
 	T = (scale == 1.0 ? K : K*scale);
@@ -63,6 +69,8 @@ FEElementMatrix::FEElementMatrix(const FEElement& el, const vector<int>& lmi) :
 	m_node = el.m_node;
 	m_lmi = lmi;
 	m_lmj = lmi;
+	m_scatter = nullptr;
+	m_lockFree = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -71,6 +79,8 @@ FEElementMatrix::FEElementMatrix(const FEElement& el, vector<int>& lmi, vector<i
 	m_node = el.m_node;
 	m_lmi = lmi;
 	m_lmj = lmj;
+	m_scatter = nullptr;
+	m_lockFree = false;
 };
 
 //-----------------------------------------------------------------------------
@@ -90,6 +100,8 @@ FEGlobalMatrix::FEGlobalMatrix(SparseMatrix* pK, bool del)
 	m_pMP = 0;
 	m_nlm = 0;
 	m_delA = del;
+	m_bcolored = false;
+	m_bscatter = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -99,12 +111,21 @@ FEGlobalMatrix::~FEGlobalMatrix()
 	if (m_delA) delete m_pA;
 	m_pA = 0;
 	if (m_pMP) delete m_pMP;
+	ClearAssemblyMaps();
 }
 
 //-----------------------------------------------------------------------------
 void FEGlobalMatrix::Clear()
 { 
 	if (m_pA) m_pA->Clear(); 
+	ClearAssemblyMaps();
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::ClearAssemblyMaps()
+{
+	for (auto it = m_amap.begin(); it != m_amap.end(); ++it) delete it->second;
+	m_amap.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -169,6 +190,9 @@ void FEGlobalMatrix::build_end()
 {
 	if (m_nlm > 0) build_flush();
 	m_pA->Create(*m_pMP);
+
+	// the assembly maps are no longer valid
+	ClearAssemblyMaps();
 }
 
 //-----------------------------------------------------------------------------
@@ -316,5 +340,79 @@ bool FEGlobalMatrix::Create(const FESurface& surf, const std::vector<int>& equat
 
 void FEGlobalMatrix::Assemble(const FEElementMatrix& ke)
 {
-	m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+	const int* map = ke.ScatterMap();
+	if (map) m_pA->AssembleScatter(ke, ke.RowIndices(), map, (ke.IsLockFree() == false));
+	else m_pA->Assemble(ke, ke.RowIndices(), ke.ColumnsIndices());
+}
+
+//-----------------------------------------------------------------------------
+FEDomainAssemblyMap* FEGlobalMatrix::GetAssemblyMap(FEDomain& dom, int ndpn)
+{
+	// nothing to do if neither colored assembly nor scatter maps are used
+	if ((m_bcolored == false) && (m_bscatter == false)) return nullptr;
+
+	// see if we already have a map for this domain
+	FEDomainAssemblyMap* amap = nullptr;
+	auto it = m_amap.find(&dom);
+	if (it != m_amap.end()) amap = it->second;
+	else
+	{
+		amap = new FEDomainAssemblyMap;
+		m_amap[&dom] = amap;
+		if (m_bscatter) BuildScatterMaps(dom, ndpn, *amap);
+	}
+
+	// color the elements (the coloring is only created when it is needed)
+	if (m_bcolored && amap->m_colors.IsEmpty()) amap->m_colors.Create(dom);
+
+	// if we only use scatter maps, but the matrix format doesn't support them, there is nothing to return.
+	if ((m_bcolored == false) && (amap->HasScatterMaps() == false)) return nullptr;
+
+	return amap;
+}
+
+//-----------------------------------------------------------------------------
+// Build the scatter maps of all the elements of a domain
+void FEGlobalMatrix::BuildScatterMaps(FEDomain& dom, int ndpn, FEDomainAssemblyMap& amap)
+{
+	// figure out the size of the scatter maps
+	const int NE = dom.Elements();
+	amap.m_off.resize(NE + 1);
+	amap.m_off[0] = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		int n = ndpn*dom.ElementRef(i).Nodes();
+		int m = m_pA->ScatterMapSize(n);
+
+		// the sparse matrix doesn't support scatter maps
+		if (m == 0)
+		{
+			amap.m_off.clear();
+			return;
+		}
+
+		amap.m_off[i + 1] = amap.m_off[i] + m;
+	}
+
+	// build the scatter maps
+	amap.m_map.resize(amap.m_off[NE]);
+	bool bok = true;
+	#pragma omp parallel for shared(bok)
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		vector<int> lm;
+		dom.UnpackLM(el, lm);
+		int n = ndpn*el.Nodes();
+		if ((int)lm.size() >= n)
+			m_pA->BuildScatterMap(lm, n, &amap.m_map[amap.m_off[i]]);
+		else bok = false;
+	}
+
+	// If the LM vectors don't match the assumed layout (e.g. mixed interpolation), we can't use scatter maps.
+	if (bok == false)
+	{
+		amap.m_off.clear();
+		amap.m_map.clear();
+	}
 }
@@ -30,13 +30,16 @@ SOFTWARE.*/
 
 #include "SparseMatrix.h"
 #include "FESolver.h"
+#include "FEElementColoring.h"
 #include <vector>
+#include <map>
 
 //-----------------------------------------------------------------------------
 class FEModel;
 class FEMesh;
 class FESurface;
 class FEElement;
+class FEDomain;
 
 //-----------------------------------------------------------------------------
 //! This class represents an element matrix, i.e. a matrix of values and the row and
@@ -45,8 +48,8 @@ class FECORE_API FEElementMatrix : public matrix
 {
 public:
 	// default constructor
-	FEElementMatrix(){}
-	FEElementMatrix(int nr, int nc) : matrix(nr, nc) {}
+	FEElementMatrix() : m_scatter(nullptr), m_lockFree(false) {}
+	FEElementMatrix(int nr, int nc) : matrix(nr, nc), m_scatter(nullptr), m_lockFree(false) {}
 	FEElementMatrix(const FEElement& el);
 
 	// constructor for symmetric matrices
@@ -71,10 +74,10 @@ public:
 	const std::vector<int>& ColumnsIndices() const { return m_lmj; }
 
 	// set the row and columnd indices (assuming they are the same)
-	void SetIndices(const std::vector<int>& lm) { m_lmi = m_lmj = lm; }
+	void SetIndices(const std::vector<int>& lm) { m_lmi = m_lmj = lm; m_scatter = nullptr; }
 
 	// set the row and columnd indices
-	void SetIndices(const std::vector<int>& lmr, const std::vector<int>& lmc) { m_lmi = lmr; m_lmj = lmc; }
+	void SetIndices(const std::vector<int>& lmr, const std::vector<int>& lmc) { m_lmi = lmr; m_lmj = lmc; m_scatter = nullptr; }
 
 	// Set the node indices
 	void SetNodes(const std::vector<int>& en) { m_node = en; }
@@ -82,10 +85,46 @@ public:
 	// get the nodes
 	const std::vector<int>& Nodes() const { return m_node; }
 
+	// Set the precomputed scatter map of this element (see FEDomainAssemblyMap).
+	// Set lockFree to true if no other thread can assemble into the same matrix entries
+	// concurrently (e.g. during element-colored assembly).
+	void SetScatterMap(const int* map, bool lockFree = false) { m_scatter = map; m_lockFree = lockFree; }
+
+	// get the scatter map (or nullptr if it was not set)
+	const int* ScatterMap() const { return m_scatter; }
+
+	// see if this element matrix can be assembled without atomic updates
+	bool IsLockFree() const { return m_lockFree; }
+
 private:
 	std::vector<int>	m_node;	//!< node indices
 	std::vector<int>	m_lmi;	//!< row indices
 	std::vector<int>	m_lmj;	//!< column indices
+	const int*			m_scatter;	//!< scatter map (offsets into sparse matrix values)
+	bool				m_lockFree;	//!< assemble without atomics
+};
+
+//-----------------------------------------------------------------------------
+//! This class stores the data that is needed for the assembly of a domain, i.e. 
+//! the element coloring (for element-colored assembly) and the element scatter maps. 
+//! Since this data only depends on the sparsity pattern of the global matrix, the 
+//! FEGlobalMatrix creates it once per matrix profile and deletes it when the profile
+//! is rebuilt, so it can be reused for all Newton iterations in between.
+class FECORE_API FEDomainAssemblyMap
+{
+public:
+	FEDomainAssemblyMap() {}
+
+	//! see if the scatter maps were created
+	bool HasScatterMaps() const { return (m_map.empty() == false); }
+
+	//! return the scatter map of an element (or nullptr if the matrix format does not support scatter maps)
+	const int* ScatterMap(int iel) const { return (m_map.empty() ? nullptr : &m_map[0] + m_off[iel]); }
+
+public:
+	FEElementColoring	m_colors;	//!< element coloring
+	std::vector<int>	m_off;		//!< start of each element's scatter map in m_map
+	std::vector<int>	m_map;		//!< the element scatter maps
 };
 
 //-----------------------------------------------------------------------------
@@ -132,6 +171,25 @@ public:
 	//! Assembly routine
 	virtual void Assemble(const FEElementMatrix& ke);
 
+	//! turn element-colored assembly on or off
+	void SetColoredAssembly(bool b) { if (b != m_bcolored) ClearAssemblyMaps(); m_bcolored = b; }
+
+	//! see if element-colored assembly is enabled
+	bool ColoredAssembly() const { return m_bcolored; }
+
+	//! turn the caching of element scatter maps on or off
+	void SetScatterMaps(bool b) { if (b != m_bscatter) ClearAssemblyMaps(); m_bscatter = b; }
+
+	//! see if element scatter maps are used
+	bool ScatterMaps() const { return m_bscatter; }
+
+	//! Get the assembly map for a domain. The map is created the first time it is 
+	//! requested after the matrix profile was built. The ndpn parameter is the number of 
+	//! dofs per node in the element matrices, which are assumed to be in the order of the 
+	//! domain's UnpackLM function. This must not be called from a parallel region.
+	//! Returns nullptr if neither colored assembly nor scatter maps can be used.
+	FEDomainAssemblyMap* GetAssemblyMap(FEDomain& dom, int ndpn);
+
 	//! return the nonzeroes in the sparse matrix
 	int NonZeroes() { return m_pA->NonZeroes(); }
 
@@ -159,6 +217,13 @@ public:
 	void build_end();
 	void build_flush();
 
+protected:
+	//! delete all assembly maps
+	void ClearAssemblyMaps();
+
+	//! build the element scatter maps of a domain
+	void BuildScatterMaps(FEDomain& dom, int ndpn, FEDomainAssemblyMap& amap);
+
 protected:
 	SparseMatrix*	m_pA;	//!< the actual global stiffness matrix
 	bool			m_delA;	//!< delete A in destructor
@@ -170,4 +235,8 @@ protected:
 	SparseMatrixProfile		m_MPs;		//!< the "static" part of the matrix profile
 	vector< vector<int> >	m_LM;		//!< used for building the stiffness matrix
 	int	m_nlm;				//!< nr of elements in m_LM array
+
+	bool	m_bcolored;		//!< use element-colored assembly
+	bool	m_bscatter;		//!< cache element scatter maps
+	std::map<FEDomain*, FEDomainAssemblyMap*>	m_amap;	//!< assembly maps of domains
 };
@@ -30,25 +30,100 @@ SOFTWARE.*/
 #include "FEGlobalVector.h"
 #include "vec3d.h"
 #include "FEModel.h"
+#include "sys.h"
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::FEGlobalVector(FEModel& fem, vector<double>& R, vector<double>& Fr) : m_fem(fem), m_R(R), m_Fr(Fr)
 {
+	m_buf = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 FEGlobalVector::~FEGlobalVector()
 {
+	// make sure nothing is lost if the caller forgot to flush
+	Flush();
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::SetThreadBuffers(vector< vector<double> >* buf)
+{
+	Flush();
+	m_buf = buf;
+	if (m_buf == nullptr) { m_used.clear(); return; }
+
+	// the buffers are kept zeroed between evaluations, so we only need
+	// to (re)initialize them when the size changes.
+	int nt = omp_get_max_threads();
+	size_t N = m_R.size() + m_Fr.size();
+	vector< vector<double> >& B = *m_buf;
+	if ((int)B.size() != nt) B.resize(nt);
+	for (int i = 0; i < nt; ++i)
+	{
+		if (B[i].size() != N) B[i].assign(N, 0.0);
+	}
+	m_used.assign(nt, 0);
+}
 
+//-----------------------------------------------------------------------------
+vector<double>* FEGlobalVector::ThreadBuffer()
+{
+	if ((m_buf == nullptr) || (omp_in_parallel() == 0)) return nullptr;
+	int n = omp_get_thread_num();
+	if (n >= (int)m_used.size()) return nullptr;
+	m_used[n] = 1;
+	return &(*m_buf)[n];
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalVector::Flush()
+{
+	if (m_buf == nullptr) return;
+
+	// collect the buffers that were written to
+	vector< vector<double> >& B = *m_buf;
+	vector<double*> buf;
+	for (size_t i = 0; i < m_used.size(); ++i)
+	{
+		if (m_used[i]) { buf.push_back(&B[i][0]); m_used[i] = 0; }
+	}
+	const int nb = (int)buf.size();
+	if (nb == 0) return;
+
+	// add them up in thread order and reset them for the next evaluation
+	const int neq = (int)m_R.size();
+	const int N = neq + (int)m_Fr.size();
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < N; ++i)
+	{
+		double s = 0.0;
+		for (int j = 0; j < nb; ++j) { s += buf[j][i]; buf[j][i] = 0.0; }
+		if (i < neq) m_R[i] += s; else m_Fr[i - neq] += s;
+	}
 }
 
 //-----------------------------------------------------------------------------
 void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>& fe, bool bdom)
 {
+	// assemble the element residual into the thread's buffer, if we have one
+	int ndof = (int)fe.size();
+	vector<double>* buf = ThreadBuffer();
+	if (buf)
+	{
+		vector<double>& B = *buf;
+		const int neq = (int)m_R.size();
+		for (int i = 0; i < ndof; ++i)
+		{
+			int I = elm[i];
+			if (I >= 0) B[I] += fe[i];
+			else if (-I - 2 >= 0) B[neq - I - 2] -= fe[i];
+		}
+		return;
+	}
+
 	vector<double>& R = m_R;
 
 	// assemble the element residual into the global residual
-	int ndof = (int)fe.size();
 	for (int i=0; i<ndof; ++i)
 	{
 		int I = elm[i];
@@ -68,8 +143,19 @@ void FEGlobalVector::Assemble(vector<int>& en, vector<int>& elm, vector<double>&
 //! \todo This function does not add to m_Fr. Is this a problem?
 void FEGlobalVector::Assemble(vector<int>& lm, vector<double>& fe)
 {
-	vector<double>& R = m_R;
 	const int n = (int) lm.size();
+	vector<double>* buf = ThreadBuffer();
+	if (buf)
+	{
+		vector<double>& B = *buf;
+		for (int i = 0; i < n; ++i)
+		{
+			if (lm[i] >= 0) B[lm[i]] += fe[i];
+		}
+		return;
+	}
+
+	vector<double>& R = m_R;
 	for (int i=0; i<n; ++i)
 	{
 		int nid = lm[i];
@@ -90,7 +176,11 @@ void FEGlobalVector::Assemble(int nodeId, int dof, double f)
 
 	// assemble into global vector
 	if (n >= 0) {
+		vector<double>* buf = ThreadBuffer();
+		if (buf) (*buf)[n] += f;
+		else {
 #pragma omp atomic
-		m_R[n] += f;
+			m_R[n] += f;
+		}
 	}
 }
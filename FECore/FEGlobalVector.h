@@ -65,8 +65,26 @@ public:
 
 	operator vector<double>& () { return m_R; }
 
+	//! Use thread-private buffers for assembly instead of atomic updates.
+	//! The buffers are owned by the caller so they can be reused between evaluations.
+	//! Flush must be called before the assembled values are read.
+	void SetThreadBuffers(vector< vector<double> >* buf);
+
+	//! Add the contents of the thread buffers to the global vector.
+	//! The buffers are summed in thread order so that the result does not depend
+	//! on the order in which threads finished.
+	void Flush();
+
+protected:
+	//! Returns the buffer of the calling thread or nullptr if assembly should go directly into the global vector.
+	//! The reaction forces are stored at offset m_R.size() in this buffer.
+	vector<double>* ThreadBuffer();
+
 protected:
 	FEModel&			m_fem;	//!< model
 	vector<double>&		m_R;	//!< residual
 	vector<double>&		m_Fr;	//!< nodal reaction forces \todo I want to remove this
+
+	vector< vector<double> >*	m_buf;	//!< thread-private buffers (optional)
+	vector<char>				m_used;	//!< flags which buffers were written to since the last flush
 };
@@ -132,6 +132,9 @@ void FELinearConstraintManager::BuildMatrixProfile(FEGlobalMatrix& G)
 	int nlin = (int)m_LinC.size();
 	if (nlin == 0) return;
 
+	// the equation numbers are known now, so we can set up the constraint transformation
+	InitTransform();
+
 	FEAnalysis* pstep = m_fem->GetCurrentStep();
 	FEMesh& mesh = m_fem->GetMesh();
 
@@ -381,9 +384,59 @@ void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>&
 }
 
 //-----------------------------------------------------------------------------
-void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
+// This sets up the constraint transformation. For each linear constraint we store the
+// equation numbers and coefficients of the child dofs, so that the stiffness assembly 
+// does not need to look them up for each element. 
+void FELinearConstraintManager::InitTransform()
 {
 	FEMesh& mesh = m_fem->GetMesh();
+	int nlin = LinearConstraints();
+
+	m_childPtr.resize(nlin + 1);
+	m_childPtr[0] = 0;
+	for (int i = 0; i < nlin; ++i) m_childPtr[i + 1] = m_childPtr[i] + (int)m_LinC[i].m_childDof.size();
+
+	int nc = m_childPtr[nlin];
+	m_childEq.resize(nc);
+	m_childVal.resize(nc);
+	for (int i = 0, n = 0; i < nlin; ++i)
+	{
+		FELinearConstraint& lc = m_LinC[i];
+		for (int j = 0; j < (int)lc.m_childDof.size(); ++j, ++n)
+		{
+			FELinearConstraint::DOF& dof = lc.m_childDof[j];
+			m_childEq[n] = mesh.Node(dof.node).m_ID[dof.dof];
+			m_childVal[n] = dof.val;
+		}
+	}
+
+	m_parentNode.assign(mesh.Nodes(), 0);
+	for (int i = 0; i < nlin; ++i) m_parentNode[m_LinC[i].m_parentDof.node] = 1;
+}
+
+//-----------------------------------------------------------------------------
+bool FELinearConstraintManager::HasConstrainedNodes(const vector<int>& en) const
+{
+	const int nodes = (int)m_parentNode.size();
+	for (size_t i = 0; i < en.size(); ++i)
+	{
+		int n = en[i];
+		if ((n >= 0) && (n < nodes) && m_parentNode[n]) return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// This function can be called concurrently for different elements. The matrix is
+// updated with (atomic) SparseMatrix::add and the right-hand side with atomic updates.
+// Since these updates go to the entries of the child dofs, which belong to other
+// elements, this is only safe if every other writer to those entries is atomic as
+// well. In particular, it can't be combined with lock-free (colored) assembly.
+void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
+{
+	// elements that are not connected to a parent node don't need to be processed
+	assert(m_childPtr.size() == m_LinC.size() + 1);
+	if (HasConstrainedNodes(en) == false) return;
 
 	int ndof = ke.rows();
 	int ndn = ndof / (int)en.size();
@@ -391,109 +444,119 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 
 	SparseMatrix& K = *(&G);
 
+	// find the linear constraint of each element dof (or -1)
+	vector<int> lc(ndof);
+	for (int i = 0; i < ndof; ++i)
+	{
+		int nodei = i / ndn;
+		lc[i] = (nodei < nodes ? m_LCT(en[nodei], i%ndn) : -1);
+	}
+
 	// loop over all stiffness components 
 	// and correct for linear constraints
 	for (int i = 0; i<ndof; ++i)
 	{
-		int nodei = i / ndn;
-		int li = (nodei < nodes ? m_LCT(en[nodei], i%ndn) : -1);
+		int li = lc[i];
 		for (int j = 0; j < ndof; ++j)
 		{
-			int nodej = j / ndn;
-			int lj = (nodej < nodes ? m_LCT(en[nodej], j%ndn) : -1);
+			int lj = lc[j];
 			if ((li >= 0) && (lj < 0))
 			{
 				// dof i is constrained
-				FELinearConstraint& Li = m_LinC[li];
-
 				assert(lmi[i] == -1);
 
-				vector<FELinearConstraint::DOF>::iterator is = Li.m_childDof.begin();
-				for (int k = 0; k < (int)Li.m_childDof.size(); ++k, ++is)
+				int J = lmj[j];
+				for (int k = m_childPtr[li]; k < m_childPtr[li + 1]; ++k)
 				{
-					int I = mesh.Node(is->node).m_ID[is->dof];
-					int J = lmj[j];
-					double kij = is->val*ke[i][j];
+					int I = m_childEq[k];
+					double kij = m_childVal[k]*ke[i][j];
 					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
 					else
 					{
 						// adjust for prescribed dofs
-						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+						int P = -J - 2;
+						if ((P >= 0) && (I >= 0))
+						{
+#pragma omp atomic
+							R[I] -= kij*ui[P];
+						}
 					}
 				}
 			}
 			else if ((lj >= 0) && (li < 0))
 			{
 				// dof j is constrained
-				FELinearConstraint& Lj = m_LinC[lj];
-
 				assert(lmj[j] == -1);
 
-				vector<FELinearConstraint::DOF>::iterator js = Lj.m_childDof.begin();
-
-				for (int k = 0; k < (int)Lj.m_childDof.size(); ++k, ++js)
+				int I = lmi[i];
+				for (int k = m_childPtr[lj]; k < m_childPtr[lj + 1]; ++k)
 				{
-					int I = lmi[i];
-					int J = mesh.Node(js->node).m_ID[js->dof];
-					double kij = js->val*ke[i][j];
+					int J = m_childEq[k];
+					double kij = m_childVal[k]*ke[i][j];
 					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
 					else
 					{
 						// adjust for prescribed dofs
 						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+						if ((J >= 0) && (I >= 0))
+						{
+#pragma omp atomic
+							R[I] -= kij*ui[J];
+						}
 					}
 				}
 
 				// adjust right-hand side for inhomogeneous linear constraints
-				if (Lj.m_off != 0.0)
+				if (m_LinC[lj].m_off != 0.0)
 				{
 					double ri = ke[i][j] * m_up[lj];
-					int I = lmi[i];
-					if (I >= 0) R[i] -= ri;
+					if (I >= 0)
+					{
+#pragma omp atomic
+						R[I] -= ri;
+					}
 				}
 			}
 			else if ((li >= 0) && (lj >= 0))
 			{
 				// both dof i and j are constrained
-				FELinearConstraint& Li = m_LinC[li];
-				FELinearConstraint& Lj = m_LinC[lj];
-
-				vector<FELinearConstraint::DOF>::iterator is = Li.m_childDof.begin();
-				vector<FELinearConstraint::DOF>::iterator js = Lj.m_childDof.begin();
-
 				assert(lmi[i] == -1);
 				assert(lmj[j] == -1);
 
-				for (int k = 0; k < (int)Li.m_childDof.size(); ++k, ++is)
+				for (int k = m_childPtr[li]; k < m_childPtr[li + 1]; ++k)
 				{
-					js = Lj.m_childDof.begin();
-					for (int l = 0; l < (int)Lj.m_childDof.size(); ++l, ++js)
+					int I = m_childEq[k];
+					for (int l = m_childPtr[lj]; l < m_childPtr[lj + 1]; ++l)
 					{
-						int I = mesh.Node(is->node).m_ID[is->dof];
-						int J = mesh.Node(js->node).m_ID[js->dof];;
-						double kij = ke[i][j] * is->val*js->val;
+						int J = m_childEq[l];
+						double kij = ke[i][j] * m_childVal[k]*m_childVal[l];
 
 						if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
 						else
 						{
 							// adjust for prescribed dofs
 							J = -J - 2;
-							if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+							if ((J >= 0) && (I >= 0))
+							{
+#pragma omp atomic
+								R[I] -= kij*ui[J];
+							}
 						}
 					}
 				}
 
 				// adjust for inhomogeneous linear constraints
-				if (Lj.m_off != 0.0)
+				if (m_LinC[lj].m_off != 0.0)
 				{
-					is = Li.m_childDof.begin();
-					for (int k = 0; k < (int)Li.m_childDof.size(); ++k, ++is)
+					for (int k = m_childPtr[li]; k < m_childPtr[li + 1]; ++k)
 					{
-						int I = mesh.Node(is->node).m_ID[is->dof];
-						double ri = is->val * ke[i][j] * m_up[lj];
-						if (I >= 0) R[i] -= ri;
+						int I = m_childEq[k];
+						double ri = m_childVal[k] * ke[i][j] * m_up[lj];
+						if (I >= 0)
+						{
+#pragma omp atomic
+							R[I] -= ri;
+						}
 					}
 				}
 			}
@@ -86,12 +86,25 @@ public:
 	// update nodal variables
 	void Update();
 
+	// see if any of the nodes is the parent node of a linear constraint
+	bool HasConstrainedNodes(const vector<int>& en) const;
+
 protected:
 	void InitTable();
 
+	// build the constraint transformation (requires equation numbers)
+	void InitTransform();
+
 private:
 	FEModel* m_fem;
 	vector<FELinearConstraint>	m_LinC;		//!< linear constraints data
 	table<int>					m_LCT;		//!< linear constraint table
 	vector<double>				m_up;		//!< the inhomogenous component of the linear constraint
+
+	// constraint transformation, i.e. for each linear constraint the equation numbers 
+	// and coefficients of its child dofs (in compressed row format)
+	vector<int>		m_childPtr;		//!< start of each constraint in m_childEq and m_childVal
+	vector<int>		m_childEq;		//!< equation numbers of child dofs
+	vector<double>	m_childVal;		//!< coefficients of child dofs
+	vector<char>	m_parentNode;	//!< flags nodes that are the parent of a linear constraint
 };
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FELinearSystem.h"
 #include "FELinearConstraintManager.h"
 #include "FEModel.h"
+#include "MatrixFreeOperator.h"
 
 //-----------------------------------------------------------------------------
 FELinearSystem::FELinearSystem(FESolver* solver, FEGlobalMatrix& K, vector<double>& F, vector<double>& u, bool bsymm) : m_K(K), m_F(F), m_u(u), m_solver(solver)
@@ -98,8 +99,11 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 	}
 
-#pragma omp critical
-	{
+	// adjust for linear constraints
+	// NOTE: This can be called concurrently as long as all other writes to the child
+	//       entries are atomic too, which is why lock-free colored assembly is disabled
+	//       when there are linear constraints (see ColoredAssemblyMap). Elements that
+	//       are not connected to a linear constraint return right away.
 	FEModel* fem = m_solver->GetFEModel();
 	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
 	if (LCM.LinearConstraints())
@@ -107,7 +111,6 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		const vector<int>& en = ke.Nodes();
 		LCM.AssembleStiffness(m_K, m_F, m_u, en, lmi, lmj, ke);
 	}
-	} // omp critical
 }
 
 //-----------------------------------------------------------------------------
@@ -142,3 +145,30 @@ void FELinearSystem::AssembleRHS(vector<int>& lm, vector<double>& fe)
 		}
 	}
 }
+
+//-----------------------------------------------------------------------------
+FEDomainAssemblyMap* FELinearSystem::ColoredAssemblyMap(FEDomain& dom, int ndpn)
+{
+	if (m_K.ColoredAssembly() == false) return nullptr;
+
+	// The coloring only guarantees that elements of the same color don't share nodes.
+	// Linear constraints couple the nodes of different elements, so the constraint
+	// assembly of one element can write to the matrix entries of another element of
+	// the same color. In that case we fall back to the (atomic) uncolored assembly.
+	FEModel* fem = m_solver->GetFEModel();
+	if (fem->GetLinearConstraintManager().LinearConstraints() > 0) return nullptr;
+
+	return m_K.GetAssemblyMap(dom, ndpn);
+}
+
+//-----------------------------------------------------------------------------
+FEDomainAssemblyMap* FELinearSystem::AssemblyMap(FEDomain& dom, int ndpn)
+{
+	return m_K.GetAssemblyMap(dom, ndpn);
+}
+
+//-----------------------------------------------------------------------------
+MatrixFreeOperator* FELinearSystem::GetMatrixFreeOperator()
+{
+	return dynamic_cast<MatrixFreeOperator*>(m_K.GetSparseMatrixPtr());
+}
@@ -33,6 +33,7 @@ SOFTWARE.*/
 using namespace std;
 
 class FESolver;
+class MatrixFreeOperator;
 
 //-----------------------------------------------------------------------------
 // Experimental class to see if all the assembly operations can be moved to a class
@@ -69,6 +70,19 @@ public:
 	// This assembles a vetor to the RHS
 	void AssembleRHS(vector<int>& lm, vector<double>& fe);
 
+	// Get the assembly map of a domain for element-colored assembly. Returns nullptr
+	// if colored assembly is not enabled, or if the model has linear constraints.
+	// See FEGlobalMatrix::GetAssemblyMap.
+	FEDomainAssemblyMap* ColoredAssemblyMap(FEDomain& dom, int ndpn);
+
+	// Get the assembly map of a domain. Returns nullptr if there is no assembly map
+	// for this domain (e.g. when the matrix format does not support scatter maps).
+	FEDomainAssemblyMap* AssemblyMap(FEDomain& dom, int ndpn);
+
+	// Get the matrix-free operator if the global matrix is not stored (returns nullptr otherwise).
+	// Domains can use this to add their contribution to the matrix-vector product directly.
+	MatrixFreeOperator* GetMatrixFreeOperator();
+
 protected:
 	bool			m_bsymm;	//!< symmetry flag
 	FESolver*		m_solver;
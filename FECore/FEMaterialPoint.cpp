@@ -36,9 +36,60 @@ FEMaterialPoint::FEMaterialPoint(FEMaterialPoint* ppt)
 	m_pPrev = 0;
 	m_pNext = ppt;
 	m_elem = 0;
+	m_layout = 0;
+	m_slot = -1;
 	if (ppt) ppt->m_pPrev = this;
 }
 
+// NOTE: A copy is not part of the original's layout, so the layout is not copied.
+FEMaterialPoint::FEMaterialPoint(const FEMaterialPoint& mp)
+{
+	m_r0 = mp.m_r0;
+	m_J0 = mp.m_J0;
+	m_Jt = mp.m_Jt;
+	m_elem = mp.m_elem;
+	m_index = mp.m_index;
+	m_shape = mp.m_shape;
+	m_pNext = mp.m_pNext;
+	m_pPrev = mp.m_pPrev;
+	m_layout = 0;
+	m_slot = -1;
+}
+
+FEMaterialPoint& FEMaterialPoint::operator = (const FEMaterialPoint& mp)
+{
+	m_r0 = mp.m_r0;
+	m_J0 = mp.m_J0;
+	m_Jt = mp.m_Jt;
+	m_elem = mp.m_elem;
+	m_index = mp.m_index;
+	m_shape = mp.m_shape;
+	m_pNext = mp.m_pNext;
+	m_pPrev = mp.m_pPrev;
+	return *this;
+}
+
+// Each allocation is preceded by a header that stores the arena it came from
+// (or null if it was allocated on the heap). The header keeps the 16-byte alignment.
+#define MP_HEADER_SIZE	16
+
+void* FEMaterialPoint::operator new(size_t size)
+{
+	FEMaterialPointArena* arena = FEMaterialPointArena::Current();
+	char* p = (char*)(arena ? arena->Allocate(size + MP_HEADER_SIZE) : ::operator new(size + MP_HEADER_SIZE));
+	*((FEMaterialPointArena**)p) = arena;
+	return p + MP_HEADER_SIZE;
+}
+
+void FEMaterialPoint::operator delete(void* p)
+{
+	if (p == 0) return;
+	char* pc = (char*)p - MP_HEADER_SIZE;
+
+	// memory from an arena is released by the arena
+	if (*((FEMaterialPointArena**)pc) == 0) ::operator delete(pc);
+}
+
 FEMaterialPoint::~FEMaterialPoint()
 { 
 	if (m_pNext) delete m_pNext;
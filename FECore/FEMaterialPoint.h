@@ -30,6 +30,7 @@ SOFTWARE.*/
 
 #include "mat3d.h"
 #include "FETimeInfo.h"
+#include "FEMaterialPointArena.h"
 #include <vector>
 using namespace std;
 
@@ -48,8 +49,15 @@ class FECORE_API FEMaterialPoint
 {
 public:
 	FEMaterialPoint(FEMaterialPoint* ppt = 0);
+	FEMaterialPoint(const FEMaterialPoint& mp);
 	virtual ~FEMaterialPoint();
 
+	FEMaterialPoint& operator = (const FEMaterialPoint& mp);
+
+	//! Material points are allocated from the active arena, if there is one.
+	static void* operator new(size_t size);
+	static void operator delete(void* p);
+
 public:
 	//! The init function is used to intialize data
 	virtual void Init();
@@ -74,9 +82,17 @@ public:
 	FEMaterialPoint* Prev() { return m_pPrev; }
     
 	//! Extract data (\todo Is it safe for a plugin to use this function?)
+	//! If the point belongs to a layout, this uses the cached offset of the data.
 	template <class T> T* ExtractData();
 	template <class T> const T* ExtractData() const;
 
+	//! Search the chain for the data (without using the cached offsets)
+	template <class T> T* FindData();
+	template <class T> const T* FindData() const;
+
+	//! assign the layout this point belongs to (see FEMaterialPointLayout)
+	void SetLayout(FEMaterialPointLayout* layout, int slot) { m_layout = layout; m_slot = slot; }
+
 	// assign the previous pointer
 	void SetPrev(FEMaterialPoint* pt);
 
@@ -101,10 +117,38 @@ public:
 protected:
 	FEMaterialPoint*	m_pNext;	//<! next data in the list
 	FEMaterialPoint*	m_pPrev;	//<! previous data in the list
+
+private:
+	FEMaterialPointLayout*	m_layout;	//!< layout of the integration point's data (or null)
+	int						m_slot;		//!< position of this point in the layout
 };
 
 //-----------------------------------------------------------------------------
 template <class T> inline T* FEMaterialPoint::ExtractData()
+{
+	if (m_layout)
+	{
+		const int nid = FEMaterialPointTypeId<T>();
+		int offset = m_layout->Offset(m_slot, nid);
+		if (offset == FEMaterialPointLayout::UNKNOWN)
+		{
+			T* p = FindData<T>();
+			m_layout->SetOffset(m_slot, nid, (p ? (int)((char*)p - (char*)this) : (int)FEMaterialPointLayout::NOT_FOUND));
+			return p;
+		}
+		return (offset == FEMaterialPointLayout::NOT_FOUND ? 0 : reinterpret_cast<T*>((char*)this + offset));
+	}
+	return FindData<T>();
+}
+
+//-----------------------------------------------------------------------------
+template <class T> inline const T* FEMaterialPoint::ExtractData() const
+{
+	return const_cast<FEMaterialPoint*>(this)->ExtractData<T>();
+}
+
+//-----------------------------------------------------------------------------
+template <class T> inline T* FEMaterialPoint::FindData()
 {
 	// first see if this is the correct type
 	T* p = dynamic_cast<T*>(this);
@@ -133,7 +177,7 @@ template <class T> inline T* FEMaterialPoint::ExtractData()
 }
 
 //-----------------------------------------------------------------------------
-template <class T> inline const T* FEMaterialPoint::ExtractData() const
+template <class T> inline const T* FEMaterialPoint::FindData() const
 {
 	// first see if this is the correct type
 	const T* p = dynamic_cast<const T*>(this);
@@ -0,0 +1,195 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEMaterialPointArena.h"
+#include "FEMaterialPoint.h"
+#include "FEMaterial.h"
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------
+// size of the chunks that the arena allocates
+#define ARENA_CHUNK_SIZE	(1 << 20)
+
+//-----------------------------------------------------------------------------
+static std::atomic<int> s_typeCounter(0);
+
+int FEMaterialPointLayout::NewTypeId()
+{
+	return s_typeCounter++;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointLayout::FEMaterialPointLayout()
+{
+	m_offset = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointLayout::~FEMaterialPointLayout()
+{
+	delete [] m_offset;
+}
+
+//-----------------------------------------------------------------------------
+// collect all the material points of an integration point
+static void collectPoints(FEMaterialPoint* pt, std::vector<FEMaterialPoint*>& pts)
+{
+	while (pt)
+	{
+		for (size_t i = 0; i < pts.size(); ++i) if (pts[i] == pt) return;
+		pts.push_back(pt);
+
+		for (int i = 0; i < pt->Components(); ++i)
+		{
+			FEMaterialPoint* pi = pt->GetPointData(i);
+			if (pi && (pi != pt)) collectPoints(pi, pts);
+		}
+
+		pt = pt->Next();
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEMaterialPointLayout::Register(FEMaterialPoint* pt)
+{
+	std::vector<FEMaterialPoint*> pts;
+	collectPoints(pt, pts);
+	const int n = (int)pts.size();
+	if ((n == 0) || (n > MAX_SLOTS)) return false;
+
+	const char* p0 = (const char*)pts[0];
+	if (m_offset == nullptr)
+	{
+		// the first chain defines the layout
+		m_type.resize(n);
+		m_pos.resize(n);
+		for (int i = 0; i < n; ++i)
+		{
+			m_type[i] = &typeid(*pts[i]);
+			m_pos[i] = (const char*)pts[i] - p0;
+		}
+
+		m_offset = new std::atomic<int>[MAX_SLOTS*MAX_TYPES];
+		for (int i = 0; i < MAX_SLOTS*MAX_TYPES; ++i) m_offset[i].store(UNKNOWN);
+	}
+	else
+	{
+		// all other chains have to match it
+		if (n != (int)m_type.size()) return false;
+		for (int i = 0; i < n; ++i)
+		{
+			if ((typeid(*pts[i]) != *m_type[i]) || ((const char*)pts[i] - p0 != m_pos[i])) return false;
+		}
+	}
+
+	for (int i = 0; i < n; ++i) pts[i]->SetLayout(this, i);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::FEMaterialPointArena()
+{
+	m_allocated = 0;
+	m_chainSize = 0;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPointArena::~FEMaterialPointArena()
+{
+	for (size_t i = 0; i < m_chunk.size(); ++i) free(m_chunk[i].m_buf);
+	m_chunk.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Reset()
+{
+	// keep the first chunk for the next allocations
+	for (size_t i = 1; i < m_chunk.size(); ++i) free(m_chunk[i].m_buf);
+	if (m_chunk.size() > 1) m_chunk.resize(1);
+	if (m_chunk.empty() == false) m_chunk[0].m_used = 0;
+	m_allocated = 0;
+}
+
+//-----------------------------------------------------------------------------
+static thread_local FEMaterialPointArena* s_currentArena = nullptr;
+
+FEMaterialPointArena* FEMaterialPointArena::Current()
+{
+	return s_currentArena;
+}
+
+//-----------------------------------------------------------------------------
+FEMaterialPoint* FEMaterialPointArena::CreateMaterialPoint(FEMaterial* pmat)
+{
+	// keep the data of one integration point in one chunk
+	Reserve(m_chainSize);
+
+	FEMaterialPointArena* prev = s_currentArena;
+	s_currentArena = this;
+	size_t n0 = m_allocated;
+	FEMaterialPoint* mp = pmat->CreateMaterialPointData();
+	s_currentArena = prev;
+
+	if (mp)
+	{
+		if (m_chainSize == 0) m_chainSize = m_allocated - n0;
+		m_layout.Register(mp);
+	}
+
+	return mp;
+}
+
+//-----------------------------------------------------------------------------
+void FEMaterialPointArena::Reserve(size_t n)
+{
+	if (m_chunk.empty() || (m_chunk.back().m_used + n > m_chunk.back().m_size))
+	{
+		Chunk c;
+		c.m_size = (n > ARENA_CHUNK_SIZE ? n : ARENA_CHUNK_SIZE);
+		c.m_buf = (char*)malloc(c.m_size);
+		c.m_used = 0;
+		m_chunk.push_back(c);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void* FEMaterialPointArena::Allocate(size_t size)
+{
+	// keep all allocations 16-byte aligned
+	size = (size + 15) & ~((size_t)15);
+	Reserve(size);
+
+	Chunk& c = m_chunk.back();
+	void* p = c.m_buf + c.m_used;
+	c.m_used += size;
+	m_allocated += size;
+	return p;
+}
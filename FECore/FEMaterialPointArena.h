@@ -0,0 +1,152 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <atomic>
+#include <typeinfo>
+#include <stddef.h>
+
+class FEMaterial;
+class FEMaterialPoint;
+
+//-----------------------------------------------------------------------------
+//! This class caches where the data of a given type can be found in the material 
+//! point data of an integration point. All integration points of a domain normally
+//! have the same chain of material points, allocated in the same order from the 
+//! domain's arena. The offset that FEMaterialPoint::ExtractData finds for one point 
+//! therefore applies to all points that share the layout, so the search (which 
+//! uses dynamic_cast) only needs to be done once per type.
+class FECORE_API FEMaterialPointLayout
+{
+public:
+	enum { MAX_SLOTS = 32, MAX_TYPES = 256 };
+
+	enum {
+		UNKNOWN   = -0x7FFFFFFF,	// offset was not determined yet
+		NOT_FOUND =  0x7FFFFFFF		// the data type is not in the chain
+	};
+
+public:
+	FEMaterialPointLayout();
+	~FEMaterialPointLayout();
+
+	//! Add the material point data of an integration point to this layout. If the 
+	//! types and relative positions of all the points in the chain match the layout,
+	//! the points are assigned a slot and can use the cached offsets.
+	bool Register(FEMaterialPoint* pt);
+
+	//! offset (in bytes) of the data with type id nid, relative to the point in the given slot
+	int Offset(int slot, int nid) const
+	{
+		if ((slot >= MAX_SLOTS) || (nid >= MAX_TYPES)) return UNKNOWN;
+		return m_offset[slot*MAX_TYPES + nid].load(std::memory_order_relaxed);
+	}
+
+	//! store an offset
+	void SetOffset(int slot, int nid, int offset)
+	{
+		if ((slot >= MAX_SLOTS) || (nid >= MAX_TYPES)) return;
+		m_offset[slot*MAX_TYPES + nid].store(offset, std::memory_order_relaxed);
+	}
+
+	//! allocate a new type id (see FEMaterialPointTypeId)
+	static int NewTypeId();
+
+private:
+	FEMaterialPointLayout(const FEMaterialPointLayout&);
+	void operator = (const FEMaterialPointLayout&);
+
+private:
+	std::vector<const std::type_info*>	m_type;	//!< type of each point in the chain
+	std::vector<ptrdiff_t>				m_pos;	//!< position relative to the first point
+	std::atomic<int>*					m_offset;	//!< cached offsets
+};
+
+//-----------------------------------------------------------------------------
+//! returns a unique id for each material point data type
+template <class T> inline int FEMaterialPointTypeId()
+{
+	static const int nid = FEMaterialPointLayout::NewTypeId();
+	return nid;
+}
+
+//-----------------------------------------------------------------------------
+//! Arena for the material point data of a domain. The material points of the
+//! integration points are allocated contiguously, in the order they are created,
+//! so that loops over the integration points access memory sequentially.
+//! Material points that are created while the arena is active are allocated
+//! from it (see FEMaterialPoint::operator new). The memory is released when
+//! the arena is destroyed or reset, so the arena must outlive its material points.
+class FECORE_API FEMaterialPointArena
+{
+	struct Chunk
+	{
+		char*	m_buf;
+		size_t	m_size;
+		size_t	m_used;
+	};
+
+public:
+	FEMaterialPointArena();
+	~FEMaterialPointArena();
+
+	//! create the material point data of an integration point
+	FEMaterialPoint* CreateMaterialPoint(FEMaterial* pmat);
+
+	//! allocate memory (called by FEMaterialPoint::operator new)
+	void* Allocate(size_t size);
+
+	//! Release all the memory so that it can be reused for new material points. The
+	//! material points allocated from this arena must have been destroyed before this is called.
+	void Reset();
+
+	//! total memory allocated from this arena
+	size_t Allocated() const { return m_allocated; }
+
+	//! the layout of the material points allocated from this arena
+	FEMaterialPointLayout& Layout() { return m_layout; }
+
+	//! the arena that is active on the calling thread (or null)
+	static FEMaterialPointArena* Current();
+
+private:
+	// make sure the next n bytes can be allocated from the current chunk
+	void Reserve(size_t n);
+
+	FEMaterialPointArena(const FEMaterialPointArena&);
+	void operator = (const FEMaterialPointArena&);
+
+private:
+	std::vector<Chunk>		m_chunk;
+	size_t					m_allocated;
+	size_t					m_chainSize;	//!< size of the data of one integration point
+	FEMaterialPointLayout	m_layout;
+};
@@ -100,6 +100,7 @@ public:
 		m_nupdates = 0;
 
 		m_bsolved = false;
+		m_bskipMesh = false;
 
 		m_block_log = false;
 
@@ -158,6 +159,7 @@ public:
 	std::string		m_moduleName;
 
 	bool	m_bsolved;	// solved flag
+	bool	m_bskipMesh;	// don't serialize the mesh (see SerializeNonMeshState)
 
 	// DOFS data
 	DOFS	m_dofs;				//!< list of degree of freedoms in this model
@@ -1920,7 +1922,16 @@ void FEModel::Implementation::Serialize(DumpStream& ar)
 //! Derived classes can override this
 void FEModel::SerializeGeometry(DumpStream& ar)
 {
-	ar & m_imp->m_mesh;
+	if (m_imp->m_bskipMesh == false) ar & m_imp->m_mesh;
+}
+
+//-----------------------------------------------------------------------------
+void FEModel::SerializeNonMeshState(DumpStream& ar)
+{
+	assert(ar.IsShallow());
+	m_imp->m_bskipMesh = true;
+	Serialize(ar);
+	m_imp->m_bskipMesh = false;
 }
 
 //-----------------------------------------------------------------------------
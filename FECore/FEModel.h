@@ -372,6 +372,11 @@ public:	// --- Miscellaneous routines ---
 	//! Derived classes can override this
 	virtual void SerializeGeometry(DumpStream& ar);
 
+	//! Serialize the model state for running restarts (i.e. a shallow archive), but 
+	//! without the state of the mesh's nodes and domains. This is used by FEModelCheckpoint,
+	//! which stores the mesh state itself.
+	void SerializeNonMeshState(DumpStream& ar);
+
 	//! set the module name
 	void SetModuleName(const std::string& moduleName);
 
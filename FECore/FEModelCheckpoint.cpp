@@ -0,0 +1,109 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "FEModelCheckpoint.h"
+#include "FEModel.h"
+#include "FEMesh.h"
+#include "FEDomain.h"
+
+//-----------------------------------------------------------------------------
+FEModelCheckpoint::FEModelCheckpoint(FEModel& fem) : m_fem(fem), m_dom(fem), m_ar(fem)
+{
+	m_nsave = 0;
+	m_nrestore = 0;
+}
+
+//-----------------------------------------------------------------------------
+size_t FEModelCheckpoint::Size() const
+{
+	return m_node.size()*sizeof(double) + m_dom.size() + m_ar.size();
+}
+
+//-----------------------------------------------------------------------------
+void FEModelCheckpoint::Save()
+{
+	m_saveTimer.start();
+
+	FEMesh& mesh = m_fem.GetMesh();
+
+	// nodal state
+	const int NN = mesh.Nodes();
+	size_t nsize = 0;
+	for (int i = 0; i < NN; ++i) nsize += mesh.Node(i).StateSize();
+	if (m_node.size() != nsize) m_node.resize(nsize);
+
+	double* pd = m_node.data();
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		node.SaveState(pd);
+		pd += node.StateSize();
+	}
+
+	// domain state (the streams keep their buffers)
+	m_dom.Open(true, true);
+	for (int i = 0; i < mesh.Domains(); ++i) mesh.Domain(i).Serialize(m_dom);
+
+	// everything else (time, contact, constraints, solver data, ...)
+	m_ar.Open(true, true);
+	m_fem.SerializeNonMeshState(m_ar);
+
+	m_nsave++;
+	m_saveTimer.stop();
+}
+
+//-----------------------------------------------------------------------------
+void FEModelCheckpoint::Restore()
+{
+	m_restoreTimer.start();
+
+	FEMesh& mesh = m_fem.GetMesh();
+
+	// nodal state
+	const double* pd = m_node.data();
+	const int NN = mesh.Nodes();
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = mesh.Node(i);
+		node.RestoreState(pd);
+		pd += node.StateSize();
+	}
+
+	// domain state
+	m_dom.Open(false, true);
+	for (int i = 0; i < mesh.Domains(); ++i) mesh.Domain(i).Serialize(m_dom);
+
+	// everything else
+	m_ar.Open(false, true);
+	m_fem.SerializeNonMeshState(m_ar);
+
+	m_nrestore++;
+	m_restoreTimer.stop();
+}
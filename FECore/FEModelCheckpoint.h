@@ -0,0 +1,72 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "DumpMemStream.h"
+#include "Timer.h"
+#include <vector>
+
+class FEModel;
+
+//-----------------------------------------------------------------------------
+//! This class stores the state of a model so that it can be restored when a 
+//! time step needs to be retried. Unlike a shallow serialization of the entire 
+//! model, the nodal state is copied directly into a flat buffer and the domain 
+//! (i.e. material point) state is streamed into a buffer that is kept between 
+//! time steps. After the first save, saving and restoring do not allocate memory, 
+//! unless the size of the model changes.
+class FECORE_API FEModelCheckpoint
+{
+public:
+	FEModelCheckpoint(FEModel& fem);
+
+	//! store the current state of the model
+	void Save();
+
+	//! restore the model to the last saved state
+	void Restore();
+
+public:
+	int Saves() const { return m_nsave; }
+	int Restores() const { return m_nrestore; }
+	double SaveTime() { return m_saveTimer.GetTime(); }
+	double RestoreTime() { return m_restoreTimer.GetTime(); }
+
+	//! size of the checkpoint data (in bytes)
+	size_t Size() const;
+
+private:
+	FEModel&			m_fem;
+	std::vector<double>	m_node;		//!< nodal state
+	DumpMemStream		m_dom;		//!< domain state
+	DumpMemStream		m_ar;		//!< the remaining model state
+
+	int		m_nsave, m_nrestore;
+	Timer	m_saveTimer, m_restoreTimer;
+};
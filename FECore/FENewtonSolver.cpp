@@ -39,6 +39,7 @@ SOFTWARE.*/
 #include "FEDomain.h"
 #include "DumpStream.h"
 #include "FELinearSystem.h"
+#include "FEGlobalVector.h"
 
 //-----------------------------------------------------------------------------
 // define the parameter list
@@ -54,13 +55,16 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 	ADD_PARAMETER(m_breformAugment      , "reform_augment");
 	ADD_PARAMETER(m_bdivreform          , "diverge_reform");
 	ADD_PARAMETER(m_bdoreforms          , "do_reforms"  );
+	ADD_PARAMETER(m_bcoloredAssembly    , "colored_assembly");
+	ADD_PARAMETER(m_bscatterMaps        , "scatter_maps");
+	ADD_PARAMETER(m_bdetResidual        , "deterministic_residual");
 	ADD_PARAMETER(m_Etol                , "etol"        );
 	ADD_PARAMETER(m_Rtol                , "rtol"        );
 	ADD_PARAMETER(m_Rmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "min_residual");
 	ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
 
 	// obsolete parameters (Should be set via the qn_method)
-	ADD_PARAMETER(m_qndefault           , "qnmethod", 0, "BFGS\0BROYDEN\0JFNK\0");
+	ADD_PARAMETER(m_qndefault           , "qnmethod", 0, "BFGS\0BROYDEN\0JFNK\0MFNK\0");
 	ADD_PARAMETER(m_maxups              , FE_RANGE_GREATER_OR_EQUAL(0.0), "max_ups" );
 	ADD_PARAMETER(m_max_buf_size        , FE_RANGE_GREATER_OR_EQUAL(0), "qn_max_buffer_size");
 	ADD_PARAMETER(m_cycle_buffer        , "qn_cycle_buffer");
@@ -107,6 +111,10 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_force_partition = 0;
 	m_breformtimestep = true;
 	m_breformAugment = false;
+
+	m_bcoloredAssembly = false;
+	m_bscatterMaps = false;
+	m_bdetResidual = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -227,6 +235,7 @@ bool FENewtonSolver::ReformStiffness()
     {
         {
 			TRACK_TIME(TimerID::Timer_Solve);
+			PROFILE_SCOPE("factorize");
 			// factorize the stiffness matrix
 			if (m_plinsolve->Factor() == false)
 			{
@@ -302,6 +311,7 @@ bool FENewtonSolver::CreateStiffness(bool breset)
 	// Do the preprocessing of the solver
 	{
 		TRACK_TIME(TimerID::Timer_Solve);
+		PROFILE_SCOPE("preprocess");
 		if (!m_plinsolve->PreProcess())
 		{
 			feLogError("An error occurred during preprocessing of linear solver");
@@ -393,10 +403,18 @@ bool FENewtonSolver::AllocateLinearSystem()
 		feLogError("Failed allocating stiffness matrix.");
 		return false;
 	}
+	m_pK->SetColoredAssembly(m_bcoloredAssembly);
+	m_pK->SetScatterMaps(m_bscatterMaps);
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void FENewtonSolver::PrepareResidualVector(FEGlobalVector& R)
+{
+	if (m_bdetResidual) R.SetThreadBuffers(&m_Rbuf);
+}
+
 //-----------------------------------------------------------------------------
 bool FENewtonSolver::Init()
 {
@@ -408,6 +426,7 @@ bool FENewtonSolver::Init()
 		case QN_BFGS   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("BFGS"   , GetFEModel())); break;
 		case QN_BROYDEN: SetSolutionStrategy(fecore_new<FENewtonStrategy>("Broyden", GetFEModel())); break;
 		case QN_JFNK   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("JFNK"   , GetFEModel())); break;
+		case QN_MFNK   : SetSolutionStrategy(fecore_new<FENewtonStrategy>("MFNK"   , GetFEModel())); break;
 		default:
 			feLogError("Invalid quasi-Newton option (%d)", m_qndefault);
 			return false;
@@ -870,6 +889,7 @@ void FENewtonSolver::SolveEquations(std::vector<double>& u, std::vector<double>&
 {
 	// call the strategy to solve the linear equations
 	TRACK_TIME(TimerID::Timer_Solve);
+	PROFILE_SCOPE("backsolve");
 
 	// for iterative solvers, we pass the last solution as the initial guess
 	if (m_plinsolve->IsIterative())
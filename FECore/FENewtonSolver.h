@@ -37,13 +37,15 @@ SOFTWARE.*/
 class FEModel;
 class FEGlobalMatrix;
 class FELinearSystem;
+class FEGlobalVector;
 
 //-----------------------------------------------------------------------------
 enum QN_STRATEGY
 {
 	QN_BFGS,
 	QN_BROYDEN,
-	QN_JFNK
+	QN_JFNK,
+	QN_MFNK
 };
 
 //-----------------------------------------------------------------------------
@@ -209,6 +211,11 @@ public:
 protected:
 	bool AllocateLinearSystem();
 
+	//! Prepare a residual vector for assembly. When deterministic residual assembly is
+	//! requested this attaches the solver's thread buffers to the vector.
+	//! Derived classes must call FEGlobalVector::Flush before reading the residual.
+	void PrepareResidualVector(FEGlobalVector& R);
+
 public:
 	// line search options
 	FELineSearch*	m_lineSearch;
@@ -229,6 +236,9 @@ public:
 	bool				m_bforceReform;		//!< forces a reform in QNInit
 	bool				m_bdivreform;		//!< reform when diverging
 	bool				m_bdoreforms;		//!< do reformations
+	bool				m_bcoloredAssembly;	//!< use element-colored (lock-free) assembly of domain stiffness matrices
+	bool				m_bscatterMaps;		//!< cache element scatter maps between stiffness reformations
+	bool				m_bdetResidual;		//!< assemble residual in thread-private buffers and reduce in fixed order
 
 	// counters
 	int		m_nref;			//!< nr of stiffness retormations
@@ -251,6 +261,8 @@ public:
 	vector<double> m_up;	//!< solution increment of previous iteration
 	vector<double> m_Fd;	//!< residual correction due to prescribed degrees of freedom
 
+	vector< vector<double> >	m_Rbuf;	//!< thread buffers for deterministic residual assembly
+
 public:
 	// obsolete parameters
 	int					m_maxups;		//!< max number of quasi-newton updates
@@ -127,6 +127,41 @@ void FENode::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+static inline double* save_vec3d(double* pd, const vec3d& r) { pd[0] = r.x; pd[1] = r.y; pd[2] = r.z; return pd + 3; }
+static inline const double* restore_vec3d(const double* pd, vec3d& r) { r.x = pd[0]; r.y = pd[1]; r.z = pd[2]; return pd + 3; }
+
+//-----------------------------------------------------------------------------
+// This stores the same data as a shallow Serialize. 
+void FENode::SaveState(double* pd) const
+{
+	pd = save_vec3d(pd, m_rt);
+	pd = save_vec3d(pd, m_at);
+	pd = save_vec3d(pd, m_rp);
+	pd = save_vec3d(pd, m_vp);
+	pd = save_vec3d(pd, m_ap);
+	pd = save_vec3d(pd, m_dt);
+	pd = save_vec3d(pd, m_dp);
+	for (size_t i = 0; i < m_val_t.size(); ++i) *pd++ = m_val_t[i];
+	for (size_t i = 0; i < m_val_p.size(); ++i) *pd++ = m_val_p[i];
+	for (size_t i = 0; i < m_Fr.size(); ++i) *pd++ = m_Fr[i];
+}
+
+//-----------------------------------------------------------------------------
+void FENode::RestoreState(const double* pd)
+{
+	pd = restore_vec3d(pd, m_rt);
+	pd = restore_vec3d(pd, m_at);
+	pd = restore_vec3d(pd, m_rp);
+	pd = restore_vec3d(pd, m_vp);
+	pd = restore_vec3d(pd, m_ap);
+	pd = restore_vec3d(pd, m_dt);
+	pd = restore_vec3d(pd, m_dp);
+	for (size_t i = 0; i < m_val_t.size(); ++i) m_val_t[i] = *pd++;
+	for (size_t i = 0; i < m_val_p.size(); ++i) m_val_p[i] = *pd++;
+	for (size_t i = 0; i < m_Fr.size(); ++i) m_Fr[i] = *pd++;
+}
+
 //-----------------------------------------------------------------------------
 //! Update nodal values, which copies the current values to the previous array
 void FENode::UpdateValues()
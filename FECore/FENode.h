@@ -93,6 +93,15 @@ public:
 	// Serialize
 	void Serialize(DumpStream& ar);
 
+	//! size of the node's state data (i.e. the data that is streamed in shallow archives)
+	int StateSize() const { return 21 + (int)(m_val_t.size() + m_val_p.size() + m_Fr.size()); }
+
+	//! copy the state data to a buffer (of size StateSize())
+	void SaveState(double* pd) const;
+
+	//! restore the state data from a buffer
+	void RestoreState(const double* pd);
+
 	//! Update nodal values, which copies the current values to the previous array
 	void UpdateValues();
 
@@ -35,13 +35,24 @@ FENormalProjection::FENormalProjection(FESurface& s) : m_surf(s)
 {
 	m_tol = 0.0;
 	m_rad = 0.0;
+	m_bvh = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 void FENormalProjection::Init()
 {
-	m_OT.Attach(&m_surf);
-	m_OT.Init(m_tol);
+	m_bvh = m_surf.UpdateSurfaceBVH();
+}
+
+//-----------------------------------------------------------------------------
+// The intersection tests accept points slightly outside the element (as set by the 
+// tolerance) and curved facets can bulge out of the box of their nodes, so the element
+// boxes are inflated a little before testing them against the ray. 
+void FENormalProjection::FindCandidateSurfaceElements(const vec3d& r, const vec3d& n, std::vector<int>& sel) const
+{
+	assert(m_bvh);
+	double tol = (m_tol > 0.01 ? m_tol : 0.01);
+	m_bvh->FindIntersectedElements(r, n, tol, sel);
 }
 
 //-----------------------------------------------------------------------------
@@ -53,18 +64,17 @@ void FENormalProjection::Init()
 FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist);
+	vector<int> selist;
+	FindCandidateSurfaceElements(r, n, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g = 0;
 	FESurfaceElement* pei = 0;
-	for (it=selist.begin(); it!=selist.end(); ++it) {
+	for (size_t i=0; i<selist.size(); ++i) {
 		// get the surface element
-		int j = *it;
+		int j = selist[i];
 		// project the node on the element
 		FESurfaceElement* pe = &m_surf.Element(j);
 		if (m_surf.Intersect(*pe, r, n, rsl, gl, m_tol)) {
@@ -97,18 +107,17 @@ FESurfaceElement* FENormalProjection::Project(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist);
+	vector<int> selist;
+	FindCandidateSurfaceElements(r, n, selist);
 	
 	// now that we found candidate surface elements, lets see if we can find 
 	// those that intersect the ray, then pick the closest intersection
-	set<int>::iterator it;
 	bool found = false;
 	double rsl[2], gl, g;
 	FESurfaceElement* pei = 0;
-	for (it=selist.begin(); it!=selist.end(); ++it) {
+	for (size_t i=0; i<selist.size(); ++i) {
 		// get the surface element
-		int j = *it;
+		int j = selist[i];
 		FESurfaceElement* pe = &m_surf.Element(j);
 		// project the node on the element
 		if (m_surf.Intersect(*pe, r, n, rsl, gl, m_tol)) {
@@ -140,18 +149,17 @@ FESurfaceElement* FENormalProjection::Project2(vec3d r, vec3d n, double rs[2])
 FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, double rs[2], int* pei)
 {
 	// let's find all the candidate surface elements
-	set<int>selist;
-	m_OT.FindCandidateSurfaceElements(r, n, selist);
+	vector<int> selist;
+	FindCandidateSurfaceElements(r, n, selist);
 
 	double g, gmax = -1e99, r2[2] = {rs[0], rs[1]};
 	int imin = -1;
 	FESurfaceElement* pme = 0;
 
 	// loop over all surface element
-	set<int>::iterator it;
-	for (it = selist.begin(); it != selist.end(); ++it)
+	for (size_t i = 0; i < selist.size(); ++i)
 	{
-		FESurfaceElement& el = m_surf.Element(*it);
+		FESurfaceElement& el = m_surf.Element(selist[i]);
 
 		// see if the ray intersects this element
 		if (m_surf.Intersect(el, r, n, r2, g, m_tol))
@@ -166,7 +174,7 @@ FESurfaceElement* FENormalProjection::Project3(const vec3d& r, const vec3d& n, d
 				pme = &el;
 //				gmin = g;
 				gmax = g;
-				imin = *it;
+				imin = selist[i];
 				rs[0] = r2[0];
 				rs[1] = r2[1];
 			}
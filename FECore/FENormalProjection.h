@@ -28,11 +28,12 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FEOctree.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 //! This class calculates the normal projection on to a surface.
-//! This is used by some contact algorithms.
+//! This is used by some contact algorithms. The projection functions only read 
+//! data, so they can be called from multiple threads after Init() was called.
 class FECORE_API FENormalProjection
 {
 public:
@@ -54,11 +55,15 @@ public:
 	vec3d Project(const vec3d& r, const vec3d& N);
 	vec3d Project2(const vec3d& r, const vec3d& N);
 
+private:
+	//! find all candidate surface elements intersected by ray
+	void FindCandidateSurfaceElements(const vec3d& r, const vec3d& n, std::vector<int>& sel) const;
+
 private:
 	double	m_tol;	//!< projection tolerance
 	double	m_rad;	//!< search radius
 
 private:
 	FESurface&	m_surf;	//!< the target surface
-	FEOctree	m_OT;	//!< used to optimize ray-surface intersections
+	FESurfaceBVH*	m_bvh;	//!< used to optimize ray-surface intersections
 };
@@ -112,6 +112,14 @@ public: // used by array variables
 	void SetArrayNames(vector<string>& s) { m_arrayNames = s; }
 	vector<string>& GetArrayNames() { return m_arrayNames; }
 
+public:
+	// Plot variables whose Save functions only read the model state can be evaluated
+	// concurrently with other plot variables. This is off by default.
+	bool IsThreadSafe() const { return m_bthreadsafe; }
+
+protected:
+	void SetThreadSafe(bool b) { m_bthreadsafe = b; }
+
 private:
 	Region_Type		m_nregion;		//!< region type
 	Var_Type		m_ntype;		//!< data type
@@ -121,6 +129,8 @@ private:
 
 	int				m_arraySize;	//!< size of arrays (used by arrays)
 	vector<string>	m_arrayNames;	//!< optional names of array components (used by arrays)
+
+	bool			m_bthreadsafe;	//!< can be evaluated concurrently with other plot variables
 };
 
 //-----------------------------------------------------------------------------
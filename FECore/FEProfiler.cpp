@@ -0,0 +1,333 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "FEProfiler.h"
+#include "Timer.h"
+#include "sys.h"
+#include <vector>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <algorithm>
+
+//-----------------------------------------------------------------------------
+// A region in the context of its parent regions.
+struct FEProfileNode
+{
+	FEProfileNode(int id, FEProfileNode* parent) : m_id(id), m_parent(parent), m_anchor(nullptr), m_calls(0) {}
+	~FEProfileNode() { for (size_t i = 0; i < m_child.size(); ++i) delete m_child[i]; }
+
+	// find the child node of a region, or create it
+	FEProfileNode* Child(int id)
+	{
+		for (size_t i = 0; i < m_child.size(); ++i) if (m_child[i]->m_id == id) return m_child[i];
+		FEProfileNode* node = new FEProfileNode(id, this);
+		m_child.push_back(node);
+		return node;
+	}
+
+	int				m_id;		// region ID (-1 for root nodes)
+	FEProfileNode*	m_parent;	// parent node
+	FEProfileNode*	m_anchor;	// for root nodes, the node this root is attached to
+	Timer			m_timer;	// time spent in this node
+	int				m_calls;	// number of times this node was entered
+
+	std::vector<FEProfileNode*>	m_child;
+};
+
+//-----------------------------------------------------------------------------
+// The profile data of a thread.
+struct FEProfileThread
+{
+	FEProfileThread() : m_root(-1, nullptr) {}
+	~FEProfileThread() { for (size_t i = 0; i < m_attached.size(); ++i) delete m_attached[i]; }
+
+	// Get the node that new regions are added to when no region is active on this thread.
+	FEProfileNode* Base(FEProfileNode* anchor)
+	{
+		if (anchor == nullptr) return &m_root;
+
+		// this is typically the last one
+		for (size_t i = m_attached.size(); i > 0; --i)
+		{
+			if (m_attached[i - 1]->m_anchor == anchor) return m_attached[i - 1];
+		}
+
+		FEProfileNode* root = new FEProfileNode(-1, nullptr);
+		root->m_anchor = anchor;
+		m_attached.push_back(root);
+		return root;
+	}
+
+	FEProfileNode					m_root;		// regions entered outside any other region
+	std::vector<FEProfileNode*>		m_attached;	// regions entered in parallel regions of other threads
+	std::vector<FEProfileNode*>		m_stack;	// the active regions
+};
+
+//-----------------------------------------------------------------------------
+class FEProfiler::Imp
+{
+public:
+	Imp() : m_anchor(nullptr) {}
+	~Imp() { for (size_t i = 0; i < m_threads.size(); ++i) delete m_threads[i]; }
+
+	FEProfileThread& Thread()
+	{
+		static thread_local FEProfileThread* thread = nullptr;
+		if (thread == nullptr)
+		{
+			thread = new FEProfileThread;
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_threads.push_back(thread);
+		}
+		return *thread;
+	}
+
+public:
+	std::mutex		m_mutex;		// protects the region names and thread list
+	std::vector<std::string>		m_name;		// region names
+	std::vector<FEProfileThread*>	m_threads;	// profile data of all threads that entered a region
+	std::vector<int>				m_timer;	// region IDs of the model timers
+
+	// The most recent region that was entered outside a parallel region. Regions
+	// that are entered in a parallel region with no active region on their own
+	// thread are attached to this node.
+	FEProfileNode* volatile	m_anchor;
+};
+
+//-----------------------------------------------------------------------------
+bool FEProfiler::m_bon = false;
+
+//-----------------------------------------------------------------------------
+FEProfiler* FEProfiler::GetInstance()
+{
+	static FEProfiler profiler;
+	return &profiler;
+}
+
+//-----------------------------------------------------------------------------
+FEProfiler::FEProfiler() : im(new FEProfiler::Imp)
+{
+	// these must be in the same order as the TimerID enum
+	const char* sztimer[] = { "update", "solve", "reform", "residual", "stiffness", "qn_update" };
+	for (int i = 0; i < 6; ++i) im->m_timer.push_back(RegionID(sztimer[i]));
+}
+
+//-----------------------------------------------------------------------------
+FEProfiler::~FEProfiler()
+{
+	m_bon = false;
+	delete im;
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::Enable(bool b)
+{
+	m_bon = b;
+}
+
+//-----------------------------------------------------------------------------
+int FEProfiler::RegionID(const char* szname)
+{
+	std::lock_guard<std::mutex> lock(im->m_mutex);
+	for (size_t i = 0; i < im->m_name.size(); ++i)
+	{
+		if (im->m_name[i] == szname) return (int)i;
+	}
+	im->m_name.push_back(szname);
+	return (int)im->m_name.size() - 1;
+}
+
+//-----------------------------------------------------------------------------
+int FEProfiler::TimerRegion(int timerId) const
+{
+	return im->m_timer[timerId];
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::Begin(int regionId)
+{
+	FEProfileThread& t = im->Thread();
+
+	FEProfileNode* parent = (t.m_stack.empty() ? t.Base(im->m_anchor) : t.m_stack.back());
+	FEProfileNode* node = parent->Child(regionId);
+	node->m_calls++;
+	t.m_stack.push_back(node);
+
+	if (omp_in_parallel() == 0) im->m_anchor = node;
+
+	node->m_timer.start();
+}
+
+//-----------------------------------------------------------------------------
+void FEProfiler::End()
+{
+	FEProfileThread& t = im->Thread();
+	if (t.m_stack.empty()) return;
+
+	t.m_stack.back()->m_timer.stop();
+	t.m_stack.pop_back();
+
+	if (omp_in_parallel() == 0) im->m_anchor = (t.m_stack.empty() ? nullptr : t.m_stack.back());
+}
+
+//-----------------------------------------------------------------------------
+static void reset_node(FEProfileNode* node)
+{
+	node->m_timer.reset();
+	node->m_calls = 0;
+	for (size_t i = 0; i < node->m_child.size(); ++i) reset_node(node->m_child[i]);
+}
+
+void FEProfiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(im->m_mutex);
+	for (size_t n = 0; n < im->m_threads.size(); ++n)
+	{
+		FEProfileThread& t = *im->m_threads[n];
+		reset_node(&t.m_root);
+		for (size_t i = 0; i < t.m_attached.size(); ++i) reset_node(t.m_attached[i]);
+
+		// active regions keep running
+		for (size_t i = 0; i < t.m_stack.size(); ++i) t.m_stack[i]->m_timer.start();
+	}
+}
+
+//-----------------------------------------------------------------------------
+namespace {
+
+typedef std::vector<int> RegionPath;
+
+struct RegionStats
+{
+	RegionStats() : time(0.0), tmax(0.0), calls(0), threads(0) {}
+	double	time;
+	double	tmax;
+	int		calls;
+	int		threads;
+};
+
+// the path of region IDs from the top-level region to this node
+void region_path(FEProfileNode* node, RegionPath& path)
+{
+	if (node->m_id == -1)
+	{
+		if (node->m_anchor) region_path(node->m_anchor, path);
+		return;
+	}
+	region_path(node->m_parent, path);
+	path.push_back(node->m_id);
+}
+
+// collect the stats of all the nodes below node
+void collect(FEProfileNode* node, RegionPath& path, std::map<RegionPath, RegionStats>& stats)
+{
+	for (size_t i = 0; i < node->m_child.size(); ++i)
+	{
+		FEProfileNode* child = node->m_child[i];
+		path.push_back(child->m_id);
+		RegionStats& s = stats[path];
+		s.time += child->m_timer.GetTime();
+		s.calls += child->m_calls;
+		collect(child, path, stats);
+		path.pop_back();
+	}
+}
+
+typedef std::vector<std::pair<RegionPath, RegionStats> > RegionList;
+
+// write the region i and its children, and return the index of the next region that is not a child
+size_t write_region(std::ostringstream& ss, const RegionList& regions, size_t i, const std::vector<std::string>& names)
+{
+	const RegionPath& path = regions[i].first;
+	const RegionStats& s = regions[i].second;
+	ss << "{\"name\":\"" << names[path.back()] << "\",\"time\":" << s.time << ",\"max\":" << s.tmax
+		<< ",\"calls\":" << s.calls << ",\"threads\":" << s.threads << ",\"children\":[";
+
+	size_t j = i + 1;
+	while ((j < regions.size()) && (regions[j].first.size() > path.size()) && std::equal(path.begin(), path.end(), regions[j].first.begin()))
+	{
+		if (j > i + 1) ss << ",";
+		j = write_region(ss, regions, j, names);
+	}
+	ss << "]}";
+	return j;
+}
+
+}
+
+//-----------------------------------------------------------------------------
+std::string FEProfiler::ReportJSON()
+{
+	std::lock_guard<std::mutex> lock(im->m_mutex);
+
+	// merge the trees of all threads
+	std::map<RegionPath, RegionStats> total;
+	for (size_t n = 0; n < im->m_threads.size(); ++n)
+	{
+		FEProfileThread& t = *im->m_threads[n];
+
+		std::map<RegionPath, RegionStats> stats;
+		RegionPath path;
+		collect(&t.m_root, path, stats);
+		for (size_t i = 0; i < t.m_attached.size(); ++i)
+		{
+			path.clear();
+			region_path(t.m_attached[i], path);
+			collect(t.m_attached[i], path, stats);
+		}
+
+		for (std::map<RegionPath, RegionStats>::iterator it = stats.begin(); it != stats.end(); ++it)
+		{
+			RegionStats& s = total[it->first];
+			s.time += it->second.time;
+			s.calls += it->second.calls;
+			s.tmax = std::max(s.tmax, it->second.time);
+			s.threads++;
+		}
+	}
+
+	// the map is sorted so that child regions follow their parent
+	RegionList regions(total.begin(), total.end());
+
+	std::ostringstream ss;
+	ss.precision(6);
+	ss << "[";
+	size_t i = 0;
+	while (i < regions.size())
+	{
+		if (i > 0) ss << ",";
+		i = write_region(ss, regions, i, im->m_name);
+	}
+	ss << "]";
+
+	return ss.str();
+}
@@ -0,0 +1,116 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <string>
+
+//-----------------------------------------------------------------------------
+//! The profiler collects the time spent in named code regions. Regions are
+//! entered with the PROFILE_SCOPE macro and can be nested, so the report is a
+//! tree where each node is a region in the context of its parent regions.
+//!
+//! Each thread accumulates its own tree, so no locking is needed when regions
+//! are entered or left. Regions that are entered in an OpenMP parallel region
+//! are attached to the region that was active when the parallel region started.
+//! The trees of all threads are merged when the report is generated.
+//!
+//! When the profiler is disabled, a scope only costs a test of a flag.
+class FECORE_API FEProfiler
+{
+	class Imp;
+
+public:
+	//! get the profiler
+	static FEProfiler* GetInstance();
+
+	//! turn the profiler on or off
+	void Enable(bool b);
+
+	//! see if the profiler is on
+	static bool IsEnabled() { return m_bon; }
+
+	//! Get the ID of a region. A new region is created if the name is not used yet.
+	int RegionID(const char* szname);
+
+	//! Get the ID of the region that goes with a TimerID (see FEModel.h)
+	int TimerRegion(int timerId) const;
+
+	//! enter a region (only call when the profiler is on)
+	void Begin(int regionId);
+
+	//! leave the last region that was entered on this thread
+	void End();
+
+	//! clear all timings (there cannot be any active regions on other threads)
+	void Reset();
+
+	//! Returns the region tree as a JSON array. Each region has a name, the total
+	//! time over all threads (in seconds), the largest time of a single thread,
+	//! the call count, the number of threads that entered it and its child regions.
+	std::string ReportJSON();
+
+private:
+	FEProfiler();
+	~FEProfiler();
+	FEProfiler(const FEProfiler&) {}
+	void operator = (const FEProfiler&) {}
+
+private:
+	Imp*	im;
+
+	static bool	m_bon;
+};
+
+//-----------------------------------------------------------------------------
+//! Helper class that enters a region on construction and leaves it when it
+//! goes out of scope (similar to TimerTracker).
+class FEProfileScope
+{
+public:
+	FEProfileScope(int regionId) : m_bon(FEProfiler::IsEnabled())
+	{
+		if (m_bon) FEProfiler::GetInstance()->Begin(regionId);
+	}
+
+	~FEProfileScope()
+	{
+		if (m_bon) FEProfiler::GetInstance()->End();
+	}
+
+private:
+	bool	m_bon;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+// Profile the rest of the enclosing scope. The region's ID is looked up once per call site.
+#define PROFILE_SCOPE(szname) \
+	static const int PROFILE_CONCAT(_profileId, __LINE__) = FEProfiler::GetInstance()->RegionID(szname); \
+	FEProfileScope PROFILE_CONCAT(_profileScope, __LINE__)(PROFILE_CONCAT(_profileId, __LINE__));
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "FEMaterial.h"
 #include "tools.h"
 #include "log.h"
+#include "FEElementBVH.h"
 
 //-----------------------------------------------------------------------------
 FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m_dofU(pfem), m_dofSU(pfem)
@@ -44,11 +45,23 @@ FESolidDomain::FESolidDomain(FEModel* pfem) : FEDomain(FE_DOMAIN_SOLID, pfem), m
 		m_dofSU.AddDof(pfem->GetDOFIndex("sy"));
 		m_dofSU.AddDof(pfem->GetDOFIndex("sz"));
 	}
+
+	m_bvh0 = nullptr;
+	m_bvht = nullptr;
+	m_bvhTag = -1;
+}
+
+//-----------------------------------------------------------------------------
+FESolidDomain::~FESolidDomain()
+{
+	ClearElementBVH();
 }
 
 //-----------------------------------------------------------------------------
 bool FESolidDomain::Create(int nsize, FE_Element_Spec espec)
 {
+	ClearElementBVH();
+
 	// allocate elements
     m_Elem.resize(nsize);
 	for (int i = 0; i < nsize; ++i)
@@ -95,6 +108,7 @@ void FESolidDomain::CopyFrom(FEMeshPartition* pd)
 	FESolidDomain* psd = dynamic_cast<FESolidDomain*>(pd);
     m_Elem = psd->m_Elem;
 	ForEachElement([=](FEElement& el) { el.SetMeshPartition(this); });
+	ClearElementBVH();
 }
 
 //-----------------------------------------------------------------------------
@@ -151,81 +165,84 @@ bool FESolidDomain::Init()
 // Reset data
 void FESolidDomain::Reset()
 {
+	// the nodes return to their initial positions
+	ClearElementBVH();
+
 	ForEachMaterialPoint([](FEMaterialPoint& mp) {
 		mp.Init();
 	});
 }
 
+//-----------------------------------------------------------------------------
+void FESolidDomain::ClearElementBVH()
+{
+	delete m_bvh0; m_bvh0 = nullptr;
+	delete m_bvht; m_bvht = nullptr;
+	m_bvhTag = -1;
+}
+
+//-----------------------------------------------------------------------------
+// The search hierarchies are created the first time they are needed. The hierarchy
+// for the current configuration is refit when the model was updated since the
+// last search (or always if this domain does not belong to a model).
+FEElementBVH* FESolidDomain::GetElementBVH(bool bcurrent)
+{
+	FEModel* fem = GetFEModel();
+	int tag = (fem ? fem->UpdateCounter() : -1);
+
+	FEElementBVH* bvh = nullptr;
+#pragma omp critical (FESolidDomain_ElementBVH)
+	{
+		FEElementBVH*& pb = (bcurrent ? m_bvht : m_bvh0);
+		if ((pb == nullptr) || (pb->Elements() != Elements()))
+		{
+			delete pb;
+			pb = new FEElementBVH(m_pMesh, (bcurrent ? FEElementBVH::CURRENT_CONFIG : FEElementBVH::REFERENCE_CONFIG));
+			pb->Build(this);
+			if (bcurrent) m_bvhTag = tag;
+		}
+		else if (bcurrent && ((tag == -1) || (tag != m_bvhTag)))
+		{
+			pb->Refit();
+			m_bvhTag = tag;
+		}
+		bvh = pb;
+	}
+	return bvh;
+}
+
 //-----------------------------------------------------------------------------
 //! This function finds the element in which point y lies and returns
 //! the isoparametric coordinates in r if an element is found
 //! (This has only been implemeneted for hexes!)
 FESolidElement* FESolidDomain::FindElement(const vec3d& y, double r[3])
 {
-    int i, j;
-    int NE = Elements();
-    vec3d x[FEElement::MAX_NODES];
-    for (i=0; i<NE; ++i)
-    {
-        // get the next element
-        FESolidElement& e = Element(i);
-        assert(e.Type() == FE_HEX8G8);
-        
-        // get the element nodal coordinates
-        int neln = e.Nodes();
-        for (j=0; j<neln; ++j) x[j] = m_pMesh->Node(e.m_node[j]).m_rt;
-        
-        // first, as a quick check, we see if y lies in the bounding box defined by x
-        FEBoundingBox box(x[0]);
-        for (j=1; j<neln; ++j) box.add(x[j]);
-        
-        if (box.IsInside(y))
-        {
-			// If the point y lies inside the box, we apply a Newton method to find
-			// the isoparametric coordinates r
-			ProjectToElement(e, y, r);
-            
-            // see if the point r lies inside the element
-            const double eps = 1.0001;
-            if ((r[0] >= -eps) && (r[0] <= eps) &&
-                (r[1] >= -eps) && (r[1] <= eps) &&
-                (r[2] >= -eps) && (r[2] <= eps)) return &e;
-        }
-    }
-    return 0;
+	return GetElementBVH(true)->FindElement(y, r);
 }
 
-
 //-----------------------------------------------------------------------------
 //! This function finds the element in which point y lies and returns
 //! the isoparametric coordinates in r if an element is found
 FESolidElement* FESolidDomain::FindReferenceElement(const vec3d& y, double r[3])
 {
-	int NE = Elements();
-	vec3d x[FEElement::MAX_NODES];
-	for (int i = 0; i<NE; ++i)
-	{
-		// get the next element
-		FESolidElement& e = Element(i);
-
-		// get the element nodal coordinates
-		int neln = e.Nodes();
-		for (int j = 0; j<neln; ++j) x[j] = m_pMesh->Node(e.m_node[j]).m_r0;
-
-		// first, as a quick check, we see if y lies in the bounding box defined by x
-		FEBoundingBox box(x[0]);
-		for (int j = 1; j<neln; ++j) box.add(x[j]);
+	return GetElementBVH(false)->FindElement(y, r);
+}
 
-		if (box.IsInside(y))
-		{
-			// If the point y lies inside the box, we apply a Newton method to find
-			// the isoparametric coordinates r
-			if (ProjectToReferenceElement(e, y, r)) return &e;
-		}
-	}
-	return 0;
+//-----------------------------------------------------------------------------
+//! Find the elements for a list of points (current configuration). 
+//! Returns the number of points for which an element was found.
+int FESolidDomain::FindElements(const std::vector<vec3d>& y, std::vector<FESolidElement*>& el, std::vector<double>& r)
+{
+	return GetElementBVH(true)->FindElements(y, el, r);
 }
 
+//-----------------------------------------------------------------------------
+//! Find the elements for a list of points (reference configuration). 
+//! Returns the number of points for which an element was found.
+int FESolidDomain::FindReferenceElements(const std::vector<vec3d>& y, std::vector<FESolidElement*>& el, std::vector<double>& r)
+{
+	return GetElementBVH(false)->FindElements(y, el, r);
+}
 
 //-----------------------------------------------------------------------------
 void FESolidDomain::ProjectToElement(FESolidElement& el, const vec3d& p, double r[3])
@@ -42,6 +42,8 @@ typedef std::function<void(FEMaterialPoint& mp, int node_a, std::vector<double>&
 
 typedef std::function<void(FEMaterialPoint& mp, int node_a, int node_b, matrix& val)> FEVolumeMatrixIntegrand;
 
+class FEElementBVH;
+
 //-----------------------------------------------------------------------------
 //! abstract base class for 3D volumetric elements
 class FECORE_API FESolidDomain : public FEDomain
@@ -49,6 +51,9 @@ class FECORE_API FESolidDomain : public FEDomain
 public:
     //! constructor
     FESolidDomain(FEModel* pfem);
+
+	//! destructor
+	~FESolidDomain();
     
     //! create storage for elements
 	bool Create(int nsize, FE_Element_Spec espec) override;
@@ -82,6 +87,12 @@ public:
 	//! find the element in which point y lies (reference configuration)
 	FESolidElement* FindReferenceElement(const vec3d& y, double r[3]);
 
+	//! find the elements in which the points y lie (three iso-parametric coordinates per point are returned in r)
+	int FindElements(const std::vector<vec3d>& y, std::vector<FESolidElement*>& el, std::vector<double>& r);
+
+	//! find the elements in which the points y lie (reference configuration)
+	int FindReferenceElements(const std::vector<vec3d>& y, std::vector<FESolidElement*>& el, std::vector<double>& r);
+
 	//! Project a point to an element and return natural coordinates
 	void ProjectToElement(FESolidElement& el, const vec3d& p, double r[3]);
 
@@ -281,4 +292,16 @@ protected:
 
 	FEDofList	m_dofU;
 	FEDofList	m_dofSU;
+
+private:
+	//! return the search hierarchy for the reference or current configuration
+	FEElementBVH* GetElementBVH(bool bcurrent);
+
+	//! delete the search hierarchies
+	void ClearElementBVH();
+
+private:
+	FEElementBVH*	m_bvh0;		//!< element search hierarchy (reference configuration)
+	FEElementBVH*	m_bvht;		//!< element search hierarchy (current configuration)
+	int				m_bvhTag;	//!< model update counter when m_bvht was last refit
 };
@@ -33,6 +33,7 @@ SOFTWARE.*/
 #include "FEElemElemList.h"
 #include "DumpStream.h"
 #include "matrix.h"
+#include "FESurfaceBVH.h"
 
 //-----------------------------------------------------------------------------
 FESurface::FESurface(FEModel* fem) : FEMeshPartition(FE_DOMAIN_SURFACE, fem)
@@ -41,17 +42,20 @@ FESurface::FESurface(FEModel* fem) : FEMeshPartition(FE_DOMAIN_SURFACE, fem)
 	m_bitfc = false;
 	m_alpha = 1;
 	m_bshellb = false;
+	m_bvh = nullptr;
 }
 
 //-----------------------------------------------------------------------------
 FESurface::~FESurface()
 {
-
+	ClearSurfaceBVH();
 }
 
 //-----------------------------------------------------------------------------
 void FESurface::Create(int nsize, int elemType)
 {
+	ClearSurfaceBVH();
+
 	m_el.resize(nsize);
 	for (int i = 0; i < nsize; ++i)
 	{
@@ -174,6 +178,33 @@ void FESurface::GetBoundaryFlags(std::vector<bool>& boundary) const
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FESurface::ClearSurfaceBVH()
+{
+	delete m_bvh;
+	m_bvh = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// The hierarchy is kept between calls so that the projection classes only need to
+// refit it to the new nodal positions instead of building a new search structure. 
+FESurfaceBVH* FESurface::UpdateSurfaceBVH()
+{
+	FESurfaceBVH* bvh = nullptr;
+#pragma omp critical (FESurface_SurfaceBVH)
+	{
+		if ((m_bvh == nullptr) || (m_bvh->Elements() != Elements()))
+		{
+			delete m_bvh;
+			m_bvh = new FESurfaceBVH(this);
+			m_bvh->Build();
+		}
+		else m_bvh->Refit();
+		bvh = m_bvh;
+	}
+	return bvh;
+}
+
 //-----------------------------------------------------------------------------
 // Create material point data for this surface
 FEMaterialPoint* FESurface::CreateMaterialPoint()
@@ -2061,6 +2092,8 @@ void FESurface::Serialize(DumpStream &ar)
 		// reallocate integration point data on loading
 		if (ar.IsSaving() == false)
 		{
+			ClearSurfaceBVH();
+
 			for (int i = 0; i < Elements(); ++i)
 			{
 				FESurfaceElement& el = Element(i);
@@ -40,6 +40,7 @@ class FEMesh;
 class FENodeSet;
 class FEFacetSet;
 class FELinearSystem;
+class FESurfaceBVH;
 
 //-----------------------------------------------------------------------------
 class FECORE_API FESurfaceMaterialPoint : public FEMaterialPoint
@@ -282,6 +283,13 @@ public:
 
 public:
 	void CreateMaterialPointData();
+
+	//! Return the search hierarchy of this surface, refit to the current nodal positions.
+	//! The hierarchy is built the first time this is called. 
+	FESurfaceBVH* UpdateSurfaceBVH();
+
+	//! delete the search hierarchy
+	void ClearSurfaceBVH();
     
 protected:
 	FEFacetSet*					m_surf;		//!< the facet set from which this surface is built
@@ -289,4 +297,7 @@ protected:
     bool                        m_bitfc;    //!< interface status
     double                      m_alpha;    //!< intermediate time fraction
 	bool						m_bshellb;	//!< true if this surface is the bottom of a shell domain
+
+private:
+	FESurfaceBVH*	m_bvh;	//!< search hierarchy used by the projection classes
 };
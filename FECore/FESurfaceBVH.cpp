@@ -0,0 +1,352 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include "FESurface.h"
+#include "FEMesh.h"
+#include <algorithm>
+#include <float.h>
+
+// max number of elements in a leaf
+#define BVH_LEAF_SIZE	4
+
+// max depth of the traversal stack
+#define BVH_MAX_STACK	128
+
+//-----------------------------------------------------------------------------
+// squared distance of a point to a box (zero if the point is inside)
+static double BoxDistance2(const vec3d& r0, const vec3d& r1, const vec3d& x)
+{
+	double dx = (x.x < r0.x ? r0.x - x.x : (x.x > r1.x ? x.x - r1.x : 0.0));
+	double dy = (x.y < r0.y ? r0.y - x.y : (x.y > r1.y ? x.y - r1.y : 0.0));
+	double dz = (x.z < r0.z ? r0.z - x.z : (x.z > r1.z ? x.z - r1.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+// see if the line through p with direction n intersects a box that is inflated by e
+static bool LineIntersectsBox(const vec3d& r0, const vec3d& r1, double e, const vec3d& p, const vec3d& n)
+{
+	double tmin = -DBL_MAX, tmax = DBL_MAX;
+	const double lo[3] = { r0.x - e, r0.y - e, r0.z - e };
+	const double hi[3] = { r1.x + e, r1.y + e, r1.z + e };
+	const double pa[3] = { p.x, p.y, p.z };
+	const double na[3] = { n.x, n.y, n.z };
+	for (int i = 0; i < 3; ++i)
+	{
+		if (na[i] == 0.0)
+		{
+			if ((pa[i] < lo[i]) || (pa[i] > hi[i])) return false;
+		}
+		else
+		{
+			double t1 = (lo[i] - pa[i]) / na[i];
+			double t2 = (hi[i] - pa[i]) / na[i];
+			if (t1 > t2) std::swap(t1, t2);
+			if (t1 > tmin) tmin = t1;
+			if (t2 < tmax) tmax = t2;
+			if (tmin > tmax) return false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH(FESurface* surf) : m_surf(surf)
+{
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::~FESurfaceBVH()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Clear()
+{
+	m_perm.clear();
+	m_ebox.clear();
+	m_node.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool FESurfaceBVH::Build()
+{
+	Clear();
+	if (m_surf == nullptr) return false;
+
+	int NE = m_surf->Elements();
+	if (NE == 0) return false;
+
+	// calculate the element boxes and centers
+	m_perm.resize(NE);
+	m_ebox.resize(NE);
+	std::vector<vec3d> c(NE);
+	for (int i = 0; i < NE; ++i)
+	{
+		m_perm[i] = i;
+		m_ebox[i] = ElementBox(i);
+		c[i] = (m_ebox[i].r0 + m_ebox[i].r1)*0.5;
+	}
+
+	// build the tree
+	m_node.reserve(2 * (NE / BVH_LEAF_SIZE + 1));
+	BuildNode(0, NE, c);
+
+	// put the element boxes in leaf order and calculate the node boxes
+	Refit();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Creates the node for the elements m_perm[first, first + count) and returns its index.
+// The elements are split at the median of the longest axis of their centers.
+int FESurfaceBVH::BuildNode(int first, int count, std::vector<vec3d>& c)
+{
+	int n = (int)m_node.size();
+	Node node;
+	node.left = node.right = -1;
+	node.first = first;
+	node.count = count;
+	m_node.push_back(node);
+
+	if (count <= BVH_LEAF_SIZE) return n;
+
+	// find the extent of the element centers
+	vec3d r0 = c[m_perm[first]], r1 = r0;
+	for (int i = first + 1; i < first + count; ++i)
+	{
+		const vec3d& ci = c[m_perm[i]];
+		if (ci.x < r0.x) r0.x = ci.x; if (ci.x > r1.x) r1.x = ci.x;
+		if (ci.y < r0.y) r0.y = ci.y; if (ci.y > r1.y) r1.y = ci.y;
+		if (ci.z < r0.z) r0.z = ci.z; if (ci.z > r1.z) r1.z = ci.z;
+	}
+	vec3d d = r1 - r0;
+	int axis = 0;
+	if ((d.y > d.x) && (d.y >= d.z)) axis = 1;
+	else if ((d.z > d.x) && (d.z > d.y)) axis = 2;
+
+	// split at the median
+	int m = count / 2;
+	int* p = &m_perm[0];
+	std::nth_element(p + first, p + first + m, p + first + count, [&](int a, int b) {
+		const vec3d& ca = c[a];
+		const vec3d& cb = c[b];
+		if (axis == 0) return ca.x < cb.x;
+		if (axis == 1) return ca.y < cb.y;
+		return ca.z < cb.z;
+	});
+
+	// NOTE: m_node may be reallocated, so don't hold on to references
+	int left  = BuildNode(first, m, c);
+	int right = BuildNode(first + m, count - m, c);
+	m_node[n].left = left;
+	m_node[n].right = right;
+	m_node[n].count = 0;
+
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+// The surface uses the back face of the shell for shell bottom surfaces, 
+// so the hierarchy has to do the same. 
+vec3d FESurfaceBVH::NodePosition(int i) const
+{
+	FENode& node = m_surf->Node(i);
+	return (m_surf->IsShellBottom() ? node.m_st() : node.m_rt);
+}
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::Box FESurfaceBVH::ElementBox(int iel) const
+{
+	FESurfaceElement& el = m_surf->Element(iel);
+	Box box;
+	int neln = el.Nodes();
+	box.r0 = box.r1 = NodePosition(el.m_lnode[0]);
+	for (int j = 1; j < neln; ++j)
+	{
+		vec3d r = NodePosition(el.m_lnode[j]);
+		if (r.x < box.r0.x) box.r0.x = r.x; if (r.x > box.r1.x) box.r1.x = r.x;
+		if (r.y < box.r0.y) box.r0.y = r.y; if (r.y > box.r1.y) box.r1.y = r.y;
+		if (r.z < box.r0.z) box.r0.z = r.z; if (r.z > box.r1.z) box.r1.z = r.z;
+	}
+
+	vec3d d = box.r1 - box.r0;
+	box.R = d.x;
+	if (d.y > box.R) box.R = d.y;
+	if (d.z > box.R) box.R = d.z;
+
+	return box;
+}
+
+//-----------------------------------------------------------------------------
+// Recalculate all bounding boxes. The tree topology is not changed, so the
+// hierarchy remains valid (although it may become less efficient) when the surface deforms. 
+void FESurfaceBVH::Refit()
+{
+	int NE = (int)m_perm.size();
+	if (NE == 0) return;
+
+	// element boxes
+#pragma omp parallel for if (NE > 1000)
+	for (int i = 0; i < NE; ++i)
+	{
+		m_ebox[i] = ElementBox(m_perm[i]);
+	}
+
+	// node boxes (children are stored after their parents, so we can loop backwards)
+	for (int i = (int)m_node.size() - 1; i >= 0; --i)
+	{
+		Node& node = m_node[i];
+		Box box;
+		if (node.left == -1)
+		{
+			box = m_ebox[node.first];
+			for (int j = 1; j < node.count; ++j)
+			{
+				const Box& bj = m_ebox[node.first + j];
+				box.r0.x = std::min(box.r0.x, bj.r0.x); box.r1.x = std::max(box.r1.x, bj.r1.x);
+				box.r0.y = std::min(box.r0.y, bj.r0.y); box.r1.y = std::max(box.r1.y, bj.r1.y);
+				box.r0.z = std::min(box.r0.z, bj.r0.z); box.r1.z = std::max(box.r1.z, bj.r1.z);
+				box.R = std::max(box.R, bj.R);
+			}
+		}
+		else
+		{
+			const Box& bl = m_node[node.left].box;
+			const Box& br = m_node[node.right].box;
+			box.r0.x = std::min(bl.r0.x, br.r0.x); box.r1.x = std::max(bl.r1.x, br.r1.x);
+			box.r0.y = std::min(bl.r0.y, br.r0.y); box.r1.y = std::max(bl.r1.y, br.r1.y);
+			box.r0.z = std::min(bl.r0.z, br.r0.z); box.r1.z = std::max(bl.r1.z, br.r1.z);
+			box.R = std::max(bl.R, br.R);
+		}
+		node.box = box;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Every surface node belongs to at least one element, so we can search the nodes
+// by visiting the element boxes that are closer than the closest node found so far. 
+int FESurfaceBVH::FindClosestNode(const vec3d& x, int nskip) const
+{
+	if (m_node.empty()) return -1;
+
+	int imin = -1;
+	double dmin = DBL_MAX;
+
+	int stack[BVH_MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const Node& node = m_node[stack[--ns]];
+		if (BoxDistance2(node.box.r0, node.box.r1, x) > dmin) continue;
+
+		if (node.left == -1)
+		{
+			for (int i = node.first; i < node.first + node.count; ++i)
+			{
+				const Box& bi = m_ebox[i];
+				if (BoxDistance2(bi.r0, bi.r1, x) > dmin) continue;
+
+				FESurfaceElement& el = m_surf->Element(m_perm[i]);
+				int neln = el.Nodes();
+				for (int j = 0; j < neln; ++j)
+				{
+					int lj = el.m_lnode[j];
+					if ((nskip >= 0) && (el.m_node[j] == nskip)) continue;
+
+					vec3d r = NodePosition(lj);
+					double d = (r - x)*(r - x);
+					if ((d < dmin) || ((d == dmin) && (lj < imin)))
+					{
+						dmin = d;
+						imin = lj;
+					}
+				}
+			}
+		}
+		else
+		{
+			// visit the closest child first
+			const Node& nl = m_node[node.left];
+			const Node& nr = m_node[node.right];
+			double dl = BoxDistance2(nl.box.r0, nl.box.r1, x);
+			double dr = BoxDistance2(nr.box.r0, nr.box.r1, x);
+			assert(ns + 2 <= BVH_MAX_STACK);
+			if (dl <= dr)
+			{
+				stack[ns++] = node.right;
+				stack[ns++] = node.left;
+			}
+			else
+			{
+				stack[ns++] = node.left;
+				stack[ns++] = node.right;
+			}
+		}
+	}
+
+	return imin;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FindIntersectedElements(const vec3d& p, const vec3d& n, double tol, std::vector<int>& sel) const
+{
+	sel.clear();
+	if (m_node.empty()) return;
+
+	int stack[BVH_MAX_STACK];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const Node& node = m_node[stack[--ns]];
+		if (LineIntersectsBox(node.box.r0, node.box.r1, tol*node.box.R, p, n) == false) continue;
+
+		if (node.left == -1)
+		{
+			for (int i = node.first; i < node.first + node.count; ++i)
+			{
+				const Box& bi = m_ebox[i];
+				if (LineIntersectsBox(bi.r0, bi.r1, tol*bi.R, p, n)) sel.push_back(m_perm[i]);
+			}
+		}
+		else
+		{
+			assert(ns + 2 <= BVH_MAX_STACK);
+			stack[ns++] = node.right;
+			stack[ns++] = node.left;
+		}
+	}
+
+	// return the elements in the order of the surface
+	if (sel.size() > 1) std::sort(sel.begin(), sel.end());
+}
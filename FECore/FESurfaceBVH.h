@@ -0,0 +1,97 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "fecore_api.h"
+#include "vec3d.h"
+#include <vector>
+
+class FESurface;
+
+//-----------------------------------------------------------------------------
+//! This class builds a bounding volume hierarchy (BVH) over the elements of a 
+//! surface in the current configuration. It is used by the contact projection
+//! classes to find the closest surface node and the elements that can be 
+//! intersected by a ray. When the nodes move, Refit() updates the bounding 
+//! boxes without rebuilding the tree. All queries are const and can be called
+//! from multiple threads.
+class FECORE_API FESurfaceBVH
+{
+private:
+	// axis-aligned box
+	struct Box
+	{
+		vec3d	r0, r1;
+		double	R;		// largest element size in this box (used for inflating)
+	};
+
+	// node of the tree
+	struct Node
+	{
+		Box		box;
+		int		left, right;	// child nodes (-1 for leaves)
+		int		first, count;	// range of elements in a leaf
+	};
+
+public:
+	FESurfaceBVH(FESurface* surf);
+	~FESurfaceBVH();
+
+	//! build the hierarchy for the surface elements
+	bool Build();
+
+	//! update the bounding boxes for the current nodal positions
+	void Refit();
+
+	//! clear all data
+	void Clear();
+
+	//! number of elements in the hierarchy
+	int Elements() const { return (int)m_perm.size(); }
+
+	//! Find the surface node (local index) that is closest to x. The node with global
+	//! index nskip is ignored. Of nodes at equal distance, the one with the lowest index 
+	//! is returned. Returns -1 if no node is found. 
+	int FindClosestNode(const vec3d& x, int nskip = -1) const;
+
+	//! Find the elements whose bounding box, inflated by tol times the element size, 
+	//! is intersected by the line through p with direction n. The element indices
+	//! are returned in ascending order. 
+	void FindIntersectedElements(const vec3d& p, const vec3d& n, double tol, std::vector<int>& sel) const;
+
+private:
+	int BuildNode(int first, int count, std::vector<vec3d>& c);
+	Box ElementBox(int iel) const;
+	vec3d NodePosition(int i) const;
+
+private:
+	FESurface*	m_surf;
+
+	std::vector<int>	m_perm;	//!< element index for each leaf slot
+	std::vector<Box>	m_ebox;	//!< element boxes (in leaf order)
+	std::vector<Node>	m_node;	//!< nodes of the tree (children are always stored after their parents)
+};
@@ -0,0 +1,303 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "MByteCode.h"
+#include <string.h>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+MByteCode::MByteCode()
+{
+	m_nvar = 0;
+	m_nconst = 0;
+	m_result = -1;
+	m_ntemp = 0;
+	m_maxtemp = 0;
+}
+
+//-----------------------------------------------------------------------------
+void MByteCode::Clear()
+{
+	m_nvar = 0;
+	m_nconst = 0;
+	m_result = -1;
+	m_reg.clear();
+	m_code.clear();
+	m_const.clear();
+	m_ntemp = 0;
+	m_maxtemp = 0;
+}
+
+//-----------------------------------------------------------------------------
+bool MByteCode::Compile(const MItem* pi)
+{
+	Clear();
+	if (pi == 0) return false;
+
+	int r = compile(pi);
+	if (r < 0)
+	{
+		Clear();
+		return false;
+	}
+	assert(m_ntemp == 0);
+
+	// now that we know the number of variables and constants, we can assign the final registers
+	for (size_t i = 0; i < m_code.size(); ++i)
+	{
+		Instruction& c = m_code[i];
+		c.dst = mapRegister(c.dst);
+		c.a = mapRegister(c.a);
+		if (c.b >= 0) c.b = mapRegister(c.b);
+	}
+	m_result = mapRegister(r);
+
+	// setup the initial register values
+	m_nconst = (int)m_const.size();
+	m_reg.assign(m_nvar + m_nconst + m_maxtemp, 0.0);
+	for (int i = 0; i < m_nconst; ++i) m_reg[m_nvar + i] = m_const[i];
+	m_const.clear();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+int MByteCode::mapRegister(int r) const
+{
+	int n = r >> 2;
+	switch (r & 3)
+	{
+	case REG_VAR  : return n;
+	case REG_CONST: return m_nvar + n;
+	case REG_TEMP : return m_nvar + (int)m_const.size() + n;
+	}
+	assert(false);
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Returns the register that holds the value of the item, or -1 if the item cannot be compiled.
+int MByteCode::compile(const MItem* pi)
+{
+	switch (pi->Type())
+	{
+	case MCONST:
+	case MFRAC:
+	case MNAMED:
+		return constant(mnumber(pi)->value());
+	case MVAR:
+	{
+		int n = mvar(pi)->index();
+		if (n < 0) return -1;
+		if (n >= m_nvar) m_nvar = n + 1;
+		return (n << 2) | REG_VAR;
+	}
+	case MNEG:
+	{
+		int a = compile(munary(pi)->Item()); if (a < 0) return -1;
+		if (isConst(a)) return constant(-constValue(a));
+		release(a);
+		return emit(OP_NEG, a, -1);
+	}
+	case MADD:
+	case MSUB:
+	case MMUL:
+	case MDIV:
+	case MPOW:
+	{
+		int a = compile(mbinary(pi)->LeftItem()); if (a < 0) return -1;
+		int b = compile(mbinary(pi)->RightItem()); if (b < 0) return -1;
+		if (isConst(a) && isConst(b))
+		{
+			double x = constValue(a), y = constValue(b);
+			switch (pi->Type())
+			{
+			case MADD: return constant(x + y);
+			case MSUB: return constant(x - y);
+			case MMUL: return constant(x * y);
+			case MDIV: return constant(x / y);
+			case MPOW: return constant(pow(x, y));
+			}
+		}
+		release(b);
+		release(a);
+		switch (pi->Type())
+		{
+		case MADD: return emit(OP_ADD, a, b);
+		case MSUB: return emit(OP_SUB, a, b);
+		case MMUL: return emit(OP_MUL, a, b);
+		case MDIV: return emit(OP_DIV, a, b);
+		case MPOW: return emit(OP_POW, a, b);
+		}
+	}
+	break;
+	case MF1D:
+	{
+		FUNCPTR f = mfnc1d(pi)->funcptr();
+		int a = compile(munary(pi)->Item()); if (a < 0) return -1;
+		if (isConst(a)) return constant(f(constValue(a)));
+		release(a);
+		return emit(OP_FNC1D, a, -1, f);
+	}
+	case MF2D:
+	{
+		FUNC2PTR f = mfnc2d(pi)->funcptr();
+		int a = compile(mbinary(pi)->LeftItem()); if (a < 0) return -1;
+		int b = compile(mbinary(pi)->RightItem()); if (b < 0) return -1;
+		if (isConst(a) && isConst(b)) return constant(f(constValue(a), constValue(b)));
+		release(b);
+		release(a);
+		return emit(OP_FNC2D, a, b, 0, f);
+	}
+	case MSFNC:
+		return compile(msfncnd(pi)->Value());
+	default:
+		break;
+	}
+
+	// we can't compile this item
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+// Find or add a constant register
+int MByteCode::constant(double v)
+{
+	// compare the bits, so that e.g. 0 and -0 are different constants
+	for (size_t i = 0; i < m_const.size(); ++i)
+	{
+		if (memcmp(&m_const[i], &v, sizeof(double)) == 0) return ((int)i << 2) | REG_CONST;
+	}
+	m_const.push_back(v);
+	return ((int)m_const.size() - 1) << 2 | REG_CONST;
+}
+
+//-----------------------------------------------------------------------------
+// Temporaries are used as a stack, so they must be released in reverse order.
+int MByteCode::temporary()
+{
+	int n = m_ntemp++;
+	if (m_ntemp > m_maxtemp) m_maxtemp = m_ntemp;
+	return (n << 2) | REG_TEMP;
+}
+
+//-----------------------------------------------------------------------------
+void MByteCode::release(int r)
+{
+	if ((r & 3) == REG_TEMP)
+	{
+		assert((r >> 2) == m_ntemp - 1);
+		m_ntemp--;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Add an instruction and return the register of its result. The operands must
+// be released before calling this function so that the result can reuse their registers.
+int MByteCode::emit(int op, int a, int b, FUNCPTR f1, FUNC2PTR f2)
+{
+	Instruction c;
+	c.op = op;
+	c.dst = temporary();
+	c.a = a;
+	c.b = b;
+	c.f1 = f1;
+	c.f2 = f2;
+	m_code.push_back(c);
+	return c.dst;
+}
+
+//-----------------------------------------------------------------------------
+void MByteCode::run(double* r) const
+{
+	const Instruction* c = (m_code.empty() ? 0 : &m_code[0]);
+	const int N = (int)m_code.size();
+	for (int i = 0; i < N; ++i, ++c)
+	{
+		switch (c->op)
+		{
+		case OP_NEG  : r[c->dst] = -r[c->a]; break;
+		case OP_ADD  : r[c->dst] = r[c->a] + r[c->b]; break;
+		case OP_SUB  : r[c->dst] = r[c->a] - r[c->b]; break;
+		case OP_MUL  : r[c->dst] = r[c->a] * r[c->b]; break;
+		case OP_DIV  : r[c->dst] = r[c->a] / r[c->b]; break;
+		case OP_POW  : r[c->dst] = pow(r[c->a], r[c->b]); break;
+		case OP_FNC1D: r[c->dst] = (c->f1)(r[c->a]); break;
+		case OP_FNC2D: r[c->dst] = (c->f2)(r[c->a], r[c->b]); break;
+		default:
+			assert(false);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+double MByteCode::Evaluate(const double* var) const
+{
+	assert(IsValid());
+	const int nreg = (int)m_reg.size();
+
+	// use the stack for the registers, unless there are too many
+	double rs[MAX_STACK_REGISTERS];
+	std::vector<double> rh;
+	double* r = rs;
+	if (nreg > MAX_STACK_REGISTERS) { rh.resize(nreg); r = &rh[0]; }
+
+	// only the variables and constants need to be initialized
+	for (int i = 0; i < m_nvar; ++i) r[i] = var[i];
+	if (m_nconst > 0) memcpy(r + m_nvar, &m_reg[m_nvar], m_nconst * sizeof(double));
+
+	run(r);
+
+	return r[m_result];
+}
+
+//-----------------------------------------------------------------------------
+void MByteCode::Evaluate(int npts, const double* var, int nvar, double* val) const
+{
+	assert(IsValid());
+	assert(nvar >= m_nvar);
+	const int nreg = (int)m_reg.size();
+
+	double rs[MAX_STACK_REGISTERS];
+	std::vector<double> rh;
+	double* r = rs;
+	if (nreg > MAX_STACK_REGISTERS) { rh.resize(nreg); r = &rh[0]; }
+
+	// the constants are never overwritten, so we only need to copy them once
+	if (m_nconst > 0) memcpy(r + m_nvar, &m_reg[m_nvar], m_nconst * sizeof(double));
+
+	for (int n = 0; n < npts; ++n)
+	{
+		const double* vn = var + (size_t)n*nvar;
+		for (int i = 0; i < m_nvar; ++i) r[i] = vn[i];
+		run(r);
+		val[n] = r[m_result];
+	}
+}
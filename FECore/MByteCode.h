@@ -0,0 +1,115 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include "MItem.h"
+#include "fecore_api.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// This class stores an expression as a flat list of register-based instructions, 
+// so that it can be evaluated without walking the expression tree. The register 
+// file starts with the variables (bound by their index), followed by the 
+// constants, and then the temporaries. Subexpressions that do not depend on a 
+// variable are folded when the expression is compiled. The operations are the 
+// same as those of the tree walk, so the results are identical.
+class FECORE_API MByteCode
+{
+	enum { MAX_STACK_REGISTERS = 128 };
+
+public:
+	enum OpCode {
+		OP_NEG, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_FNC1D, OP_FNC2D
+	};
+
+	struct Instruction
+	{
+		int			op;		// op code
+		int			dst;	// destination register
+		int			a, b;	// operand registers
+		FUNCPTR		f1;		// function pointer (OP_FNC1D)
+		FUNC2PTR	f2;		// function pointer (OP_FNC2D)
+	};
+
+public:
+	MByteCode();
+
+	// compile an expression. Returns false if the expression contains items
+	// that cannot be compiled, in which case the byte code remains empty.
+	bool Compile(const MItem* pi);
+
+	// clear the byte code
+	void Clear();
+
+	// see if the byte code is valid
+	bool IsValid() const { return (m_result >= 0); }
+
+	// number of instructions
+	int Instructions() const { return (int)m_code.size(); }
+
+	// number of registers
+	int Registers() const { return (int)m_reg.size(); }
+
+	// evaluate the expression. The var array must hold (at least) the 
+	// values of all variables referenced by the expression.
+	double Evaluate(const double* var) const;
+
+	// evaluate the expression at npts points. The variables of the points are stored
+	// consecutively in var, with nvar values per point.
+	void Evaluate(int npts, const double* var, int nvar, double* val) const;
+
+private:
+	// During compilation, registers are stored as (index << 2 | kind), since the number
+	// of variables and constants is only known at the end.
+	enum { REG_VAR, REG_CONST, REG_TEMP };
+
+	int compile(const MItem* pi);
+	int constant(double v);
+	int temporary();
+	void release(int r);
+	int emit(int op, int a, int b, FUNCPTR f1 = 0, FUNC2PTR f2 = 0);
+	bool isConst(int r) const { return ((r & 3) == REG_CONST); }
+	double constValue(int r) const { return m_const[r >> 2]; }
+	int mapRegister(int r) const;
+
+	void run(double* r) const;
+
+private:
+	int		m_nvar;		// number of variable registers
+	int		m_nconst;	// number of constant registers
+	int		m_result;	// register of the result (-1 if not compiled)
+
+	std::vector<double>			m_reg;		// initial register values
+	std::vector<Instruction>	m_code;		// the instructions
+
+	// only used during compilation
+	std::vector<double>	m_const;	// constant values
+	int					m_ntemp;	// number of temporaries in use
+	int					m_maxtemp;	// max number of temporaries
+};
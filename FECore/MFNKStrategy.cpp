@@ -0,0 +1,116 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "MFNKStrategy.h"
+#include "FENewtonSolver.h"
+#include "MatrixFreeOperator.h"
+#include "FEException.h"
+#include "LinearSolver.h"
+#include "Preconditioner.h"
+#include "log.h"
+
+BEGIN_FECORE_CLASS(MFNKStrategy, FENewtonStrategy)
+	ADD_PARAMETER(m_bcache, "cache_tangents");
+END_FECORE_CLASS();
+
+MFNKStrategy::MFNKStrategy(FEModel* fem) : FENewtonStrategy(fem)
+{
+	m_bcache = false;
+	m_plinsolve = nullptr;
+	m_A = nullptr;
+}
+
+//! New initialization method
+bool MFNKStrategy::Init()
+{
+	if (m_pns == nullptr) return false;
+	m_plinsolve = m_pns->GetLinearSolver();
+
+	// The operator always uses the tangent of the current iterate, 
+	// so we reform at every iteration.
+	m_maxups = 0;
+
+	// Each product re-runs the solver's stiffness evaluation (including contact, rigid
+	// bodies and the element matrices of all other domains), so make sure users know.
+	feLogWarning("The MFNK strategy does not store the stiffness matrix, but each Krylov iteration costs about one stiffness assembly.");
+	if (m_bcache)
+	{
+		feLogWarning("cache_tangents stores the material tangent at each integration point, so the memory savings of the MFNK strategy are small.");
+	}
+
+	return true;
+}
+
+SparseMatrix* MFNKStrategy::CreateSparseMatrix(Matrix_Type mtype)
+{
+	m_A = nullptr;
+
+	// make sure the linear solver is an iterative linear solver
+	IterativeLinearSolver* ls = dynamic_cast<IterativeLinearSolver*>(m_pns->m_plinsolve);
+	if (ls == nullptr)
+	{
+		feLogError("The MFNK strategy requires an iterative linear solver.");
+		return nullptr;
+	}
+
+	// only the diagonal of the matrix is available to preconditioners
+	LinearSolver* PL = ls->GetLeftPreconditioner();
+	LinearSolver* PR = ls->GetRightPreconditioner();
+	if ((PL && (dynamic_cast<DiagonalPreconditioner*>(PL) == nullptr)) ||
+		(PR && (dynamic_cast<DiagonalPreconditioner*>(PR) == nullptr)))
+	{
+		feLogError("The MFNK strategy only supports a Jacobi preconditioner.");
+		return nullptr;
+	}
+
+	m_A = new MatrixFreeOperator(m_pns, (mtype == REAL_SYMMETRIC));
+	m_A->SetCacheTangents(m_bcache);
+	ls->SetSparseMatrix(m_A);
+	if (ls->PreProcess() == false) return nullptr;
+
+	return m_A;
+}
+
+//! perform a Newton udpate
+bool MFNKStrategy::Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1)
+{
+	// nothing to do here
+	return true;
+}
+
+//! solve the equations
+void MFNKStrategy::SolveEquations(vector<double>& x, vector<double>& b)
+{
+	if (m_plinsolve->BackSolve(x, b) == false)
+	{
+		throw LinearSolverFailed();
+	}
+}
@@ -0,0 +1,71 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#pragma once
+#include "FENewtonStrategy.h"
+#include "SparseMatrix.h"
+
+class MatrixFreeOperator;
+
+//-----------------------------------------------------------------------------
+// Implements a matrix-free Newton-Krylov strategy. Unlike the JFNK strategy, the
+// matrix-vector products are evaluated with the element tangents, so they are exact
+// and do not require a residual evaluation. The global stiffness matrix is never stored.
+// This requires an iterative linear solver, optionally with a Jacobi preconditioner.
+class MFNKStrategy : public FENewtonStrategy
+{
+public:
+	MFNKStrategy(FEModel* fem);
+
+	//! New initialization method
+	bool Init() override;
+
+	//! initialize the linear system
+	SparseMatrix* CreateSparseMatrix(Matrix_Type mtype) override;
+
+	//! perform a Newton udpate
+	bool Update(double s, vector<double>& ui, vector<double>& R0, vector<double>& R1) override;
+
+	//! solve the equations
+	void SolveEquations(vector<double>& x, vector<double>& b) override;
+
+public:
+	//! Allow domains to cache their material tangents (off by default). This avoids
+	//! re-evaluating the materials in each product, but stores a tens4ds per integration
+	//! point, so most of the memory savings are lost. Each Krylov product still costs
+	//! about one stiffness assembly for contact, rigid bodies and all other domains.
+	bool	m_bcache;
+
+private:
+	LinearSolver*		m_plinsolve;	//!< pointer to linear solver
+	MatrixFreeOperator*	m_A;
+
+	DECLARE_FECORE_CLASS();
+};
@@ -120,6 +120,42 @@ int MSimpleExpression::Items()
 	else return 1;
 }
 
+//-----------------------------------------------------------------------------
+void MSimpleExpression::SetExpression(MITEM& e)
+{
+	m_item = e;
+
+	// The byte code only references the variables by their index, so it does not
+	// matter if variables are added after this. If the expression contains items that
+	// cannot be compiled, the expression tree is evaluated instead.
+	m_code.Compile(m_item.ItemPtr());
+}
+
+//-----------------------------------------------------------------------------
+double MSimpleExpression::value_s(const double* var) const
+{
+	if (m_code.IsValid()) return m_code.Evaluate(var);
+
+	std::vector<double> v(var, var + m_Var.size());
+	return value(m_item.ItemPtr(), v);
+}
+
+//-----------------------------------------------------------------------------
+void MSimpleExpression::value_s(int npts, const double* var, double* val) const
+{
+	const int nvar = (int)m_Var.size();
+	if (m_code.IsValid()) m_code.Evaluate(npts, var, nvar, val);
+	else
+	{
+		std::vector<double> v(nvar);
+		for (int n = 0; n < npts; ++n)
+		{
+			for (int i = 0; i < nvar; ++i) v[i] = var[(size_t)n*nvar + i];
+			val[n] = value(m_item.ItemPtr(), v);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 double MSimpleExpression::value(const MItem* pi) const
 {
@@ -197,7 +233,7 @@ double MSimpleExpression::value(const MItem* pi, const std::vector<double>& var)
 }
 
 //-----------------------------------------------------------------------------
-MSimpleExpression::MSimpleExpression(const MSimpleExpression& mo) : MathObject(mo), m_item(mo.m_item)
+MSimpleExpression::MSimpleExpression(const MSimpleExpression& mo) : MathObject(mo), m_item(mo.m_item), m_code(mo.m_code)
 {
 	// The copy c'tor of MathObject copied the variables, but any MVarRefs still point to the mo object, not this object's var list.
 	// Calling the following function fixes this
@@ -212,6 +248,7 @@ void MSimpleExpression::operator=(const MSimpleExpression& mo)
 
 	// copy the item
 	m_item = mo.m_item;
+	m_code = mo.m_code;
 
 	// The = operator of MathObject copied the variables, but any MVarRefs still point to the mo object, not this object's var list.
 	// Calling the following function fixes this
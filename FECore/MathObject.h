@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include "MItem.h"
+#include "MByteCode.h"
 #include <vector>
 #include "fecore_api.h"
 
@@ -74,7 +75,8 @@ public:
 	MSimpleExpression(const MSimpleExpression& mo);
 	void operator = (const MSimpleExpression& mo);
 
-	void SetExpression(MITEM& e) { m_item = e; }
+	// Set the expression. This also compiles the expression to byte code.
+	void SetExpression(MITEM& e);
 	MITEM& GetExpression() { return m_item; }
 	const MITEM& GetExpression() const { return m_item; }
 
@@ -95,9 +97,21 @@ public:
 	double value_s(const std::vector<double>& var) const
 	{ 
 		assert(var.size() == m_Var.size());
+		if (m_code.IsValid()) return m_code.Evaluate(var.data());
 		return value(m_item.ItemPtr(), var); 
 	}
 
+	// Same as above, but the variable values are passed in an array, which must 
+	// have (at least) as many values as there are variables.
+	double value_s(const double* var) const;
+
+	// Evaluate the expression at npts points. The variables of each point are stored 
+	// consecutively in the var array, i.e. var must be of size npts*Variables().
+	void value_s(int npts, const double* var, double* val) const;
+
+	// see if the expression was compiled to byte code
+	bool IsCompiled() const { return m_code.IsValid(); }
+
 	int Items();
 
 protected:
@@ -108,5 +122,6 @@ protected:
 	void fixVariableRefs(MItem* pi);
 
 protected:
-	MITEM	m_item;
+	MITEM		m_item;
+	MByteCode	m_code;	// compiled expression
 };
@@ -0,0 +1,224 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "MatrixFreeOperator.h"
+#include "FENewtonSolver.h"
+
+MatrixFreeOperator::MatrixFreeOperator(FENewtonSolver* pns, bool bsymm) : m_pns(pns), m_bsymm(bsymm)
+{
+	m_nrow = m_ncol = pns->m_neq;
+	m_nsize = 0;
+
+	m_bcache = false;
+	m_x = nullptr;
+	m_y = nullptr;
+
+	m_diag.assign(m_nrow, 0.0);
+	m_dset.assign(m_nrow, 0.0);
+	m_bset.assign(m_nrow, 0);
+}
+
+void MatrixFreeOperator::Create(SparseMatrixProfile& MP)
+{
+	m_nrow = MP.Rows();
+	m_ncol = MP.Columns();
+	m_nsize = 0;
+
+	m_diag.assign(m_nrow, 0.0);
+	m_dset.assign(m_nrow, 0.0);
+	m_bset.assign(m_nrow, 0);
+}
+
+void MatrixFreeOperator::Zero()
+{
+	zero(m_diag);
+	zero(m_dset);
+	for (size_t i = 0; i < m_bset.size(); ++i) m_bset[i] = 0;
+}
+
+void MatrixFreeOperator::Clear()
+{
+	m_diag.clear();
+	m_dset.clear();
+	m_bset.clear();
+}
+
+void MatrixFreeOperator::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	Assemble(ke, lm, lm);
+}
+
+void MatrixFreeOperator::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+
+	if (IsApplying() && m_bsymm)
+	{
+		// multiply the lower triangular part of the element matrix (w.r.t. the
+		// global equation numbers) with the vector, and add its transpose
+		for (int i = 0; i < N; ++i)
+		{
+			int I = lmi[i];
+			if (I < 0) continue;
+
+			double s = 0.0;
+			for (int j = 0; j < M; ++j)
+			{
+				int J = lmj[j];
+				if ((J < 0) || (J > I)) continue;
+
+				s += ke[i][j] * m_x[J];
+				if (J != I)
+				{
+#pragma omp atomic
+					m_y[J] += ke[i][j] * m_x[I];
+				}
+			}
+
+#pragma omp atomic
+			m_y[I] += s;
+		}
+	}
+	else if (IsApplying())
+	{
+		// multiply the element matrix with the vector
+		for (int i = 0; i < N; ++i)
+		{
+			int I = lmi[i];
+			if (I < 0) continue;
+
+			double s = 0.0;
+			for (int j = 0; j < M; ++j)
+			{
+				int J = lmj[j];
+				if (J >= 0) s += ke[i][j] * m_x[J];
+			}
+
+#pragma omp atomic
+			m_y[I] += s;
+		}
+	}
+	else
+	{
+		// only collect the diagonal
+		for (int i = 0; i < N; ++i)
+		{
+			int I = lmi[i];
+			if (I < 0) continue;
+			for (int j = 0; j < M; ++j)
+			{
+				if (lmj[j] == I)
+				{
+#pragma omp atomic
+					m_diag[I] += ke[i][j];
+				}
+			}
+		}
+	}
+}
+
+void MatrixFreeOperator::AddProduct(const std::vector<int>& lm, const std::vector<double>& ye, int n)
+{
+	assert(IsApplying());
+	for (int i = 0; i < n; ++i)
+	{
+		int I = lm[i];
+		if (I >= 0)
+		{
+#pragma omp atomic
+			m_y[I] += ye[i];
+		}
+	}
+}
+
+void MatrixFreeOperator::add(int i, int j, double v)
+{
+	if (IsApplying())
+	{
+		// for symmetric problems, only the upper triangular part is used
+		if (m_bsymm && (i > j)) return;
+
+#pragma omp atomic
+		m_y[i] += v*m_x[j];
+
+		if (m_bsymm && (i != j))
+		{
+#pragma omp atomic
+			m_y[j] += v*m_x[i];
+		}
+	}
+	else if (i == j)
+	{
+#pragma omp atomic
+		m_diag[i] += v;
+	}
+}
+
+// NOTE: Only the diagonal is set by FEBio (for prescribed dofs), so only those
+//       are tracked here.
+void MatrixFreeOperator::set(int i, int j, double v)
+{
+	assert(i == j);
+	if ((i != j) || IsApplying()) return;
+#pragma omp critical
+	{
+		m_dset[i] = v;
+		m_bset[i] = 1;
+		m_diag[i] = v;
+	}
+}
+
+bool MatrixFreeOperator::mult_vector(double* x, double* r)
+{
+	const int neq = Rows();
+	for (int i = 0; i < neq; ++i) r[i] = 0.0;
+
+	// The stiffness evaluation also assembles the contributions of the prescribed
+	// dofs, so we need to make sure that this does not change the solver's vector.
+	m_Fd = m_pns->m_Fd;
+
+	m_x = x;
+	m_y = r;
+	bool bret = m_pns->StiffnessMatrix();
+	m_x = nullptr;
+	m_y = nullptr;
+
+	m_pns->m_Fd.swap(m_Fd);
+
+	// rows whose diagonal was set only contain the diagonal
+	for (int i = 0; i < neq; ++i)
+	{
+		if (m_bset[i]) r[i] = m_dset[i] * x[i];
+	}
+
+	return bret;
+}
@@ -0,0 +1,108 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#pragma once
+#include "SparseMatrix.h"
+
+class FENewtonSolver;
+
+//-----------------------------------------------------------------------------
+// This class mimics a sparse matrix, but does not store the global matrix.
+// When the stiffness matrix is evaluated, only the diagonal is collected (so that
+// it can be used with a Jacobi preconditioner). The matrix-vector product is evaluated
+// by reevaluating the stiffness matrix, where each element matrix is multiplied 
+// with the vector instead of being assembled. Domains can also add their contribution
+// to the product directly (see AddProduct), e.g. from cached material tangents.
+// For symmetric problems, the product uses the same triangle of the element matrices
+// as the symmetric matrix formats, so that the operator is symmetric.
+// It is only used by the MFNK strategy.
+class FECORE_API MatrixFreeOperator : public SparseMatrix
+{
+public:
+	MatrixFreeOperator(FENewtonSolver* pns, bool bsymm);
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! Is a matrix-vector product being evaluated?
+	bool IsApplying() const { return (m_x != nullptr); }
+
+	//! the vector that is multiplied (only valid while applying)
+	const double* InputVector() const { return m_x; }
+
+	//! add an element's contribution to the product. The vector ye stores the element matrix 
+	//! multiplied with the input vector for the first n entries of lm.
+	void AddProduct(const std::vector<int>& lm, const std::vector<double>& ye, int n);
+
+	//! Can domains use cached tangents to evaluate the product?
+	bool CacheTangents() const { return m_bcache; }
+	void SetCacheTangents(bool b) { m_bcache = b; }
+
+public:
+	//! set all matrix elements to zero
+	void Zero() override;
+
+	//! Create a sparse matrix from a sparse-matrix profile
+	void Create(SparseMatrixProfile& MP) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! check if an entry was allocated
+	bool check(int i, int j) override { return true; }
+
+	//! set entry to value
+	void set(int i, int j, double v) override;
+
+	//! add value to entry
+	void add(int i, int j, double v) override;
+
+	//! get the diagonal value
+	double diag(int i) override { return m_diag[i]; }
+
+	//! release memory for storing data
+	void Clear() override;
+
+private:
+	FENewtonSolver*	m_pns;
+	bool			m_bsymm;	// symmetric operator
+	bool			m_bcache;	// allow domains to use cached tangents
+
+	vector<double>	m_diag;		// the diagonal of the matrix
+	vector<double>	m_dset;		// diagonal values that were set (instead of added)
+	vector<char>	m_bset;		// flags rows whose diagonal was set
+	vector<double>	m_Fd;		// copy of the solver's prescribed dof contributions
+
+	const double*	m_x;		// the vector that is multiplied
+	double*			m_y;		// the product
+};
@@ -53,6 +53,7 @@ class FECORE_API NodeDataRecord : public DataRecord
 public:
 	NodeDataRecord(FEModel* pfem, const char* szfile);
 	double Evaluate(int item, int ndata);
+	bool PrepareParallelEvaluate() { return true; }
 	void Parse(const char* sz);
 	void SelectAllItems();
 	void SetItemList(FENodeSet* pns);
@@ -107,6 +107,21 @@ public:
 	virtual int*    Pointers() { return 0; }
 	virtual int     Offset() const { return 0; }
 
+public:
+	// NOTE: The following functions support element assembly with precomputed scatter maps.
+	// A scatter map stores for each element matrix entry the offset into the Values() array,
+	// so that the sparsity pattern only needs to be searched once per matrix profile.
+
+	//! return the size of the scatter map of an element with n dofs (zero if not supported by this format)
+	virtual int ScatterMapSize(int n) const { return 0; }
+
+	//! build the scatter map for an element, using the first n entries of lm
+	virtual void BuildScatterMap(const std::vector<int>& lm, int n, int* map) {}
+
+	//! assemble an element matrix using a scatter map created with BuildScatterMap.
+	//! If batomic is false, the caller guarantees that no other thread updates the same entries.
+	virtual void AssembleScatter(const matrix& ke, const std::vector<int>& lm, const int* map, bool batomic) { assert(false); }
+
 protected:
 	// NOTE: These values are set by derived classes
 	int	m_nrow, m_ncol;		//!< dimension of matrix
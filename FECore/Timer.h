@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "fecore_api.h"
 #include "FECoreKernel.h"
+#include "FEProfiler.h"
 #include <vector>
 #include <string>
 
@@ -94,4 +95,6 @@ private:
 	Timer*	m_timer;
 };
 
-#define TRACK_TIME(timerId) TimerTracker _trackTimer(GetFEModel()->GetTimer(timerId));
+// The timers are also profiler regions, so finer regions can be nested in them.
+#define TRACK_TIME(timerId) TimerTracker _trackTimer(GetFEModel()->GetTimer(timerId)); \
+	FEProfileScope _profileScope(FEProfiler::GetInstance()->TimerRegion(timerId));
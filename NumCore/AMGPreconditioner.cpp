@@ -0,0 +1,887 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "AMGPreconditioner.h"
+#include "CompactUnSymmMatrix.h"
+#include "CompactSymmMatrix.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/DOFS.h>
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+typedef AMGPreconditioner::CSR CSR;
+
+//-----------------------------------------------------------------------------
+// y = A*x
+static void spmv(const CSR& A, const double* x, double* y)
+{
+	const int* pp = &A.ptr[0];
+	const int* pi = (A.ind.empty() ? nullptr : &A.ind[0]);
+	const double* pv = (A.val.empty() ? nullptr : &A.val[0]);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < A.nr; ++i)
+	{
+		double s = 0.0;
+		for (int k = pp[i]; k < pp[i + 1]; ++k) s += pv[k] * x[pi[k]];
+		y[i] = s;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// T = transpose(A)
+static void transpose(const CSR& A, CSR& T)
+{
+	T.nr = A.nc;
+	T.nc = A.nr;
+	T.ptr.assign(T.nr + 1, 0);
+	T.ind.resize(A.ind.size());
+	T.val.resize(A.val.size());
+
+	for (size_t k = 0; k < A.ind.size(); ++k) T.ptr[A.ind[k] + 1]++;
+	for (int i = 0; i < T.nr; ++i) T.ptr[i + 1] += T.ptr[i];
+
+	vector<int> pos(T.ptr.begin(), T.ptr.end() - 1);
+	for (int i = 0; i < A.nr; ++i)
+	{
+		for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k)
+		{
+			int n = pos[A.ind[k]]++;
+			T.ind[n] = i;
+			T.val[n] = A.val[k];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// C = A*B. The rows of C are evaluated in parallel: a symbolic pass counts the 
+// nonzeroes of each row, and a numeric pass fills in the columns and values.
+static void multiply(const CSR& A, const CSR& B, CSR& C)
+{
+	C.nr = A.nr;
+	C.nc = B.nc;
+	C.ptr.assign(C.nr + 1, 0);
+
+#pragma omp parallel
+	{
+		vector<int> mark(B.nc, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < A.nr; ++i)
+		{
+			int nnz = 0;
+			for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k)
+			{
+				int j = A.ind[k];
+				for (int l = B.ptr[j]; l < B.ptr[j + 1]; ++l)
+				{
+					int c = B.ind[l];
+					if (mark[c] != i) { mark[c] = i; nnz++; }
+				}
+			}
+			C.ptr[i + 1] = nnz;
+		}
+	}
+
+	for (int i = 0; i < C.nr; ++i) C.ptr[i + 1] += C.ptr[i];
+	C.ind.resize(C.ptr[C.nr]);
+	C.val.resize(C.ptr[C.nr]);
+
+#pragma omp parallel
+	{
+		vector<int> pos(B.nc, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < A.nr; ++i)
+		{
+			int n0 = C.ptr[i], n = n0;
+			for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k)
+			{
+				int j = A.ind[k];
+				double a = A.val[k];
+				for (int l = B.ptr[j]; l < B.ptr[j + 1]; ++l)
+				{
+					int c = B.ind[l];
+					if ((pos[c] < n0) || (pos[c] >= n) || (C.ind[pos[c]] != c))
+					{
+						pos[c] = n;
+						C.ind[n] = c;
+						C.val[n] = a*B.val[l];
+						n++;
+					}
+					else C.val[pos[c]] += a*B.val[l];
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(AMGPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_maxLevels  , "max_levels");
+	ADD_PARAMETER(m_coarseSize , "coarse_size");
+	ADD_PARAMETER(m_theta      , "theta");
+	ADD_PARAMETER(m_nsmooth    , "smooth_steps");
+	ADD_PARAMETER(m_reuseTol   , "reuse_tol");
+	ADD_PARAMETER(m_printLevel , "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+AMGPreconditioner::AMGPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_maxLevels = 10;
+	m_coarseSize = 500;
+	m_theta = 0.08;
+	m_nsmooth = 1;
+	m_reuseTol = 0.1;
+	m_printLevel = 0;
+
+	m_normA0 = 0.0;
+	m_bdirect = true;
+	m_nsetup = 0;
+	m_nupdate = 0;
+}
+
+//-----------------------------------------------------------------------------
+AMGPreconditioner::~AMGPreconditioner()
+{
+	Destroy();
+}
+
+//-----------------------------------------------------------------------------
+// The hierarchy is built from a general sparse matrix with the full pattern.
+SparseMatrix* AMGPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	return new CRSSparseMatrix(0);
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::Destroy()
+{
+	m_lev.clear();
+	m_LU.clear();
+	m_piv.clear();
+	m_A0.clear();
+	m_normA0 = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::CopyMatrix(SparseMatrix* K, CSR& A)
+{
+	if (K == nullptr) return false;
+	const int n = K->Rows();
+	const int offset = K->Offset();
+	const int* pp = K->Pointers();
+	const int* pi = K->Indices();
+	const double* pv = K->Values();
+
+	A.nr = A.nc = n;
+	if (dynamic_cast<CRSSparseMatrix*>(K))
+	{
+		int nnz = pp[n] - offset;
+		A.ptr.resize(n + 1);
+		A.ind.resize(nnz);
+		A.val.assign(pv, pv + nnz);
+		for (int i = 0; i <= n; ++i) A.ptr[i] = pp[i] - offset;
+		for (int i = 0; i < nnz; ++i) A.ind[i] = pi[i] - offset;
+		return true;
+	}
+	else if (dynamic_cast<CompactSymmMatrix*>(K))
+	{
+		// only the lower triangular part is stored (column-wise), so we need to
+		// expand it to the full matrix
+		A.ptr.assign(n + 1, 0);
+		for (int j = 0; j < n; ++j)
+		{
+			for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+			{
+				int i = pi[k] - offset;
+				A.ptr[j + 1]++;
+				if (i != j) A.ptr[i + 1]++;
+			}
+		}
+		for (int i = 0; i < n; ++i) A.ptr[i + 1] += A.ptr[i];
+		A.ind.resize(A.ptr[n]);
+		A.val.resize(A.ptr[n]);
+		vector<int> pos(A.ptr.begin(), A.ptr.end() - 1);
+		for (int j = 0; j < n; ++j)
+		{
+			for (int k = pp[j] - offset; k < pp[j + 1] - offset; ++k)
+			{
+				int i = pi[k] - offset;
+				int m = pos[j]++;
+				A.ind[m] = i; A.val[m] = pv[k];
+				if (i != j)
+				{
+					m = pos[i]++;
+					A.ind[m] = j; A.val[m] = pv[k];
+				}
+			}
+		}
+		return true;
+	}
+
+	feLogError("AMG preconditioner: unsupported matrix format.");
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Factor()
+{
+	SparseMatrix* K = GetSparseMatrix();
+	if (K == nullptr) return false;
+
+	// see if we can reuse the current hierarchy
+	bool breuse = false;
+	if ((m_lev.empty() == false) && (m_reuseTol > 0.0) && (m_lev[0].A.nr == K->Rows()))
+	{
+		CSR A;
+		if (CopyMatrix(K, A) == false) return false;
+
+		CSR& A0 = m_lev[0].A;
+		if ((A.ptr == A0.ptr) && (A.ind == A0.ind) && (m_A0.size() == A.val.size()))
+		{
+			double d2 = 0.0;
+			for (size_t i = 0; i < A.val.size(); ++i) { double d = A.val[i] - m_A0[i]; d2 += d*d; }
+			if (sqrt(d2) <= m_reuseTol*m_normA0) breuse = true;
+		}
+		A0.val.swap(A.val);
+		if (breuse == false)
+		{
+			A0.ptr.swap(A.ptr);
+			A0.ind.swap(A.ind);
+		}
+	}
+	else
+	{
+		m_lev.assign(1, Level());
+		if (CopyMatrix(K, m_lev[0].A) == false) return false;
+	}
+
+	if (breuse) return Update();
+
+	m_lev.resize(1);
+	return Setup();
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::BuildNullSpace(Level& L, vector<double>& B, int& nb)
+{
+	const CSR& A = L.A;
+	const int n = A.nr;
+
+	// The first six vectors are the rigid body modes of the nodal displacements,
+	// the last one is a constant vector for all other degrees of freedom.
+	nb = 7;
+	B.assign((size_t)n*nb, 0.0);
+	vector<int> grp(n, -1);
+	int ng = 0;
+
+	FEModel* fem = GetFEModel();
+	if (fem)
+	{
+		FEMesh& mesh = fem->GetMesh();
+		DOFS& dofs = fem->GetDOFS();
+		int dof[3] = { dofs.GetDOF("x"), dofs.GetDOF("y"), dofs.GetDOF("z") };
+		bool bdisp = ((dof[0] >= 0) && (dof[1] >= 0) && (dof[2] >= 0));
+
+		// the rotations are taken about the center of the mesh
+		vec3d c(0, 0, 0);
+		const int NN = mesh.Nodes();
+		for (int i = 0; i < NN; ++i) c += mesh.Node(i).m_rt;
+		if (NN > 0) c /= (double)NN;
+
+		for (int i = 0; i < NN; ++i)
+		{
+			FENode& node = mesh.Node(i);
+			vec3d r = node.m_rt - c;
+			int gd = -1, go = -1;
+			for (int j = 0; j < node.dofs(); ++j)
+			{
+				int id = node.m_ID[j];
+				int eq = (id >= 0 ? id : (id < -1 ? -id - 2 : -1));
+				if ((eq < 0) || (eq >= n) || (grp[eq] >= 0)) continue;
+
+				double* b = &B[(size_t)eq*nb];
+				int d = (bdisp ? (j == dof[0] ? 0 : (j == dof[1] ? 1 : (j == dof[2] ? 2 : -1))) : -1);
+				if (d >= 0)
+				{
+					if (gd < 0) gd = ng++;
+					grp[eq] = gd;
+					b[d] = 1.0;
+					switch (d)
+					{
+					case 0: b[4] =  r.z; b[5] = -r.y; break;
+					case 1: b[3] = -r.z; b[5] =  r.x; break;
+					case 2: b[3] =  r.y; b[4] = -r.x; break;
+					}
+				}
+				else
+				{
+					if (go < 0) go = ng++;
+					grp[eq] = go;
+					b[6] = 1.0;
+				}
+			}
+		}
+	}
+
+	// all remaining equations (e.g. rigid bodies) are treated separately
+	for (int i = 0; i < n; ++i)
+	{
+		if (grp[i] < 0)
+		{
+			grp[i] = ng++;
+			B[(size_t)i*nb + 6] = 1.0;
+		}
+	}
+
+	// equations that are decoupled from all others (e.g. prescribed dofs) 
+	// are handled by the smoother alone
+	for (int i = 0; i < n; ++i)
+	{
+		bool bcoupled = false;
+		for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k)
+			if ((A.ind[k] != i) && (A.val[k] != 0.0)) { bcoupled = true; break; }
+		if (bcoupled == false) for (int j = 0; j < nb; ++j) B[(size_t)i*nb + j] = 0.0;
+	}
+
+	// store the groups
+	L.gptr.assign(ng + 1, 0);
+	for (int i = 0; i < n; ++i) L.gptr[grp[i] + 1]++;
+	for (int i = 0; i < ng; ++i) L.gptr[i + 1] += L.gptr[i];
+	L.geq.resize(n);
+	vector<int> pos(L.gptr.begin(), L.gptr.end() - 1);
+	for (int i = 0; i < n; ++i) L.geq[pos[grp[i]]++] = i;
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::InitLevel(Level& L)
+{
+	const CSR& A = L.A;
+	const int n = A.nr;
+
+	// inverse of diagonal
+	L.Dinv.assign(n, 0.0);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k)
+			if (A.ind[k] == i)
+			{
+				if (A.val[k] != 0.0) L.Dinv[i] = 1.0 / A.val[k];
+				break;
+			}
+	}
+
+	L.x.assign(n, 0.0);
+	L.b.assign(n, 0.0);
+	L.r.assign(n, 0.0);
+
+	// estimate the spectral radius of inv(D)*A with a few power iterations
+	vector<double>& u = L.x;
+	vector<double>& v = L.r;
+	for (int i = 0; i < n; ++i) u[i] = 1.0 + 0.5*sin((double)i);
+	double rho = 1.0;
+	for (int it = 0; it < 15; ++it)
+	{
+		double nu = 0.0;
+		for (int i = 0; i < n; ++i) nu += u[i] * u[i];
+		nu = sqrt(nu);
+		if (nu == 0.0) break;
+		for (int i = 0; i < n; ++i) u[i] /= nu;
+
+		spmv(A, &u[0], &v[0]);
+		double nv = 0.0;
+		for (int i = 0; i < n; ++i) { v[i] *= L.Dinv[i]; nv += v[i] * v[i]; }
+		rho = sqrt(nv);
+		u.swap(v);
+	}
+	if (rho <= 0.0) rho = 1.0;
+	L.omega = 4.0 / (3.0*rho);
+
+	L.x.assign(n, 0.0);
+	L.r.assign(n, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Coarsen(int l, vector<double>& B, int& nb)
+{
+	const Level& L = m_lev[l];
+	const CSR& A = L.A;
+	const int n = A.nr;
+	const int ng = (int)L.gptr.size() - 1;
+
+	vector<int> grp(n);
+	for (int g = 0; g < ng; ++g)
+		for (int k = L.gptr[g]; k < L.gptr[g + 1]; ++k) grp[L.geq[k]] = g;
+
+	// evaluate the (Frobenius) norms of the blocks that couple the groups
+	vector<vector<int> > nbr(ng);
+	vector<vector<double> > w(ng);
+	vector<double> gd(ng, 0.0);
+#pragma omp parallel
+	{
+		vector<int> mark(ng, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int g = 0; g < ng; ++g)
+		{
+			vector<int>& ng_g = nbr[g];
+			vector<double>& w_g = w[g];
+			for (int m = L.gptr[g]; m < L.gptr[g + 1]; ++m)
+			{
+				int i = L.geq[m];
+				for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k)
+				{
+					int h = grp[A.ind[k]];
+					double a2 = A.val[k] * A.val[k];
+					if (mark[h] < 0)
+					{
+						mark[h] = (int)ng_g.size();
+						ng_g.push_back(h);
+						w_g.push_back(a2);
+					}
+					else w_g[mark[h]] += a2;
+				}
+			}
+			for (size_t k = 0; k < ng_g.size(); ++k)
+			{
+				mark[ng_g[k]] = -1;
+				w_g[k] = sqrt(w_g[k]);
+				if (ng_g[k] == g) gd[g] = w_g[k];
+			}
+		}
+	}
+
+	// only keep the strong connections
+	const double eps = m_theta*pow(0.5, l);
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int g = 0; g < ng; ++g)
+	{
+		int m = 0;
+		for (size_t k = 0; k < nbr[g].size(); ++k)
+		{
+			int h = nbr[g][k];
+			if ((h != g) && (w[g][k] > 0.0) && (w[g][k] >= eps*sqrt(gd[g] * gd[h])))
+			{
+				nbr[g][m] = h;
+				w[g][m] = w[g][k];
+				m++;
+			}
+		}
+		nbr[g].resize(m);
+		w[g].resize(m);
+	}
+
+	// aggregation
+	vector<int> agg(ng, -1);
+	int na = 0;
+
+	// phase 1: form aggregates from groups whose neighbors are all free
+	for (int g = 0; g < ng; ++g)
+	{
+		if (agg[g] >= 0) continue;
+		bool bfree = true;
+		for (size_t k = 0; k < nbr[g].size(); ++k) if (agg[nbr[g][k]] >= 0) { bfree = false; break; }
+		if (bfree)
+		{
+			agg[g] = na;
+			for (size_t k = 0; k < nbr[g].size(); ++k) agg[nbr[g][k]] = na;
+			na++;
+		}
+	}
+
+	// phase 2: add remaining groups to the most strongly connected aggregate
+	vector<int> agg1(agg);
+	for (int g = 0; g < ng; ++g)
+	{
+		if (agg[g] >= 0) continue;
+		double wmax = 0.0;
+		for (size_t k = 0; k < nbr[g].size(); ++k)
+		{
+			int h = nbr[g][k];
+			if ((agg1[h] >= 0) && (w[g][k] > wmax)) { wmax = w[g][k]; agg[g] = agg1[h]; }
+		}
+	}
+
+	// phase 3: aggregate whatever is left
+	for (int g = 0; g < ng; ++g)
+	{
+		if (agg[g] >= 0) continue;
+		agg[g] = na;
+		for (size_t k = 0; k < nbr[g].size(); ++k) if (agg[nbr[g][k]] < 0) agg[nbr[g][k]] = na;
+		na++;
+	}
+
+	// stop if the coarsening stagnates
+	if (na >= ng) return false;
+
+	// collect the equations of each aggregate
+	vector<int> aptr(na + 1, 0), aeq(n);
+	for (int g = 0; g < ng; ++g) aptr[agg[g] + 1] += L.gptr[g + 1] - L.gptr[g];
+	for (int a = 0; a < na; ++a) aptr[a + 1] += aptr[a];
+	{
+		vector<int> pos(aptr.begin(), aptr.end() - 1);
+		for (int g = 0; g < ng; ++g)
+			for (int k = L.gptr[g]; k < L.gptr[g + 1]; ++k) aeq[pos[agg[g]]++] = L.geq[k];
+	}
+
+	// the tentative prolongator is obtained from a QR decomposition of the 
+	// near null space restricted to each aggregate
+	vector<vector<double> > Q(na), R(na);
+	vector<int> nca(na, 0);
+	const double tol = 1e-10;
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int a = 0; a < na; ++a)
+	{
+		const int m = aptr[a + 1] - aptr[a];
+		const int* eq = &aeq[0] + aptr[a];
+		vector<double>& q = Q[a];	// m x nb, column-major
+		vector<double>& r = R[a];	// nb x nb, row-major
+		q.assign((size_t)m*nb, 0.0);
+		r.assign((size_t)nb*nb, 0.0);
+
+		// modified Gram-Schmidt, dropping dependent columns
+		int nc = 0;
+		vector<double> v(m);
+		for (int c = 0; c < nb; ++c)
+		{
+			double n0 = 0.0;
+			for (int i = 0; i < m; ++i) { v[i] = B[(size_t)eq[i] * nb + c]; n0 += v[i] * v[i]; }
+			n0 = sqrt(n0);
+			if (n0 == 0.0) continue;
+
+			for (int p = 0; p < nc; ++p)
+			{
+				const double* qp = &q[0] + (size_t)p*m;
+				double s = 0.0;
+				for (int i = 0; i < m; ++i) s += qp[i] * v[i];
+				for (int i = 0; i < m; ++i) v[i] -= s*qp[i];
+				r[p*nb + c] = s;
+			}
+
+			double nv = 0.0;
+			for (int i = 0; i < m; ++i) nv += v[i] * v[i];
+			nv = sqrt(nv);
+			if ((nv > tol*n0) && (nc < m))
+			{
+				double* qc = &q[0] + (size_t)nc*m;
+				for (int i = 0; i < m; ++i) qc[i] = v[i] / nv;
+				r[nc*nb + c] = nv;
+				nc++;
+			}
+		}
+		nca[a] = nc;
+	}
+
+	// number the coarse equations
+	vector<int> coff(na + 1, 0);
+	for (int a = 0; a < na; ++a) coff[a + 1] = coff[a] + nca[a];
+	const int nc = coff[na];
+	if (nc == 0) return false;
+
+	// build tentative prolongator
+	CSR T;
+	T.nr = n; T.nc = nc;
+	T.ptr.assign(n + 1, 0);
+	for (int a = 0; a < na; ++a)
+		for (int k = aptr[a]; k < aptr[a + 1]; ++k) T.ptr[aeq[k] + 1] = nca[a];
+	for (int i = 0; i < n; ++i) T.ptr[i + 1] += T.ptr[i];
+	T.ind.resize(T.ptr[n]);
+	T.val.resize(T.ptr[n]);
+	for (int a = 0; a < na; ++a)
+	{
+		const int m = aptr[a + 1] - aptr[a];
+		for (int k = 0; k < m; ++k)
+		{
+			int i = aeq[aptr[a] + k];
+			for (int p = 0; p < nca[a]; ++p)
+			{
+				T.ind[T.ptr[i] + p] = coff[a] + p;
+				T.val[T.ptr[i] + p] = Q[a][(size_t)p*m + k];
+			}
+		}
+	}
+
+	// coarse near null space and coarse groups
+	vector<double> Bc((size_t)nc*nb);
+	Level C;
+	C.gptr.assign(1, 0);
+	C.geq.resize(nc);
+	for (int a = 0; a < na; ++a)
+	{
+		for (int p = 0; p < nca[a]; ++p)
+		{
+			for (int c = 0; c < nb; ++c) Bc[(size_t)(coff[a] + p)*nb + c] = R[a][p*nb + c];
+			C.geq[coff[a] + p] = coff[a] + p;
+		}
+		if (nca[a] > 0) C.gptr.push_back(coff[a + 1]);
+	}
+
+	// smooth the prolongator: P = (I - w*inv(D)*A)*T
+	Level& F = m_lev[l];
+	CSR AT;
+	multiply(F.A, T, AT);
+	F.P = AT;
+	const double w0 = F.omega;
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i)
+	{
+		double s = -w0*F.Dinv[i];
+		for (int k = F.P.ptr[i]; k < F.P.ptr[i + 1]; ++k) F.P.val[k] *= s;
+		for (int k = T.ptr[i]; k < T.ptr[i + 1]; ++k)
+		{
+			for (int m = F.P.ptr[i]; m < F.P.ptr[i + 1]; ++m)
+				if (F.P.ind[m] == T.ind[k]) { F.P.val[m] += T.val[k]; break; }
+		}
+	}
+	transpose(F.P, F.R);
+
+	// Galerkin product
+	CSR AP;
+	multiply(F.A, F.P, AP);
+	multiply(F.R, AP, C.A);
+
+	m_lev.push_back(C);
+	InitLevel(m_lev.back());
+
+	B.swap(Bc);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::FactorCoarse()
+{
+	const CSR& A = m_lev.back().A;
+	const int n = A.nr;
+
+	// Coarsening can stop early (stagnation or max_levels). If the coarsest level is still
+	// much larger than the coarse size, a dense factorization would be too expensive, so
+	// this level is only smoothed.
+	m_bdirect = (n <= 4 * max(m_coarseSize, 1));
+	if (m_bdirect == false)
+	{
+		vector<double>().swap(m_LU);
+		m_piv.clear();
+		if (m_nsetup == 0) feLogWarning("AMG: coarsest level (%d equations) is too large for a direct solve.\nIt will be smoothed instead. Try increasing max_levels or decreasing theta.", n);
+		return true;
+	}
+
+	// dense LU factorization with partial pivoting
+	m_LU.assign((size_t)n*n, 0.0);
+	m_piv.resize(n);
+	for (int i = 0; i < n; ++i)
+		for (int k = A.ptr[i]; k < A.ptr[i + 1]; ++k) m_LU[(size_t)i*n + A.ind[k]] += A.val[k];
+
+	double* a = (m_LU.empty() ? nullptr : &m_LU[0]);
+	double amax = 0.0;
+	for (size_t i = 0; i < m_LU.size(); ++i) amax = max(amax, fabs(a[i]));
+
+	int nzero = 0;
+	for (int k = 0; k < n; ++k)
+	{
+		int p = k;
+		for (int i = k + 1; i < n; ++i) if (fabs(a[(size_t)i*n + k]) > fabs(a[(size_t)p*n + k])) p = i;
+		m_piv[k] = p;
+		if (p != k) for (int j = 0; j < n; ++j) swap(a[(size_t)k*n + j], a[(size_t)p*n + j]);
+
+		// singular directions (e.g. unconstrained rigid body modes) are regularized
+		if (fabs(a[(size_t)k*n + k]) <= 1e-14*amax) { a[(size_t)k*n + k] = (amax > 0.0 ? amax : 1.0); nzero++; }
+
+		double d = 1.0 / a[(size_t)k*n + k];
+#pragma omp parallel for schedule(static) if (n > 256)
+		for (int i = k + 1; i < n; ++i)
+		{
+			double* ai = a + (size_t)i*n;
+			const double* ak = a + (size_t)k*n;
+			double f = ai[k] * d;
+			ai[k] = f;
+			if (f != 0.0) for (int j = k + 1; j < n; ++j) ai[j] -= f*ak[j];
+		}
+	}
+
+	if ((nzero > 0) && (m_printLevel > 0)) feLog("AMG: coarse operator is singular (%d zero pivots).\n", nzero);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Setup()
+{
+	vector<double> B;
+	int nb = 0;
+	BuildNullSpace(m_lev[0], B, nb);
+	InitLevel(m_lev[0]);
+
+	while (((int)m_lev.size() < m_maxLevels) && (m_lev.back().A.nr > m_coarseSize))
+	{
+		if (Coarsen((int)m_lev.size() - 1, B, nb) == false) break;
+	}
+
+	if (FactorCoarse() == false) return false;
+
+	// store the fine level operator so we can decide when to rebuild the hierarchy
+	m_A0 = m_lev[0].A.val;
+	double n2 = 0.0;
+	for (size_t i = 0; i < m_A0.size(); ++i) n2 += m_A0[i] * m_A0[i];
+	m_normA0 = sqrt(n2);
+
+	m_nsetup++;
+	if (m_printLevel > 0)
+	{
+		size_t nnz0 = m_lev[0].A.ind.size(), nnz = 0;
+		for (size_t l = 0; l < m_lev.size(); ++l) nnz += m_lev[l].A.ind.size();
+		feLog("AMG setup: %d levels, operator complexity = %lg\n", (int)m_lev.size(), (nnz0 > 0 ? (double)nnz / (double)nnz0 : 0.0));
+		for (size_t l = 0; l < m_lev.size(); ++l)
+			feLog("\tlevel %d: %d equations, %d nonzeroes\n", (int)l, m_lev[l].A.nr, (int)m_lev[l].A.ind.size());
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::Update()
+{
+	InitLevel(m_lev[0]);
+	for (size_t l = 0; l + 1 < m_lev.size(); ++l)
+	{
+		Level& F = m_lev[l];
+		CSR AP;
+		multiply(F.A, F.P, AP);
+		multiply(F.R, AP, m_lev[l + 1].A);
+		InitLevel(m_lev[l + 1]);
+	}
+
+	m_nupdate++;
+	if (m_printLevel > 0) feLog("AMG: reusing hierarchy (%d levels)\n", (int)m_lev.size());
+
+	return FactorCoarse();
+}
+
+//-----------------------------------------------------------------------------
+void AMGPreconditioner::VCycle(int l, double* x, const double* b)
+{
+	Level& L = m_lev[l];
+	const int n = L.A.nr;
+
+	// solve on coarsest level
+	if (l == (int)m_lev.size() - 1)
+	{
+		if (m_bdirect == false)
+		{
+			SmoothCoarse(L, x, b);
+			return;
+		}
+
+		const double* a = (m_LU.empty() ? nullptr : &m_LU[0]);
+		for (int i = 0; i < n; ++i) x[i] = b[i];
+		for (int k = 0; k < n; ++k) if (m_piv[k] != k) swap(x[k], x[m_piv[k]]);
+		for (int i = 0; i < n; ++i)
+		{
+			double s = x[i];
+			for (int j = 0; j < i; ++j) s -= a[(size_t)i*n + j] * x[j];
+			x[i] = s;
+		}
+		for (int i = n - 1; i >= 0; --i)
+		{
+			double s = x[i];
+			for (int j = i + 1; j < n; ++j) s -= a[(size_t)i*n + j] * x[j];
+			x[i] = s / a[(size_t)i*n + i];
+		}
+		return;
+	}
+
+	const double w = L.omega;
+	const double* Dinv = &L.Dinv[0];
+	double* r = &L.r[0];
+
+	// pre-smoothing (starting from zero)
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) x[i] = w*Dinv[i] * b[i];
+	for (int k = 1; k < m_nsmooth; ++k)
+	{
+		spmv(L.A, x, r);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i) x[i] += w*Dinv[i] * (b[i] - r[i]);
+	}
+
+	// restrict the residual
+	spmv(L.A, x, r);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) r[i] = b[i] - r[i];
+
+	Level& C = m_lev[l + 1];
+	spmv(L.R, r, &C.b[0]);
+
+	// coarse grid correction
+	VCycle(l + 1, &C.x[0], &C.b[0]);
+	spmv(L.P, &C.x[0], r);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) x[i] += r[i];
+
+	// post-smoothing
+	for (int k = 0; k < m_nsmooth; ++k)
+	{
+		spmv(L.A, x, r);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i) x[i] += w*Dinv[i] * (b[i] - r[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Approximate the coarsest level solution with damped Jacobi sweeps, starting from 
+//! zero. The number of sweeps equals the smoothing steps of a full V-cycle level, and 
+//! the result is a symmetric operator, so the preconditioner can still be used with CG.
+void AMGPreconditioner::SmoothCoarse(Level& L, double* x, const double* b)
+{
+	const int n = L.A.nr;
+	const double w = L.omega;
+	const double* Dinv = &L.Dinv[0];
+	double* r = &L.r[0];
+
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < n; ++i) x[i] = w*Dinv[i] * b[i];
+	for (int k = 1; k < 2 * m_nsmooth; ++k)
+	{
+		spmv(L.A, x, r);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < n; ++i) x[i] += w*Dinv[i] * (b[i] - r[i]);
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool AMGPreconditioner::BackSolve(double* x, double* y)
+{
+	if (m_lev.empty()) return false;
+	if (m_lev[0].A.nr == 0) return true;
+	VCycle(0, x, y);
+	return true;
+}
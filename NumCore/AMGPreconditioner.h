@@ -0,0 +1,137 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Smoothed-aggregation algebraic multigrid (SA-AMG) preconditioner. The 
+//! coarse spaces are built from the rigid-body modes of the mesh (the near 
+//! null space of the elasticity operator) and the preconditioner applies a 
+//! symmetric V-cycle with damped Jacobi smoothing, so that it can be used with
+//! the CG solver. The multigrid hierarchy is reused between calls to Factor as 
+//! long as the matrix does not change by more than a given relative amount.
+class AMGPreconditioner : public Preconditioner
+{
+public:
+	// simple compressed row storage used for the operators of the hierarchy
+	struct CSR
+	{
+		int		nr, nc;
+		std::vector<int>	ptr;
+		std::vector<int>	ind;
+		std::vector<double>	val;
+
+		CSR() : nr(0), nc(0) {}
+	};
+
+	// one level of the hierarchy
+	struct Level
+	{
+		CSR		A;		// level operator
+		CSR		P;		// prolongation to this level from the next coarser level
+		CSR		R;		// restriction (transpose of P)
+		std::vector<double>	Dinv;	// inverse of the diagonal of A
+		double	omega;				// Jacobi damping factor
+
+		std::vector<int>	gptr;	// groups of equations that are aggregated together (e.g. nodes)
+		std::vector<int>	geq;
+
+		std::vector<double>	x, b, r;	// work vectors for the V-cycle
+	};
+
+public:
+	AMGPreconditioner(FEModel* fem);
+	~AMGPreconditioner();
+
+	// create a preconditioner for a sparse matrix
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	// clean up
+	void Destroy() override;
+
+public:
+	int		m_maxLevels;	// max number of levels
+	int		m_coarseSize;	// coarsening stops when the number of equations drops below this
+	double	m_theta;		// strength-of-connection threshold
+	int		m_nsmooth;		// number of pre- and post-smoothing steps
+	double	m_reuseTol;		// relative change of the matrix for which the hierarchy is reused
+	int		m_printLevel;	// output level
+
+private:
+	// copy the sparse matrix into the fine level operator
+	bool CopyMatrix(SparseMatrix* K, CSR& A);
+
+	// build the near null space and the nodal groups of the fine level
+	void BuildNullSpace(Level& L, std::vector<double>& B, int& nb);
+
+	// build the complete hierarchy
+	bool Setup();
+
+	// update the level operators, keeping the prolongators
+	bool Update();
+
+	// build the next coarser level
+	bool Coarsen(int l, std::vector<double>& B, int& nb);
+
+	// evaluate the smoother and coarse solver data for level l
+	void InitLevel(Level& L);
+
+	// factor the coarsest level operator
+	bool FactorCoarse();
+
+	// apply the smoother to the coarsest level when it is too large to be factored
+	void SmoothCoarse(Level& L, double* x, const double* b);
+
+	// apply the V-cycle at level l
+	void VCycle(int l, double* x, const double* b);
+
+private:
+	std::vector<Level>	m_lev;
+
+	std::vector<double>	m_LU;		// LU factorization of coarsest operator
+	std::vector<int>	m_piv;
+	bool				m_bdirect;	// solve the coarsest level directly (otherwise it is smoothed)
+
+	std::vector<double>	m_A0;		// fine level values at last full setup
+	double				m_normA0;	// and their norm
+
+	int		m_nsetup;	// nr. of full setups
+	int		m_nupdate;	// nr. of updates with reused prolongators
+
+	DECLARE_FECORE_CLASS();
+};
@@ -0,0 +1,479 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "BSRMatrix.h"
+#include <algorithm>
+#include <assert.h>
+
+//-----------------------------------------------------------------------------
+// see if two columns of the profile have the same sparsity pattern
+static bool samePattern(SparseMatrixProfile::ColumnProfile& a, SparseMatrixProfile::ColumnProfile& b)
+{
+	if (a.size() != b.size()) return false;
+	for (int i = 0; i < a.size(); ++i)
+	{
+		if ((a[i].start != b[i].start) || (a[i].end != b[i].end)) return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+BSRMatrix::BSRMatrix(int blockSize, bool bsymm) : m_bs(blockSize), m_bsymm(bsymm)
+{
+	// the multiplication kernels are only implemented for these block sizes
+	assert((m_bs >= 1) && (m_bs <= 4));
+	m_nb = 0;
+}
+
+//-----------------------------------------------------------------------------
+BSRMatrix::~BSRMatrix()
+{
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Zero()
+{
+	const int N = (int)m_val.size();
+	double* pv = (N > 0 ? &m_val[0] : nullptr);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < N; ++i) pv[i] = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Clear()
+{
+	m_nb = 0;
+	m_start.clear();
+	m_blk.clear();
+	m_ptr.clear();
+	m_ind.clear();
+	m_val.clear();
+	m_xp.clear();
+	m_yp.clear();
+	SparseMatrix::Clear();
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Create(SparseMatrixProfile& mp)
+{
+	const int neq = mp.Rows();
+	assert(mp.Columns() == neq);
+
+	// Group consecutive equations with the same sparsity pattern into blocks.
+	// Since the profile is structurally symmetric, we can compare columns instead of rows.
+	m_blk.resize(neq);
+	m_start.clear();
+	int i = 0;
+	while (i < neq)
+	{
+		int b = (int)m_start.size();
+		m_start.push_back(i);
+		m_blk[i] = b;
+		int n = 1;
+		while ((n < m_bs) && (i + n < neq) && samePattern(mp.Column(i), mp.Column(i + n)))
+		{
+			m_blk[i + n] = b;
+			n++;
+		}
+		i += n;
+	}
+	m_nb = (int)m_start.size();
+	m_start.push_back(neq);
+
+	// find the block rows of each block column
+	vector<int> cptr(m_nb + 1, 0), mark(m_nb, -1);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		vector<int> cind;
+		if (pass == 1)
+		{
+			for (int c = 0; c < m_nb; ++c) cptr[c + 1] += cptr[c];
+			cind.resize(cptr[m_nb]);
+			mark.assign(m_nb, -1);
+		}
+
+		for (int c = 0; c < m_nb; ++c)
+		{
+			int n = 0;
+			for (int j = m_start[c]; j < m_start[c + 1]; ++j)
+			{
+				SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+				for (int k = 0; k < a.size(); ++k)
+				{
+					for (int br = m_blk[a[k].start]; br <= m_blk[a[k].end]; ++br)
+					{
+						if (mark[br] != c)
+						{
+							mark[br] = c;
+							if (pass == 0) cptr[c + 1]++;
+							else cind[cptr[c] + n] = br;
+							n++;
+						}
+					}
+				}
+			}
+		}
+
+		if (pass == 1)
+		{
+			// transpose to block rows. Since we loop over the columns in order
+			// the column indices of each row will be sorted.
+			int nnz = cptr[m_nb];
+			m_ptr.assign(m_nb + 1, 0);
+			for (int k = 0; k < nnz; ++k) m_ptr[cind[k] + 1]++;
+			for (int r = 0; r < m_nb; ++r) m_ptr[r + 1] += m_ptr[r];
+			m_ind.resize(nnz);
+			vector<int> pos(m_ptr.begin(), m_ptr.end() - 1);
+			for (int c = 0; c < m_nb; ++c)
+			{
+				for (int k = cptr[c]; k < cptr[c + 1]; ++k) m_ind[pos[cind[k]]++] = c;
+			}
+		}
+	}
+
+	const int nnz = (int)m_ind.size();
+	m_val.assign((size_t)nnz*m_bs*m_bs, 0.0);
+
+	// the padding of these vectors must remain zero
+	m_xp.assign(m_nb*m_bs, 0.0);
+	m_yp.assign(m_nb*m_bs, 0.0);
+
+	m_nrow = m_ncol = neq;
+	m_nsize = nnz*m_bs*m_bs;
+}
+
+//-----------------------------------------------------------------------------
+int BSRMatrix::FindBlock(int bi, int bj) const
+{
+	const int* p0 = &m_ind[0] + m_ptr[bi];
+	const int* p1 = &m_ind[0] + m_ptr[bi + 1];
+	const int* p = std::lower_bound(p0, p1, bj);
+	if ((p != p1) && (*p == bj)) return (int)(p - &m_ind[0]);
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+int BSRMatrix::Offset(int i, int j) const
+{
+	int bi = m_blk[i];
+	int bj = m_blk[j];
+	int k = FindBlock(bi, bj);
+	if (k < 0) return -1;
+	return (k*m_bs + (i - m_start[bi]))*m_bs + (j - m_start[bj]);
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble an element matrix. The element dofs are first mapped to the blocks they
+//! belong to, so that each block only needs to be searched once.
+void BSRMatrix::Assemble(const matrix& ke, const vector<int>& lm)
+{
+	const int N = ke.rows();
+	const int bs = m_bs;
+
+	// collect the blocks of this element, and the location of each dof in its block
+	vector<int> eb(N), el(N), blocks;
+	blocks.reserve(N);
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lm[i];
+		if (I < 0) { eb[i] = -1; continue; }
+
+		int b = m_blk[I];
+		int p = 0;
+		while ((p < (int)blocks.size()) && (blocks[p] != b)) ++p;
+		if (p == (int)blocks.size()) blocks.push_back(b);
+
+		eb[i] = p;
+		el[i] = I - m_start[b];
+	}
+
+	// find the offsets of all the blocks this element connects to
+	const int nbe = (int)blocks.size();
+	vector<int> off(nbe*nbe);
+	for (int p = 0; p < nbe; ++p)
+		for (int q = 0; q < nbe; ++q)
+		{
+			int k = FindBlock(blocks[p], blocks[q]);
+			assert(k >= 0);
+			off[p*nbe + q] = (k >= 0 ? k*bs*bs : -1);
+		}
+
+	// add the element matrix
+	double* pv = &m_val[0];
+	for (int i = 0; i < N; ++i)
+	{
+		if (eb[i] < 0) continue;
+		const int* offi = &off[0] + eb[i] * nbe;
+		const int ri = el[i] * bs;
+		for (int j = 0; j < N; ++j)
+		{
+			if (eb[j] < 0) continue;
+			int n = offi[eb[j]];
+			if (n < 0) continue;
+
+			// for symmetric matrices only the lower triangular part is used
+			double v = ((m_bsymm && (lm[i] < lm[j])) ? ke[j][i] : ke[i][j]);
+
+#pragma omp atomic
+			pv[n + ri + el[j]] += v;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj)
+{
+	const int N = ke.rows();
+	const int M = ke.columns();
+	double* pv = &m_val[0];
+	for (int i = 0; i < N; ++i)
+	{
+		int I = lmi[i];
+		if (I < 0) continue;
+		for (int j = 0; j < M; ++j)
+		{
+			int J = lmj[j];
+			if (J < 0) continue;
+
+			// only add values from the lower-diagonal part for symmetric matrices
+			if (m_bsymm && (I < J)) continue;
+
+			double v = ke[i][j];
+			int n = Offset(I, J);
+			if (n >= 0)
+			{
+#pragma omp atomic
+				pv[n] += v;
+			}
+
+			if (m_bsymm && (I != J))
+			{
+				n = Offset(J, I);
+				if (n >= 0)
+				{
+#pragma omp atomic
+					pv[n] += v;
+				}
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::BuildScatterMap(const vector<int>& lm, int n, int* map)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			int I = lm[i];
+			int J = lm[j];
+			int& mij = map[i*n + j];
+			mij = -1;
+			if ((I >= 0) && (J >= 0))
+			{
+				mij = Offset(I, J);
+				assert(mij >= 0);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic)
+{
+	const int N = ke.rows();
+	double* pv = &m_val[0];
+	for (int i = 0; i < N; ++i)
+	{
+		const int* mi = map + i*N;
+		for (int j = 0; j < N; ++j)
+		{
+			int n = mi[j];
+			if (n >= 0)
+			{
+				// for symmetric matrices only the lower triangular part is used
+				double v = ((m_bsymm && (lm[i] < lm[j])) ? ke[j][i] : ke[i][j]);
+				if (batomic)
+				{
+					#pragma omp atomic
+					pv[n] += v;
+				}
+				else pv[n] += v;
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BSRMatrix::check(int i, int j)
+{
+	return (Offset(i, j) >= 0);
+}
+
+//-----------------------------------------------------------------------------
+// For symmetric matrices this follows the CompactSymmMatrix convention, i.e. only 
+// entries in the lower triangular part are set, and they are mirrored.
+void BSRMatrix::set(int i, int j, double v)
+{
+	if (m_bsymm && (j > i)) return;
+
+	int n = Offset(i, j);
+	int m = (m_bsymm && (i != j) ? Offset(j, i) : -1);
+#pragma omp critical
+	{
+		if (n >= 0) m_val[n] = v;
+		if (m >= 0) m_val[m] = v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// For symmetric matrices this follows the CompactSymmMatrix convention, i.e. only 
+// entries in the upper triangular part are added, and they are mirrored.
+void BSRMatrix::add(int i, int j, double v)
+{
+	if (m_bsymm && (i > j)) return;
+
+	int n = Offset(i, j);
+	assert(n >= 0);
+	if (n >= 0)
+	{
+#pragma omp atomic
+		m_val[n] += v;
+	}
+
+	if (m_bsymm && (i != j))
+	{
+		n = Offset(j, i);
+		if (n >= 0)
+		{
+#pragma omp atomic
+			m_val[n] += v;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+double BSRMatrix::get(int i, int j)
+{
+	int n = Offset(i, j);
+	return (n >= 0 ? m_val[n] : 0.0);
+}
+
+//-----------------------------------------------------------------------------
+double BSRMatrix::diag(int i)
+{
+	return get(i, i);
+}
+
+//-----------------------------------------------------------------------------
+void BSRMatrix::scale(const vector<double>& L, const vector<double>& R)
+{
+	assert(L.size() == Rows());
+	assert(R.size() == Columns());
+	const int bs = m_bs;
+#pragma omp parallel for schedule(guided)
+	for (int bi = 0; bi < m_nb; ++bi)
+	{
+		const int ni = m_start[bi + 1] - m_start[bi];
+		for (int k = m_ptr[bi]; k < m_ptr[bi + 1]; ++k)
+		{
+			const int bj = m_ind[k];
+			const int nj = m_start[bj + 1] - m_start[bj];
+			double* a = &m_val[0] + (size_t)k*bs*bs;
+			for (int r = 0; r < ni; ++r)
+				for (int c = 0; c < nj; ++c) a[r*bs + c] *= L[m_start[bi] + r] * R[m_start[bj] + c];
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Multiply the padded vector x with the matrix. Since the block size is a compile-time
+// constant, the compiler can unroll (and vectorize) the block products.
+template <int B> void BSRMatrix::mult_blocks(const double* x, double* y) const
+{
+	const int* ptr = &m_ptr[0];
+	const int* ind = &m_ind[0];
+	const double* val = &m_val[0];
+#pragma omp parallel for schedule(guided)
+	for (int b = 0; b < m_nb; ++b)
+	{
+		double yb[B] = { 0.0 };
+		for (int k = ptr[b]; k < ptr[b + 1]; ++k)
+		{
+			const double* a = val + (size_t)k*B*B;
+			const double* xb = x + ind[k] * B;
+			for (int r = 0; r < B; ++r)
+			{
+				double s = 0.0;
+				for (int c = 0; c < B; ++c) s += a[r*B + c] * xb[c];
+				yb[r] += s;
+			}
+		}
+		for (int r = 0; r < B; ++r) y[b*B + r] = yb[r];
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool BSRMatrix::mult_vector(double* x, double* r)
+{
+	if (m_nb == 0) return true;
+	const int bs = m_bs;
+
+	// copy x into the padded vector
+	double* xp = &m_xp[0];
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < m_nb; ++b)
+	{
+		for (int k = m_start[b]; k < m_start[b + 1]; ++k) xp[b*bs + k - m_start[b]] = x[k];
+	}
+
+	double* yp = &m_yp[0];
+	switch (bs)
+	{
+	case 1: mult_blocks<1>(xp, yp); break;
+	case 2: mult_blocks<2>(xp, yp); break;
+	case 3: mult_blocks<3>(xp, yp); break;
+	case 4: mult_blocks<4>(xp, yp); break;
+	default:
+		assert(false);
+		return false;
+	}
+
+	// copy the result back
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < m_nb; ++b)
+	{
+		for (int k = m_start[b]; k < m_start[b + 1]; ++k) r[k] = yp[b*bs + k - m_start[b]];
+	}
+
+	return true;
+}
@@ -0,0 +1,144 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+#include <vector>
+
+//=============================================================================
+//! This class stores a sparse matrix in block compressed row (BSR) format with
+//! dense bs x bs blocks (e.g. bs = 3 for displacement and bs = 4 for u-p problems).
+//!
+//! The block partition is derived from the matrix profile: consecutive equations 
+//! with the same sparsity pattern (usually the dofs of a node) are grouped into one 
+//! block of at most bs equations. Blocks with fewer equations (e.g. nodes with fixed 
+//! dofs) are padded with zeroes, so that all blocks can be processed with the same
+//! fixed-size kernels.
+//!
+//! Symmetric matrices are stored in full. As in CompactSymmMatrix, only the lower 
+//! triangular part of an element matrix is assembled (and mirrored).
+class BSRMatrix : public SparseMatrix
+{
+public:
+	//! constructor
+	BSRMatrix(int blockSize = 3, bool bsymm = false);
+
+	//! destructor
+	~BSRMatrix();
+
+	//! zero matrix elements
+	void Zero() override;
+
+	//! release memory
+	void Clear() override;
+
+	//! Create the matrix structure from the SparseMatrixProfile
+	void Create(SparseMatrixProfile& mp) override;
+
+	//! Assemble an element matrix into the global matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! assemble a matrix into the sparse matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! see if a matrix element is defined
+	bool check(int i, int j) override;
+
+	//! set matrix item
+	void set(int i, int j, double v) override;
+
+	//! add a value to a matrix item
+	void add(int i, int j, double v) override;
+
+	//! get a matrix item
+	double get(int i, int j) override;
+
+	//! return the diagonal value
+	double diag(int i) override;
+
+	//! do row (L) and column (R) scaling
+	void scale(const std::vector<double>& L, const std::vector<double>& R) override;
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! size of the scatter map (all entries of the element matrix are mapped)
+	int ScatterMapSize(int n) const override { return n*n; }
+
+	//! build the scatter map for an element
+	void BuildScatterMap(const std::vector<int>& lm, int n, int* map) override;
+
+	//! assemble an element matrix using a precomputed scatter map
+	void AssembleScatter(const matrix& ke, const std::vector<int>& lm, const int* map, bool batomic) override;
+
+public:
+	//! is the matrix symmetric
+	bool isSymmetric() const { return m_bsymm; }
+
+	//! the block size
+	int BlockSize() const { return m_bs; }
+
+	//! number of block rows
+	int BlockRows() const { return m_nb; }
+
+	//! first equation of a block row
+	int BlockStart(int b) const { return m_start[b]; }
+
+	//! number of equations in a block row (the rest is padding)
+	int BlockEquations(int b) const { return m_start[b + 1] - m_start[b]; }
+
+	//! block row pointers, block column indices, and block values (row-major)
+	const int* BlockPointers() const { return &m_ptr[0]; }
+	const int* BlockIndices() const { return &m_ind[0]; }
+	double* BlockValues() { return &m_val[0]; }
+
+	//! return the position of block (bi, bj) or -1 if it is not allocated
+	int FindBlock(int bi, int bj) const;
+
+private:
+	//! offset of entry (i,j) into the values array (or -1 if not allocated)
+	int Offset(int i, int j) const;
+
+	//! block multiplication kernel
+	template <int B> void mult_blocks(const double* x, double* y) const;
+
+private:
+	int		m_bs;		//!< block size
+	bool	m_bsymm;	//!< symmetric flag
+	int		m_nb;		//!< number of block rows (and columns)
+
+	std::vector<int>	m_start;	//!< first equation of each block
+	std::vector<int>	m_blk;		//!< block of each equation
+	std::vector<int>	m_ptr;		//!< block row pointers
+	std::vector<int>	m_ind;		//!< block column indices (sorted)
+	std::vector<double>	m_val;		//!< block values
+
+	std::vector<double>	m_xp, m_yp;	//!< padded vectors used by mult_vector
+};
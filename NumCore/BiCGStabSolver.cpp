@@ -23,89 +23,20 @@ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
 LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
-#include "stdafx.h"
-#include "BiCGStabSolver.h"
-#include "CompactUnSymmMatrix.h"
-#include <FECore/log.h>
 
-//-----------------------------------------------------------------------------
-BEGIN_FECORE_CLASS(BiCGStabSolver, IterativeLinearSolver)
-	ADD_PARAMETER(m_print_level, "print_level");
-	ADD_PARAMETER(m_tol, "tol");
-	ADD_PARAMETER(m_maxiter, "max_iter");
-	ADD_PARAMETER(m_fail_max_iter, "fail_max_iters");
-	ADD_PROPERTY(m_P, "pc_left");
-END_FECORE_CLASS();
 
-//-----------------------------------------------------------------------------
-BiCGStabSolver::BiCGStabSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_P(0)
-{
-	m_maxiter = 0;
-	m_tol = 1e-5;
-	m_abstol = 0.0;
-	m_print_level = 0;
-	m_fail_max_iter = true;
-}
 
-//-----------------------------------------------------------------------------
-SparseMatrix* BiCGStabSolver::CreateSparseMatrix(Matrix_Type ntype)
-{
-	// let the preconditioner decide
-	m_pA = nullptr;
-	if (m_P)
-	{
-		m_P->SetPartitions(m_part);
-		m_pA = m_P->CreateSparseMatrix(ntype);
-	}
-	else
-	{
-		if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix;
-		else m_pA = new CRSSparseMatrix(1);
-	}
-	return m_pA;
-}
 
-//-----------------------------------------------------------------------------
-bool BiCGStabSolver::SetSparseMatrix(SparseMatrix* A)
-{
-	m_pA = A;
-	return (m_pA != 0);
-}
 
-//-----------------------------------------------------------------------------
-void BiCGStabSolver::SetLeftPreconditioner(LinearSolver* P)
-{
-	m_P = P;
-}
-
-//-----------------------------------------------------------------------------
-LinearSolver* BiCGStabSolver::GetLeftPreconditioner()
-{
-	return m_P;
-}
-
-//-----------------------------------------------------------------------------
-bool BiCGStabSolver::HasPreconditioner() const
-{
-	return (m_P != nullptr);
-}
-
-//-----------------------------------------------------------------------------
-bool BiCGStabSolver::PreProcess()
-{
-	return true;
-}
+#include "stdafx.h"
+#include "BiCGStabSolver.h"
+#include <FECore/log.h>
+#include <vector>
+#include <math.h>
 
 //-----------------------------------------------------------------------------
-bool BiCGStabSolver::Factor()
+BiCGStabSolver::BiCGStabSolver(FEModel* fem) : KrylovSolver(fem)
 {
-	if (m_pA == 0) return false;
-	if (m_P)
-	{
-		if (m_P->PreProcess() == false) return false;
-		if (m_P->Factor() == false) return false;
-	}
-	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -114,113 +45,99 @@ bool BiCGStabSolver::BackSolve(double* x, double* b)
 	if (m_pA == nullptr) return false;
 
 	SparseMatrix& A = *m_pA;
-	int neq = A.Rows();
+	const int neq = A.Rows();
+	const int maxiter = MaxIterations(neq);
 
-	// assume initial guess is zero
+	// assume initial guess is zero, so r0 = b
+	std::vector<double> r(b, b + neq);
+#pragma omp parallel for schedule(static)
 	for (int i = 0; i < neq; ++i) x[i] = 0.0;
 
-	// calculate initial norm
-	// r0 = b - A*x0
-	vector<double> r_i(neq); double norm0 = 0.0, normi = 0.0;
-	for (int j = 0; j < neq; ++j)
-	{
-		r_i[j] = b[j];
-		norm0 += r_i[j] * r_i[j];
-	}
-	norm0 = sqrt(norm0);
-
-	// if the norm is zero, there is nothing to do
+	double norm0 = norm(neq, &r[0]);
+	double normi = norm0;
 	if (norm0 == 0.0) return true;
 
-//	Choose an arbitrary vector rt such that(rt, r0) != 0, e.g., rt = r0
-	vector<double> rt(r_i);
+	// choose rt such that (rt, r0) != 0, e.g. rt = r0
+	std::vector<double> rt(r);
 
-	// initialize some stuff
-	double rho_p = 1, alpha = 1, w_p = 1;
-	vector<double> v_p(neq, 0.0), p_p(neq, 0.0), p_i(neq), y(neq, 0.0), h(neq), s(neq), z(neq), t(neq), q(neq);
+	std::vector<double> p(neq, 0.0), v(neq, 0.0), s(neq), t(neq), ph(neq), sh(neq);
+	double rho = 1.0, alpha = 1.0, omega = 1.0;
 
 	int iter = 0;
-	bool converged = false;
-	do
+	bool bconv = false;
+	while ((bconv == false) && (iter < maxiter))
 	{
-		double rho_i = rt*r_i;
-
-		double beta = (rho_i / rho_p)*(alpha / w_p);
-
-		for (int j = 0; j < neq; ++j) p_i[j] = r_i[j] + beta*(p_p[j] - w_p*v_p[j]);
-
-		// apply preconditioner
-		if (m_P)
+		double rho_i = dot(neq, &rt[0], &r[0]);
+		if (rho_i == 0.0) break;
+
+		// update search direction
+		double beta = (rho_i / rho)*(alpha / omega);
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < neq; ++i) p[i] = r[i] + beta*(p[i] - omega*v[i]);
+
+		// v = A M p
+		if (precondition(&ph[0], &p[0]) == false) return false;
+		A.mult_vector(&ph[0], &v[0]);
+
+		double rtv = dot(neq, &rt[0], &v[0]);
+		if (rtv == 0.0) break;
+		alpha = rho_i / rtv;
+
+		// s = r - alpha*v
+		double ss = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:ss)
+		for (int i = 0; i < neq; ++i)
 		{
-			m_P->BackSolve(y, p_i);
+			s[i] = r[i] - alpha*v[i];
+			ss += s[i] * s[i];
 		}
-		else y = p_i;
-
-		A.mult_vector(&y[0], &v_p[0]);
-
-		alpha = rho_i / (rt*v_p);
-
-		for (int j = 0; j < neq; ++j) h[j] = x[j] + alpha*y[j];
-
-		for (int j = 0; j < neq; ++j) s[j] = r_i[j] - alpha*v_p[j];
-//		If h is accurate enough then xi = h and quit
+		iter++;
 
-		if (m_P)
+		// see if we're already converged
+		if (converged(sqrt(ss), norm0))
 		{
-			m_P->BackSolve(z, s);
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < neq; ++i) x[i] += alpha*ph[i];
+			normi = sqrt(ss);
+			bconv = true;
+			break;
 		}
-		else z = s;
-
-		A.mult_vector(&z[0], &t[0]);
 
-		if (m_P)
-		{
-			m_P->BackSolve(q, t);
-		}
-		else q = t;
+		// t = A M s
+		if (precondition(&sh[0], &s[0]) == false) return false;
+		A.mult_vector(&sh[0], &t[0]);
 
-		w_p = (q*z) / (q*q);
+		double tt = dot(neq, &t[0], &t[0]);
+		omega = (tt != 0.0 ? dot(neq, &t[0], &s[0]) / tt : 0.0);
 
-		for (int j = 0; j < neq; ++j) x[j] = h[j] + w_p*z[j];
-		
-		normi = 0.0;
-		for (int j = 0; j < neq; ++j)
+		// update solution and residual
+		double rr = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:rr)
+		for (int i = 0; i < neq; ++i)
 		{
-			r_i[j] = s[j] - w_p*t[j];
-			normi += r_i[j] * r_i[j];
+			x[i] += alpha*ph[i] + omega*sh[i];
+			r[i] = s[i] - omega*t[i];
+			rr += r[i] * r[i];
 		}
-		normi = sqrt(normi);
+		normi = sqrt(rr);
 
-		// see if we have converged
-		double tol = norm0*m_tol + m_abstol;
-		if (normi <= tol) converged = true;
-		else
-		{
-			// prepare for next iteration
-			rho_p = rho_i;
-			p_p = p_i;
-		}
+		if (m_print_level > 1) report(iter, normi, norm0);
 
-		// check max iterations
-		iter++;
-		if (iter > m_maxiter) break;
+		if (converged(normi, norm0)) bconv = true;
+		else if (omega == 0.0) break;
 
-		if (m_print_level > 1)
-		{
-			feLog("%d:%lg, %lg\n", iter, normi, tol);
-		}
+		rho = rho_i;
 	}
-	while (!converged);
 
-	if (m_print_level == 1)
+	if (m_print_level == 1) report(iter, normi, norm0);
+
+	UpdateStats(iter);
+
+	if ((bconv == false) && m_fail_max_iters)
 	{
-		feLog("%d:%lg, %lg\n", iter, normi, norm0);
+		feLogWarning("BiCGStab solver did not converge in %d iterations (residual norm = %lg).", iter, normi);
+		return false;
 	}
 
-	return (m_fail_max_iter ? converged : true);
-}
-
-//-----------------------------------------------------------------------------
-void BiCGStabSolver::Destroy()
-{
+	return true;
 }
@@ -23,43 +23,21 @@ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
 LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
 OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.*/
-#pragma once
-#include <FECore/LinearSolver.h>
-#include "CompactSymmMatrix.h"
 
-// This class implements an interface to the RCI CG iterative solver from the MKL math library.
-class BiCGStabSolver : public IterativeLinearSolver
-{
-public:
-	BiCGStabSolver(FEModel* fem);
-	bool PreProcess() override;
-	bool Factor() override;
-	bool BackSolve(double* x, double* b) override;
-	void Destroy() override;
-
-public:
-	bool HasPreconditioner() const override;
 
-	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
 
-	bool SetSparseMatrix(SparseMatrix* A) override;
 
-	void SetLeftPreconditioner(LinearSolver* P) override;
-	LinearSolver* GetLeftPreconditioner() override;
 
-	void SetMaxIterations(int n) { m_maxiter = n; }
-	void SetTolerance(double tol) { m_tol = tol; }
-	void SetPrintLevel(int n) override { m_print_level = n; }
-
-protected:
-	SparseMatrix*		m_pA;
-	LinearSolver*		m_P;
+#pragma once
+#include "KrylovSolver.h"
 
-	int		m_maxiter;		// max nr of iterations
-	double	m_tol;			// residual relative tolerance
-	double	m_abstol;		// absolute residual tolerance
-	int		m_print_level;	// output level
-	double	m_fail_max_iter;
+//-----------------------------------------------------------------------------
+//! Native BiCGStab solver with right preconditioning. This solver works with 
+//! symmetric and non-symmetric matrices.
+class BiCGStabSolver : public KrylovSolver
+{
+public:
+	BiCGStabSolver(FEModel* fem);
 
-	DECLARE_FECORE_CLASS();
+	bool BackSolve(double* x, double* b) override;
 };
@@ -0,0 +1,163 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+
+#include "stdafx.h"
+#include "BlockJacobiPreconditioner.h"
+#include "BSRMatrix.h"
+#include <FECore/log.h>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+// invert the n x n leading part of the block a (stored with leading dimension ld)
+// using Gauss-Jordan elimination with partial pivoting.
+static bool invertBlock(int n, int ld, const double* a, double* ai)
+{
+	double m[4][8];
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			m[i][j] = a[i*ld + j];
+			m[i][n + j] = (i == j ? 1.0 : 0.0);
+		}
+	}
+
+	for (int k = 0; k < n; ++k)
+	{
+		// find the pivot
+		int p = k;
+		for (int i = k + 1; i < n; ++i) if (fabs(m[i][k]) > fabs(m[p][k])) p = i;
+		if (m[p][k] == 0.0) return false;
+		if (p != k) for (int j = 0; j < 2 * n; ++j) { double t = m[k][j]; m[k][j] = m[p][j]; m[p][j] = t; }
+
+		double d = 1.0 / m[k][k];
+		for (int j = 0; j < 2 * n; ++j) m[k][j] *= d;
+		for (int i = 0; i < n; ++i)
+		{
+			if ((i != k) && (m[i][k] != 0.0))
+			{
+				double f = m[i][k];
+				for (int j = 0; j < 2 * n; ++j) m[i][j] -= f*m[k][j];
+			}
+		}
+	}
+
+	for (int i = 0; i < n; ++i)
+		for (int j = 0; j < n; ++j) ai[i*ld + j] = m[i][n + j];
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(BlockJacobiPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_bs, "block_size");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+BlockJacobiPreconditioner::BlockJacobiPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_bs = 3;
+	m_K = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* BlockJacobiPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	if ((m_bs < 1) || (m_bs > 4))
+	{
+		feLogError("Invalid block size for block-Jacobi preconditioner (must be 1 - 4).");
+		return nullptr;
+	}
+	m_K = new BSRMatrix(m_bs, (ntype == REAL_SYMMETRIC));
+	return m_K;
+}
+
+//-----------------------------------------------------------------------------
+bool BlockJacobiPreconditioner::Factor()
+{
+	// the solver may have created the matrix
+	BSRMatrix* K = dynamic_cast<BSRMatrix*>(GetSparseMatrix());
+	if (K) m_K = K;
+	if (m_K == nullptr)
+	{
+		feLogError("The block-Jacobi preconditioner requires a BSR matrix format.");
+		return false;
+	}
+
+	const int nb = m_K->BlockRows();
+	const int bs = m_K->BlockSize();
+	m_Dinv.assign((size_t)nb*bs*bs, 0.0);
+
+	bool bok = true;
+#pragma omp parallel for schedule(static) reduction(&&:bok)
+	for (int b = 0; b < nb; ++b)
+	{
+		int k = m_K->FindBlock(b, b);
+		if (k < 0) bok = false;
+		else
+		{
+			const double* a = m_K->BlockValues() + (size_t)k*bs*bs;
+			double* ai = &m_Dinv[0] + (size_t)b*bs*bs;
+			if (invertBlock(m_K->BlockEquations(b), bs, a, ai) == false) bok = false;
+		}
+	}
+
+	if (bok == false)
+	{
+		feLogError("Singular diagonal block in block-Jacobi preconditioner.");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool BlockJacobiPreconditioner::BackSolve(double* x, double* y)
+{
+	if (m_K == nullptr) return false;
+	const int nb = m_K->BlockRows();
+	const int bs = m_K->BlockSize();
+
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < nb; ++b)
+	{
+		const int s = m_K->BlockStart(b);
+		const int n = m_K->BlockEquations(b);
+		const double* ai = &m_Dinv[0] + (size_t)b*bs*bs;
+		for (int i = 0; i < n; ++i)
+		{
+			double xi = 0.0;
+			for (int j = 0; j < n; ++j) xi += ai[i*bs + j] * y[s + j];
+			x[s + i] = xi;
+		}
+	}
+
+	return true;
+}
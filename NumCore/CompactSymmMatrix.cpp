@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactSymmMatrix.h"
+#include <FECore/sys.h>
+#include <algorithm>
 
 //-----------------------------------------------------------------------------
 //! constructor
@@ -40,34 +42,127 @@ CompactSymmMatrix::CompactSymmMatrix(int offset) : CompactMatrix(offset)
 bool CompactSymmMatrix::mult_vector(double* x, double* r)
 {
 	// get row count
-	int N = Rows();
-	int M = Columns();
+	const int N = Rows();
+	const int M = Columns();
+
+	const int nt = omp_get_max_threads();
+	if ((nt == 1) || (M < 1000))
+	{
+		// zero result vector
+		for (int j = 0; j<N; ++j) r[j] = 0.0;
+		mult_columns(0, M, x, r, 0);
+		return true;
+	}
+
+	// the column blocks are set up in Create, but the thread count may have changed since.
+	if ((int)m_blocks.size() != nt) BuildColumnBlocks(nt);
+
+	// Each block of columns has about the same number of nonzeroes. Since a column also updates
+	// rows below its block, each block accumulates its result in a separate buffer that only 
+	// covers the rows the block touches. The buffers are added at the end.
+	const int NB = (int)m_blocks.size();
+#pragma omp parallel num_threads(nt)
+	{
+#pragma omp for schedule(static, 1)
+		for (int n = 0; n < NB; ++n)
+		{
+			const ColumnBlock& b = m_blocks[n];
+			double* rn = &m_buf[b.off];
+			for (int i = 0; i < b.r1 - b.j0; ++i) rn[i] = 0.0;
+			mult_columns(b.j0, b.j1, x, rn, b.j0);
+		}
+
+		// add the buffers of the blocks that touch each row
+#pragma omp for schedule(static, 1)
+		for (int n = 0; n < NB; ++n)
+		{
+			const ColumnBlock& b = m_blocks[n];
+			for (int i = b.j0; i < b.j1; ++i)
+			{
+				double ri = 0.0;
+				for (int k = b.k0; k <= n; ++k)
+				{
+					const ColumnBlock& bk = m_blocks[k];
+					if (i < bk.r1) ri += m_buf[bk.off + (i - bk.j0)];
+				}
+				r[i] = ri;
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Divide the columns into nt blocks with about the same number of nonzeroes and
+//! allocate the result buffers of the threaded matrix-vector product.
+void CompactSymmMatrix::BuildColumnBlocks(int nt)
+{
+	const int M = Columns();
+	const int* p0 = m_ppointers;
+	const int nnz = p0[M] - p0[0];
+
+	m_blocks.resize(nt);
+	size_t off = 0;
+	for (int n = 0; n < nt; ++n)
+	{
+		ColumnBlock& b = m_blocks[n];
+		b.j0 = (int)(std::lower_bound(p0, p0 + M, p0[0] + (int)(((double)nnz*n) / nt)) - p0);
+		b.j1 = (n == nt - 1 ? M : (int)(std::lower_bound(p0, p0 + M, p0[0] + (int)(((double)nnz*(n + 1)) / nt)) - p0));
+		if (n > 0) b.j0 = m_blocks[n - 1].j1;
+		if (b.j1 < b.j0) b.j1 = b.j0;
+
+		// the last row touched by this block (the row indices of a column are sorted)
+		b.r1 = b.j1;
+		for (int j = b.j0; j < b.j1; ++j)
+		{
+			int nj = p0[j + 1] - p0[j];
+			if (nj > 0)
+			{
+				int rj = m_pindices[p0[j + 1] - 1 - m_offset] - m_offset + 1;
+				if (rj > b.r1) b.r1 = rj;
+			}
+		}
+
+		// the first block that touches the rows of this block
+		b.k0 = n;
+		for (int k = 0; k < n; ++k) if (m_blocks[k].r1 > b.j0) { b.k0 = k; break; }
+
+		b.off = off;
+		off += b.r1 - b.j0;
+	}
+	m_buf.resize(off);
+}
 
-	// zero result vector
-	for (int j = 0; j<N; ++j) r[j] = 0.0;
+//-----------------------------------------------------------------------------
+//! Multiply the columns [j0, j1) of the matrix with x and add the result to r.
+//! The result vector r starts at row r0.
+void CompactSymmMatrix::mult_columns(int j0, int j1, const double* x, double* r, int r0) const
+{
+	const int ro = m_offset + r0;
 
 	// loop over all columns
-	for (int j = 0; j<M; ++j)
+	for (int j = j0; j<j1; ++j)
 	{
-		double* pv = m_pd + m_ppointers[j] - m_offset;
-		int* pi = m_pindices + m_ppointers[j] - m_offset;
+		const double* pv = m_pd + m_ppointers[j] - m_offset;
+		const int* pi = m_pindices + m_ppointers[j] - m_offset;
 		int n = m_ppointers[j + 1] - m_ppointers[j];
 
 		// add off-diagonal elements
 		for (int i = 1; i<n - 7; i += 8)
 		{
 			// add lower triangular element
-			r[pi[i    ] - m_offset] += pv[i    ] * x[j];
-			r[pi[i + 1] - m_offset] += pv[i + 1] * x[j];
-			r[pi[i + 2] - m_offset] += pv[i + 2] * x[j];
-			r[pi[i + 3] - m_offset] += pv[i + 3] * x[j];
-			r[pi[i + 4] - m_offset] += pv[i + 4] * x[j];
-			r[pi[i + 5] - m_offset] += pv[i + 5] * x[j];
-			r[pi[i + 6] - m_offset] += pv[i + 6] * x[j];
-			r[pi[i + 7] - m_offset] += pv[i + 7] * x[j];
+			r[pi[i    ] - ro] += pv[i    ] * x[j];
+			r[pi[i + 1] - ro] += pv[i + 1] * x[j];
+			r[pi[i + 2] - ro] += pv[i + 2] * x[j];
+			r[pi[i + 3] - ro] += pv[i + 3] * x[j];
+			r[pi[i + 4] - ro] += pv[i + 4] * x[j];
+			r[pi[i + 5] - ro] += pv[i + 5] * x[j];
+			r[pi[i + 6] - ro] += pv[i + 6] * x[j];
+			r[pi[i + 7] - ro] += pv[i + 7] * x[j];
 		}
 		for (int i = 0; i<(n - 1) % 8; ++i)
-			r[pi[n - 1 - i] - m_offset] += pv[n - 1 - i] * x[j];
+			r[pi[n - 1 - i] - ro] += pv[n - 1 - i] * x[j];
 
 		// add diagonal element
 		double rj = pv[0] * x[j];
@@ -88,10 +183,8 @@ bool CompactSymmMatrix::mult_vector(double* x, double* r)
 		for (int i = 0; i<(n - 1) % 8; ++i)
 			rj += pv[n - 1 - i] * x[pi[n - 1 - i] - m_offset];
 
-		r[j] += rj;
+		r[j - r0] += rj;
 	}
-
-	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -172,6 +265,12 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 
 	// create the stiffness matrix
 	CompactMatrix::alloc(nr, nc, nsize, pvalues, pindices, pointers);
+
+	// set up the buffers for the threaded matrix-vector product
+	m_blocks.clear();
+	m_buf.clear();
+	int nt = omp_get_max_threads();
+	if ((nt > 1) && (nc >= 1000)) BuildColumnBlocks(nt);
 }
 
 //-----------------------------------------------------------------------------
@@ -265,6 +364,72 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Build the scatter map for an element. Since the element matrix is symmetric,
+//! only the entries (i,j) with j <= i are mapped, stored row by row. Each entry
+//! stores the offset of the global entry (max(I,J), min(I,J)), or -1 if this entry
+//! is not assembled (i.e. one of the dofs is not an equation).
+void CompactSymmMatrix::BuildScatterMap(const vector<int>& lm, int n, int* map)
+{
+	int k = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j <= i; ++j, ++k)
+		{
+			int I = lm[i];
+			int J = lm[j];
+			if (I < J) { I ^= J; J ^= I; I ^= J; }
+
+			map[k] = -1;
+			if (J >= 0)
+			{
+				// find the row index I in column J (row indices are sorted)
+				int* pi = m_pindices + (m_ppointers[J] - m_offset);
+				int l = m_ppointers[J + 1] - m_ppointers[J];
+				int* p = std::lower_bound(pi, pi + l, I + m_offset);
+				if ((p != pi + l) && (*p == I + m_offset)) map[k] = (m_ppointers[J] - m_offset) + (int)(p - pi);
+				else assert(false);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble an element matrix using a precomputed scatter map. This adds the same
+//! contributions as Assemble(ke, lm, lm) would, but avoids the search for the matrix entries.
+void CompactSymmMatrix::AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic)
+{
+	const int N = ke.rows();
+	double* pv = m_pd;
+	int k = 0;
+	for (int i = 0; i < N; ++i)
+	{
+		const double* kei = ke[i];
+		for (int j = 0; j <= i; ++j, ++k)
+		{
+			int n = map[k];
+			if (n >= 0)
+			{
+				// only the lower triangular part is stored, so grab the entry that
+				// corresponds to the global lower triangular part
+				int I = lm[i];
+				int J = lm[j];
+				double v;
+				if      (I > J) v = kei[j];
+				else if (I < J) v = ke[j][i];
+				else v = (i == j ? kei[i] : kei[j] + ke[j][i]);
+
+				if (batomic)
+				{
+					#pragma omp atomic
+					pv[n] += v;
+				}
+				else pv[n] += v;
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! add a matrix item
 void CompactSymmMatrix::add(int i, int j, double v)
@@ -50,6 +50,15 @@ public:
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj) override;
 
+	//! size of the scatter map (only the lower triangular half of the element matrix is mapped)
+	int ScatterMapSize(int n) const override { return n*(n + 1) / 2; }
+
+	//! build the scatter map for an element
+	void BuildScatterMap(const vector<int>& lm, int n, int* map) override;
+
+	//! assemble an element matrix using a precomputed scatter map
+	void AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic) override;
+
 	//! add a matrix item
 	void add(int i, int j, double v) override;
 
@@ -85,4 +94,24 @@ public:
 
 	//! do row (L) and column (R) scaling
 	void scale(const vector<double>& L, const vector<double>& R) override;
+
+private:
+	//! multiply a block of columns with a vector
+	void mult_columns(int j0, int j1, const double* x, double* r, int r0) const;
+
+	//! set up the column blocks for the threaded matrix-vector product
+	void BuildColumnBlocks(int nt);
+
+private:
+	// A block of columns of the threaded matrix-vector product
+	struct ColumnBlock
+	{
+		int		j0, j1;		// column range [j0, j1)
+		int		r1;			// the block touches the rows [j0, r1)
+		int		k0;			// first block that touches row j0
+		size_t	off;		// offset of the block's result buffer
+	};
+
+	vector<ColumnBlock>	m_blocks;	//!< column blocks
+	vector<double>		m_buf;		//!< result buffers of the column blocks
 };
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "CompactUnSymmMatrix.h"
 #include <FECore/log.h>
+#include <algorithm>
 
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
 #ifdef MKL_ISS
@@ -261,6 +262,58 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const v
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Build the scatter map of an element. The map stores for each entry (i,j) of the
+//! element matrix (row major) the offset into the values array, or -1 if the entry is not assembled.
+void CRSSparseMatrix::BuildScatterMap(const vector<int>& lm, int n, int* map)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			int I = lm[i];
+			int J = lm[j];
+			int& mij = map[i*n + j];
+			mij = -1;
+			if ((I >= 0) && (J >= 0))
+			{
+				// find the column index J in row I (indices are sorted)
+				int* pi = m_pindices + (m_ppointers[I] - m_offset);
+				int l = m_ppointers[I + 1] - m_ppointers[I];
+				int* p = std::lower_bound(pi, pi + l, J + m_offset);
+				if ((p != pi + l) && (*p == J + m_offset)) mij = (m_ppointers[I] - m_offset) + (int)(p - pi);
+				else assert(false);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble an element matrix using a precomputed scatter map. 
+void CRSSparseMatrix::AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic)
+{
+	const int N = ke.rows();
+	double* pv = m_pd;
+	for (int i = 0; i < N; ++i)
+	{
+		const double* kei = ke[i];
+		const int* mi = map + i*N;
+		for (int j = 0; j < N; ++j)
+		{
+			int n = mi[j];
+			if (n >= 0)
+			{
+				if (batomic)
+				{
+					#pragma omp atomic
+					pv[n] += kei[j];
+				}
+				else pv[n] += kei[j];
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // This algorithm uses a binary search for locating the correct row index
 // This assumes that the indices are ordered!
@@ -359,38 +412,34 @@ double CRSSparseMatrix::diag(int i)
 //-----------------------------------------------------------------------------
 bool CRSSparseMatrix::mult_vector(double* x, double* r)
 {
-#ifdef MKL_ISS
-
 	// get the matrix size
 	const int N = Rows();
 
+#ifdef MKL_ISS
 	if (Offset() == 1)
 	{
 		const char transa = 'N';
 		mkl_dcsrgemv(&transa, &N, m_pd, m_ppointers, m_pindices, x, r);
+		return true;
 	}
-	else
+#endif
+
+	// loop over all rows
+#pragma omp parallel for schedule(guided)
+	for (int i = 0; i < N; ++i)
 	{
-		assert(m_offset == 0);
-		// loop over all rows
-	#pragma omp parallel for schedule(guided)
-		for (int i = 0; i < N; ++i)
+		const double* pv = m_pd + (m_ppointers[i] - m_offset);
+		const int* pi = m_pindices + (m_ppointers[i] - m_offset);
+		const int n = m_ppointers[i + 1] - m_ppointers[i];
+		double ri = 0.0;
+		for (int j = 0; j < n; j ++)
 		{
-			const double* pv = m_pd + (m_ppointers[i] - m_offset);
-			const int* pi = m_pindices + (m_ppointers[i] - m_offset);
-			const int n = m_ppointers[i + 1] - m_ppointers[i];
-			r[i] = 0.0;
-			for (int j = 0; j < n; j ++)
-			{
-				r[i] += (*pv++) * x[*pi++ - m_offset];
-			}
+			ri += (*pv++) * x[*pi++ - m_offset];
 		}
+		r[i] = ri;
 	}
 
 	return true;
-#else
-	return false;
-#endif
 }
 
 //! calculate the abs row sum 
@@ -685,6 +734,58 @@ void CCSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const v
 	}
 }
 
+//-----------------------------------------------------------------------------
+//! Build the scatter map of an element. The map stores for each entry (i,j) of the
+//! element matrix (row major) the offset into the values array, or -1 if the entry is not assembled.
+void CCSSparseMatrix::BuildScatterMap(const vector<int>& lm, int n, int* map)
+{
+	for (int i = 0; i < n; ++i)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			int I = lm[i];
+			int J = lm[j];
+			int& mij = map[i*n + j];
+			mij = -1;
+			if ((I >= 0) && (J >= 0))
+			{
+				// find the row index I in column J (indices are sorted)
+				int* pi = m_pindices + (m_ppointers[J] - m_offset);
+				int l = m_ppointers[J + 1] - m_ppointers[J];
+				int* p = std::lower_bound(pi, pi + l, I + m_offset);
+				if ((p != pi + l) && (*p == I + m_offset)) mij = (m_ppointers[J] - m_offset) + (int)(p - pi);
+				else assert(false);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Assemble an element matrix using a precomputed scatter map. 
+void CCSSparseMatrix::AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic)
+{
+	const int N = ke.rows();
+	double* pv = m_pd;
+	for (int i = 0; i < N; ++i)
+	{
+		const double* kei = ke[i];
+		const int* mi = map + i*N;
+		for (int j = 0; j < N; ++j)
+		{
+			int n = mi[j];
+			if (n >= 0)
+			{
+				if (batomic)
+				{
+					#pragma omp atomic
+					pv[n] += kei[j];
+				}
+				else pv[n] += kei[j];
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // This algorithm uses a binary search for locating the correct row index
 // This assumes that the indices are ordered!
@@ -72,6 +72,15 @@ public:
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj) override;
 
+	//! size of the scatter map (all entries of the element matrix are mapped)
+	int ScatterMapSize(int n) const override { return n*n; }
+
+	//! build the scatter map for an element
+	void BuildScatterMap(const vector<int>& lm, int n, int* map) override;
+
+	//! assemble an element matrix using a precomputed scatter map
+	void AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic) override;
+
 	//! add a value to the matrix item
 	void add(int i, int j, double v) override;
 
@@ -143,6 +152,15 @@ public:
 	//! assemble a matrix into the sparse matrix
 	void Assemble(const matrix& ke, const vector<int>& lmi, const vector<int>& lmj) override;
 
+	//! size of the scatter map (all entries of the element matrix are mapped)
+	int ScatterMapSize(int n) const override { return n*n; }
+
+	//! build the scatter map for an element
+	void BuildScatterMap(const vector<int>& lm, int n, int* map) override;
+
+	//! assemble an element matrix using a precomputed scatter map
+	void AssembleScatter(const matrix& ke, const vector<int>& lm, const int* map, bool batomic) override;
+
 	//! add a value to the matrix item
 	void add(int i, int j, double v) override;
 
@@ -0,0 +1,187 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "GMRESSolver.h"
+#include <FECore/log.h>
+#include <vector>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(GMRESSolver, KrylovSolver)
+	ADD_PARAMETER(m_nrestart, "max_restart");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+GMRESSolver::GMRESSolver(FEModel* fem) : KrylovSolver(fem)
+{
+	m_nrestart = 30;
+}
+
+//-----------------------------------------------------------------------------
+bool GMRESSolver::BackSolve(double* x, double* b)
+{
+	if (m_pA == nullptr) return false;
+
+	SparseMatrix& A = *m_pA;
+	const int neq = A.Rows();
+	const int maxiter = MaxIterations(neq);
+	const int M = (m_nrestart > 0 ? m_nrestart : 30);
+
+	// assume initial guess is zero, so r0 = b
+	std::vector<double> r(b, b + neq), z(neq), w(neq);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < neq; ++i) x[i] = 0.0;
+
+	double norm0 = norm(neq, &r[0]);
+	double normi = norm0;
+	if (norm0 == 0.0) return true;
+
+	// Krylov basis, Hessenberg matrix (column major) and Givens rotations
+	std::vector< std::vector<double> > V(M + 1, std::vector<double>(neq));
+	std::vector<double> H((M + 1)*M), cs(M), sn(M), g(M + 1), y(M);
+
+	int iter = 0;
+	bool bconv = false;
+	double beta = norm0;
+	while ((bconv == false) && (iter < maxiter))
+	{
+		// setup first basis vector
+		double* v0 = &V[0][0];
+		const double s = 1.0 / beta;
+#pragma omp parallel for schedule(static)
+		for (int i = 0; i < neq; ++i) v0[i] = r[i] * s;
+		for (int i = 0; i <= M; ++i) g[i] = 0.0;
+		g[0] = beta;
+
+		int k = 0;
+		for (int j = 0; (j < M) && (iter < maxiter); ++j)
+		{
+			double* hj = &H[j*(M + 1)];
+
+			// w = A M v_j
+			if (precondition(&z[0], &V[j][0]) == false) return false;
+			A.mult_vector(&z[0], &w[0]);
+
+			// modified Gram-Schmidt
+			for (int i = 0; i <= j; ++i)
+			{
+				double* vi = &V[i][0];
+				double hij = dot(neq, &w[0], vi);
+#pragma omp parallel for schedule(static)
+				for (int l = 0; l < neq; ++l) w[l] -= hij*vi[l];
+				hj[i] = hij;
+			}
+			double hn = norm(neq, &w[0]);
+			hj[j + 1] = hn;
+			if (hn != 0.0)
+			{
+				double* vj = &V[j + 1][0];
+				const double si = 1.0 / hn;
+#pragma omp parallel for schedule(static)
+				for (int l = 0; l < neq; ++l) vj[l] = w[l] * si;
+			}
+
+			// apply the previous Givens rotations to the new column
+			for (int i = 0; i < j; ++i)
+			{
+				double t = cs[i] * hj[i] + sn[i] * hj[i + 1];
+				hj[i + 1] = -sn[i] * hj[i] + cs[i] * hj[i + 1];
+				hj[i] = t;
+			}
+
+			// calculate the new rotation
+			double d = sqrt(hj[j] * hj[j] + hj[j + 1] * hj[j + 1]);
+			if (d == 0.0) d = 1e-300;
+			cs[j] = hj[j] / d;
+			sn[j] = hj[j + 1] / d;
+			hj[j] = d;
+			hj[j + 1] = 0.0;
+			g[j + 1] = -sn[j] * g[j];
+			g[j] = cs[j] * g[j];
+
+			// the residual norm is the last entry of g
+			normi = fabs(g[j + 1]);
+			iter++;
+			k = j + 1;
+
+			if (m_print_level > 1) report(iter, normi, norm0);
+
+			// a zero norm of the new basis vector means that we found the exact solution
+			if (converged(normi, norm0) || (hn == 0.0))
+			{
+				bconv = true;
+				break;
+			}
+		}
+
+		// solve the upper triangular system H y = g
+		for (int i = k - 1; i >= 0; --i)
+		{
+			double yi = g[i];
+			for (int l = i + 1; l < k; ++l) yi -= H[l*(M + 1) + i] * y[l];
+			y[i] = yi / H[i*(M + 1) + i];
+		}
+
+		// update the solution: x += M (V y)
+#pragma omp parallel for schedule(static)
+		for (int l = 0; l < neq; ++l)
+		{
+			double wl = 0.0;
+			for (int i = 0; i < k; ++i) wl += V[i][l] * y[i];
+			w[l] = wl;
+		}
+		if (precondition(&z[0], &w[0]) == false) return false;
+#pragma omp parallel for schedule(static)
+		for (int l = 0; l < neq; ++l) x[l] += z[l];
+
+		// calculate the true residual before restarting
+		if (bconv == false)
+		{
+			A.mult_vector(x, &w[0]);
+#pragma omp parallel for schedule(static)
+			for (int l = 0; l < neq; ++l) r[l] = b[l] - w[l];
+			beta = norm(neq, &r[0]);
+			normi = beta;
+			if (converged(normi, norm0)) bconv = true;
+		}
+	}
+
+	if (m_print_level == 1) report(iter, normi, norm0);
+
+	UpdateStats(iter);
+
+	if ((bconv == false) && m_fail_max_iters)
+	{
+		feLogWarning("GMRES solver did not converge in %d iterations (residual norm = %lg).", iter, normi);
+		return false;
+	}
+
+	return true;
+}
@@ -29,6 +29,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "ILU0_Preconditioner.h"
 #include "CompactUnSymmMatrix.h"
+#include <FECore/log.h>
 
 // We must undef PARDISO since it is defined as a function in mkl_solver.h
 #ifdef MKL_ISS
@@ -118,6 +119,133 @@ bool ILU0_Preconditioner::BackSolve(double* x, double* y)
 }
 
 #else
-bool ILU0_Preconditioner::Factor() { return false; }
-bool ILU0_Preconditioner::BackSolve(double* x, double* y) { return false; }
+//-----------------------------------------------------------------------------
+// Native ILU(0) factorization. The factors are stored in the sparsity pattern of
+// the matrix with L having a unit diagonal (which is not stored).
+bool ILU0_Preconditioner::Factor()
+{
+	// the solver may have created the matrix
+	CRSSparseMatrix* K = dynamic_cast<CRSSparseMatrix*>(GetSparseMatrix());
+	if (K) m_K = K;
+	if (m_K == 0)
+	{
+		feLogError("The ILU0 preconditioner requires a non-symmetric matrix format.");
+		return false;
+	}
+
+	const int N = m_K->Rows();
+	const int NNZ = m_K->NonZeroes();
+	const int offset = m_K->Offset();
+	const double* pa = m_K->Values();
+	const int* ia = m_K->Pointers();
+	const int* ja = m_K->Indices();
+
+	m_bilu0.assign(pa, pa + NNZ);
+	m_tmp.assign(N, 0.0);
+
+	// find the diagonal entries (column indices are sorted)
+	m_diag.resize(N);
+	for (int i = 0; i < N; ++i)
+	{
+		m_diag[i] = -1;
+		for (int k = ia[i] - offset; k < ia[i + 1] - offset; ++k)
+		{
+			if (ja[k] - offset == i) { m_diag[i] = k; break; }
+		}
+		if (m_diag[i] < 0)
+		{
+			feLogError("Missing diagonal element in row %d of ILU0 preconditioner.", i);
+			return false;
+		}
+	}
+
+	// do the factorization
+	double* pv = &m_bilu0[0];
+	vector<int> iw(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		const int k0 = ia[i] - offset;
+		const int k1 = ia[i + 1] - offset;
+		for (int k = k0; k < k1; ++k) iw[ja[k] - offset] = k;
+
+		for (int k = k0; k < m_diag[i]; ++k)
+		{
+			// calculate the L-entry
+			int j = ja[k] - offset;
+			double lij = pv[k] / pv[m_diag[j]];
+			pv[k] = lij;
+
+			// update the rest of row i with row j of U
+			for (int m = m_diag[j] + 1; m < ia[j + 1] - offset; ++m)
+			{
+				int p = iw[ja[m] - offset];
+				if (p >= 0) pv[p] -= lij*pv[m];
+			}
+		}
+
+		// check the diagonal
+		double& dii = pv[m_diag[i]];
+		if (m_checkZeroDiagonal && (fabs(dii) < m_zeroThreshold)) dii = m_zeroReplace;
+		if (dii == 0.0)
+		{
+			feLogError("Zero pivot in row %d of ILU0 preconditioner.", i);
+			return false;
+		}
+
+		for (int k = k0; k < k1; ++k) iw[ja[k] - offset] = -1;
+	}
+
+	// setup the level schedules for the triangular solves
+	m_fwd.Create(N, ia, ja, offset, true);
+	m_bwd.Create(N, ia, ja, offset, false);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Solve (LU)x = y. The rows in each level of the triangular solves are processed in parallel.
+bool ILU0_Preconditioner::BackSolve(double* x, double* y)
+{
+	const int offset = m_K->Offset();
+	const int* ia = m_K->Pointers();
+	const int* ja = m_K->Indices();
+	const double* pv = &m_bilu0[0];
+	const int* pd = &m_diag[0];
+	double* t = &m_tmp[0];
+
+#pragma omp parallel
+	{
+		// forward substitution: L t = y
+		for (int l = 0; l < m_fwd.Levels(); ++l)
+		{
+			const int nl = m_fwd.LevelSize(l);
+			const int* rows = m_fwd.LevelRows(l);
+#pragma omp for schedule(static)
+			for (int n = 0; n < nl; ++n)
+			{
+				int i = rows[n];
+				double ti = y[i];
+				for (int k = ia[i] - offset; k < pd[i]; ++k) ti -= pv[k] * t[ja[k] - offset];
+				t[i] = ti;
+			}
+		}
+
+		// backward substitution: U x = t
+		for (int l = 0; l < m_bwd.Levels(); ++l)
+		{
+			const int nl = m_bwd.LevelSize(l);
+			const int* rows = m_bwd.LevelRows(l);
+#pragma omp for schedule(static)
+			for (int n = 0; n < nl; ++n)
+			{
+				int i = rows[n];
+				double xi = t[i];
+				for (int k = pd[i] + 1; k < ia[i + 1] - offset; ++k) xi -= pv[k] * x[ja[k] - offset];
+				x[i] = xi / pv[pd[i]];
+			}
+		}
+	}
+
+	return true;
+}
 #endif
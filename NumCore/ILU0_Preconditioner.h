@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "LevelSchedule.h"
 
 //-----------------------------------------------------------------------------
 class ILU0_Preconditioner : public Preconditioner
@@ -54,5 +55,10 @@ private:
 	vector<double>		m_tmp;
 	CRSSparseMatrix*	m_K;
 
+	// used by the native implementation
+	vector<int>			m_diag;		// location of diagonal entries
+	LevelSchedule		m_fwd;		// level schedule for forward substitution
+	LevelSchedule		m_bwd;		// level schedule for backward substitution
+
 	DECLARE_FECORE_CLASS();
 };
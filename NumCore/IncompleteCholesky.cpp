@@ -43,7 +43,12 @@ SOFTWARE.*/
 
 IncompleteCholesky::IncompleteCholesky(FEModel* fem) : Preconditioner(fem)
 {
+	m_L = nullptr;
+}
 
+IncompleteCholesky::~IncompleteCholesky()
+{
+	delete m_L;
 }
 
 CompactSymmMatrix* IncompleteCholesky::getMatrix()
@@ -66,6 +71,7 @@ bool IncompleteCholesky::Factor()
 	z.resize(N, 0.0);
 
 	// create the preconditioner
+	delete m_L;
 	m_L = new CompactSymmMatrix(K->Offset());
 	double* val = new double[nnz];
 	int* row = new int[nnz];
@@ -154,9 +160,52 @@ bool IncompleteCholesky::Factor()
 		assert(Lii != 0.0);
 	}
 
+#ifndef MKL_ISS
+	// setup the data for the parallel triangular solves
+	CreateSchedule();
+#endif
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// Setup the level schedules for the native triangular solves. The backward solve
+// (with L^T) can work directly with the columns of L, but the forward solve needs 
+// the rows of L, so we store the row structure of the strictly lower part as well.
+void IncompleteCholesky::CreateSchedule()
+{
+	const int N = m_L->Rows();
+	const int offset = m_L->Offset();
+	const int* col = m_L->Pointers();
+	const int* row = m_L->Indices();
+
+	// count the off-diagonal entries in each row
+	m_rowPtr.assign(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = col[j] - offset + 1; k < col[j + 1] - offset; ++k) m_rowPtr[row[k] - offset + 1]++;
+	}
+	for (int i = 0; i < N; ++i) m_rowPtr[i + 1] += m_rowPtr[i];
+
+	// fill the row structure
+	m_rowInd.resize(m_rowPtr[N]);
+	m_rowVal.resize(m_rowPtr[N]);
+	vector<int> pos(m_rowPtr.begin(), m_rowPtr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = col[j] - offset + 1; k < col[j + 1] - offset; ++k)
+		{
+			int i = row[k] - offset;
+			m_rowInd[pos[i]] = j;
+			m_rowVal[pos[i]] = k;
+			pos[i]++;
+		}
+	}
+
+	m_fwd.Create(N, &m_rowPtr[0], (m_rowInd.empty() ? nullptr : &m_rowInd[0]), 0, true);
+	m_bwd.Create(N, col, row, offset, false);
+}
+
 bool IncompleteCholesky::BackSolve(double* x, double* y)
 {
 #ifdef MKL_ISS
@@ -176,6 +225,47 @@ bool IncompleteCholesky::BackSolve(double* x, double* y)
 
 	return true;
 #else 
+	// solve L z = y, followed by L^T x = z. 
+	// The rows in each level are processed in parallel.
+	const int offset = m_L->Offset();
+	const double* val = m_L->Values();
+	const int* col = m_L->Pointers();
+	const int* row = m_L->Indices();
+	double* pz = &z[0];
+
+#pragma omp parallel
+	{
+		// forward substitution
+		for (int l = 0; l < m_fwd.Levels(); ++l)
+		{
+			const int nl = m_fwd.LevelSize(l);
+			const int* rows = m_fwd.LevelRows(l);
+#pragma omp for schedule(static)
+			for (int n = 0; n < nl; ++n)
+			{
+				int i = rows[n];
+				double zi = y[i];
+				for (int k = m_rowPtr[i]; k < m_rowPtr[i + 1]; ++k) zi -= val[m_rowVal[k]] * pz[m_rowInd[k]];
+				pz[i] = zi / val[col[i] - offset];
+			}
+		}
+
+		// backward substitution
+		for (int l = 0; l < m_bwd.Levels(); ++l)
+		{
+			const int nl = m_bwd.LevelSize(l);
+			const int* rows = m_bwd.LevelRows(l);
+#pragma omp for schedule(static)
+			for (int n = 0; n < nl; ++n)
+			{
+				int i = rows[n];
+				double xi = pz[i];
+				for (int k = col[i] - offset + 1; k < col[i + 1] - offset; ++k) xi -= val[k] * x[row[k] - offset];
+				x[i] = xi / val[col[i] - offset];
+			}
+		}
+	}
+
 	return true;
 #endif
 }
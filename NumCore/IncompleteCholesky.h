@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "LevelSchedule.h"
 
 class CompactSymmMatrix;
 
@@ -35,6 +36,7 @@ class IncompleteCholesky : public Preconditioner
 {
 public:
 	IncompleteCholesky(FEModel* fem);
+	~IncompleteCholesky();
 
 	// create a preconditioner for a sparse matrix
 	bool Factor() override;
@@ -45,7 +47,17 @@ public:
 public:
 	CompactSymmMatrix* getMatrix();
 
+private:
+	void CreateSchedule();
+
 private:
 	CompactSymmMatrix*	m_L;
 	vector<double>		z;
+
+	// used by the native triangular solves
+	vector<int>			m_rowPtr;	// row pointers of strictly lower part of L
+	vector<int>			m_rowInd;	// column indices of strictly lower part of L
+	vector<int>			m_rowVal;	// location of the row entries in L's values
+	LevelSchedule		m_fwd;		// level schedule for forward substitution
+	LevelSchedule		m_bwd;		// level schedule for backward substitution
 };
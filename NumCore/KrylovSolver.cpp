@@ -0,0 +1,177 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "KrylovSolver.h"
+#include "CompactSymmMatrix.h"
+#include "CompactUnSymmMatrix.h"
+#include "BSRMatrix.h"
+#include <FECore/log.h>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(KrylovSolver, IterativeLinearSolver)
+	ADD_PARAMETER(m_print_level   , "print_level");
+	ADD_PARAMETER(m_tol           , "tol");
+	ADD_PARAMETER(m_abstol        , "abs_tol");
+	ADD_PARAMETER(m_maxiter       , "max_iter");
+	ADD_PARAMETER(m_fail_max_iters, "fail_max_iters");
+	ADD_PARAMETER(m_blockSize     , "block_size");
+	ADD_PROPERTY(m_P, "pc_left", FEProperty::Optional);
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+KrylovSolver::KrylovSolver(FEModel* fem) : IterativeLinearSolver(fem), m_pA(0), m_P(0)
+{
+	m_maxiter = 0;
+	m_tol = 1e-5;
+	m_abstol = 0.0;
+	m_print_level = 0;
+	m_fail_max_iters = true;
+	m_blockSize = 0;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* KrylovSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// let the preconditioner decide
+	m_pA = nullptr;
+	if (m_P)
+	{
+		m_P->SetPartitions(m_part);
+		m_pA = m_P->CreateSparseMatrix(ntype);
+
+		// Some preconditioners (e.g. ILU0) need the full matrix, even for symmetric problems.
+		if ((m_pA == nullptr) && (ntype == REAL_SYMMETRIC)) m_pA = m_P->CreateSparseMatrix(REAL_UNSYMMETRIC);
+	}
+
+	// if the preconditioner doesn't care, we use our default formats
+	if (m_pA == nullptr)
+	{
+		if ((m_blockSize < 0) || (m_blockSize > 4))
+		{
+			feLogError("Invalid block size for BSR matrix format (must be 1 - 4).");
+			return nullptr;
+		}
+
+		if (m_blockSize > 0) m_pA = new BSRMatrix(m_blockSize, (ntype == REAL_SYMMETRIC));
+		else if (ntype == REAL_SYMMETRIC) m_pA = new CompactSymmMatrix(1);
+		else m_pA = new CRSSparseMatrix(1);
+	}
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool KrylovSolver::SetSparseMatrix(SparseMatrix* A)
+{
+	m_pA = A;
+	return (m_pA != 0);
+}
+
+//-----------------------------------------------------------------------------
+void KrylovSolver::SetLeftPreconditioner(LinearSolver* P)
+{
+	m_P = P;
+}
+
+//-----------------------------------------------------------------------------
+LinearSolver* KrylovSolver::GetLeftPreconditioner()
+{
+	return m_P;
+}
+
+//-----------------------------------------------------------------------------
+bool KrylovSolver::HasPreconditioner() const
+{
+	return (m_P != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool KrylovSolver::PreProcess()
+{
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool KrylovSolver::Factor()
+{
+	if (m_pA == 0) return false;
+	if (m_P)
+	{
+		// the preconditioner may not have created the matrix, so make sure it has it.
+		if (m_P->SetSparseMatrix(m_pA) == false) return false;
+		if (m_P->PreProcess() == false) return false;
+		if (m_P->Factor() == false) return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void KrylovSolver::Destroy()
+{
+	if (m_P) m_P->Destroy();
+}
+
+//-----------------------------------------------------------------------------
+int KrylovSolver::MaxIterations(int neq) const
+{
+	return (m_maxiter > 0 ? m_maxiter : neq);
+}
+
+//-----------------------------------------------------------------------------
+bool KrylovSolver::precondition(double* z, double* r)
+{
+	if (m_P) return m_P->BackSolve(z, r);
+
+	const int neq = m_pA->Rows();
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < neq; ++i) z[i] = r[i];
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void KrylovSolver::report(int iter, double norm, double norm0) const
+{
+	feLog("%d:%lg, %lg\n", iter, norm, m_tol*norm0 + m_abstol);
+}
+
+//-----------------------------------------------------------------------------
+double KrylovSolver::dot(int n, const double* a, const double* b)
+{
+	double s = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:s)
+	for (int i = 0; i < n; ++i) s += a[i] * b[i];
+	return s;
+}
+
+//-----------------------------------------------------------------------------
+double KrylovSolver::norm(int n, const double* a)
+{
+	return sqrt(dot(n, a, a));
+}
@@ -0,0 +1,78 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "LevelSchedule.h"
+
+//-----------------------------------------------------------------------------
+LevelSchedule::LevelSchedule()
+{
+}
+
+//-----------------------------------------------------------------------------
+void LevelSchedule::Clear()
+{
+	m_row.clear();
+	m_lev.clear();
+}
+
+//-----------------------------------------------------------------------------
+void LevelSchedule::Create(int n, const int* ptr, const int* ind, int offset, bool lower)
+{
+	// calculate the level of each row
+	std::vector<int> level(n, 0);
+	int nlevels = 0;
+	for (int k = 0; k < n; ++k)
+	{
+		int i = (lower ? k : n - 1 - k);
+		const int* pi = ind + (ptr[i] - offset);
+		int m = ptr[i + 1] - ptr[i];
+		int li = 0;
+		for (int l = 0; l < m; ++l)
+		{
+			int j = pi[l] - offset;
+			if ((lower && (j < i)) || (!lower && (j > i)))
+			{
+				if (level[j] + 1 > li) li = level[j] + 1;
+			}
+		}
+		level[i] = li;
+		if (li + 1 > nlevels) nlevels = li + 1;
+	}
+
+	// count the rows in each level
+	m_lev.assign(nlevels + 1, 0);
+	for (int i = 0; i < n; ++i) m_lev[level[i] + 1]++;
+	for (int l = 0; l < nlevels; ++l) m_lev[l + 1] += m_lev[l];
+
+	// sort the rows by level
+	m_row.resize(n);
+	std::vector<int> pos(m_lev.begin(), m_lev.end() - 1);
+	for (int i = 0; i < n; ++i) m_row[pos[level[i]]++] = i;
+}
@@ -0,0 +1,63 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! This class partitions the rows of a sparse triangular matrix into levels, 
+//! such that the rows of a level only depend on rows of previous levels. The 
+//! rows of a level can then be processed in parallel during forward or backward
+//! substitution.
+class LevelSchedule
+{
+public:
+	LevelSchedule();
+
+	//! Build the schedule from a row-compressed dependency graph, i.e. row i depends on the 
+	//! rows ind[ptr[i]-offset ... ptr[i+1]-offset-1] - offset. For a lower triangular matrix
+	//! (forward substitution) only the dependencies j < i are considered, otherwise only j > i.
+	void Create(int n, const int* ptr, const int* ind, int offset, bool lower);
+
+	//! clear the schedule
+	void Clear();
+
+	//! number of levels
+	int Levels() const { return (int)m_lev.size() - 1; }
+
+	//! number of rows in a level
+	int LevelSize(int l) const { return m_lev[l + 1] - m_lev[l]; }
+
+	//! rows of a level
+	const int* LevelRows(int l) const { return &m_row[0] + m_lev[l]; }
+
+private:
+	std::vector<int>	m_row;	//!< rows, sorted by level
+	std::vector<int>	m_lev;	//!< start of each level in m_row
+};
@@ -0,0 +1,372 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "NestedDissection.h"
+#include <algorithm>
+#include <assert.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+NestedDissection::NestedDissection()
+{
+	m_leafSize = 16;
+}
+
+//-----------------------------------------------------------------------------
+void NestedDissection::Apply(int n, const vector<int>& xadj, const vector<int>& adj, vector<int>& perm)
+{
+	perm.resize(n);
+	if (n == 0) return;
+
+	// merge vertices with identical adjacency into supervariables
+	vector<int> sv(n);
+	int ns = FindSupervariables(n, xadj, adj, sv);
+
+	// representative vertex and weight of each supervariable
+	vector<int> rep(ns, -1);
+	m_wgt.assign(ns, 0);
+	for (int i = 0; i < n; ++i)
+	{
+		if (rep[sv[i]] == -1) rep[sv[i]] = i;
+		m_wgt[sv[i]]++;
+	}
+
+	// build the compressed graph
+	vector<int> tag(ns, -1);
+	m_xadj.assign(ns + 1, 0);
+	m_adj.clear();
+	for (int s = 0; s < ns; ++s)
+	{
+		tag[s] = s;
+		int v = rep[s];
+		for (int k = xadj[v]; k < xadj[v + 1]; ++k)
+		{
+			int t = sv[adj[k]];
+			if (tag[t] != s) { tag[t] = s; m_adj.push_back(t); }
+		}
+		m_xadj[s + 1] = (int)m_adj.size();
+	}
+
+	// order the compressed graph
+	vector<int> sperm;
+	Dissect(sperm);
+
+	// expand the ordering to the original vertices
+	vector<int> pos(ns + 1, 0);
+	for (int s = 0; s < ns; ++s) pos[s + 1] = pos[s] + m_wgt[s];
+	vector<int> var(n);
+	vector<int> cnt(pos.begin(), pos.end() - 1);
+	for (int i = 0; i < n; ++i) var[cnt[sv[i]]++] = i;
+
+	int m = 0;
+	for (int k = 0; k < ns; ++k)
+	{
+		int s = sperm[k];
+		for (int l = pos[s]; l < pos[s + 1]; ++l) perm[m++] = var[l];
+	}
+	assert(m == n);
+
+	// clean up
+	m_xadj.clear();
+	m_adj.clear();
+	m_wgt.clear();
+	m_part.clear();
+	m_level.clear();
+}
+
+//-----------------------------------------------------------------------------
+int NestedDissection::FindSupervariables(int n, const vector<int>& xadj, const vector<int>& adj, vector<int>& sv)
+{
+	// sort the vertices by degree and a hash of their closed neighborhood
+	vector<long long> hash(n);
+	for (int i = 0; i < n; ++i)
+	{
+		long long h = i;
+		for (int k = xadj[i]; k < xadj[i + 1]; ++k) h += adj[k];
+		hash[i] = h;
+	}
+
+	vector<int> tmp(n);
+	for (int i = 0; i < n; ++i) tmp[i] = i;
+	sort(tmp.begin(), tmp.end(), [&](int a, int b) {
+		int da = xadj[a + 1] - xadj[a];
+		int db = xadj[b + 1] - xadj[b];
+		if (da != db) return da < db;
+		if (hash[a] != hash[b]) return hash[a] < hash[b];
+		return a < b;
+	});
+
+	// compare the closed neighborhoods of vertices with the same key
+	sv.assign(n, -1);
+	vector<int> mark(n, -1);
+	int ns = 0;
+	for (int k0 = 0; k0 < n;)
+	{
+		int a = tmp[k0];
+		int k1 = k0 + 1;
+		while ((k1 < n) && (xadj[tmp[k1] + 1] - xadj[tmp[k1]] == xadj[a + 1] - xadj[a]) && (hash[tmp[k1]] == hash[a])) k1++;
+
+		for (int k = k0; k < k1; ++k)
+		{
+			int u = tmp[k];
+			if (sv[u] != -1) continue;
+			sv[u] = ns;
+
+			mark[u] = u;
+			for (int l = xadj[u]; l < xadj[u + 1]; ++l) mark[adj[l]] = u;
+
+			for (int l = k + 1; l < k1; ++l)
+			{
+				int v = tmp[l];
+				if ((sv[v] != -1) || (mark[v] != u)) continue;
+
+				bool bsame = true;
+				for (int m = xadj[v]; m < xadj[v + 1]; ++m)
+				{
+					if (mark[adj[m]] != u) { bsame = false; break; }
+				}
+				if (bsame) sv[v] = ns;
+			}
+			ns++;
+		}
+		k0 = k1;
+	}
+
+	// number the supervariables in order of their first vertex
+	vector<int> newid(ns, -1);
+	int m = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		if (newid[sv[i]] == -1) newid[sv[i]] = m++;
+		sv[i] = newid[sv[i]];
+	}
+
+	return ns;
+}
+
+//-----------------------------------------------------------------------------
+int NestedDissection::LevelStructure(int root, int id, vector<int>& order, vector<int>& lptr)
+{
+	order.clear();
+	lptr.clear();
+
+	order.push_back(root);
+	m_level[root] = 0;
+	lptr.push_back(0);
+
+	int l0 = 0, l1 = 1, nl = 0;
+	while (l1 > l0)
+	{
+		lptr.push_back(l1);
+		nl++;
+		for (int k = l0; k < l1; ++k)
+		{
+			int v = order[k];
+			for (int m = m_xadj[v]; m < m_xadj[v + 1]; ++m)
+			{
+				int w = m_adj[m];
+				if ((m_part[w] == id) && (m_level[w] == -1))
+				{
+					m_level[w] = nl;
+					order.push_back(w);
+				}
+			}
+		}
+		l0 = l1;
+		l1 = (int)order.size();
+	}
+
+	// reset the levels
+	for (size_t k = 0; k < order.size(); ++k) m_level[order[k]] = -1;
+
+	return nl;
+}
+
+//-----------------------------------------------------------------------------
+void NestedDissection::Dissect(vector<int>& perm)
+{
+	const int N = (int)m_wgt.size();
+	m_part.assign(N, 0);
+	m_level.assign(N, -1);
+
+	perm.clear();
+	perm.reserve(N);
+
+	// The subgraphs are processed from a stack, so that the ordering becomes
+	// part A, part B and then the separator. 
+	struct Task
+	{
+		vector<int>	v;		// vertices of the subgraph
+		bool		emit;	// number the vertices without dissecting them
+	};
+	vector<Task> stack;
+	stack.push_back(Task());
+	stack.back().v.resize(N);
+	for (int i = 0; i < N; ++i) stack.back().v[i] = i;
+	stack.back().emit = false;
+
+	vector<int> order, lptr, tmp, tptr;
+	vector<int> lab(N, -1);
+	int nid = 0;
+	while (stack.empty() == false)
+	{
+		Task t;
+		t.v.swap(stack.back().v);
+		t.emit = stack.back().emit;
+		stack.pop_back();
+
+		const int nv = (int)t.v.size();
+		if (t.emit || (nv <= m_leafSize))
+		{
+			perm.insert(perm.end(), t.v.begin(), t.v.end());
+			continue;
+		}
+
+		// tag the vertices of this subgraph
+		int id = ++nid;
+		for (int i = 0; i < nv; ++i) m_part[t.v[i]] = id;
+
+		// find a pseudo-peripheral vertex, starting from a vertex of lowest degree
+		int root = t.v[0];
+		for (int i = 1; i < nv; ++i)
+		{
+			int v = t.v[i];
+			if (m_xadj[v + 1] - m_xadj[v] < m_xadj[root + 1] - m_xadj[root]) root = v;
+		}
+		int nl = LevelStructure(root, id, order, lptr);
+		for (int iter = 0; iter < 8; ++iter)
+		{
+			// try the vertex of lowest degree in the last level
+			int cand = order[lptr[nl - 1]];
+			for (int k = lptr[nl - 1] + 1; k < lptr[nl]; ++k)
+			{
+				int v = order[k];
+				if (m_xadj[v + 1] - m_xadj[v] < m_xadj[cand + 1] - m_xadj[cand]) cand = v;
+			}
+
+			int ml = LevelStructure(cand, id, tmp, tptr);
+			if (ml <= nl) break;
+			nl = ml;
+			order.swap(tmp);
+			lptr.swap(tptr);
+		}
+
+		// if the subgraph is not connected, split off the component we found
+		if ((int)order.size() < nv)
+		{
+			for (size_t k = 0; k < order.size(); ++k) m_part[order[k]] = -1;
+
+			Task rest;
+			rest.emit = false;
+			for (int i = 0; i < nv; ++i) if (m_part[t.v[i]] == id) rest.v.push_back(t.v[i]);
+			stack.push_back(rest);
+
+			Task comp;
+			comp.emit = false;
+			comp.v = order;
+			stack.push_back(comp);
+			continue;
+		}
+
+		// we need at least three levels to split the graph
+		if (nl < 3)
+		{
+			perm.insert(perm.end(), t.v.begin(), t.v.end());
+			continue;
+		}
+
+		// pick the separator level: the smallest level that still gives a reasonable balance
+		int W = 0;
+		for (int i = 0; i < nv; ++i) W += m_wgt[t.v[i]];
+
+		int isep = -1, wsep = 0, wsum = 0;
+		int ihalf = -1;
+		for (int l = 0; l < nl; ++l)
+		{
+			int wl = 0;
+			for (int k = lptr[l]; k < lptr[l + 1]; ++k) wl += m_wgt[order[k]];
+
+			if ((l > 0) && (l < nl - 1))
+			{
+				if ((ihalf == -1) && (2 * (wsum + wl) >= W)) ihalf = l;
+				if ((5 * wsum >= W) && (5 * (wsum + wl) <= 4 * W))
+				{
+					if ((isep == -1) || (wl < wsep)) { isep = l; wsep = wl; }
+				}
+			}
+			wsum += wl;
+		}
+		if (isep == -1) isep = (ihalf == -1 ? nl / 2 : ihalf);
+
+		// label the vertices: 0 = part A, 1 = separator, 2 = part B
+		for (int l = 0; l < nl; ++l)
+		{
+			int lv = (l < isep ? 0 : (l == isep ? 1 : 2));
+			for (int k = lptr[l]; k < lptr[l + 1]; ++k) lab[order[k]] = lv;
+		}
+
+		// thin the separator: vertices not connected to one of the parts can be moved to the other
+		for (int k = lptr[isep]; k < lptr[isep + 1]; ++k)
+		{
+			int v = order[k];
+			bool bA = false, bB = false;
+			for (int m = m_xadj[v]; m < m_xadj[v + 1]; ++m)
+			{
+				int w = m_adj[m];
+				if (m_part[w] != id) continue;
+				if (lab[w] == 0) bA = true;
+				else if (lab[w] == 2) bB = true;
+			}
+			if (bB == false) lab[v] = 0;
+			else if (bA == false) lab[v] = 2;
+		}
+
+		Task A, B, S;
+		A.emit = B.emit = false;
+		S.emit = true;
+		for (int i = 0; i < nv; ++i)
+		{
+			int v = t.v[i];
+			switch (lab[v])
+			{
+			case 0: A.v.push_back(v); break;
+			case 1: S.v.push_back(v); break;
+			case 2: B.v.push_back(v); break;
+			}
+			lab[v] = -1;
+		}
+
+		if (S.v.empty() == false) stack.push_back(S);
+		if (B.v.empty() == false) stack.push_back(B);
+		if (A.v.empty() == false) stack.push_back(A);
+	}
+
+	assert((int)perm.size() == N);
+}
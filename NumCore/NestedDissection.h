@@ -0,0 +1,70 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! This class calculates a fill-reducing ordering of a sparse symmetric matrix 
+//! using nested dissection. The graph is recursively split into two parts and a
+//! separator, which is numbered last. The separators are found from a level structure 
+//! that starts at a pseudo-peripheral vertex. Vertices with identical adjacency 
+//! (e.g. the degrees of freedom of a node) are merged before the graph is dissected.
+class NestedDissection
+{
+public:
+	NestedDissection();
+
+	//! Calculate the ordering of a graph, given as adjacency lists in compressed row format
+	//! (without the diagonal). On return perm[i] is the (old) vertex that is numbered i.
+	void Apply(int n, const std::vector<int>& xadj, const std::vector<int>& adj, std::vector<int>& perm);
+
+	//! set the max size of a subgraph that is not dissected any further
+	void SetLeafSize(int n) { m_leafSize = n; }
+
+private:
+	// find vertices with identical closed neighborhoods (returns nr of supervariables)
+	int FindSupervariables(int n, const std::vector<int>& xadj, const std::vector<int>& adj, std::vector<int>& sv);
+
+	// order the (compressed) graph
+	void Dissect(std::vector<int>& perm);
+
+	// create the level structure of the subgraph with the given id, starting at vertex root
+	int LevelStructure(int root, int id, std::vector<int>& order, std::vector<int>& lptr);
+
+private:
+	int		m_leafSize;
+
+	// compressed graph
+	std::vector<int>	m_xadj;
+	std::vector<int>	m_adj;
+	std::vector<int>	m_wgt;		// nr of vertices in each supervariable
+	std::vector<int>	m_part;		// id of the subgraph each vertex currently belongs to
+	std::vector<int>	m_level;	// level of each vertex in the current level structure
+};
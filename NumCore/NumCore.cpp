@@ -26,6 +26,7 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "NumCore.h"
 #include "SkylineSolver.h"
+#include "SupernodalSolver.h"
 #include "LUSolver.h"
 #include "PardisoSolver.h"
 #include "RCICGSolver.h"
@@ -37,10 +38,15 @@ SOFTWARE.*/
 #include "Hypre_PCG_AMG.h"
 #include "SchurSolver.h"
 #include "IncompleteCholesky.h"
+#include "BlockJacobiPreconditioner.h"
+#include "AMGPreconditioner.h"
 #include "BoomerAMGSolver.h"
 #include "BlockSolver.h"
 #include "BiCGStabSolver.h"
+#include "PCGSolver.h"
+#include "GMRESSolver.h"
 #include "StrategySolver.h"
+#include <FECore/Preconditioner.h>
 #include <FECore/fecore_enum.h>
 #include <FECore/FECoreFactory.h>
 #include <FECore/FECoreKernel.h>
@@ -53,6 +59,7 @@ void NumCore::InitModule()
 	// register linear solvers
 	REGISTER_FECORE_CLASS(PardisoSolver  , "pardiso");
 	REGISTER_FECORE_CLASS(SkylineSolver  , "skyline");
+	REGISTER_FECORE_CLASS(SupernodalSolver, "supernodal");
 	REGISTER_FECORE_CLASS(LUSolver       , "LU"     );
 	REGISTER_FECORE_CLASS(FGMRESSolver        , "fgmres"   );
 	REGISTER_FECORE_CLASS(BoomerAMGSolver     , "boomeramg");
@@ -63,12 +70,17 @@ void NumCore::InitModule()
 	REGISTER_FECORE_CLASS(BlockIterativeSolver, "block");
 	REGISTER_FECORE_CLASS(BIPNSolver          , "bipn");
 	REGISTER_FECORE_CLASS(BiCGStabSolver      , "bicgstab");
+	REGISTER_FECORE_CLASS(PCGSolver           , "pcg");
+	REGISTER_FECORE_CLASS(GMRESSolver         , "gmres");
 	REGISTER_FECORE_CLASS(StrategySolver      , "strategy");
 
 	// register preconditioners
 	REGISTER_FECORE_CLASS(ILU0_Preconditioner, "ilu0");
 	REGISTER_FECORE_CLASS(ILUT_Preconditioner, "ilut");
 	REGISTER_FECORE_CLASS(IncompleteCholesky , "ichol");
+	REGISTER_FECORE_CLASS(DiagonalPreconditioner, "jacobi");
+	REGISTER_FECORE_CLASS(BlockJacobiPreconditioner, "block_jacobi");
+	REGISTER_FECORE_CLASS(AMGPreconditioner, "amg");
 
 	// register eigen solvers
 	REGISTER_FECORE_CLASS(FEASTEigenSolver, "feast");
@@ -80,6 +92,6 @@ void NumCore::InitModule()
 #ifdef PARDISO
 	fecore.SetDefaultSolverType("pardiso");
 #else
-	fecore.SetDefaultSolverType("skyline");
+	fecore.SetDefaultSolverType("supernodal");
 #endif
 }
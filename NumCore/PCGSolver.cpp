@@ -0,0 +1,124 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "PCGSolver.h"
+#include <FECore/log.h>
+#include <vector>
+#include <math.h>
+
+//-----------------------------------------------------------------------------
+PCGSolver::PCGSolver(FEModel* fem) : KrylovSolver(fem)
+{
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* PCGSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// CG only works for symmetric matrices
+	if (ntype != REAL_SYMMETRIC) return nullptr;
+	return KrylovSolver::CreateSparseMatrix(ntype);
+}
+
+//-----------------------------------------------------------------------------
+bool PCGSolver::BackSolve(double* x, double* b)
+{
+	if (m_pA == nullptr) return false;
+
+	SparseMatrix& A = *m_pA;
+	const int neq = A.Rows();
+	const int maxiter = MaxIterations(neq);
+
+	// assume initial guess is zero, so r0 = b
+	std::vector<double> r(b, b + neq), z(neq), p(neq), q(neq);
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < neq; ++i) x[i] = 0.0;
+
+	double norm0 = norm(neq, &r[0]);
+	double normi = norm0;
+	if (norm0 == 0.0) return true;
+
+	// z0 = M r0, p0 = z0
+	if (precondition(&z[0], &r[0]) == false) return false;
+	p = z;
+	double rz = dot(neq, &r[0], &z[0]);
+
+	int iter = 0;
+	bool bconv = false;
+	while ((bconv == false) && (iter < maxiter))
+	{
+		// q = A p
+		A.mult_vector(&p[0], &q[0]);
+
+		double pq = dot(neq, &p[0], &q[0]);
+		if (pq == 0.0) break;
+		double alpha = rz / pq;
+
+		// update solution and residual
+		double rr = 0.0;
+#pragma omp parallel for schedule(static) reduction(+:rr)
+		for (int i = 0; i < neq; ++i)
+		{
+			x[i] += alpha*p[i];
+			r[i] -= alpha*q[i];
+			rr += r[i] * r[i];
+		}
+		normi = sqrt(rr);
+		iter++;
+
+		if (m_print_level > 1) report(iter, normi, norm0);
+
+		if (converged(normi, norm0)) bconv = true;
+		else
+		{
+			// z = M r
+			if (precondition(&z[0], &r[0]) == false) return false;
+
+			double rz_new = dot(neq, &r[0], &z[0]);
+			double beta = rz_new / rz;
+			rz = rz_new;
+
+			// update search direction
+#pragma omp parallel for schedule(static)
+			for (int i = 0; i < neq; ++i) p[i] = z[i] + beta*p[i];
+		}
+	}
+
+	if (m_print_level == 1) report(iter, normi, norm0);
+
+	UpdateStats(iter);
+
+	if ((bconv == false) && m_fail_max_iters)
+	{
+		feLogWarning("PCG solver did not converge in %d iterations (residual norm = %lg).", iter, normi);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,618 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#include "stdafx.h"
+#include "SupernodalSolver.h"
+#include "NestedDissection.h"
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <algorithm>
+#include <assert.h>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(SupernodalSolver, LinearSolver)
+	ADD_PARAMETER(m_print_level, "print_level");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::SupernodalSolver(FEModel* fem) : LinearSolver(fem), m_pA(0)
+{
+	m_print_level = 0;
+	m_bsymbolic = false;
+	m_neq = 0;
+	m_nnz = 0;
+	m_zeroPivot = -1;
+}
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::~SupernodalSolver()
+{
+	Destroy();
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SupernodalSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// this solver only works with symmetric matrices
+	m_pA = (ntype == REAL_SYMMETRIC ? new CompactSymmMatrix(0) : nullptr);
+	m_bsymbolic = false;
+	return m_pA;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SetSparseMatrix(SparseMatrix* A)
+{
+	CompactSymmMatrix* pA = dynamic_cast<CompactSymmMatrix*>(A);
+	if (pA != m_pA) m_bsymbolic = false;
+	m_pA = pA;
+	return (m_pA != nullptr);
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::PreProcess()
+{
+	// The matrix profile (may have) changed, so we need to redo the symbolic factorization
+	m_bsymbolic = false;
+	if (m_pA == nullptr) return false;
+	if (SymbolicFactor() == false) return false;
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SymbolicFactor()
+{
+	CompactSymmMatrix& A = *m_pA;
+	const int N = A.Rows();
+	const int off = A.Offset();
+	const int* pA = A.Pointers();
+	const int* iA = A.Indices();
+
+	m_neq = N;
+	m_nnz = A.NonZeroes();
+	if (N == 0) return false;
+
+	// build the adjacency graph of the matrix
+	// (Since the row indices of each column are sorted, so are the adjacency lists.)
+	vector<int> xadj(N + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pA[j] - off; k < pA[j + 1] - off; ++k)
+		{
+			int i = iA[k] - off;
+			if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < N; ++i) xadj[i + 1] += xadj[i];
+	vector<int> adj(xadj[N]);
+	vector<int> pos(xadj.begin(), xadj.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pA[j] - off; k < pA[j + 1] - off; ++k)
+		{
+			int i = iA[k] - off;
+			if (i != j) { adj[pos[i]++] = j; adj[pos[j]++] = i; }
+		}
+	}
+
+	// fill-reducing ordering
+	NestedDissection nd;
+	vector<int> perm;
+	nd.Apply(N, xadj, adj, perm);
+	vector<int> iperm(N);
+	for (int i = 0; i < N; ++i) iperm[perm[i]] = i;
+
+	// elimination tree of the permuted matrix
+	vector<int> parent(N, -1), ancestor(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		int v = perm[i];
+		for (int m = xadj[v]; m < xadj[v + 1]; ++m)
+		{
+			int r = iperm[adj[m]];
+			if (r >= i) continue;
+			while ((ancestor[r] != -1) && (ancestor[r] != i))
+			{
+				int t = ancestor[r];
+				ancestor[r] = i;
+				r = t;
+			}
+			if (ancestor[r] == -1) { ancestor[r] = i; parent[r] = i; }
+		}
+	}
+
+	// postorder the elimination tree, so that subtrees are numbered consecutively
+	vector<int> head(N, -1), next(N, -1);
+	for (int j = N - 1; j >= 0; --j)
+	{
+		if (parent[j] != -1) { next[j] = head[parent[j]]; head[parent[j]] = j; }
+	}
+	vector<int> post(N), stack;
+	int npost = 0;
+	for (int j = 0; j < N; ++j)
+	{
+		if (parent[j] != -1) continue;
+		stack.push_back(j);
+		while (stack.empty() == false)
+		{
+			int p = stack.back();
+			int c = head[p];
+			if (c == -1) { stack.pop_back(); post[npost++] = p; }
+			else { head[p] = next[c]; stack.push_back(c); }
+		}
+	}
+	assert(npost == N);
+
+	vector<int> ipost(N);
+	for (int k = 0; k < N; ++k) ipost[post[k]] = k;
+	m_perm.resize(N);
+	vector<int> tmp(N);
+	for (int k = 0; k < N; ++k)
+	{
+		m_perm[k] = perm[post[k]];
+		int p = parent[post[k]];
+		tmp[k] = (p == -1 ? -1 : ipost[p]);
+	}
+	parent.swap(tmp);
+	for (int i = 0; i < N; ++i) iperm[m_perm[i]] = i;
+
+	// column counts, by traversing the row subtrees
+	vector<int> cc(N, 1), mark(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		mark[i] = i;
+		int v = m_perm[i];
+		for (int m = xadj[v]; m < xadj[v + 1]; ++m)
+		{
+			int j = iperm[adj[m]];
+			if (j > i) continue;
+			while (mark[j] != i)
+			{
+				mark[j] = i;
+				cc[j]++;
+				j = parent[j];
+			}
+		}
+	}
+
+	// fundamental supernodes
+	vector<int> nchild(N, 0);
+	for (int j = 0; j < N; ++j) if (parent[j] != -1) nchild[parent[j]]++;
+	vector<int> fs;
+	for (int j = 0; j < N; ++j)
+	{
+		if ((j == 0) || (parent[j - 1] != j) || (cc[j - 1] != cc[j] + 1) || (nchild[j] != 1)) fs.push_back(j);
+	}
+	const int nfs = (int)fs.size();
+	fs.push_back(N);
+
+	// Relaxed amalgamation: merge small supernodes with their parent if that does not
+	// introduce too many explicit zeroes. Only the last child can be merged with its parent,
+	// since the columns of a supernode must be contiguous.
+	m_snode.clear();
+	{
+		int a = fs[0], b = fs[1] - 1;
+		double ntrue = 0.0;
+		for (int j = a; j <= b; ++j) ntrue += cc[j];
+		for (int f = 1; f < nfs; ++f)
+		{
+			int fa = fs[f], fb = fs[f + 1] - 1;
+			double ftrue = 0.0;
+			for (int j = fa; j <= fb; ++j) ftrue += cc[j];
+
+			bool bmerge = false;
+			int p = parent[b];
+			if ((p >= fa) && (p <= fb))
+			{
+				double nc = fb - a + 1;
+				double ncc = nc + cc[fa] - (fb - fa + 1);
+				double nfull = nc*ncc - nc*(nc - 1.0)*0.5;
+				double z = (nfull - ntrue - ftrue) / nfull;
+				if      (nc <=  4) bmerge = true;
+				else if (nc <= 16) bmerge = (z < 0.8);
+				else if (nc <= 48) bmerge = (z < 0.1);
+				else bmerge = (z < 0.05);
+			}
+
+			if (bmerge)
+			{
+				b = fb;
+				ntrue += ftrue;
+			}
+			else
+			{
+				m_snode.push_back(a);
+				a = fa; b = fb;
+				ntrue = ftrue;
+			}
+		}
+		m_snode.push_back(a);
+		m_snode.push_back(N);
+	}
+	const int ns = (int)m_snode.size() - 1;
+
+	vector<int> snodeOf(N);
+	for (int s = 0; s < ns; ++s)
+		for (int j = m_snode[s]; j < m_snode[s + 1]; ++j) snodeOf[j] = s;
+
+	// supernode tree
+	m_sparent.resize(ns);
+	m_cptr.assign(ns + 1, 0);
+	for (int s = 0; s < ns; ++s)
+	{
+		int p = parent[m_snode[s + 1] - 1];
+		m_sparent[s] = (p == -1 ? -1 : snodeOf[p]);
+		if (p != -1) m_cptr[m_sparent[s] + 1]++;
+	}
+	for (int s = 0; s < ns; ++s) m_cptr[s + 1] += m_cptr[s];
+	m_cind.resize(m_cptr[ns]);
+	pos.assign(m_cptr.begin(), m_cptr.end() - 1);
+	for (int s = 0; s < ns; ++s) if (m_sparent[s] != -1) m_cind[pos[m_sparent[s]]++] = s;
+
+	// row structure of each supernode: its own columns, followed by the rows of the 
+	// matrix and the update rows of the children
+	m_rptr.assign(ns + 1, 0);
+	m_rind.clear();
+	mark.assign(N, -1);
+	for (int s = 0; s < ns; ++s)
+	{
+		const int a = m_snode[s], b = m_snode[s + 1] - 1;
+		for (int j = a; j <= b; ++j) { mark[j] = s; m_rind.push_back(j); }
+		size_t n0 = m_rind.size();
+
+		for (int j = a; j <= b; ++j)
+		{
+			int v = m_perm[j];
+			for (int m = xadj[v]; m < xadj[v + 1]; ++m)
+			{
+				int i = iperm[adj[m]];
+				if ((i > b) && (mark[i] != s)) { mark[i] = s; m_rind.push_back(i); }
+			}
+		}
+
+		for (int n = m_cptr[s]; n < m_cptr[s + 1]; ++n)
+		{
+			int c = m_cind[n];
+			int kc = m_snode[c + 1] - m_snode[c];
+			for (int m = m_rptr[c] + kc; m < m_rptr[c + 1]; ++m)
+			{
+				int i = m_rind[m];
+				if (mark[i] != s) { mark[i] = s; m_rind.push_back(i); }
+			}
+		}
+
+		sort(m_rind.begin() + n0, m_rind.end());
+		m_rptr[s + 1] = (int)m_rind.size();
+	}
+
+	// location of the update rows in the parent's structure
+	m_rel.assign(m_rind.size(), -1);
+	for (int s = 0; s < ns; ++s)
+	{
+		int p = m_sparent[s];
+		if (p == -1) continue;
+		const int* r0 = &m_rind[0] + m_rptr[p];
+		const int* r1 = &m_rind[0] + m_rptr[p + 1];
+		int k = m_snode[s + 1] - m_snode[s];
+		for (int m = m_rptr[s] + k; m < m_rptr[s + 1]; ++m)
+		{
+			const int* pi = lower_bound(r0, r1, m_rind[m]);
+			assert((pi != r1) && (*pi == m_rind[m]));
+			m_rel[m] = (int)(pi - r0);
+		}
+	}
+
+	// location of each matrix entry in the frontal matrices
+	m_aptr.assign(ns + 1, 0);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pA[j] - off; k < pA[j + 1] - off; ++k)
+		{
+			int i = iA[k] - off;
+			int c = min(iperm[i], iperm[j]);
+			m_aptr[snodeOf[c] + 1]++;
+		}
+	}
+	for (int s = 0; s < ns; ++s) m_aptr[s + 1] += m_aptr[s];
+	const int nnz = m_aptr[ns];
+	m_aval.resize(nnz);
+	m_arow.resize(nnz);
+	m_acol.resize(nnz);
+	pos.assign(m_aptr.begin(), m_aptr.end() - 1);
+	for (int j = 0; j < N; ++j)
+	{
+		for (int k = pA[j] - off; k < pA[j + 1] - off; ++k)
+		{
+			int i = iA[k] - off;
+			int c = min(iperm[i], iperm[j]);
+			int r = max(iperm[i], iperm[j]);
+			int s = snodeOf[c];
+			const int* r0 = &m_rind[0] + m_rptr[s];
+			const int* r1 = &m_rind[0] + m_rptr[s + 1];
+			const int* pi = lower_bound(r0, r1, r);
+			assert((pi != r1) && (*pi == r));
+
+			int n = pos[s]++;
+			m_aval[n] = k;
+			m_arow[n] = (int)(pi - r0);
+			m_acol[n] = c - m_snode[s];
+		}
+	}
+
+	// group the supernodes by their height in the assembly tree, so that all 
+	// supernodes in a group can be factored independently
+	vector<int> height(ns, 0);
+	int maxh = 0;
+	for (int s = 0; s < ns; ++s)
+	{
+		int p = m_sparent[s];
+		if (p != -1) height[p] = max(height[p], height[s] + 1);
+		maxh = max(maxh, height[s]);
+	}
+	m_lptr.assign(maxh + 2, 0);
+	for (int s = 0; s < ns; ++s) m_lptr[height[s] + 1]++;
+	for (int l = 0; l <= maxh; ++l) m_lptr[l + 1] += m_lptr[l];
+	m_lind.resize(ns);
+	pos.assign(m_lptr.begin(), m_lptr.end() - 1);
+	for (int s = 0; s < ns; ++s) m_lind[pos[height[s]]++] = s;
+
+	if (m_print_level > 0)
+	{
+		double nnzL = 0.0, flops = 0.0;
+		for (int s = 0; s < ns; ++s)
+		{
+			double m = m_rptr[s + 1] - m_rptr[s];
+			for (int j = m_snode[s]; j < m_snode[s + 1]; ++j, m -= 1.0)
+			{
+				nnzL += m;
+				flops += m*m;
+			}
+		}
+		feLog("Supernodal solver: %d equations, %d supernodes, %d levels\n", N, ns, maxh + 1);
+		feLog("\tnonzeroes in factor : %.0lf\n", nnzL);
+		feLog("\tfactorization flops : %lg\n", flops);
+	}
+
+	m_bsymbolic = true;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Factor()
+{
+	if (m_pA == nullptr) return false;
+
+	// we only need to redo the symbolic factorization if the profile changed
+	if ((m_bsymbolic == false) || (m_neq != m_pA->Rows()) || (m_nnz != m_pA->NonZeroes()))
+	{
+		if (SymbolicFactor() == false) return false;
+	}
+
+	const int ns = (int)m_snode.size() - 1;
+	m_L.resize(ns);
+	m_U.resize(ns);
+	m_D.resize(m_neq);
+	m_zeroPivot = -1;
+
+	// Process the assembly tree level by level. If a level has enough supernodes, 
+	// they are factored in parallel. Otherwise, the dense updates are parallelized.
+	const int nt = omp_get_max_threads();
+	const int nl = (int)m_lptr.size() - 1;
+	bool bok = true;
+	for (int l = 0; (l < nl) && bok; ++l)
+	{
+		const int n0 = m_lptr[l];
+		const int n1 = m_lptr[l + 1];
+		if ((nt > 1) && (n1 - n0 >= 2 * nt))
+		{
+#pragma omp parallel for schedule(dynamic)
+			for (int n = n0; n < n1; ++n)
+			{
+				if (FactorSupernode(m_lind[n], false) == false) bok = false;
+			}
+		}
+		else
+		{
+			for (int n = n0; (n < n1) && bok; ++n) bok = FactorSupernode(m_lind[n], true);
+		}
+	}
+
+	// release the remaining update matrices
+	for (int s = 0; s < ns; ++s) vector<double>().swap(m_U[s]);
+
+	if (bok == false)
+	{
+		feLogError("Zero pivot encountered in supernodal factorization (equation %d).", m_zeroPivot);
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::FactorSupernode(int s, bool bparallel)
+{
+	const int a = m_snode[s];
+	const int k = m_snode[s + 1] - a;
+	const int m = m_rptr[s + 1] - m_rptr[s];
+	const size_t M = (size_t)m;
+
+	// assemble the frontal matrix (only the lower triangle is used)
+	vector<double> F(M*M, 0.0);
+	const double* pv = m_pA->Values();
+	for (int n = m_aptr[s]; n < m_aptr[s + 1]; ++n)
+	{
+		F[m_arow[n] + m_acol[n] * M] += pv[m_aval[n]];
+	}
+
+	// add the update matrices of the children
+	for (int n = m_cptr[s]; n < m_cptr[s + 1]; ++n)
+	{
+		int c = m_cind[n];
+		int kc = m_snode[c + 1] - m_snode[c];
+		int r = m_rptr[c + 1] - m_rptr[c] - kc;
+		const int* rel = &m_rel[m_rptr[c] + kc];
+		const double* U = m_U[c].data();
+		for (int jj = 0; jj < r; ++jj)
+		{
+			double* Fj = &F[rel[jj] * M];
+			const double* Uj = U + jj*(size_t)r;
+			for (int ii = jj; ii < r; ++ii) Fj[rel[ii]] += Uj[ii];
+		}
+		vector<double>().swap(m_U[c]);
+	}
+
+	// partial LDLt factorization of the first k columns, in blocks of NB columns
+	const int NB = 32;
+	double* D = &m_D[a];
+	for (int jb = 0; jb < k; jb += NB)
+	{
+		const int je = min(jb + NB, k);
+
+		// factor the block columns
+		for (int j = jb; j < je; ++j)
+		{
+			double* Fj = &F[j*M];
+			double d = Fj[j];
+			if (d == 0.0)
+			{
+				m_zeroPivot = m_perm[a + j] + 1;
+				return false;
+			}
+			D[j] = d;
+
+			for (int c = j + 1; c < je; ++c)
+			{
+				double w = Fj[c] / d;
+				if (w == 0.0) continue;
+				double* Fc = &F[c*M];
+				for (int i = c; i < m; ++i) Fc[i] -= Fj[i] * w;
+			}
+
+			double di = 1.0 / d;
+			for (int i = j + 1; i < m; ++i) Fj[i] *= di;
+		}
+
+		// update the remaining columns (this includes the update matrix)
+#pragma omp parallel for schedule(dynamic, 4) if (bparallel && (m - je > 64))
+		for (int c = je; c < m; ++c)
+		{
+			double* Fc = &F[c*M];
+			for (int t = jb; t < je; ++t)
+			{
+				const double* Lt = &F[t*M];
+				double w = Lt[c] * D[t];
+				if (w == 0.0) continue;
+				for (int i = c; i < m; ++i) Fc[i] -= Lt[i] * w;
+			}
+		}
+	}
+
+	// store the factor
+	m_L[s].assign(F.begin(), F.begin() + M*k);
+
+	// store the update matrix for the parent
+	const int r = m - k;
+	if ((r > 0) && (m_sparent[s] != -1))
+	{
+		vector<double>& U = m_U[s];
+		U.resize((size_t)r*r);
+		for (int jj = 0; jj < r; ++jj)
+		{
+			const double* Fj = &F[(k + jj)*M + k];
+			double* Uj = &U[jj*(size_t)r];
+			for (int ii = jj; ii < r; ++ii) Uj[ii] = Fj[ii];
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::BackSolve(double* x, double* b)
+{
+	if (m_bsymbolic == false) return false;
+
+	const int N = m_neq;
+	const int ns = (int)m_snode.size() - 1;
+	m_tmp.resize(N);
+	double* y = m_tmp.data();
+	for (int i = 0; i < N; ++i) y[i] = b[m_perm[i]];
+
+	// forward substitution (L is unit lower triangular)
+	for (int s = 0; s < ns; ++s)
+	{
+		const int a = m_snode[s];
+		const int k = m_snode[s + 1] - a;
+		const int m = m_rptr[s + 1] - m_rptr[s];
+		const int* rows = &m_rind[m_rptr[s]];
+		const double* L = m_L[s].data();
+		for (int jj = 0; jj < k; ++jj)
+		{
+			double yj = y[a + jj];
+			if (yj == 0.0) continue;
+			const double* Lj = L + jj*(size_t)m;
+			for (int i = jj + 1; i < m; ++i) y[rows[i]] -= Lj[i] * yj;
+		}
+	}
+
+	// diagonal
+	for (int i = 0; i < N; ++i) y[i] /= m_D[i];
+
+	// backward substitution
+	for (int s = ns - 1; s >= 0; --s)
+	{
+		const int a = m_snode[s];
+		const int k = m_snode[s + 1] - a;
+		const int m = m_rptr[s + 1] - m_rptr[s];
+		const int* rows = &m_rind[m_rptr[s]];
+		const double* L = m_L[s].data();
+		for (int jj = k - 1; jj >= 0; --jj)
+		{
+			const double* Lj = L + jj*(size_t)m;
+			double sum = y[a + jj];
+			for (int i = jj + 1; i < m; ++i) sum -= Lj[i] * y[rows[i]];
+			y[a + jj] = sum;
+		}
+	}
+
+	for (int i = 0; i < N; ++i) x[m_perm[i]] = y[i];
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Destroy()
+{
+	vector< vector<double> >().swap(m_L);
+	vector< vector<double> >().swap(m_U);
+	vector<double>().swap(m_D);
+	vector<double>().swap(m_tmp);
+}
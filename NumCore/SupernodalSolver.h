@@ -0,0 +1,105 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2020 University of Utah, The Trustees of Columbia University in 
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+
+#pragma once
+#include <FECore/LinearSolver.h>
+#include "CompactSymmMatrix.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! Implements a supernodal sparse LDLt solver for symmetric matrices. 
+//! The matrix is reordered with nested dissection and the numeric factorization
+//! is done with a multifrontal method, where independent subtrees of the assembly 
+//! tree are factored in parallel. The symbolic analysis is only redone when the 
+//! matrix profile changes. No pivoting is done, so the matrix cannot have zero pivots.
+class SupernodalSolver : public LinearSolver
+{
+public:
+	//! constructor
+	SupernodalSolver(FEModel* fem);
+
+	//! destructor
+	~SupernodalSolver();
+
+	//! Preprocess (does the symbolic factorization)
+	bool PreProcess() override;
+
+	//! Factor matrix
+	bool Factor() override;
+
+	//! Backsolve the linear system
+	bool BackSolve(double* x, double* b) override;
+
+	//! Clean up
+	void Destroy() override;
+
+	//! Create a sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	//! Set the sparse matrix
+	bool SetSparseMatrix(SparseMatrix* A) override;
+
+	void SetPrintLevel(int n) override { m_print_level = n; }
+
+private:
+	// ordering, elimination tree and supernode structure
+	bool SymbolicFactor();
+
+	// assemble and factor the frontal matrix of supernode s
+	bool FactorSupernode(int s, bool bparallel);
+
+private:
+	CompactSymmMatrix*	m_pA;
+
+	int		m_print_level;	//!< output level
+
+	// symbolic factorization
+	bool				m_bsymbolic;	//!< symbolic factorization is valid
+	int					m_neq;			//!< matrix size when the symbolic factorization was done
+	int					m_nnz;			//!< nonzeroes when the symbolic factorization was done
+	std::vector<int>	m_perm;			//!< permutation (new to old)
+	std::vector<int>	m_snode;		//!< first column of each supernode
+	std::vector<int>	m_sparent;		//!< parent of each supernode (-1 for roots)
+	std::vector<int>	m_cptr, m_cind;	//!< children of each supernode
+	std::vector<int>	m_rptr, m_rind;	//!< row structure of each supernode
+	std::vector<int>	m_rel;			//!< position of the update rows in the parent's row structure
+	std::vector<int>	m_aptr;			//!< matrix entries assembled into each supernode
+	std::vector<int>	m_aval;			//!< index in matrix value array
+	std::vector<int>	m_arow, m_acol;	//!< location in frontal matrix
+	std::vector<int>	m_lptr, m_lind;	//!< supernodes grouped by height in the assembly tree
+
+	// numeric factorization
+	std::vector< std::vector<double> >	m_L;	//!< factor columns of each supernode
+	std::vector< std::vector<double> >	m_U;	//!< update matrices
+	std::vector<double>	m_D;					//!< diagonal
+	std::vector<double>	m_tmp;					//!< work vector for back solve
+	int					m_zeroPivot;			//!< location of zero pivot (or -1)
+
+	DECLARE_FECORE_CLASS();
+};